@@ -68,11 +68,14 @@ std::array<T, D> split_string(const std::string& in,
   return arr;
 }
 
-GlobalConfig* GlobalConfig::global_config_ = nullptr;
+std::shared_ptr<GlobalConfig> GlobalConfig::global_config_;
+
+size_t GlobalConfig::next_id_ = 0;
 
 GlobalConfig::GlobalConfig(const stdfs::path& base_path,
 			   const Config& config)
-  : simulation_base_path_(base_path),
+  : id_(next_id_++),
+    simulation_base_path_(base_path),
     config_(config)
 {
 }
@@ -98,6 +101,7 @@ void GlobalConfig::init(int argc, char* argv[])
     ("base-path", bpo::value<std::string>(), "simulation base path")
     ("accel-platform", bpo::value<std::string>(), "accelerator platform")
     ("accel-device", bpo::value<std::string>(), "accelerator device")
+    ("retune-launch", "tune kernel launch configurations again")
     ;
 
   bpo::options_description hidden_desc("Hidden options");
@@ -147,12 +151,9 @@ void GlobalConfig::init(int argc, char* argv[])
     base_path = config_file_path.parent_path();
   }
   
-  std::cout << "Simulation base directory: " << base_path << std::endl;
-  std::cout << "Configuration file name: " << config_file_path << std::endl;
-
-  Config config;
-  bpt::read_mf(config_file_path.native(), config);
+  init(config_file_path, base_path);
 
+  Config& config = global_config_->config_;
   if (bpo_vm.count("accel-platform")) {
     config.put<std::string>("device.platform",
 			    bpo_vm["accel-platform"].as<std::string>());
@@ -161,8 +162,42 @@ void GlobalConfig::init(int argc, char* argv[])
     config.put<std::string>("device.device",
 			    bpo_vm["accel-device"].as<std::string>());
   }
-  
-  global_config_ = new GlobalConfig(base_path, config);
+  if (bpo_vm.count("retune-launch")) {
+    config.put<bool>("device.retune launch", true);
+  }
+}
+
+void GlobalConfig::init(const stdfs::path& config_file_path,
+			const stdfs::path& base_path)
+{
+  std::cout << "Simulation base directory: " << base_path << std::endl;
+  std::cout << "Configuration file name: " << config_file_path << std::endl;
+
+  Config config;
+  bpt::read_mf(config_file_path.native(), config);
+
+  global_config_.reset(new GlobalConfig(base_path, config));
+}
+
+std::string GlobalConfig::input_key(const Config& conf) const
+{
+  std::ostringstream key;
+  key << conf.data() << std::endl;
+  bpt::write_mf(key, conf);
+  key << simulation_base_path_.native() << std::endl;
+  if (conf.count("filename") > 0) {
+    stdfs::path filepath = conf.get<stdfs::path>("filename");
+    if (not filepath.is_absolute()) {
+      filepath = simulation_base_path_ / filepath;
+    }
+    std::error_code ec;
+    auto size = stdfs::file_size(filepath, ec);
+    auto time = stdfs::last_write_time(filepath, ec);
+    if (not ec) {
+      key << size << " " << time.time_since_epoch().count() << std::endl;
+    }
+  }
+  return key.str();
 }
 
 const Config& GlobalConfig::device_configuration(void) const
@@ -347,6 +382,36 @@ measure_configuration(void)
   
 }
 
+const Config& GlobalConfig::
+ensemble_configuration(void)
+{
+  if (config_.count("ensemble") > 0) {
+    return config_.get_child("ensemble");
+  } else {
+    return config_.add("ensemble", "");
+  }
+}
+
+const Config& GlobalConfig::
+batch_configuration(void)
+{
+  if (config_.count("batch") > 0) {
+    return config_.get_child("batch");
+  } else {
+    return config_.add("batch", "");
+  }
+}
+
+const Config& GlobalConfig::
+server_configuration(void)
+{
+  if (config_.count("server") > 0) {
+    return config_.get_child("server");
+  } else {
+    return config_.add("server", "");
+  }
+}
+
 const std::vector<std::reference_wrapper<Config>>
 GlobalConfig::source_term_configurations(void)
 {
@@ -22,6 +22,7 @@
 #include <stdexcept>
 #include <iostream>
 #include <filesystem>
+#include <memory>
 namespace stdfs = std::filesystem;
 
 #include "mf_parser.hpp"
@@ -57,9 +58,21 @@ protected:
 	       const Config& config);
 
   /**
-     Static pointer to the singleton GlobalConfig object.
+     Static pointer to the singleton GlobalConfig object. A batch run
+     (see batch_configuration) reads the configuration of each model
+     and makes each the instance in turn (see activate).
    */
-  static GlobalConfig* global_config_;
+  static std::shared_ptr<GlobalConfig> global_config_;
+
+  /**
+     Identifier of the next configuration to be read.
+   */
+  static size_t next_id_;
+
+  /**
+     Identifier of this configuration, unique within the process.
+   */
+  size_t id_;
 
   /**
      Filename from which the configuration has been read.
@@ -98,6 +111,47 @@ public:
    */
   static void init(int argc, char* argv[]);
 
+  /**
+     Read a configuration file and make it the instance, replacing
+     any that there was.
+   */
+  static void init(const stdfs::path& config_file_path,
+		   const stdfs::path& base_path);
+
+  /**
+     Get the pointer to the instance, which keeps it alive after
+     another has been made the instance.
+   */
+  static const std::shared_ptr<GlobalConfig>& current(void)
+  {
+    return global_config_;
+  }
+
+  /**
+     Make a configuration read earlier the instance again.
+   */
+  static void activate(const std::shared_ptr<GlobalConfig>& config)
+  {
+    global_config_ = config;
+  }
+
+  /**
+     Get the identifier of the configuration. Caches of inputs named
+     in the configuration use it to tell when it has been replaced.
+   */
+  size_t id(void) const
+  {
+    return id_;
+  }
+
+  /**
+     Get a key identifying an input: its configuration, the base path
+     against which it is read, and the size and modification time of
+     the file it names, if any. Caches of inputs reuse an input
+     loaded for an earlier configuration if its key is unchanged.
+   */
+  std::string input_key(const Config& conf) const;
+
   /**
      Get the base path for the simulation.
    */
@@ -161,6 +215,21 @@ public:
   */
   const Config& measure_configuration(void);
 
+  /**
+     Get the ensemble configuration
+  */
+  const Config& ensemble_configuration(void);
+
+  /**
+     Get the batch configuration
+  */
+  const Config& batch_configuration(void);
+
+  /**
+     Get the server configuration
+  */
+  const Config& server_configuration(void);
+
   const std::vector<std::reference_wrapper<Config>>
   source_term_configurations(void);
 
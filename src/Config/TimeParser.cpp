@@ -146,3 +146,11 @@ std::string TimeParser<T>::format(const TimeType& time) const
     return std::to_string(TimeType(time / time_unit_factor_));
   }
 }
+
+template<typename T>
+std::string TimeParser<T>::key(void) const
+{
+  std::ostringstream ss;
+  ss << time_format_str_ << " " << time_zero_ << " " << time_unit_factor_;
+  return ss.str();
+}
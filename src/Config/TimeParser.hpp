@@ -63,6 +63,12 @@ public:
   TimeType parse(const std::string& time_str) const;
 
   std::string format(const TimeType& time) const;
+
+  /**
+     Get a key identifying how times are parsed, so that inputs
+     parsed with an equal key can be reused.
+  */
+  std::string key(void) const;
   
 };
 
@@ -42,10 +42,7 @@ DataArray<T>::DataArray(const std::shared_ptr<sycl::queue>& queue,
 {
   if (on_device) {
     device_data_ = std::make_shared<sycl::buffer<T,1>>(sycl::range<1>(size));
-    queue_->submit([&](sycl::handler& cgh)
-    {
-      cgh.fill(this->get_discard_write_accessor(cgh), value);
-    });
+    fill(value);
   } else {
     host_data_ = std::make_shared<std::vector<T>>(size,value);
   }
@@ -114,3 +111,87 @@ void DataArray<T>::move_to_host(void)
   }
   device_data_.reset();
 }
+
+template<typename T>
+void DataArray<T>::fill(const T& value) const
+{
+  if (device_data_) {
+    queue_->submit([&](sycl::handler& cgh)
+    {
+      cgh.fill(this->get_discard_write_accessor(cgh), value);
+    });
+  } else {
+    std::fill(host_data_->begin(), host_data_->end(), value);
+  }
+}
+
+template<typename T>
+void DataArray<T>::read_range(const size_t& offset,
+			      const size_t& count,
+			      T* dest) const
+{
+  if (device_data_) {
+    queue_->submit([&](sycl::handler& cgh)
+    {
+      auto acc = device_data_->template get_access<sycl::access::mode::read>(cgh, sycl::range<1>(count), sycl::id<1>(offset));
+      cgh.copy(acc, dest);
+    }).wait();
+  } else {
+    std::copy(host_data_->begin() + offset,
+	      host_data_->begin() + offset + count, dest);
+  }
+}
+
+template<typename T>
+sycl::event DataArray<T>::copy_to_host_async(T* dest) const
+{
+  if (device_data_) {
+    return queue_->submit([&](sycl::handler& cgh)
+    {
+      auto acc = device_data_->template get_access<sycl::access::mode::read>(cgh);
+      cgh.copy(acc, dest);
+    });
+  } else {
+    std::copy(host_data_->begin(), host_data_->end(), dest);
+    return sycl::event();
+  }
+}
+
+template<typename T>
+void DataArray<T>::copy_range(const size_t& offset,
+			      const size_t& count,
+			      const DataArray<T>& src,
+			      const size_t& src_offset) const
+{
+  if (count == 0) {
+    return;
+  }
+  if (device_data_ and src.device_data_) {
+    queue_->submit([&](sycl::handler& cgh)
+    {
+      auto src_acc = src.device_data_->template get_access<sycl::access::mode::read>(cgh, sycl::range<1>(count), sycl::id<1>(src_offset));
+      auto acc = device_data_->template get_access<sycl::access::mode::discard_write>(cgh, sycl::range<1>(count), sycl::id<1>(offset));
+      cgh.copy(src_acc, acc);
+    });
+  } else if (device_data_) {
+    write_range(offset, count, src.host_data_->data() + src_offset);
+  } else {
+    src.read_range(src_offset, count, host_data_->data() + offset);
+  }
+}
+
+template<typename T>
+void DataArray<T>::write_range(const size_t& offset,
+			       const size_t& count,
+			       const T* src) const
+{
+  if (device_data_) {
+    queue_->submit([&](sycl::handler& cgh)
+    {
+      auto acc = device_data_->template get_access<sycl::access::mode::discard_write>(cgh, sycl::range<1>(count), sycl::id<1>(offset));
+      cgh.copy(src, acc);
+    }).wait();
+  } else {
+    std::copy(src, src + count, host_data_->begin() + offset);
+  }
+}
@@ -225,6 +225,47 @@ public:
    */
   void move_to_host(void);
 
+  /**
+     Sets every element of the array to value.
+   */
+  void fill(const T& value) const;
+
+  /**
+     Copies count elements, starting at element offset, from this
+     array to dest on the host. Only the requested range is
+     transferred from the device.
+   */
+  void read_range(const size_t& offset,
+		  const size_t& count,
+		  T* dest) const;
+
+  /**
+     Starts copying the whole array to dest on the host without
+     waiting for the copy, which must be waited for on the returned
+     event before dest is read. Kernels submitted later that write to
+     the array wait for the copy.
+   */
+  sycl::event copy_to_host_async(T* dest) const;
+
+  /**
+     Copies count elements from src on the host into this array,
+     starting at element offset. Only the requested range is
+     transferred to the device.
+   */
+  void write_range(const size_t& offset,
+		   const size_t& count,
+		   const T* src) const;
+
+  /**
+     Copies count elements of src, starting at element src_offset,
+     into this array starting at element offset, without waiting for
+     the copy when both arrays are on the device.
+   */
+  void copy_range(const size_t& offset,
+		  const size_t& count,
+		  const DataArray<T>& src,
+		  const size_t& src_offset) const;
+
   /**
      Returns whether the array data is on the device (true) or on the
      host (false)
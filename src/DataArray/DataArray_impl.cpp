@@ -25,5 +25,9 @@
 template class DataArray<float>;
 template class DataArray<double>;
 template class DataArray<int32_t>;
+template class DataArray<uint8_t>;
+template class DataArray<uint16_t>;
 template class DataArray<uint32_t>;
 template class DataArray<size_t>;
+template class DataArray<sycl::vec<float,4>>;
+template class DataArray<sycl::vec<double,4>>;
@@ -0,0 +1,157 @@
+/***********************************************************************
+ * mfcm Field/DiagnosticFields.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_Field_DiagnosticFields_hpp
+#define mfcm_Field_DiagnosticFields_hpp
+
+#include <functional>
+#include <iomanip>
+#include <map>
+
+#include "Field.hpp"
+
+/**
+   Registry of optional diagnostic fields owned by some part of a
+   solver (e.g. the flux branch taken at each face, or the friction
+   slope in each cell).
+
+   Each diagnostic is declared with a name and a function that
+   allocates it, but is only allocated once it is requested, i.e. when
+   an output file asks for it at startup. Kernels should only write to
+   a diagnostic field if it has been allocated (see
+   DiagnosticFieldAccessor).
+ */
+template<typename FieldType>
+class DiagnosticFields
+{
+public:
+
+  using Allocator = std::function<std::shared_ptr<FieldType>(void)>;
+
+private:
+
+  std::map<std::string, Allocator> allocators_;
+
+  std::map<std::string, std::shared_ptr<FieldType>> fields_;
+
+public:
+
+  /**
+     Declare a diagnostic field that may later be requested.
+   */
+  void declare(const std::string& name, const Allocator& allocator)
+  {
+    allocators_[name] = allocator;
+  }
+
+  /**
+     Return true if a diagnostic field with the given name has been
+     declared.
+   */
+  bool is_declared(const std::string& name) const
+  {
+    return allocators_.count(name) > 0;
+  }
+
+  /**
+     Allocate the named diagnostic field if it has been declared and
+     not yet allocated. Returns true if the field has been declared.
+   */
+  bool request(const std::string& name)
+  {
+    auto it = allocators_.find(name);
+    if (it == allocators_.end()) {
+      return false;
+    }
+    if (fields_.count(name) == 0) {
+      std::cout << "Allocating diagnostic field " << std::quoted(name)
+		<< std::endl;
+      fields_[name] = (it->second)();
+    }
+    return true;
+  }
+
+  /**
+     Return a pointer to the named diagnostic field, or nullptr if it
+     has not been requested.
+   */
+  FieldType* get(const std::string& name) const
+  {
+    auto it = fields_.find(name);
+    if (it == fields_.end()) {
+      return nullptr;
+    }
+    return it->second.get();
+  }
+
+};
+
+/**
+   Write accessor for an optional diagnostic field. If Enabled is
+   false the accessor binds nothing and writes are discarded, so that
+   a kernel instantiated without diagnostics does not touch any
+   diagnostic buffer.
+ */
+template<typename FieldType,
+	 bool Enabled>
+class DiagnosticFieldAccessor;
+
+template<typename FieldType>
+class DiagnosticFieldAccessor<FieldType, true>
+{
+public:
+
+  using ValueType = typename FieldType::ValueType;
+
+  using Accessor = typename FieldType::
+    template Accessor<sycl::access::mode::write,
+		      sycl::access::target::global_buffer>;
+
+private:
+
+  Accessor acc_;
+
+public:
+
+  DiagnosticFieldAccessor(FieldType* f, sycl::handler& cgh)
+    : acc_(*f, cgh)
+  {}
+
+  void set(const size_t& i, const ValueType& v) const
+  {
+    acc_.data()[i] = v;
+  }
+
+};
+
+template<typename FieldType>
+class DiagnosticFieldAccessor<FieldType, false>
+{
+public:
+
+  using ValueType = typename FieldType::ValueType;
+
+  DiagnosticFieldAccessor(FieldType* f, sycl::handler& cgh)
+  {}
+
+  void set(const size_t& i, const ValueType& v) const
+  {}
+
+};
+
+#endif
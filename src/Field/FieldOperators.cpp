@@ -58,16 +58,20 @@ apply(const SourceFieldType& s, DestFieldType& d,
 			     "context in map operator");
     }
 
-    op_queue.submit([&](sycl::handler& cgh)
+    selection.dispatch([&](auto encoding)
     {
-      auto op_kernel =
-	MapFieldOperationKernel<MapFieldOperator<ValueType,
-						 SourceMeshType,
-						 DestMeshType,
-						 SourceFieldMappingType,
-						 DestFieldMappingType>>
-	(cgh, s, d, selection);
-      cgh.parallel_for(sycl::range<1>(selection.size()), op_kernel);
+      op_queue.submit([&](sycl::handler& cgh)
+      {
+	auto op_kernel =
+	  MapFieldOperationKernel<MapFieldOperator<ValueType,
+						   SourceMeshType,
+						   DestMeshType,
+						   SourceFieldMappingType,
+						   DestFieldMappingType>,
+				  decltype(encoding)::value>
+	  (cgh, s, d, selection);
+	launch_kernel(cgh, selection.size(), op_kernel);
+      });
     });
   } else {
     if (d.is_on_device()) {
@@ -120,10 +124,13 @@ apply(const SourceFieldType& s, DestFieldType& d,
 			     "context in unary operator");
     }
 
-    op_queue.submit([&](sycl::handler& cgh)
+    selection.dispatch([&](auto encoding)
     {
-      auto op_kernel = CastFieldOperationKernel<CastFieldOperator<SourceValueType,DestValueType,MeshType,FieldMappingType>>(cgh, s, d, selection);
-      cgh.parallel_for(sycl::range<1>(selection.size()), op_kernel);
+      op_queue.submit([&](sycl::handler& cgh)
+      {
+	auto op_kernel = CastFieldOperationKernel<CastFieldOperator<SourceValueType,DestValueType,MeshType,FieldMappingType>, decltype(encoding)::value>(cgh, s, d, selection);
+	launch_kernel(cgh, selection.size(), op_kernel);
+      });
     });
   } else {
     if (d.is_on_device()) {
@@ -162,10 +169,13 @@ apply(const SourceValueType& s, DestFieldType& d,
 {
   if (d.is_on_device()) {
     auto& op_queue = d.data().queue();
-    op_queue.submit([&](sycl::handler& cgh)
+    selection.dispatch([&](auto encoding)
     {
-      auto op_kernel = CastConstantOperationKernel<CastFieldOperator<SourceValueType,DestValueType,MeshType,FieldMappingType>>(cgh, s, d, selection);
-      cgh.parallel_for(sycl::range<1>(selection.size()), op_kernel);
+      op_queue.submit([&](sycl::handler& cgh)
+      {
+	auto op_kernel = CastConstantOperationKernel<CastFieldOperator<SourceValueType,DestValueType,MeshType,FieldMappingType>, decltype(encoding)::value>(cgh, s, d, selection);
+	launch_kernel(cgh, selection.size(), op_kernel);
+      });
     });
   } else {
     throw std::logic_error("Operators not currently supported on the host.");
@@ -213,10 +223,13 @@ apply(const FieldType& s, FieldType& d,
 			     "context in unary operator");
     }
 
-    op_queue.submit([&](sycl::handler& cgh)
+    selection.dispatch([&](auto encoding)
     {
-      auto op_kernel = UnaryFieldOperationKernel<UnaryFieldOperator<ValueType,MeshType,FieldMappingType,Op>>(cgh, s, d, selection);
-      cgh.parallel_for(sycl::range<1>(selection.size()), op_kernel);
+      op_queue.submit([&](sycl::handler& cgh)
+      {
+	auto op_kernel = UnaryFieldOperationKernel<UnaryFieldOperator<ValueType,MeshType,FieldMappingType,Op>, decltype(encoding)::value>(cgh, s, d, selection);
+	launch_kernel(cgh, selection.size(), op_kernel);
+      });
     });
   } else {
     if (d.is_on_device()) {
@@ -269,10 +282,13 @@ apply(FieldType& lhs, const FieldType& rhs,
 			     "context in binary operator");
     }
 
-    op_queue.submit([&](sycl::handler& cgh)
+    selection.dispatch([&](auto encoding)
     {
-      auto op_kernel = BinaryFieldCompoundAssignmentOperationKernel<BinaryFieldCompoundAssignmentOperator<ValueType,MeshType,FieldMappingType,Op>>(cgh, lhs, rhs, selection);
-      cgh.parallel_for(sycl::range<1>(selection.size()), op_kernel);
+      op_queue.submit([&](sycl::handler& cgh)
+      {
+	auto op_kernel = BinaryFieldCompoundAssignmentOperationKernel<BinaryFieldCompoundAssignmentOperator<ValueType,MeshType,FieldMappingType,Op>, decltype(encoding)::value>(cgh, lhs, rhs, selection);
+	launch_kernel(cgh, selection.size(), op_kernel);
+      });
     });
   } else {
     throw std::logic_error("Operators not currently supported on the host.");
@@ -305,10 +321,13 @@ apply(FieldType& lhs, const ValueType& rhs,
 {
   if (lhs.is_on_device()) {
     auto& op_queue = lhs.data().queue();
-    op_queue.submit([&](sycl::handler& cgh)
+    selection.dispatch([&](auto encoding)
     {
-      auto op_kernel = BinaryFieldConstantCompoundAssignmentOperationKernel<BinaryFieldCompoundAssignmentOperator<ValueType,MeshType,FieldMappingType,Op>>(cgh, lhs, rhs, selection);
-      cgh.parallel_for(sycl::range<1>(selection.size()), op_kernel);
+      op_queue.submit([&](sycl::handler& cgh)
+      {
+	auto op_kernel = BinaryFieldConstantCompoundAssignmentOperationKernel<BinaryFieldCompoundAssignmentOperator<ValueType,MeshType,FieldMappingType,Op>, decltype(encoding)::value>(cgh, lhs, rhs, selection);
+	launch_kernel(cgh, selection.size(), op_kernel);
+      });
     });
   } else {
     throw std::logic_error("Operators not currently supported on the host.");
@@ -356,10 +375,13 @@ apply(const FieldType& lhs, const FieldType& rhs, FieldType& d,
 			     "context in binary operator");
     }
 
-    op_queue.submit([&](sycl::handler& cgh)
+    selection.dispatch([&](auto encoding)
     {
-      auto op_kernel = BinaryFieldOperationKernel<BinaryFieldOperator<ValueType,MeshType,FieldMappingType,Op>>(cgh, lhs, rhs, d, selection);
-      cgh.parallel_for(sycl::range<1>(selection.size()), op_kernel);
+      op_queue.submit([&](sycl::handler& cgh)
+      {
+	auto op_kernel = BinaryFieldOperationKernel<BinaryFieldOperator<ValueType,MeshType,FieldMappingType,Op>, decltype(encoding)::value>(cgh, lhs, rhs, d, selection);
+	launch_kernel(cgh, selection.size(), op_kernel);
+      });
     });
   } else {
     throw std::logic_error("Operators not currently supported on the host.");
@@ -21,6 +21,7 @@
 
 #include "Field.hpp"
 #include "MeshSelection.hpp"
+#include "launch.hpp"
 
 template<typename T,
 	 typename SourceMesh,
@@ -58,7 +59,8 @@ public:
   
 };
 
-template<typename MFO>
+template<typename MFO,
+	 MeshSelectionEncoding Encoding>
 class MapFieldOperationKernel
 {
 public:
@@ -72,7 +74,7 @@ public:
   using DestAccessor =
     typename DestFieldType::template Accessor<sycl::access::mode::write>;
   using DestSelectionAccessor =
-    typename DestSelectionType::Accessor;
+    typename DestSelectionType::template Accessor<Encoding>;
   
 private:
 
@@ -96,21 +98,21 @@ public:
     d_sel_ro_.bind(cgh);
   }
 
-  void operator()(sycl::item<1> item) const
+  void operator()(sycl::id<1> idx) const
   {
     constexpr MeshComponent SourceFieldMappingType =
       SourceFieldType::FieldMappingType;
     constexpr MeshComponent DestFieldMappingType =
       DestFieldType::FieldMappingType;
-    // Get the location of the item
-    size_t i = d_sel_ro_(item.get_linear_id());
+    // Get the location of the object
+    size_t i = d_sel_ro_(idx[0]);
     size_t n_obj = s_ro_.mesh().template object_count<SourceFieldMappingType>();
     if (i < n_obj) {
       std::array<double,2> location =
 	d_wo_.mesh().template get_object_location<DestFieldMappingType>(i);
       size_t j = s_ro_.mesh().template get_nearest_object_index<SourceFieldMappingType>(location);
       if (j < n_obj) {
-	d_wo_.data()[item] = MFO()(s_ro_.data()[j]);
+	d_wo_.data()[idx] = MFO()(s_ro_.data()[j]);
       }
     }
   }
@@ -151,7 +153,8 @@ public:
   
 };
 
-template<typename CFO>
+template<typename CFO,
+	 MeshSelectionEncoding Encoding>
 class CastFieldOperationKernel
 {
 public:
@@ -166,7 +169,7 @@ public:
     typename DestFieldType::template Accessor<sycl::access::mode::write>;
 
   using DestSelectionAccessor =
-    typename DestSelectionType::Accessor;
+    typename DestSelectionType::template Accessor<Encoding>;
 
 private:
 
@@ -190,11 +193,11 @@ public:
     d_sel_ro_.bind(cgh);
   }
 
-  void operator()(sycl::item<1> item) const
+  void operator()(sycl::id<1> idx) const
   {
     constexpr MeshComponent SourceFieldMappingType =
       SourceFieldType::FieldMappingType;
-    size_t i = d_sel_ro_(item.get_linear_id());
+    size_t i = d_sel_ro_(idx[0]);
     if (i < s_ro_.mesh().template object_count<SourceFieldMappingType>()) {
       d_wo_.data()[i] = CFO()(s_ro_.data()[i]);
     }
@@ -202,7 +205,8 @@ public:
   
 };
 
-template<typename CFO>
+template<typename CFO,
+	 MeshSelectionEncoding Encoding>
 class CastConstantOperationKernel
 {
 public:
@@ -215,7 +219,7 @@ public:
     typename DestFieldType::template Accessor<sycl::access::mode::write>;
 
   using DestSelectionAccessor =
-    typename DestSelectionType::Accessor;
+    typename DestSelectionType::template Accessor<Encoding>;
 
 private:
 
@@ -238,11 +242,11 @@ public:
     d_sel_ro_.bind(cgh);
   }
 
-  void operator()(sycl::item<1> item) const
+  void operator()(sycl::id<1> idx) const
   {
     constexpr MeshComponent FieldMappingType =
       DestFieldType::FieldMappingType;
-    size_t i = d_sel_ro_(item.get_linear_id());
+    size_t i = d_sel_ro_(idx[0]);
     if (i < d_wo_.mesh().template object_count<FieldMappingType>()) {
       d_wo_.data()[i] = CFO()(s_value_);
     }
@@ -279,7 +283,8 @@ public:
   
 };
 
-template<typename UFO>
+template<typename UFO,
+	 MeshSelectionEncoding Encoding>
 class UnaryFieldOperationKernel
 {
 public:
@@ -292,7 +297,7 @@ public:
   using DestAccessor =
     typename FieldType::template Accessor<sycl::access::mode::write>;
   using DestSelectionAccessor =
-    typename SelectionType::Accessor;
+    typename SelectionType::template Accessor<Encoding>;
 
 private:
 
@@ -315,11 +320,11 @@ public:
     d_sel_ro_.bind(cgh);
   }
 
-  void operator()(sycl::item<1> item) const
+  void operator()(sycl::id<1> idx) const
   {
     constexpr MeshComponent SourceFieldMappingType =
       FieldType::FieldMappingType;
-    size_t i = d_sel_ro_(item.get_linear_id());
+    size_t i = d_sel_ro_(idx[0]);
     if (i < s_ro_.mesh().template object_count<SourceFieldMappingType>()) {
       d_wo_.data()[i] = UFO()(s_ro_.data()[i]);
     }
@@ -358,7 +363,8 @@ public:
 };
 
 
-template<typename BCAO>
+template<typename BCAO,
+	 MeshSelectionEncoding Encoding>
 class BinaryFieldCompoundAssignmentOperationKernel
 {
 public:
@@ -370,7 +376,7 @@ public:
     typename FieldType::template Accessor<sycl::access::mode::read_write>;
   using RHSAccessor =
     typename FieldType::template Accessor<sycl::access::mode::read>;
-  using SelectionAccessor = typename SelectionType::Accessor;
+  using SelectionAccessor = typename SelectionType::template Accessor<Encoding>;
 
 private:
 
@@ -391,18 +397,19 @@ public:
     sel_.bind(cgh);
   }
 
-  void operator()(sycl::item<1> item) const
+  void operator()(sycl::id<1> idx) const
   {
     constexpr MeshComponent SourceFieldMappingType =
       FieldType::FieldMappingType;
-    size_t i = sel_(item.get_linear_id());
+    size_t i = sel_(idx[0]);
     if (i < lhs_.mesh().template object_count<SourceFieldMappingType>()) {
       lhs_.data()[i] = BCAO()(lhs_.data()[i], rhs_.data()[i]);
     }
   }
 };
 
-template<typename BCAO>
+template<typename BCAO,
+	 MeshSelectionEncoding Encoding>
 class BinaryFieldConstantCompoundAssignmentOperationKernel
 {
 public:
@@ -413,7 +420,7 @@ public:
 
   using LHSAccessor =
     typename FieldType::template Accessor<sycl::access::mode::read_write>;
-  using SelectionAccessor = typename SelectionType::Accessor;
+  using SelectionAccessor = typename SelectionType::template Accessor<Encoding>;
 
 private:
 
@@ -433,11 +440,11 @@ public:
     sel_.bind(cgh);
   }
 
-  void operator()(sycl::item<1> item) const
+  void operator()(sycl::id<1> idx) const
   {
     constexpr MeshComponent SourceFieldMappingType =
       FieldType::FieldMappingType;
-    size_t i = sel_(item.get_linear_id());
+    size_t i = sel_(idx[0]);
     if (i < lhs_.mesh().template object_count<SourceFieldMappingType>()) {
       lhs_.data()[i] = BCAO()(lhs_.data()[i], rhs_);
     }
@@ -473,7 +480,8 @@ public:
   
 };
 
-template<typename BFO>
+template<typename BFO,
+	 MeshSelectionEncoding Encoding>
 class BinaryFieldOperationKernel
 {
 public:
@@ -486,7 +494,7 @@ public:
   using DestAccessor =
     typename FieldType::template Accessor<sycl::access::mode::write>;
   using DestSelectionAccessor =
-    typename SelectionType::Accessor;
+    typename SelectionType::template Accessor<Encoding>;
 
 private:
 
@@ -514,11 +522,11 @@ public:
     d_sel_ro_.bind(cgh);
   }
 
-  void operator()(sycl::item<1> item) const
+  void operator()(sycl::id<1> idx) const
   {
     constexpr MeshComponent SourceFieldMappingType =
       FieldType::FieldMappingType;
-    size_t i = d_sel_ro_(item.get_linear_id());
+    size_t i = d_sel_ro_(idx[0]);
     if (i < lhs_ro_.mesh().template object_count<SourceFieldMappingType>()) {
       d_wo_.data()[i] = BFO()(lhs_ro_.data()[i], rhs_ro_.data()[i]);
     }
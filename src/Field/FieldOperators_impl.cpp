@@ -22,6 +22,11 @@
 
 #include "FieldOperators.cpp"
 #include "Cartesian2DMesh.hpp"
+#include "QuadtreeMesh.hpp"
+#include "RectilinearMesh.hpp"
+#include "SparseCartesian2DMesh.hpp"
+#include "UnstructuredMesh.hpp"
+#include "MultiCartesian2DMesh.hpp"
 #include <functional>
 
 template class MapFieldOperator<float, Cartesian2DMesh, Cartesian2DMesh, MeshComponent::Cell, MeshComponent::Cell>;
@@ -29,7 +34,60 @@ template class MapFieldOperator<double, Cartesian2DMesh, Cartesian2DMesh, MeshCo
 template class MapFieldOperator<int32_t, Cartesian2DMesh, Cartesian2DMesh, MeshComponent::Cell, MeshComponent::Cell>;
 template class MapFieldOperator<uint32_t, Cartesian2DMesh, Cartesian2DMesh, MeshComponent::Cell, MeshComponent::Cell>;
 
+template class MapFieldOperator<float, Cartesian2DMesh, TiledCartesian2DMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<double, Cartesian2DMesh, TiledCartesian2DMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<int32_t, Cartesian2DMesh, TiledCartesian2DMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<uint32_t, Cartesian2DMesh, TiledCartesian2DMesh, MeshComponent::Cell, MeshComponent::Cell>;
+
+template class MapFieldOperator<float, Cartesian2DMesh, QuadtreeMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<double, Cartesian2DMesh, QuadtreeMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<int32_t, Cartesian2DMesh, QuadtreeMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<uint32_t, Cartesian2DMesh, QuadtreeMesh, MeshComponent::Cell, MeshComponent::Cell>;
+
+template class MapFieldOperator<float, Cartesian2DMesh, RectilinearMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<double, Cartesian2DMesh, RectilinearMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<int32_t, Cartesian2DMesh, RectilinearMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<uint32_t, Cartesian2DMesh, RectilinearMesh, MeshComponent::Cell, MeshComponent::Cell>;
+
+template class MapFieldOperator<float, Cartesian2DMesh, SparseCartesian2DMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<double, Cartesian2DMesh, SparseCartesian2DMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<int32_t, Cartesian2DMesh, SparseCartesian2DMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<uint32_t, Cartesian2DMesh, SparseCartesian2DMesh, MeshComponent::Cell, MeshComponent::Cell>;
+
+template class MapFieldOperator<float, Cartesian2DMesh, UnstructuredMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<double, Cartesian2DMesh, UnstructuredMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<int32_t, Cartesian2DMesh, UnstructuredMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<uint32_t, Cartesian2DMesh, UnstructuredMesh, MeshComponent::Cell, MeshComponent::Cell>;
+
+template class MapFieldOperator<float, Cartesian2DMesh, MultiCartesian2DMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<double, Cartesian2DMesh, MultiCartesian2DMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<int32_t, Cartesian2DMesh, MultiCartesian2DMesh, MeshComponent::Cell, MeshComponent::Cell>;
+template class MapFieldOperator<uint32_t, Cartesian2DMesh, MultiCartesian2DMesh, MeshComponent::Cell, MeshComponent::Cell>;
+
 #define MeshType Cartesian2DMesh
 #include "FieldOperators_impl_mesh.cpp"
 #undef MeshType
 
+#define MeshType TiledCartesian2DMesh
+#include "FieldOperators_impl_mesh.cpp"
+#undef MeshType
+
+#define MeshType QuadtreeMesh
+#include "FieldOperators_impl_mesh.cpp"
+#undef MeshType
+
+#define MeshType RectilinearMesh
+#include "FieldOperators_impl_mesh.cpp"
+#undef MeshType
+
+#define MeshType SparseCartesian2DMesh
+#include "FieldOperators_impl_mesh.cpp"
+#undef MeshType
+
+#define MeshType UnstructuredMesh
+#include "FieldOperators_impl_mesh.cpp"
+#undef MeshType
+
+#define MeshType MultiCartesian2DMesh
+#include "FieldOperators_impl_mesh.cpp"
+#undef MeshType
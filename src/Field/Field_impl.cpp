@@ -22,9 +22,40 @@
 
 #include "Field.cpp"
 #include "FieldVector.cpp"
+#include "PackedField.cpp"
+#include "ZonedField.cpp"
 #include "Cartesian2DMesh.hpp"
+#include "QuadtreeMesh.hpp"
+#include "RectilinearMesh.hpp"
+#include "SparseCartesian2DMesh.hpp"
+#include "UnstructuredMesh.hpp"
+#include "MultiCartesian2DMesh.hpp"
 
 #define MeshType Cartesian2DMesh
 #include "Field_impl_mesh.cpp"
 #undef MeshType
 
+#define MeshType TiledCartesian2DMesh
+#include "Field_impl_mesh.cpp"
+#undef MeshType
+
+#define MeshType QuadtreeMesh
+#include "Field_impl_mesh.cpp"
+#undef MeshType
+
+#define MeshType RectilinearMesh
+#include "Field_impl_mesh.cpp"
+#undef MeshType
+
+#define MeshType SparseCartesian2DMesh
+#include "Field_impl_mesh.cpp"
+#undef MeshType
+
+#define MeshType UnstructuredMesh
+#include "Field_impl_mesh.cpp"
+#undef MeshType
+
+#define MeshType MultiCartesian2DMesh
+#include "Field_impl_mesh.cpp"
+#undef MeshType
+
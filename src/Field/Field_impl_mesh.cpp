@@ -31,3 +31,6 @@
 #define ValueType uint32_t
 #include "Field_impl_mesh_value.cpp"
 #undef ValueType
+
+#include "PackedField_impl_mesh.cpp"
+#include "ZonedField_impl_mesh.cpp"
@@ -0,0 +1,149 @@
+/***********************************************************************
+ * mfcm Field/PackedField.cpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "PackedField.hpp"
+
+template<typename T,
+	 typename S,
+	 typename Mesh,
+	 MeshComponent FieldMapping>
+PackedField<T,S,Mesh,FieldMapping>::
+PackedField(const Field<ValueType,MeshType,FieldMappingType>& f)
+  : name_(f.name()),
+    mesh_p_(f.mesh()),
+    data_(f.queue_ptr(), std::vector<StorageType>()),
+    scale_(0.0),
+    offset_(0.0)
+{
+  // Take a host copy of the source data without disturbing the
+  // source field (or its mesh) on the device.
+  DataArray<ValueType> values(f.data());
+  values.move_to_host();
+  const std::vector<ValueType>& vv = values.host_vector();
+
+  ValueType vmin = std::numeric_limits<ValueType>::infinity();
+  ValueType vmax = -std::numeric_limits<ValueType>::infinity();
+  for (auto&& v : vv) {
+    if (std::isfinite(v)) {
+      vmin = std::min(vmin, v);
+      vmax = std::max(vmax, v);
+    }
+  }
+  if (vmin > vmax) {
+    // No finite values in the field
+    vmin = 0.0;
+    vmax = 0.0;
+  }
+
+  // The largest code is reserved for NaN
+  const ValueType max_code = ValueType(nan_code - 1);
+  offset_ = vmin;
+  scale_ = (vmax - vmin) / max_code;
+
+  std::vector<StorageType>& codes = data_.host_vector();
+  codes.resize(vv.size());
+  for (size_t i = 0; i < vv.size(); ++i) {
+    if (vv[i] != vv[i]) {
+      codes[i] = nan_code;
+    } else if (scale_ > 0.0) {
+      ValueType c = std::round((vv[i] - offset_) / scale_);
+      codes[i] = StorageType(std::min(std::max(c, ValueType(0.0)), max_code));
+    } else {
+      codes[i] = 0;
+    }
+  }
+
+  std::cout << "Packed field " << name_ << " into "
+	    << 8 * sizeof(StorageType) << "-bit codes (offset "
+	    << offset_ << ", scale " << scale_ << ")." << std::endl;
+  
+  if (f.is_on_device()) {
+    data_.move_to_device();
+  }
+}
+
+template<typename T,
+	 typename S,
+	 typename Mesh,
+	 MeshComponent FieldMapping>
+Field<T,Mesh,FieldMapping>
+PackedField<T,S,Mesh,FieldMapping>::unpack(bool on_device) const
+{
+  DataArray<StorageType> codes(data_);
+  codes.move_to_host();
+  const std::vector<StorageType>& cv = codes.host_vector();
+
+  std::vector<ValueType> values(cv.size());
+  for (size_t i = 0; i < cv.size(); ++i) {
+    if (cv[i] == nan_code) {
+      values[i] = std::numeric_limits<ValueType>::quiet_NaN();
+    } else {
+      values[i] = offset_ + scale_ * ValueType(cv[i]);
+    }
+  }
+  return Field<ValueType,MeshType,FieldMappingType>(data_.queue_ptr(), name_,
+						    mesh_p_, values, on_device);
+}
+
+template<typename T,
+	 typename S,
+	 typename Mesh,
+	 MeshComponent FieldMapping,
+	 sycl::access::mode Mode,
+	 sycl::access::target Target>
+PackedFieldAccessor<T,S,Mesh,FieldMapping,Mode,Target>::
+PackedFieldAccessor(const FieldType& f)
+  : mesh_ro_(MeshAccessor(*(f.mesh()))),
+    data_acc_(f.data().template get_placeholder_accessor<Mode,Target>()),
+    scale_(f.scale()),
+    offset_(f.offset())
+{}
+
+template<typename T,
+	 typename S,
+	 typename Mesh,
+	 MeshComponent FieldMapping,
+	 sycl::access::mode Mode,
+	 sycl::access::target Target>
+PackedFieldAccessor<T,S,Mesh,FieldMapping,Mode,Target>::
+PackedFieldAccessor(const FieldType& f,
+		    sycl::handler& cgh)
+  : mesh_ro_(MeshAccessor(*(f.mesh()))),
+    data_acc_(f.data().template get_placeholder_accessor<Mode,Target>()),
+    scale_(f.scale()),
+    offset_(f.offset())
+{
+  mesh_ro_.bind(cgh);
+  cgh.require(data_acc_);
+}
+
+template<typename T,
+	 typename S,
+	 typename Mesh,
+	 MeshComponent FieldMapping,
+	 sycl::access::mode Mode,
+	 sycl::access::target Target>
+void
+PackedFieldAccessor<T,S,Mesh,FieldMapping,Mode,Target>::bind(sycl::handler& cgh)
+{
+  mesh_ro_.bind(cgh);
+  cgh.require(data_acc_);
+}
@@ -0,0 +1,239 @@
+/***********************************************************************
+ * mfcm Field/PackedField.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_Field_PackedField_hpp
+#define mfcm_Field_PackedField_hpp
+
+#include <limits>
+
+#include "Field.hpp"
+
+template<typename T,
+	 typename S,
+	 typename Mesh,
+	 MeshComponent FieldMapping,
+	 sycl::access::mode Mode,
+	 sycl::access::target Target = sycl::access::target::global_buffer>
+class PackedFieldAccessor;
+
+/**
+   Class representing a read-only field whose values are stored as
+   unsigned integer codes of type S with a per-field scale and
+   offset. The value of each datum is offset + scale * code, except
+   that the largest code represents NaN (e.g. coded-out cells).
+
+   Packed fields are intended for static parameters (roughness,
+   infiltration rates and so on) that are read on every stage but
+   never written after they are generated: storing them as 8- or
+   16-bit codes reduces the bandwidth needed to read them.
+ */
+template<typename T,
+	 typename S,
+	 typename Mesh,
+	 MeshComponent FieldMapping>
+class PackedField
+{
+public:
+
+  /**
+     The type of data returned when the field is read.
+   */
+  using ValueType = T;
+
+  /**
+     The type of the codes stored in the underlying array.
+   */
+  using StorageType = S;
+
+  /**
+     The type of mesh that the data maps to.
+   */
+  using MeshType = Mesh;
+
+  using MeshAccessor = typename Mesh::Accessor;
+
+  /**
+     Enumeration type indicating what type of mesh component each
+     datum is associated with.
+   */
+  static const MeshComponent FieldMappingType = FieldMapping;
+
+  template<sycl::access::mode Mode,
+	   sycl::access::target Target = sycl::access::target::global_buffer>
+  using Accessor = PackedFieldAccessor<ValueType, StorageType, MeshType,
+				       FieldMappingType, Mode, Target>;
+
+  /**
+     The code used to represent NaN values.
+   */
+  static constexpr StorageType nan_code = std::numeric_limits<S>::max();
+
+private:
+
+  std::string name_;
+
+  std::shared_ptr<MeshType> mesh_p_;
+
+  DataArray<StorageType> data_;
+
+  ValueType scale_;
+  ValueType offset_;
+
+public:
+
+  /**
+     Construct by encoding the values of a full-precision field. The
+     packed field is placed on the device if f is on the device.
+   */
+  explicit PackedField(const Field<ValueType,MeshType,FieldMappingType>& f);
+
+  const std::string& name(void) const
+  {
+    return name_;
+  }
+
+  size_t size(void) const
+  {
+    return data_.size();
+  }
+
+  bool is_on_device(void) const
+  {
+    return data_.is_on_device();
+  }
+
+  const std::shared_ptr<sycl::queue>& queue_ptr(void) const
+  {
+    return data_.queue_ptr();
+  }
+
+  const std::shared_ptr<MeshType>& mesh(void) const
+  {
+    return mesh_p_;
+  }
+
+  void move_to_device(void)
+  {
+    mesh_p_->move_to_device();
+    data_.move_to_device();
+  }
+
+  void move_to_host(void)
+  {
+    mesh_p_->move_to_host();
+    data_.move_to_host();
+  }
+
+  const DataArray<StorageType>& data(void) const
+  {
+    return data_;
+  }
+
+  const ValueType& scale(void) const
+  {
+    return scale_;
+  }
+
+  const ValueType& offset(void) const
+  {
+    return offset_;
+  }
+
+  /**
+     Return a full-precision field containing the decoded values.
+   */
+  Field<T,Mesh,FieldMapping> unpack(bool on_device = false) const;
+
+};
+
+template<typename T,
+	 typename S,
+	 typename Mesh,
+	 MeshComponent FieldMapping,
+	 sycl::access::mode Mode,
+	 sycl::access::target Target>
+class PackedFieldAccessor
+{
+public:
+
+  static_assert(Mode == sycl::access::mode::read,
+		"Packed fields may only be accessed for reading.");
+
+  using ValueType = T;
+
+  using StorageType = S;
+
+  using MeshType = Mesh;
+
+  static const MeshComponent FieldMappingType = FieldMapping;
+
+  using MeshAccessor = typename MeshType::Accessor;
+
+  using FieldType = PackedField<T,S,Mesh,FieldMapping>;
+
+  using DataAccessor = typename DataArray<S>::
+    template Accessor<Mode, Target, sycl::access::placeholder::true_t>;
+
+private:
+
+  MeshAccessor mesh_ro_;
+
+  DataAccessor data_acc_;
+
+  ValueType scale_;
+  ValueType offset_;
+
+public:
+
+  PackedFieldAccessor(const FieldType& f);
+
+  PackedFieldAccessor(const FieldType& f,
+		      sycl::handler& cgh);
+
+  void bind(sycl::handler& cgh);
+
+  const MeshAccessor& mesh(void) const
+  {
+    return mesh_ro_;
+  }
+
+  /**
+     Return a reference to this accessor, so that packed fields can be
+     read with the same data()[i] syntax as a FieldAccessor.
+   */
+  const PackedFieldAccessor<T,S,Mesh,FieldMapping,Mode,Target>&
+  data(void) const
+  {
+    return *this;
+  }
+
+  /**
+     Return the decoded value of the i-th datum.
+   */
+  ValueType operator[](const size_t& i) const
+  {
+    StorageType code = data_acc_[i];
+    if (code == FieldType::nan_code) {
+      return std::numeric_limits<ValueType>::quiet_NaN();
+    }
+    return offset_ + scale_ * ValueType(code);
+  }
+
+};
+
+#endif
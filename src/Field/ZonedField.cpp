@@ -0,0 +1,201 @@
+/***********************************************************************
+ * mfcm Field/ZonedField.cpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#include <map>
+
+#include "ZonedField.hpp"
+
+template<typename T,
+	 typename Mesh,
+	 MeshComponent FieldMapping>
+ZonedField<T,Mesh,FieldMapping>::
+ZonedField(const std::shared_ptr<sycl::queue>& queue,
+	   const std::string& name,
+	   const std::shared_ptr<MeshType>& mesh_p,
+	   const T& value,
+	   bool on_device)
+  : name_(name),
+    mesh_p_(mesh_p),
+    zone_values_(queue, 1, value, on_device),
+    zone_index_(queue, std::vector<ZoneIndexType>(), on_device)
+{
+}
+
+template<typename T,
+	 typename Mesh,
+	 MeshComponent FieldMapping>
+ZonedField<T,Mesh,FieldMapping>::
+ZonedField(const std::shared_ptr<sycl::queue>& queue,
+	   const std::string& name,
+	   const std::shared_ptr<MeshType>& mesh_p,
+	   const std::vector<T>& zone_values,
+	   const std::vector<ZoneIndexType>& zone_index,
+	   bool on_device)
+  : name_(name),
+    mesh_p_(mesh_p),
+    zone_values_(queue, zone_values, on_device),
+    zone_index_(queue, zone_index, on_device)
+{
+  if (zone_values.empty() or zone_values.size() > max_zones) {
+    std::cerr << "ERROR: Zoned field " << name_ << " has "
+	      << zone_values.size() << " zones." << std::endl;
+    throw std::logic_error("Invalid number of zones in zoned field.");
+  }
+  if (zone_values.size() > 1 and zone_index.size() != this->size()) {
+    std::cerr << "ERROR: Zoned field " << name_ << " has "
+	      << zone_index.size() << " zone indices but maps to "
+	      << this->size() << " mesh objects." << std::endl;
+    throw std::logic_error("Zone index does not match mesh size.");
+  }
+}
+
+template<typename T,
+	 typename Mesh,
+	 MeshComponent FieldMapping>
+ZonedField<T,Mesh,FieldMapping>::
+ZonedField(const Field<ValueType,MeshType,FieldMappingType>& f)
+  : name_(f.name()),
+    mesh_p_(f.mesh()),
+    zone_values_(f.queue_ptr(), std::vector<ValueType>()),
+    zone_index_(f.queue_ptr(), std::vector<ZoneIndexType>())
+{
+  // Take a host copy of the source data without disturbing the
+  // source field (or its mesh) on the device.
+  DataArray<ValueType> values(f.data());
+  values.move_to_host();
+  const std::vector<ValueType>& vv = values.host_vector();
+
+  // NaN values compare unequal to everything so are given their own
+  // zone, which is always the last one.
+  std::map<ValueType, ZoneIndexType> zone_map;
+  bool has_nan = false;
+  for (auto&& v : vv) {
+    if (v != v) {
+      has_nan = true;
+    } else if (zone_map.count(v) == 0) {
+      if (zone_map.size() + (has_nan ? 1 : 0) >= max_zones) {
+	std::cerr << "ERROR: Field " << name_ << " has more than "
+		  << max_zones << " distinct values." << std::endl;
+	throw std::runtime_error("Too many distinct values for zoned field.");
+      }
+      zone_map[v] = 0;
+    }
+  }
+  if (zone_map.empty() and not has_nan) {
+    zone_map[ValueType()] = 0;
+  }
+
+  std::vector<ValueType>& zv = zone_values_.host_vector();
+  for (auto&& kv : zone_map) {
+    kv.second = ZoneIndexType(zv.size());
+    zv.push_back(kv.first);
+  }
+  const ZoneIndexType nan_zone = ZoneIndexType(zv.size());
+  if (has_nan) {
+    zv.push_back(std::numeric_limits<ValueType>::quiet_NaN());
+  }
+
+  if (zv.size() > 1) {
+    std::vector<ZoneIndexType>& zi = zone_index_.host_vector();
+    zi.resize(vv.size());
+    for (size_t i = 0; i < vv.size(); ++i) {
+      zi[i] = (vv[i] != vv[i]) ? nan_zone : zone_map.at(vv[i]);
+    }
+  }
+
+  std::cout << "Zoned field " << name_ << " has " << zv.size()
+	    << " zone(s)." << std::endl;
+
+  if (f.is_on_device()) {
+    zone_values_.move_to_device();
+    zone_index_.move_to_device();
+  }
+}
+
+template<typename T,
+	 typename Mesh,
+	 MeshComponent FieldMapping>
+Field<T,Mesh,FieldMapping>
+ZonedField<T,Mesh,FieldMapping>::expand(bool on_device) const
+{
+  DataArray<ValueType> zv_da(zone_values_);
+  zv_da.move_to_host();
+  const std::vector<ValueType>& zv = zv_da.host_vector();
+
+  if (is_uniform()) {
+    return Field<ValueType,MeshType,FieldMappingType>(zone_values_.queue_ptr(),
+						      name_, mesh_p_, zv.at(0),
+						      on_device);
+  }
+  
+  DataArray<ZoneIndexType> zi_da(zone_index_);
+  zi_da.move_to_host();
+  const std::vector<ZoneIndexType>& zi = zi_da.host_vector();
+
+  std::vector<ValueType> values(zi.size());
+  for (size_t i = 0; i < zi.size(); ++i) {
+    values[i] = zv.at(zi[i]);
+  }
+  return Field<ValueType,MeshType,FieldMappingType>(zone_values_.queue_ptr(),
+						    name_, mesh_p_, values,
+						    on_device);
+}
+
+template<typename T,
+	 typename Mesh,
+	 MeshComponent FieldMapping,
+	 sycl::access::mode Mode,
+	 sycl::access::target Target>
+ZonedFieldAccessor<T,Mesh,FieldMapping,Mode,Target>::
+ZonedFieldAccessor(const FieldType& f)
+  : mesh_ro_(MeshAccessor(*(f.mesh()))),
+    values_acc_(f.zone_values().template get_placeholder_accessor<Mode,Target>()),
+    index_acc_(f.zone_index().template get_placeholder_accessor<Mode,Target>()),
+    is_uniform_(f.is_uniform())
+{}
+
+template<typename T,
+	 typename Mesh,
+	 MeshComponent FieldMapping,
+	 sycl::access::mode Mode,
+	 sycl::access::target Target>
+ZonedFieldAccessor<T,Mesh,FieldMapping,Mode,Target>::
+ZonedFieldAccessor(const FieldType& f,
+		   sycl::handler& cgh)
+  : mesh_ro_(MeshAccessor(*(f.mesh()))),
+    values_acc_(f.zone_values().template get_placeholder_accessor<Mode,Target>()),
+    index_acc_(f.zone_index().template get_placeholder_accessor<Mode,Target>()),
+    is_uniform_(f.is_uniform())
+{
+  mesh_ro_.bind(cgh);
+  cgh.require(values_acc_);
+  cgh.require(index_acc_);
+}
+
+template<typename T,
+	 typename Mesh,
+	 MeshComponent FieldMapping,
+	 sycl::access::mode Mode,
+	 sycl::access::target Target>
+void
+ZonedFieldAccessor<T,Mesh,FieldMapping,Mode,Target>::bind(sycl::handler& cgh)
+{
+  mesh_ro_.bind(cgh);
+  cgh.require(values_acc_);
+  cgh.require(index_acc_);
+}
@@ -0,0 +1,272 @@
+/***********************************************************************
+ * mfcm Field/ZonedField.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_Field_ZonedField_hpp
+#define mfcm_Field_ZonedField_hpp
+
+#include <limits>
+
+#include "Field.hpp"
+
+template<typename T,
+	 typename Mesh,
+	 MeshComponent FieldMapping,
+	 sycl::access::mode Mode,
+	 sycl::access::target Target = sycl::access::target::global_buffer>
+class ZonedFieldAccessor;
+
+/**
+   Class representing a read-only, piecewise-constant field. The
+   distinct values of the field are stored in a small zone table and
+   each datum stores the (16-bit) index of its zone. If the field has
+   a single zone it is uniform and no per-datum indices are stored at
+   all, so that memory use and bandwidth scale with the number of
+   zones rather than the size of the mesh.
+ */
+template<typename T,
+	 typename Mesh,
+	 MeshComponent FieldMapping>
+class ZonedField
+{
+public:
+
+  /**
+     The type of data returned when the field is read.
+   */
+  using ValueType = T;
+
+  /**
+     The type of the per-datum zone indices.
+   */
+  using ZoneIndexType = uint16_t;
+
+  /**
+     The type of mesh that the data maps to.
+   */
+  using MeshType = Mesh;
+
+  using MeshAccessor = typename Mesh::Accessor;
+
+  /**
+     Enumeration type indicating what type of mesh component each
+     datum is associated with.
+   */
+  static const MeshComponent FieldMappingType = FieldMapping;
+
+  template<sycl::access::mode Mode,
+	   sycl::access::target Target = sycl::access::target::global_buffer>
+  using Accessor = ZonedFieldAccessor<ValueType, MeshType,
+				      FieldMappingType, Mode, Target>;
+
+  /**
+     The maximum number of zones that can be represented.
+   */
+  static constexpr size_t max_zones =
+    size_t(std::numeric_limits<ZoneIndexType>::max()) + 1;
+
+private:
+
+  std::string name_;
+
+  std::shared_ptr<MeshType> mesh_p_;
+
+  DataArray<ValueType> zone_values_;
+
+  DataArray<ZoneIndexType> zone_index_;
+
+public:
+
+  /**
+     Construct a uniform field with the given value.
+   */
+  ZonedField(const std::shared_ptr<sycl::queue>& queue,
+	     const std::string& name,
+	     const std::shared_ptr<MeshType>& mesh_p,
+	     const T& value = T(),
+	     bool on_device = false);
+
+  /**
+     Construct from a zone table and a per-datum zone index.
+   */
+  ZonedField(const std::shared_ptr<sycl::queue>& queue,
+	     const std::string& name,
+	     const std::shared_ptr<MeshType>& mesh_p,
+	     const std::vector<T>& zone_values,
+	     const std::vector<ZoneIndexType>& zone_index,
+	     bool on_device = false);
+
+  /**
+     Construct from the distinct values of a full-precision field. The
+     zoned field is placed on the device if f is on the device. Throws
+     if f has more than max_zones distinct values.
+   */
+  explicit ZonedField(const Field<ValueType,MeshType,FieldMappingType>& f);
+
+  const std::string& name(void) const
+  {
+    return name_;
+  }
+
+  /**
+     Return the number of mesh objects the field maps to.
+   */
+  size_t size(void) const
+  {
+    return mesh_p_->template object_count<FieldMappingType>();
+  }
+
+  /**
+     Return the number of zones.
+   */
+  size_t zone_count(void) const
+  {
+    return zone_values_.size();
+  }
+
+  /**
+     Return true if the field has a single value everywhere.
+   */
+  bool is_uniform(void) const
+  {
+    return zone_count() == 1;
+  }
+
+  bool is_on_device(void) const
+  {
+    return zone_values_.is_on_device();
+  }
+
+  const std::shared_ptr<sycl::queue>& queue_ptr(void) const
+  {
+    return zone_values_.queue_ptr();
+  }
+
+  const std::shared_ptr<MeshType>& mesh(void) const
+  {
+    return mesh_p_;
+  }
+
+  void move_to_device(void)
+  {
+    mesh_p_->move_to_device();
+    zone_values_.move_to_device();
+    zone_index_.move_to_device();
+  }
+
+  void move_to_host(void)
+  {
+    mesh_p_->move_to_host();
+    zone_values_.move_to_host();
+    zone_index_.move_to_host();
+  }
+
+  const DataArray<ValueType>& zone_values(void) const
+  {
+    return zone_values_;
+  }
+
+  const DataArray<ZoneIndexType>& zone_index(void) const
+  {
+    return zone_index_;
+  }
+
+  /**
+     Return a full field containing the value of each datum.
+   */
+  Field<T,Mesh,FieldMapping> expand(bool on_device = false) const;
+
+};
+
+template<typename T,
+	 typename Mesh,
+	 MeshComponent FieldMapping,
+	 sycl::access::mode Mode,
+	 sycl::access::target Target>
+class ZonedFieldAccessor
+{
+public:
+
+  static_assert(Mode == sycl::access::mode::read,
+		"Zoned fields may only be accessed for reading.");
+
+  using ValueType = T;
+
+  using MeshType = Mesh;
+
+  static const MeshComponent FieldMappingType = FieldMapping;
+
+  using MeshAccessor = typename MeshType::Accessor;
+
+  using FieldType = ZonedField<T,Mesh,FieldMapping>;
+
+  using ZoneIndexType = typename FieldType::ZoneIndexType;
+
+  using ValueAccessor = typename DataArray<T>::
+    template Accessor<Mode, Target, sycl::access::placeholder::true_t>;
+
+  using IndexAccessor = typename DataArray<ZoneIndexType>::
+    template Accessor<Mode, Target, sycl::access::placeholder::true_t>;
+
+private:
+
+  MeshAccessor mesh_ro_;
+
+  ValueAccessor values_acc_;
+
+  IndexAccessor index_acc_;
+
+  bool is_uniform_;
+
+public:
+
+  ZonedFieldAccessor(const FieldType& f);
+
+  ZonedFieldAccessor(const FieldType& f,
+		     sycl::handler& cgh);
+
+  void bind(sycl::handler& cgh);
+
+  const MeshAccessor& mesh(void) const
+  {
+    return mesh_ro_;
+  }
+
+  /**
+     Return a reference to this accessor, so that zoned fields can be
+     read with the same data()[i] syntax as a FieldAccessor.
+   */
+  const ZonedFieldAccessor<T,Mesh,FieldMapping,Mode,Target>&
+  data(void) const
+  {
+    return *this;
+  }
+
+  /**
+     Return the value of the i-th datum.
+   */
+  ValueType operator[](const size_t& i) const
+  {
+    if (is_uniform_) {
+      return values_acc_[0];
+    }
+    return values_acc_[index_acc_[i]];
+  }
+
+};
+
+#endif
@@ -0,0 +1,23 @@
+/***********************************************************************
+ * mfcm Field/ZonedField_impl_mesh.cpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+template class ZonedField<float,MeshType,MeshComponent::Cell>;
+template class ZonedField<double,MeshType,MeshComponent::Cell>;
+
+template class ZonedFieldAccessor<float,MeshType,MeshComponent::Cell,sycl::access::mode::read>;
+template class ZonedFieldAccessor<double,MeshType,MeshComponent::Cell,sycl::access::mode::read>;
@@ -142,7 +142,7 @@ template<typename T,
 FieldGenerator<T,Mesh,FieldMapping>::
 FieldGenerator(const std::shared_ptr<sycl::queue>& queue,
 	       const std::string& name,
-	       std::shared_ptr<Mesh>& mesh_p,
+	       const std::shared_ptr<Mesh>& mesh_p,
 	       const T& init_value,
 	       bool on_device)
   : field_(std::make_shared<Field<T,Mesh,FieldMapping>>(queue, name, mesh_p,
@@ -56,7 +56,7 @@ public:
 
   FieldGenerator(const std::shared_ptr<sycl::queue>& queue,
 		 const std::string& name,
-		 std::shared_ptr<Mesh>& mesh_p,
+		 const std::shared_ptr<Mesh>& mesh_p,
 		 const T& init_value,
 		 bool on_device = true);
 
@@ -22,6 +22,11 @@
 
 #include "FieldGenerator.cpp"
 #include "Cartesian2DMesh.hpp"
+#include "QuadtreeMesh.hpp"
+#include "RectilinearMesh.hpp"
+#include "SparseCartesian2DMesh.hpp"
+#include "UnstructuredMesh.hpp"
+#include "MultiCartesian2DMesh.hpp"
 
 template class FieldGenerator<float,Cartesian2DMesh,MeshComponent::Cell>;
 
@@ -31,3 +36,50 @@ template class FieldGenerator<int32_t,Cartesian2DMesh,MeshComponent::Cell>;
 
 template class FieldGenerator<uint32_t,Cartesian2DMesh,MeshComponent::Cell>;
 
+template class FieldGenerator<float,TiledCartesian2DMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<double,TiledCartesian2DMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<int32_t,TiledCartesian2DMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<uint32_t,TiledCartesian2DMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<float,QuadtreeMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<double,QuadtreeMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<int32_t,QuadtreeMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<uint32_t,QuadtreeMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<float,RectilinearMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<double,RectilinearMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<int32_t,RectilinearMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<uint32_t,RectilinearMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<float,SparseCartesian2DMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<double,SparseCartesian2DMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<int32_t,SparseCartesian2DMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<uint32_t,SparseCartesian2DMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<float,UnstructuredMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<double,UnstructuredMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<int32_t,UnstructuredMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<uint32_t,UnstructuredMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<float,MultiCartesian2DMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<double,MultiCartesian2DMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<int32_t,MultiCartesian2DMesh,MeshComponent::Cell>;
+
+template class FieldGenerator<uint32_t,MultiCartesian2DMesh,MeshComponent::Cell>;
@@ -345,9 +345,30 @@ template<typename TT,
 TimeSeriesDatabase<TT,T>&
 TimeSeriesDatabase<TT,T>::instance(void)
 {
+  size_t config_id = GlobalConfig::instance().id();
   if (not tsdb_) {
     tsdb_ = new TimeSeriesDatabase<TimeType,ValueType>();
   }
+  if (tsdb_->configs_.count(config_id) == 0) {
+    // Forget the configurations no longer in use, and keep their time
+    // series for the configurations that follow them only
+    bool released = false;
+    for (auto it = tsdb_->configs_.begin(); it != tsdb_->configs_.end(); ) {
+      if (it->second.expired()) {
+	tsdb_->db_.erase(it->first);
+	it = tsdb_->configs_.erase(it);
+	released = true;
+      } else {
+	++it;
+      }
+    }
+    if (released) {
+      tsdb_->previous_cache_ = std::move(tsdb_->cache_);
+      tsdb_->cache_.clear();
+    }
+    tsdb_->configs_[config_id] = GlobalConfig::current();
+  }
+  tsdb_->config_id_ = config_id;
   return *tsdb_;
 }
 
@@ -359,18 +380,27 @@ get_time_series_ptr(const std::shared_ptr<sycl::queue>& queue,
 		    const TimeParser<TimeType>& parser,
 		    const std::string& name)
 {
-  if (db_.count(name) == 0) {
+  TimeSeriesMap& db = db_[config_id_];
+  if (db.count(name) == 0) {
     const GlobalConfig& gc = GlobalConfig::instance();
     const Config& conf = gc.time_series_configuration(name);
-    db_[name] = TimeSeries<TimeType,ValueType>::load(queue, parser, conf);
-
-    db_[name]->sanity_checks();
+    std::string key = gc.input_key(conf) + parser.key();
+    if (cache_.count(key) > 0) {
+      db[name] = cache_[key];
+    } else if (previous_cache_.count(key) > 0) {
+      std::cout << "Reusing time series " << name << std::endl;
+      db[name] = cache_[key] = previous_cache_[key];
+    } else {
+      db[name] = cache_[key] = TimeSeries<TimeType,ValueType>::load(queue, parser, conf);
+
+      db[name]->sanity_checks();
     
-    std::cout << "Loaded time series " << name << std::endl;
+      std::cout << "Loaded time series " << name << std::endl;
+    }
     TimeSeriesCheckFile<TimeSeries<TimeType,ValueType>> cf("time series");
     cf.output(name);
   }
-  return db_[name];
+  return db[name];
 }
 
 template<typename TT,
@@ -379,8 +409,9 @@ const std::shared_ptr<TimeSeries<TT,T>>&
 TimeSeriesDatabase<TT,T>::
 get_time_series_ptr(const std::string& name)
 {
-  if (db_.count(name) == 0) {
+  TimeSeriesMap& db = db_[config_id_];
+  if (db.count(name) == 0) {
     throw std::logic_error("No queue available in time series database.");
   }
-  return db_[name];
+  return db[name];
 }
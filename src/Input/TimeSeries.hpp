@@ -277,10 +277,27 @@ public:
   
 private:
 
-  std::map<std::string, std::shared_ptr<TimeSeries<TimeType,ValueType>>> db_;
+  using TimeSeriesMap = std::map<std::string, std::shared_ptr<TimeSeries<TimeType,ValueType>>>;
+
+  // The time series of each configuration in use (see
+  // GlobalConfig::id) by name, since a batch run makes the
+  // configurations of the models it packs the instance in turn (see
+  // GlobalConfig::activate)
+  std::map<size_t, TimeSeriesMap> db_;
+  std::map<size_t, std::weak_ptr<GlobalConfig>> configs_;
+  size_t config_id_;
+
+  // The time series of the current and previous configurations by
+  // input key (see GlobalConfig::input_key), so that a resident
+  // process can reuse them for its next job
+  TimeSeriesMap cache_;
+  TimeSeriesMap previous_cache_;
 
 protected:
 
+  // Never deleted: the time series it holds own SYCL buffers, which
+  // must not be destroyed during static destruction, after the SYCL
+  // runtime may have gone
   static TimeSeriesDatabase<TimeType,ValueType>* tsdb_;
   
   TimeSeriesDatabase(void) {}
@@ -0,0 +1,274 @@
+/***********************************************************************
+ * mfcm LaunchTuner.cpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#include <algorithm>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <map>
+
+#include <boost/interprocess/sync/file_lock.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+#include "LaunchTuner.hpp"
+#include "mpi.hpp"
+
+namespace {
+
+  const char* kernel_kind_name(const KernelKind& kind)
+  {
+    switch (kind) {
+    case KernelKind::Flux:
+      return "flux";
+    case KernelKind::Derivative:
+      return "derivative";
+    case KernelKind::TemporalDerivative:
+      return "temporal derivative";
+    default:
+      return "reduction";
+    }
+  }
+
+  /**
+     Read the cache file into a map from key to configuration. Each
+     line holds the tab-separated device name, engine, mesh size,
+     kernel variant and kernel kind, which form the key, then the
+     block size and work-group size. Lines in any other form, such as
+     those of older versions, are skipped.
+   */
+  std::map<std::string,LaunchConfiguration> read_cache(const stdfs::path& path)
+  {
+    std::map<std::string,LaunchConfiguration> cache;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+      std::vector<std::string> fields = split_string<std::string>(line, "\t");
+      if (fields.size() != 7) {
+	continue;
+      }
+      LaunchConfiguration lc;
+      try {
+	lc.block_size = boost::lexical_cast<size_t>(fields.at(5));
+	lc.work_group_size = boost::lexical_cast<size_t>(fields.at(6));
+      } catch (const boost::bad_lexical_cast&) {
+	continue;
+      }
+      fields.resize(5);
+      cache[boost::algorithm::join(fields, "\t")] = lc;
+    }
+    return cache;
+  }
+
+  /**
+     Add an entry to the cache file, keeping those saved by other
+     processes since it was read. The lock file stops processes
+     sharing the cache from writing it at the same time.
+   */
+  void write_cache_entry(const stdfs::path& path,
+			 const std::string& key,
+			 const LaunchConfiguration& lc)
+  {
+    stdfs::path lock_path = path;
+    lock_path += ".lock";
+    try {
+      std::ofstream(lock_path, std::ios::app);
+      boost::interprocess::file_lock lock(lock_path.c_str());
+      boost::interprocess::scoped_lock<boost::interprocess::file_lock> guard(lock);
+
+      auto cache = read_cache(path);
+      cache[key] = lc;
+      std::ofstream out(path);
+      if (not out) {
+	std::cout << "WARNING: Cannot write launch cache " << path
+		  << std::endl;
+	return;
+      }
+      for (auto&& [ k, v ] : cache) {
+	out << k << "\t" << v.block_size << "\t" << v.work_group_size << std::endl;
+      }
+    } catch (const boost::interprocess::interprocess_exception& e) {
+      std::cout << "WARNING: Cannot lock launch cache " << path << ": "
+		<< e.what() << std::endl;
+    }
+  }
+
+  /**
+     The configurations tuned by this process, or read from the cache
+     file, by key.
+   */
+  std::map<std::string,LaunchConfiguration>& known_configurations(void)
+  {
+    static std::map<std::string,LaunchConfiguration> known;
+    return known;
+  }
+
+}
+
+LaunchTuner::LaunchTuner(const std::shared_ptr<sycl::queue>& queue,
+			 const size_t& size,
+			 const std::string& variant,
+			 const size_t& tile)
+  : queue_(queue),
+    device_name_(queue->get_device().get_info<sycl::info::device::name>()),
+    size_(size),
+    variant_(variant),
+    tile_(tile)
+{
+  const Config& device_conf = GlobalConfig::instance().device_configuration();
+  // The default block size of the blocked engine is part of what the
+  // cached configurations were chosen against
+  default_ = default_launch_configuration();
+  engine_ = device_conf.get<std::string>("engine", "sycl");
+  if (default_.block_size > 1) {
+    engine_ += " " + std::to_string(default_.block_size);
+  }
+  enabled_ = device_conf.get<bool>("launch tuning", true);
+  retune_ = device_conf.get<bool>("retune launch", false);
+  repetitions_ = std::max(device_conf.get<size_t>("launch tuning repetitions", 5),
+			  size_t(1));
+  cache_path_ = device_conf.get<stdfs::path>("launch cache",
+					     "mfcm_launch_cache.txt");
+  if (not cache_path_.is_absolute()) {
+    cache_path_ = GlobalConfig::instance().simulation_base_path() / cache_path_;
+  }
+}
+
+std::string LaunchTuner::key(const KernelKind& kind) const
+{
+  // Tabs separate the fields of the cache file, which are trimmed
+  // when it is read
+  std::string device_name = boost::algorithm::trim_copy(device_name_);
+  std::replace(device_name.begin(), device_name.end(), '\t', ' ');
+  // The tiles change which configurations are tried
+  std::string variant = variant_;
+  if (tile_ > 0) {
+    variant += ", tiles of " + std::to_string(tile_);
+  }
+  return device_name + "\t" + engine_ + "\t" + std::to_string(size_)
+    + "\t" + variant + "\t" + kernel_kind_name(kind);
+}
+
+std::vector<LaunchConfiguration>
+LaunchTuner::candidates(const KernelKind& kind) const
+{
+  // Reductions have no blocks of objects
+  LaunchConfiguration first =
+    (kind == KernelKind::Reduction) ? LaunchConfiguration() : default_;
+  std::vector<LaunchConfiguration> candidates = { first };
+  if (first.block_size > 1) {
+    // The blocked engine runs one work item per block of objects, and
+    // the block size matters more than how the runtime groups them
+    std::vector<size_t> block_sizes = { 64, 128, 256, 512, 1024, 2048 };
+    // Blocks of whole tiles of the mesh
+    if (tile_ > 0) {
+      for (size_t tiles : { 1, 2, 4, 8 }) {
+	block_sizes.push_back(tiles * tile_);
+      }
+    }
+    std::sort(block_sizes.begin(), block_sizes.end());
+    block_sizes.erase(std::unique(block_sizes.begin(), block_sizes.end()),
+		      block_sizes.end());
+    for (size_t block_size : block_sizes) {
+      if (block_size != default_.block_size) {
+	candidates.push_back({ block_size, 0 });
+      }
+    }
+  } else {
+    std::vector<size_t> work_group_sizes = { 32, 64, 128, 256, 512, 1024 };
+    // Work groups of whole tiles of the mesh
+    if (tile_ > 0 and kind != KernelKind::Reduction) {
+      for (size_t tiles : { 1, 2, 4 }) {
+	work_group_sizes.push_back(tiles * tile_);
+      }
+    }
+    std::sort(work_group_sizes.begin(), work_group_sizes.end());
+    work_group_sizes.erase(std::unique(work_group_sizes.begin(),
+				       work_group_sizes.end()),
+			   work_group_sizes.end());
+    size_t max_size =
+      queue_->get_device().get_info<sycl::info::device::max_work_group_size>();
+    for (size_t work_group_size : work_group_sizes) {
+      if (work_group_size <= max_size) {
+	candidates.push_back({ 0, work_group_size });
+      }
+    }
+  }
+  return candidates;
+}
+
+void LaunchTuner::tune(const KernelKind& kind,
+		       LaunchConfiguration& lc,
+		       const std::function<void(void)>& run)
+{
+  if (not enabled_) {
+    return;
+  }
+
+  std::string entry_key = key(kind);
+  auto& known = known_configurations();
+  auto it = known.find(entry_key);
+  if (it != known.end()) {
+    lc = it->second;
+    return;
+  }
+  if (not retune_) {
+    auto cache = read_cache(cache_path_);
+    auto cache_it = cache.find(entry_key);
+    if (cache_it != cache.end()) {
+      lc = cache_it->second;
+    }
+    known[entry_key] = lc;
+    return;
+  }
+
+  std::cout << "Tuning launch configuration of " << kernel_kind_name(kind)
+	    << " kernels (" << variant_ << ") for " << size_ << " cells on "
+	    << device_name_ << " with the " << engine_ << " engine"
+	    << std::endl;
+
+  LaunchConfiguration best;
+  double best_time = std::numeric_limits<double>::max();
+  for (auto&& candidate : candidates(kind)) {
+    lc = candidate;
+    // The first run includes any compilation of the kernel
+    run();
+    queue_->wait_and_throw();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repetitions_; ++i) {
+      run();
+    }
+    queue_->wait_and_throw();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "  block size " << candidate.block_size
+	      << ", work-group size " << candidate.work_group_size
+	      << ": " << elapsed.count() / repetitions_ << " s" << std::endl;
+    if (elapsed.count() < best_time) {
+      best_time = elapsed.count();
+      best = candidate;
+    }
+  }
+  lc = best;
+  known[entry_key] = best;
+
+  // The other ranks run the same kernels on their own part of the
+  // mesh
+  if (mpi_rank() == 0) {
+    write_cache_entry(cache_path_, entry_key, best);
+  }
+}
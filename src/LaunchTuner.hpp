@@ -0,0 +1,109 @@
+/***********************************************************************
+ * mfcm LaunchTuner.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_LaunchTuner_hpp
+#define mfcm_LaunchTuner_hpp
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "launch.hpp"
+#include "Config.hpp"
+
+/**
+   Tunes the launch configuration of each kind of kernel (see
+   launch_kernel) for a device and a mesh size, by timing the kernels
+   with each candidate configuration, and keeps the best in a cache
+   file so that later runs can load it. Entries of the cache are kept
+   for each device, engine (see default_launch_configuration), mesh
+   size, kernel variant and kind of kernel.
+
+   Kernels are only timed if "retune launch", which the
+   --retune-launch flag sets, is true. Otherwise configurations are
+   read from the cache, and kinds of kernel it has no entry for keep
+   their default. A process tunes each entry at most once, and only
+   MPI rank 0 writes the cache, holding a lock on the file with the
+   name of the cache followed by ".lock".
+
+   The device configuration key "launch tuning" (default true) turns
+   tuning and the cache off, and "launch cache" names the cache file
+   (default "mfcm_launch_cache.txt", relative to the simulation base
+   path).
+ */
+class LaunchTuner
+{
+private:
+
+  std::shared_ptr<sycl::queue> queue_;
+  std::string device_name_;
+  std::string engine_;
+  LaunchConfiguration default_;
+  size_t size_;
+  std::string variant_;
+  size_t tile_;
+  stdfs::path cache_path_;
+  bool enabled_;
+  bool retune_;
+  size_t repetitions_;
+
+  /**
+     Candidate launch configurations of a kind of kernel on the
+     device. Reductions have no blocks of objects, so only their
+     work-group size is tuned. On a tiled mesh, blocks or work groups
+     of whole tiles are also tried.
+   */
+  std::vector<LaunchConfiguration> candidates(const KernelKind& kind) const;
+
+  /**
+     Key of an entry in the cache file.
+   */
+  std::string key(const KernelKind& kind) const;
+
+public:
+
+  /**
+     Constructor.
+
+     @param queue The queue on which the kernels run.
+     @param size Number of cells of the mesh.
+     @param variant The variant of the kernels, such as the slope
+     mode of a solver, which changes their cost.
+     @param tile Number of cells in a tile of the mesh ordering (see
+     TiledOrdering), or zero if the cells are not tiled.
+   */
+  LaunchTuner(const std::shared_ptr<sycl::queue>& queue,
+	      const size_t& size,
+	      const std::string& variant,
+	      const size_t& tile = 0);
+
+  /**
+     Set lc, the launch configuration of a kind of kernel, to the one
+     tuned by this process for this device, engine, mesh size and
+     variant or, unless retuning, to the one in the cache file. When
+     retuning, time run, which must submit the kernels to the queue
+     with lc, with each candidate configuration and save the fastest
+     to the cache. Otherwise lc keeps its value if the cache has no
+     entry.
+   */
+  void tune(const KernelKind& kind,
+	    LaunchConfiguration& lc,
+	    const std::function<void(void)>& run);
+};
+
+#endif
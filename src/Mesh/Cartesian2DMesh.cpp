@@ -21,17 +21,35 @@
 #include "Config.hpp"
 #include <cmath>
 
-Cartesian2DMesh::
-Cartesian2DMesh(const std::shared_ptr<sycl::queue>& queue,
-		bool on_device)
-  : ncells_(queue, 2),
+template<typename Ordering>
+OrderedCartesian2DMesh<Ordering>::
+OrderedCartesian2DMesh(const std::shared_ptr<sycl::queue>& queue,
+		       bool on_device)
+  : ncells_(queue, 3),
     geotrans_(queue, 12)
 {
   const Config& conf = GlobalConfig::instance().mesh_configuration();
   
   std::array<size_t,2> user_ncells =
     split_string<size_t,2>(conf.get<std::string>("cell count"));
-  ncells_.host_vector() = { user_ncells[0], user_ncells[1] };
+
+  std::string ordering = conf.get<std::string>("ordering", "row major");
+  if (ordering != Ordering::name) {
+    std::cerr << "ERROR: Mesh ordering " << ordering
+	      << " cannot be used here (expected " << Ordering::name << ")."
+	      << std::endl;
+    throw std::runtime_error("Unsupported mesh ordering.");
+  }
+  size_t tile = Ordering::default_tile_size;
+  if constexpr (Ordering::default_tile_size > 0) {
+    tile = conf.get<size_t>("tile size", Ordering::default_tile_size);
+    if (tile == 0) {
+      std::cerr << "ERROR: Mesh tile size must be greater than zero."
+		<< std::endl;
+      throw std::runtime_error("Invalid mesh tile size.");
+    }
+  }
+  ncells_.host_vector() = { user_ncells[0], user_ncells[1], tile };
   
   std::array<double,2> user_origin =
     split_string<double,2>(conf.get<std::string>("origin", "0.0, 0.0"));
@@ -60,17 +78,19 @@ Cartesian2DMesh(const std::shared_ptr<sycl::queue>& queue,
   }
 }
 
-Cartesian2DMesh::
-Cartesian2DMesh(const std::shared_ptr<sycl::queue>& queue,
-		const std::array<size_t,2>& ncells,
-		const std::array<double,6>& geo_transform,
-		bool on_device)
-  : ncells_(queue, 2),
+template<typename Ordering>
+OrderedCartesian2DMesh<Ordering>::
+OrderedCartesian2DMesh(const std::shared_ptr<sycl::queue>& queue,
+		       const std::array<size_t,2>& ncells,
+		       const std::array<double,6>& geo_transform,
+		       bool on_device)
+  : ncells_(queue, 3),
     geotrans_(queue, 12)
 {
-  std::vector<size_t> nc = ncells_.host_vector();
+  std::vector<size_t>& nc = ncells_.host_vector();
   nc.at(0) = ncells.at(0);
   nc.at(1) = ncells.at(1);
+  nc.at(2) = Ordering::default_tile_size;
 
   std::vector<double>& gtvec = geotrans_.host_vector();
   gtvec[0] = geo_transform.at(0);
@@ -92,25 +112,53 @@ Cartesian2DMesh(const std::shared_ptr<sycl::queue>& queue,
   }
 }
 
-void Cartesian2DMesh::move_to_device(void)
+template<typename Ordering>
+std::shared_ptr<OrderedCartesian2DMesh<Ordering>>
+OrderedCartesian2DMesh<Ordering>::row_block(const std::shared_ptr<sycl::queue>& queue,
+					    const size_t& y0,
+					    const size_t& nrows) const
+{
+  if (y0 + nrows > nycells()) {
+    std::cerr << "ERROR: Rows " << y0 << " to " << y0 + nrows - 1
+	      << " are outside the mesh." << std::endl;
+    throw std::runtime_error("Mesh row block outside mesh.");
+  }
+  // Shift the origin along the y axis of the grid
+  return std::make_shared<OrderedCartesian2DMesh>(queue,
+						  std::array<size_t,2>{ nxcells(), nrows },
+						  std::array<double,6>{
+						    origin_x() + y0 * row_rotation(),
+						    cell_width(),
+						    row_rotation(),
+						    origin_y() + y0 * cell_height(),
+						    col_rotation(),
+						    cell_height() },
+						  ncells_.is_on_device());
+}
+
+template<typename Ordering>
+void OrderedCartesian2DMesh<Ordering>::move_to_device(void)
 {
   ncells_.move_to_device();
   geotrans_.move_to_device();
 }
 
-void Cartesian2DMesh::move_to_host(void)
+template<typename Ordering>
+void OrderedCartesian2DMesh<Ordering>::move_to_host(void)
 {
   ncells_.move_to_host();
   geotrans_.move_to_host();
 }
 
-Cartesian2DMeshAccessor::
-Cartesian2DMeshAccessor(const Cartesian2DMesh& c2m)
+template<typename Ordering>
+OrderedCartesian2DMeshAccessor<Ordering>::
+OrderedCartesian2DMeshAccessor(const OrderedCartesian2DMesh<Ordering>& c2m)
   : ncells_ro_(c2m.ncells_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
     geotrans_ro_(c2m.geotrans_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>())
 {}
 
-void Cartesian2DMeshAccessor::bind(sycl::handler& cgh)
+template<typename Ordering>
+void OrderedCartesian2DMeshAccessor<Ordering>::bind(sycl::handler& cgh)
 {
   cgh.require(ncells_ro_);
   cgh.require(geotrans_ro_);
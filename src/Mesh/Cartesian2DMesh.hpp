@@ -23,13 +23,104 @@
 #include "DataArray.hpp"
 #include "../Geometry/Geometry.hpp"
 
-class Cartesian2DMeshAccessor;
+template<typename Ordering>
+class OrderedCartesian2DMeshAccessor;
+
+/**
+   Row-major numbering of the objects of an nx by ny grid. The tile
+   size is ignored.
+ */
+struct RowMajorOrdering
+{
+  static constexpr const char* name = "row major";
+
+  static constexpr size_t default_tile_size = 0;
+
+  static inline size_t index(const size_t& x, const size_t& y,
+			     const size_t& nx, const size_t& ny,
+			     const size_t& tile)
+  {
+    return y * nx + x;
+  }
 
-class Cartesian2DMesh
+  static inline std::array<size_t,2> coordinate(const size_t& i,
+						const size_t& nx,
+						const size_t& ny,
+						const size_t& tile)
+  {
+    return { i % nx, i / nx };
+  }
+};
+
+/**
+   Tiled numbering of the objects of an nx by ny grid. The grid is
+   divided into square tiles of tile by tile objects (smaller at the
+   right and top edges), the tiles are numbered in row-major order and
+   the objects within each tile are numbered in row-major order.
+   Neighbours in both directions are then usually within the same
+   tile, which improves cache reuse on wide grids.
+ */
+struct TiledOrdering
+{
+  static constexpr const char* name = "tiled";
+
+  static constexpr size_t default_tile_size = 16;
+
+  static inline size_t index(const size_t& x, const size_t& y,
+			     const size_t& nx, const size_t& ny,
+			     const size_t& tile)
+  {
+    size_t tx = x / tile;
+    size_t ty = y / tile;
+    // Number of rows in this row of tiles and columns in this tile
+    size_t ry = (ny - ty * tile < tile) ? ny - ty * tile : tile;
+    size_t rx = (nx - tx * tile < tile) ? nx - tx * tile : tile;
+    return ty * tile * nx + tx * tile * ry + (y - ty * tile) * rx + (x - tx * tile);
+  }
+
+  static inline std::array<size_t,2> coordinate(const size_t& i,
+						const size_t& nx,
+						const size_t& ny,
+						const size_t& tile)
+  {
+    size_t ty = i / (tile * nx);
+    size_t r = i - ty * tile * nx;
+    size_t ry = (ny - ty * tile < tile) ? ny - ty * tile : tile;
+    size_t tx = r / (tile * ry);
+    r -= tx * tile * ry;
+    size_t rx = (nx - tx * tile < tile) ? nx - tx * tile : tile;
+    return { tx * tile + r % rx, ty * tile + r / rx };
+  }
+};
+
+/**
+   A Cartesian grid whose cells, faces and vertices are numbered by
+   the Ordering policy (RowMajorOrdering or TiledOrdering). The
+   ordering is fixed at compile time, so that row-major meshes do no
+   tiling arithmetic.
+ */
+template<typename Ordering>
+class OrderedCartesian2DMesh
 {
 public:
 
-  using Accessor = Cartesian2DMeshAccessor;
+  using Accessor = OrderedCartesian2DMeshAccessor<Ordering>;
+
+  /**
+     Every cell side is a single face.
+   */
+  static constexpr bool has_hanging_faces = false;
+
+  /**
+     Faces are aligned with the x and y axes.
+   */
+  static constexpr bool has_face_normals = false;
+
+  /**
+     Kernels take the time and timestep from their arguments (see
+     MultiCartesian2DMesh).
+   */
+  static constexpr bool has_block_clocks = false;
   
 private:
 
@@ -45,6 +136,10 @@ private:
   {
     return ncells_.host_vector().at(1);
   }
+  inline const size_t& tile_size(void) const
+  {
+    return ncells_.host_vector().at(2);
+  }
 
   inline const double& origin_x(void) const { return geotrans_.host_vector()[0]; }
   inline const double& cell_width(void) const { return geotrans_.host_vector()[1]; }
@@ -56,18 +151,71 @@ private:
   inline const double& inv_cell_height(void) const { return geotrans_.host_vector()[7]; }
   inline const double& inv_cell_size(void) const { return geotrans_.host_vector()[8]; }
   inline const double& inv_denom(void) const { return geotrans_.host_vector()[9]; }
+
+  inline size_t cell_index(const size_t& x, const size_t& y) const
+  {
+    return Ordering::index(x, y, nxcells(), nycells(), tile_size());
+  }
+  inline std::array<size_t,2> cell_coordinate(const size_t& i) const
+  {
+    return Ordering::coordinate(i, nxcells(), nycells(), tile_size());
+  }
+  inline size_t vface_index(const size_t& x, const size_t& y) const
+  {
+    return Ordering::index(x, y, nxcells() + 1, nycells(), tile_size());
+  }
+  inline std::array<size_t,2> vface_coordinate(const size_t& i) const
+  {
+    return Ordering::coordinate(i, nxcells() + 1, nycells(), tile_size());
+  }
+  inline size_t hface_index(const size_t& x, const size_t& y) const
+  {
+    return (nxcells() + 1) * nycells() +
+      Ordering::index(x, y, nxcells(), nycells() + 1, tile_size());
+  }
+  inline std::array<size_t,2> hface_coordinate(const size_t& i) const
+  {
+    return Ordering::coordinate(i - (nxcells() + 1) * nycells(),
+					   nxcells(), nycells() + 1, tile_size());
+  }
+  inline size_t vertex_index(const size_t& x, const size_t& y) const
+  {
+    return Ordering::index(x, y, nxcells() + 1, nycells() + 1, tile_size());
+  }
+  inline std::array<size_t,2> vertex_coordinate(const size_t& i) const
+  {
+    return Ordering::coordinate(i, nxcells() + 1, nycells() + 1, tile_size());
+  }
   
 public:
 
-  Cartesian2DMesh(const std::shared_ptr<sycl::queue>& queue,
+  /**
+     Construct from the mesh configuration. The "ordering" key must
+     name the Ordering of this mesh ("row major" by default). Tiled
+     meshes are numbered in tiles of "tile size" (default 16) objects
+     square.
+   */
+  OrderedCartesian2DMesh(const std::shared_ptr<sycl::queue>& queue,
 		  bool on_device = true);
 
-  Cartesian2DMesh(const std::shared_ptr<sycl::queue>& queue,
+  /**
+     Construct a mesh from a cell count and a GDAL-style
+     geotransform. Tiled meshes use the default tile size.
+   */
+  OrderedCartesian2DMesh(const std::shared_ptr<sycl::queue>& queue,
 		  const std::array<size_t,2>& ncells,
 		  const std::array<double,6>& geo_transform,
 		  bool on_device = true);
 
-  ~Cartesian2DMesh(void)
+  /**
+     Create a mesh covering the nrows rows of this mesh starting at
+     row y0, for instance one subdomain of a domain decomposition.
+   */
+  std::shared_ptr<OrderedCartesian2DMesh> row_block(const std::shared_ptr<sycl::queue>& queue,
+					     const size_t& y0,
+					     const size_t& nrows) const;
+
+  ~OrderedCartesian2DMesh(void)
   {
     std::cout << "Freeing memory for mesh." << std::endl;
   }
@@ -108,6 +256,23 @@ public:
     return (nxcells() + 1) * (nycells() + 1);
   }
 
+  /**
+     Return the number of cells along the x and y axes.
+   */
+  inline std::array<size_t,2> cell_dimensions(void) const
+  {
+    return { nxcells(), nycells() };
+  }
+
+  /**
+     Return the number of cells in a whole tile of the ordering, or
+     zero if the cells are not numbered in tiles.
+   */
+  inline size_t tile_cell_count(void) const
+  {
+    return tile_size() * tile_size();
+  }
+
   /**
      Return the physical location corresponding to a sub-cell
      coordinate in the mesh.
@@ -140,8 +305,9 @@ public:
   inline std::array<double,2>
   get_object_location<MeshComponent::Cell>(const size_t& i) const
   {
-    double xi = (double)(i % nxcells()) + 0.5;
-    double yi = (double)(i / nxcells()) + 0.5;
+    std::array<size_t,2> c = cell_coordinate(i);
+    double xi = (double)c[0] + 0.5;
+    double yi = (double)c[1] + 0.5;
     return get_location({xi, yi});
   }
 
@@ -151,14 +317,15 @@ public:
   {
     if (i < (nxcells() + 1) * nycells()) {
       // Face is vertical and has cells to left and right
-      double xi = (double)(i % (nxcells() + 1));
-      double yi = (double)(i / (nxcells() + 1)) + 0.5;
+      std::array<size_t,2> c = vface_coordinate(i);
+      double xi = (double)c[0];
+      double yi = (double)c[1] + 0.5;
       return get_location({xi, yi});
     } else {
       // Face is horizontal
-      size_t i2 = i - ((nxcells() + 1) * nycells());
-      double xi = (double)(i2 % nxcells()) + 0.5;
-      double yi = (double)(i2 / nxcells());
+      std::array<size_t,2> c = hface_coordinate(i);
+      double xi = (double)c[0] + 0.5;
+      double yi = (double)c[1];
       return get_location({xi, yi});
     }
   }
@@ -167,9 +334,8 @@ public:
   inline std::array<double,2>
   get_object_location<MeshComponent::Vertex>(const size_t& i) const
   {
-    double xi = (double)(i % (nxcells() + 1));
-    double yi = (double)(i / (nxcells() + 1));    
-    return get_location({xi, yi});
+    std::array<size_t,2> c = vertex_coordinate(i);
+    return get_location({(double)c[0], (double)c[1]});
   }
 
   template<MeshComponent C>
@@ -181,15 +347,135 @@ public:
     std::array<double,2> coord = get_coordinate(loc);
     if (coord[0] >= 0.0 and coord[0] < nxcells() and
 	coord[1] >= 0.0 and coord[1] < nycells()) {
-      return ((size_t)coord[1]) * nxcells() + (size_t)coord[0];
+      return cell_index((size_t)coord[0], (size_t)coord[1]);
     } else {
       return nxcells() * nycells();
     }
   }
 
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Face>(const std::array<double,2>& loc) const
+  {
+    std::array<double,2> coord = get_coordinate(loc);
+    if (not (coord[0] >= 0.0 and coord[0] < nxcells() and
+	     coord[1] >= 0.0 and coord[1] < nycells())) {
+      return object_count<MeshComponent::Face>();
+    }
+    // The nearest face is the side of the containing cell nearest to
+    // loc
+    size_t cx = (size_t)coord[0];
+    size_t cy = (size_t)coord[1];
+    double rx = coord[0] - cx;
+    double ry = coord[1] - cy;
+    double dx_min = ((rx < 0.5) ? rx : 1.0 - rx) * cell_width();
+    double dy_min = ((ry < 0.5) ? ry : 1.0 - ry) * cell_height();
+    if (dx_min * dx_min <= dy_min * dy_min) {
+      return vface_index(cx + (rx < 0.5 ? 0 : 1), cy);
+    } else {
+      return hface_index(cx, cy + (ry < 0.5 ? 0 : 1));
+    }
+  }
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Vertex>(const std::array<double,2>& loc) const
+  {
+    std::array<double,2> coord = get_coordinate(loc);
+    if (not (coord[0] >= 0.0 and coord[0] < nxcells() and
+	     coord[1] >= 0.0 and coord[1] < nycells())) {
+      return object_count<MeshComponent::Vertex>();
+    }
+    return vertex_index((size_t)(coord[0] + 0.5), (size_t)(coord[1] + 0.5));
+  }
+
+  /**
+     Return the id of the object that is the i-th in row-major order
+     (vertical faces before horizontal faces). Objects are written to
+     outputs, and given by users, in row-major order.
+   */
+  template<MeshComponent C>
+  size_t storage_index(const size_t& i) const;
+
+  template<>
+  size_t storage_index<MeshComponent::Cell>(const size_t& i) const
+  {
+    return cell_index(i % nxcells(), i / nxcells());
+  }
+
+  template<>
+  size_t storage_index<MeshComponent::Face>(const size_t& i) const
+  {
+    size_t nvfaces = (nxcells() + 1) * nycells();
+    if (i < nvfaces) {
+      return vface_index(i % (nxcells() + 1), i / (nxcells() + 1));
+    } else {
+      return hface_index((i - nvfaces) % nxcells(), (i - nvfaces) / nxcells());
+    }
+  }
+
+  template<>
+  size_t storage_index<MeshComponent::Vertex>(const size_t& i) const
+  {
+    return vertex_index(i % (nxcells() + 1), i / (nxcells() + 1));
+  }
+
+  /**
+     Return the row-major position of the object with id i. This is
+     the inverse of storage_index.
+   */
+  template<MeshComponent C>
+  size_t row_major_index(const size_t& i) const;
+
+  template<>
+  size_t row_major_index<MeshComponent::Cell>(const size_t& i) const
+  {
+    std::array<size_t,2> c = cell_coordinate(i);
+    return c[1] * nxcells() + c[0];
+  }
+
+  template<>
+  size_t row_major_index<MeshComponent::Face>(const size_t& i) const
+  {
+    size_t nvfaces = (nxcells() + 1) * nycells();
+    if (i < nvfaces) {
+      std::array<size_t,2> c = vface_coordinate(i);
+      return c[1] * (nxcells() + 1) + c[0];
+    } else {
+      std::array<size_t,2> c = hface_coordinate(i);
+      return nvfaces + c[1] * nxcells() + c[0];
+    }
+  }
+
+  template<>
+  size_t row_major_index<MeshComponent::Vertex>(const size_t& i) const
+  {
+    std::array<size_t,2> c = vertex_coordinate(i);
+    return c[1] * (nxcells() + 1) + c[0];
+  }
+
+  /**
+     Return the number of objects in row-major order, which is the
+     number of rows written to outputs.
+   */
+  template<MeshComponent C>
+  size_t row_major_count(void) const
+  {
+    return object_count<C>();
+  }
+
+  /**
+     Return the location of the object at row-major position i.
+   */
+  template<MeshComponent C>
+  std::array<double,2> get_row_major_location(const size_t& i) const
+  {
+    return get_object_location<C>(storage_index<C>(i));
+  }
+
 protected:
 
-  friend class Cartesian2DMeshAccessor;
+  friend class OrderedCartesian2DMeshAccessor<Ordering>;
+
+  friend class MultiCartesian2DMesh;
 
   const DataArray<size_t>& ncells_data(void) const
   {
@@ -203,9 +489,10 @@ protected:
   
 };
 
-class Cartesian2DMeshAccessor
+template<typename Ordering>
+class OrderedCartesian2DMeshAccessor
 {
-private:
+protected:
 
   using NCAccessor =
     typename DataArray<size_t>::
@@ -225,6 +512,7 @@ private:
 
   inline const size_t& nxcells(void) const { return ncells_ro_[0]; }
   inline const size_t& nycells(void) const { return ncells_ro_[1]; }
+  inline const size_t& tile_size(void) const { return ncells_ro_[2]; }
   
   inline const double& origin_x(void) const { return geotrans_ro_[0]; }
   inline const double& cell_width(void) const { return geotrans_ro_[1]; }
@@ -237,12 +525,59 @@ private:
   inline const double& inv_cell_size(void) const { return geotrans_ro_[8]; }
   inline const double& inv_denom(void) const { return geotrans_ro_[9]; }
 
+  inline size_t cell_index(const size_t& x, const size_t& y) const
+  {
+    return Ordering::index(x, y, nxcells(), nycells(), tile_size());
+  }
+  inline std::array<size_t,2> cell_coordinate(const size_t& i) const
+  {
+    return Ordering::coordinate(i, nxcells(), nycells(), tile_size());
+  }
+  inline size_t vface_index(const size_t& x, const size_t& y) const
+  {
+    return Ordering::index(x, y, nxcells() + 1, nycells(), tile_size());
+  }
+  inline std::array<size_t,2> vface_coordinate(const size_t& i) const
+  {
+    return Ordering::coordinate(i, nxcells() + 1, nycells(), tile_size());
+  }
+  inline size_t hface_index(const size_t& x, const size_t& y) const
+  {
+    return (nxcells() + 1) * nycells() +
+      Ordering::index(x, y, nxcells(), nycells() + 1, tile_size());
+  }
+  inline std::array<size_t,2> hface_coordinate(const size_t& i) const
+  {
+    return Ordering::coordinate(i - (nxcells() + 1) * nycells(),
+					   nxcells(), nycells() + 1, tile_size());
+  }
+  inline size_t vertex_index(const size_t& x, const size_t& y) const
+  {
+    return Ordering::index(x, y, nxcells() + 1, nycells() + 1, tile_size());
+  }
+  inline std::array<size_t,2> vertex_coordinate(const size_t& i) const
+  {
+    return Ordering::coordinate(i, nxcells() + 1, nycells() + 1, tile_size());
+  }
+
 public:
 
+  static constexpr bool has_hanging_faces = false;
+
+  static constexpr bool has_face_normals = false;
+
+  static constexpr bool has_block_clocks = false;
+
   inline const double& dx(void) const { return geotrans_ro_[10]; }
   inline const double& dy(void) const { return geotrans_ro_[11]; }
 
-  Cartesian2DMeshAccessor(const Cartesian2DMesh& c2m);
+  /**
+     Width and height of cell i, which are the same for every cell.
+   */
+  inline const double& dx(const size_t& i) const { return dx(); }
+  inline const double& dy(const size_t& i) const { return dy(); }
+
+  OrderedCartesian2DMeshAccessor(const OrderedCartesian2DMesh<Ordering>& c2m);
 
   void bind(sycl::handler& cgh);
 
@@ -305,8 +640,9 @@ public:
   inline std::array<double,2>
   get_object_location<MeshComponent::Cell>(const size_t& i) const
   {
-    double xi = (double)(i % nxcells()) + 0.5;
-    double yi = (double)(i / nxcells()) + 0.5;
+    std::array<size_t,2> c = cell_coordinate(i);
+    double xi = (double)c[0] + 0.5;
+    double yi = (double)c[1] + 0.5;
     return get_location({xi, yi});
   }
 
@@ -316,14 +652,15 @@ public:
   {
     if (i < (nxcells() + 1) * nycells()) {
       // Face is vertical and has cells to left and right
-      double xi = (double)(i % (nxcells() + 1));
-      double yi = (double)(i / (nxcells() + 1)) + 0.5;
+      std::array<size_t,2> c = vface_coordinate(i);
+      double xi = (double)c[0];
+      double yi = (double)c[1] + 0.5;
       return get_location({xi, yi});
     } else {
       // Face is horizontal
-      size_t i2 = i - ((nxcells() + 1) * nycells());
-      double xi = (double)(i2 % nxcells()) + 0.5;
-      double yi = (double)(i2 / nxcells());
+      std::array<size_t,2> c = hface_coordinate(i);
+      double xi = (double)c[0] + 0.5;
+      double yi = (double)c[1];
       return get_location({xi, yi});
     }
   }
@@ -332,9 +669,8 @@ public:
   inline std::array<double,2>
   get_object_location<MeshComponent::Vertex>(const size_t& i) const
   {
-    double xi = (double)(i % (nxcells() + 1));
-    double yi = (double)(i / (nxcells() + 1));    
-    return get_location({xi, yi});
+    std::array<size_t,2> c = vertex_coordinate(i);
+    return get_location({(double)c[0], (double)c[1]});
   }
 
   template<MeshComponent C>
@@ -346,7 +682,7 @@ public:
     std::array<double,2> coord = get_coordinate(loc);
     if (coord[0] >= 0.0 and coord[0] < nxcells() and
 	coord[1] >= 0.0 and coord[1] < nycells()) {
-      return ((size_t)coord[1]) * nxcells() + (size_t)coord[0];
+      return cell_index((size_t)coord[0], (size_t)coord[1]);
     } else {
       return nxcells() * nycells();
     }
@@ -355,15 +691,35 @@ public:
   template<>
   size_t get_nearest_object_index<MeshComponent::Face>(const std::array<double,2>& loc) const
   {
-    // TODO
-    return nxcells() * nycells();
+    std::array<double,2> coord = get_coordinate(loc);
+    if (not (coord[0] >= 0.0 and coord[0] < nxcells() and
+	     coord[1] >= 0.0 and coord[1] < nycells())) {
+      return object_count<MeshComponent::Face>();
+    }
+    // The nearest face is the side of the containing cell nearest to
+    // loc
+    size_t cx = (size_t)coord[0];
+    size_t cy = (size_t)coord[1];
+    double rx = coord[0] - cx;
+    double ry = coord[1] - cy;
+    double dx_min = ((rx < 0.5) ? rx : 1.0 - rx) * cell_width();
+    double dy_min = ((ry < 0.5) ? ry : 1.0 - ry) * cell_height();
+    if (dx_min * dx_min <= dy_min * dy_min) {
+      return vface_index(cx + (rx < 0.5 ? 0 : 1), cy);
+    } else {
+      return hface_index(cx, cy + (ry < 0.5 ? 0 : 1));
+    }
   }
 
   template<>
   size_t get_nearest_object_index<MeshComponent::Vertex>(const std::array<double,2>& loc) const
   {
-    // TODO
-    return nxcells() * nycells();
+    std::array<double,2> coord = get_coordinate(loc);
+    if (not (coord[0] >= 0.0 and coord[0] < nxcells() and
+	     coord[1] >= 0.0 and coord[1] < nycells())) {
+      return object_count<MeshComponent::Vertex>();
+    }
+    return vertex_index((size_t)(coord[0] + 0.5), (size_t)(coord[1] + 0.5));
   }
 
 
@@ -384,15 +740,16 @@ public:
       // Face is vertical and has cells to the left and right.
       result.dir = 0;
       result.dx = dx();
-      size_t fxid = face_id % (nxcells() + 1);
-      size_t fyid = face_id / (nxcells() + 1);
+      std::array<size_t,2> fc = vface_coordinate(face_id);
+      size_t fxid = fc[0];
+      size_t fyid = fc[1];
 
       if (fxid < nxcells()) {
-	result.rhs_id = fyid * nxcells() + fxid;
+	result.rhs_id = cell_index(fxid, fyid);
 	if (fxid > 0) {
 	  // Mid-row
 	  result.edge = 0;
-	  result.lhs_id = fyid * nxcells() + (fxid - 1);
+	  result.lhs_id = cell_index(fxid - 1, fyid);
 	} else {
 	  // Left hand edge of row
 	  result.edge = -1;
@@ -400,7 +757,7 @@ public:
 	}
       } else {
 	// Right-hand edge of row
-	result.lhs_id = fyid * nxcells() + (fxid - 1);
+	result.lhs_id = cell_index(fxid - 1, fyid);
 	result.rhs_id = result.lhs_id;
 	result.edge = 1;
       }
@@ -408,16 +765,16 @@ public:
       // Face is horizontal and has cells above and below
       result.dir = 1;
       result.dx = dy();
-      size_t f2id = face_id - (nxcells() + 1) * nycells();
-      size_t fxid = f2id % nxcells();
-      size_t fyid = f2id / nxcells();
+      std::array<size_t,2> fc = hface_coordinate(face_id);
+      size_t fxid = fc[0];
+      size_t fyid = fc[1];
 
       if (fyid < nycells()) {
-	result.rhs_id = fyid * nxcells() + fxid;
+	result.rhs_id = cell_index(fxid, fyid);
 	if (fyid > 0) {
 	  // Mid-column
 	  result.edge = 0;
-	  result.lhs_id = (fyid - 1) * nxcells() + fxid;
+	  result.lhs_id = cell_index(fxid, fyid - 1);
 	} else {
 	  // Bottom of column
 	  result.edge = -1;
@@ -425,7 +782,7 @@ public:
 	}
       } else {
 	// Top of column
-	result.lhs_id = (fyid - 1) * nxcells() + fxid;
+	result.lhs_id = cell_index(fxid, fyid - 1);
 	result.rhs_id = result.lhs_id;
 	result.edge = 1;
       }
@@ -446,19 +803,38 @@ public:
 
   get_adjacent_faces_result get_adjacent_faces(const size_t& cell_id) const
   {
-    size_t cxid = cell_id % nxcells();
-    size_t cyid = cell_id / nxcells();
+    std::array<size_t,2> cc = cell_coordinate(cell_id);
+    size_t cxid = cc[0];
+    size_t cyid = cc[1];
 
     get_adjacent_faces_result result;
-    result.face_w = cyid * (nxcells() + 1) + cxid;
-    result.face_e = result.face_w + 1;
+    result.face_w = vface_index(cxid, cyid);
+    result.face_e = vface_index(cxid + 1, cyid);
     result.dx = dx();
-    result.face_s = (nxcells() + 1) * nycells() + cyid * nxcells() + cxid;
-    result.face_n = result.face_s + nxcells();
+    result.face_s = hface_index(cxid, cyid);
+    result.face_n = hface_index(cxid, cyid + 1);
     result.dy = dy();
     return result;
   }
   
+  struct get_hanging_faces_result
+  {
+    size_t face_w;
+    size_t face_e;
+    size_t face_s;
+    size_t face_n;
+  };
+
+  /**
+     Return the second face on each side of a cell. Sides are never
+     split, so these are the faces returned by get_adjacent_faces.
+   */
+  get_hanging_faces_result get_hanging_faces(const size_t& cell_id) const
+  {
+    auto [ face_w, face_e, dx, face_s, face_n, dy ] = get_adjacent_faces(cell_id);
+    return { face_w, face_e, face_s, face_n };
+  }
+
   struct offset_type
   {
     size_t i;
@@ -477,9 +853,9 @@ public:
   template<>
   offset_type get_object_west<MeshComponent::Cell>(const size_t& i) const
   {
-    size_t xi = i % nxcells();
-    if (xi > 0) {
-      return { i-1, dx() };
+    std::array<size_t,2> c = cell_coordinate(i);
+    if (c[0] > 0) {
+      return { cell_index(c[0] - 1, c[1]), dx() };
     } else {
       return { i, 0.0 };
     }
@@ -488,9 +864,9 @@ public:
   template<>
   offset_type get_object_east<MeshComponent::Cell>(const size_t& i) const
   {
-    size_t xi = i % nxcells();
-    if (xi < nxcells() - 1) {
-      return { i+1, dx() };
+    std::array<size_t,2> c = cell_coordinate(i);
+    if (c[0] < nxcells() - 1) {
+      return { cell_index(c[0] + 1, c[1]), dx() };
     } else {
       return { i, 0.0 };
     }
@@ -499,9 +875,9 @@ public:
   template<>
   offset_type get_object_north<MeshComponent::Cell>(const size_t& i) const
   {
-    size_t yi = i / nxcells();
-    if (yi < nycells() - 1) {
-      return { i+nxcells(), dy() };
+    std::array<size_t,2> c = cell_coordinate(i);
+    if (c[1] < nycells() - 1) {
+      return { cell_index(c[0], c[1] + 1), dy() };
     } else {
       return { i, 0.0 };
     }
@@ -510,9 +886,9 @@ public:
   template<>
   offset_type get_object_south<MeshComponent::Cell>(const size_t& i) const
   {
-    size_t yi = i / nxcells();
-    if (yi > 0) {
-      return { i-nxcells(), dy() };
+    std::array<size_t,2> c = cell_coordinate(i);
+    if (c[1] > 0) {
+      return { cell_index(c[0], c[1] - 1), dy() };
     } else {
       return { i, 0.0 };
     }
@@ -520,4 +896,8 @@ public:
 
 };
 
+using Cartesian2DMesh = OrderedCartesian2DMesh<RowMajorOrdering>;
+
+using TiledCartesian2DMesh = OrderedCartesian2DMesh<TiledOrdering>;
+
 #endif
@@ -0,0 +1,102 @@
+/***********************************************************************
+ * mfcm Mesh/MeshLocator.cpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#include "MeshLocator.hpp"
+
+template<typename Mesh, MeshComponent FieldMapping>
+class LocatePointsKernel
+{
+public:
+
+  using MeshType = Mesh;
+  using MeshAccessor = typename MeshType::Accessor;
+  using PointAccessor = typename DataArray<double>::
+    template Accessor<sycl::access::mode::read,
+		      sycl::access::target::global_buffer>;
+  using IdAccessor = typename DataArray<size_t>::
+    template Accessor<sycl::access::mode::discard_write,
+		      sycl::access::target::global_buffer>;
+
+private:
+
+  MeshAccessor mesh_ro_;
+
+  PointAccessor points_ro_;
+
+  IdAccessor ids_wo_;
+
+public:
+
+  LocatePointsKernel(sycl::handler& cgh,
+		     const MeshType& mesh,
+		     const DataArray<double>& points,
+		     DataArray<size_t>& ids)
+    : mesh_ro_(mesh),
+      points_ro_(points.get_read_accessor(cgh)),
+      ids_wo_(ids.get_discard_write_accessor(cgh))
+  {
+    mesh_ro_.bind(cgh);
+  }
+
+  void operator()(sycl::item<1> item) const
+  {
+    size_t i = item.get_linear_id();
+    std::array<double,2> location = { points_ro_[2 * i], points_ro_[2 * i + 1] };
+    ids_wo_[i] =
+      mesh_ro_.template get_nearest_object_index<FieldMapping>(location);
+  }
+
+};
+
+template<typename Mesh, MeshComponent FieldMapping>
+void MeshLocator<Mesh,FieldMapping>::
+locate(const std::shared_ptr<MeshType>& mesh,
+       const DataArray<double>& points,
+       DataArray<size_t>& ids)
+{
+  size_t n = ids.size();
+  if (n == 0) {
+    return;
+  }
+  mesh->queue_ptr()->submit([&](sycl::handler& cgh)
+  {
+    auto kernel = LocatePointsKernel<Mesh,FieldMapping>(cgh, *mesh, points, ids);
+    cgh.parallel_for(sycl::range<1>(n), kernel);
+  });
+}
+
+template<typename Mesh, MeshComponent FieldMapping>
+std::vector<size_t> MeshLocator<Mesh,FieldMapping>::
+locate(const std::shared_ptr<MeshType>& mesh,
+       const std::vector<std::array<double,2>>& points)
+{
+  if (points.empty()) {
+    return std::vector<size_t>();
+  }
+  std::vector<double> xy;
+  xy.reserve(2 * points.size());
+  for (auto&& pt : points) {
+    xy.push_back(pt[0]);
+    xy.push_back(pt[1]);
+  }
+  DataArray<double> points_data(mesh->queue_ptr(), xy, true);
+  DataArray<size_t> ids(mesh->queue_ptr(), points.size(), 0, true);
+  locate(mesh, points_data, ids);
+  ids.move_to_host();
+  return ids.host_vector();
+}
@@ -0,0 +1,60 @@
+/***********************************************************************
+ * mfcm Mesh/MeshLocator.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_Mesh_MeshLocator_hpp
+#define mfcm_Mesh_MeshLocator_hpp
+
+#include "Mesh.hpp"
+#include "DataArray.hpp"
+
+/**
+   Finds the objects of a mesh nearest to many points at once. Every
+   point is resolved by the get_nearest_object_index method of the
+   mesh accessor, in a single kernel, so that selections and measures
+   with many locations need neither a kernel nor a copy back to the
+   host for each location.
+ */
+template<typename Mesh, MeshComponent FieldMapping>
+class MeshLocator
+{
+public:
+
+  using MeshType = Mesh;
+  static const MeshComponent FieldMappingType = FieldMapping;
+
+  /**
+     Set ids[i] to the id of the object nearest to the point
+     (points[2 i], points[2 i + 1]), or to the object count if the
+     point is outside the mesh. Both arrays must be on the device and
+     ids must hold one value per point.
+   */
+  static void locate(const std::shared_ptr<MeshType>& mesh,
+		     const DataArray<double>& points,
+		     DataArray<size_t>& ids);
+
+  /**
+     Return the ids of the objects nearest to each of a list of
+     points.
+   */
+  static std::vector<size_t>
+  locate(const std::shared_ptr<MeshType>& mesh,
+	 const std::vector<std::array<double,2>>& points);
+
+};
+
+#endif
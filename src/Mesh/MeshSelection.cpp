@@ -17,147 +17,155 @@
  ***********************************************************************/
 
 #include "MeshSelection.hpp"
-#include "../Geometry/GeometryDataArray.hpp"
+#include "MeshLocator.hpp"
 
 template<typename Mesh, MeshComponent FieldMapping>
 void MeshSelection<Mesh, FieldMapping>::
 initialize_global_(void)
 {
-  // A global selection is indicated by list_ containing two
-  // elements that are the mesh's object count.
-  std::vector<size_t>& id_list = list_.host_vector();
-  size_t idmax = mesh_p_->template object_count<FieldMappingType>();
-  id_list.push_back(idmax);
-  id_list.push_back(idmax);
+  // A global selection stores nothing, but the arrays must exist on
+  // the device so that accessors can be bound to them.
+  encoding_ = MeshSelectionEncoding::global;
+  size_ = mesh_p_->template object_count<FieldMappingType>();
   list_.move_to_device();
+  bits_.move_to_device();
 }
 
 template<typename Mesh, MeshComponent FieldMapping>
-void MeshSelection<Mesh, FieldMapping>::
-initialize_mask_(void)
+void MeshSelection<Mesh,FieldMapping>::
+add_points_from_geometry_(const std::shared_ptr<Geometry>& geom_ptr,
+			  std::vector<std::array<double,2>>& points)
 {
-  // A mask selection is indicated by list_ having size N + 2 where N
-  // is the total number of objects in the mesh. The last two elements
-  // contain N.
-  std::vector<size_t>& mask = list_.host_vector();
-  size_t idmax = mesh_p_->template object_count<FieldMappingType>();
-  mask.clear();
-  mask.resize(idmax + 2);
-  mask.at(idmax) = idmax;
-  mask.at(idmax + 1) = idmax;
-  list_.move_to_device();
+  switch (geom_ptr->type()) {
+  case Geometry::Type::point:
+    {
+      auto pt = std::dynamic_pointer_cast<Point>(geom_ptr);
+      points.push_back({ pt->x(), pt->y() });
+    }
+    return;
+  case Geometry::Type::multipoint:
+    for (auto&& pt : *std::dynamic_pointer_cast<MultiPoint>(geom_ptr)) {
+      points.push_back({ pt.x(), pt.y() });
+    }
+    return;
+  default:
+    std::cerr << "Cannot select mesh objects with geometry of type: "
+	      << geom_ptr->type_str() << std::endl;
+    throw std::runtime_error("Cannot select mesh objects with this type of geometry.");
+  };
 }
 
 template<typename Mesh, MeshComponent FieldMapping>
-class UpdateMaskFromPointKernel
+void MeshSelection<Mesh, FieldMapping>::
+encode_list_(const std::vector<size_t>& ids)
 {
-public:
-
-  using MeshType = Mesh;
-  using MeshAccessor = typename MeshType::Accessor;
-  using DataAccessor = typename DataArray<size_t>::
-    template Accessor<sycl::access::mode::read_write,
-		      sycl::access::target::global_buffer>;
-  using PDAAccessor = PointDataArrayAccessor<sycl::access::mode::read,
-					     sycl::access::target::global_buffer>;
-  
-private:
-
-  std::shared_ptr<sycl::queue> queue_;
-  
-  MeshAccessor mesh_ro_;
-
-  DataAccessor list_acc_;
-
-  PDAAccessor pda_acc_;
-
-public:
-  
-  UpdateMaskFromPointKernel(sycl::handler& cgh,
-			    std::shared_ptr<MeshType>& mesh_ptr,
-			    DataArray<size_t>& list,
-			    PointDataArray& pda)
-    : queue_(mesh_ptr->queue_ptr()), mesh_ro_(*mesh_ptr),
-      list_acc_(list.get_read_write_accessor(cgh)),
-      pda_acc_(pda, cgh)
-  {
-    mesh_ro_.bind(cgh);
-  }
-
-  void operator()(sycl::item<1> item) const
-  {
-    size_t i = item.get_linear_id();
-    size_t n_obj = mesh_ro_.template object_count<FieldMapping>();
-    if (i < n_obj) {
-      std::array<double,2> location = { pda_acc_.x(), pda_acc_.y() };
-      size_t j = mesh_ro_.template get_nearest_object_index<FieldMapping>(location);
-      if (i == j) {
-	list_acc_[item] = 1;
-      }
-    }
-  }
-};
+  encoding_ = MeshSelectionEncoding::list;
+  list_.host_vector() = ids;
+}
 
 template<typename Mesh, MeshComponent FieldMapping>
-void MeshSelection<Mesh,FieldMapping>::
-update_mask_from_point_(const std::shared_ptr<Point>& pt)
+void MeshSelection<Mesh, FieldMapping>::
+encode_intervals_(const std::vector<size_t>& ids)
 {
-  PointDataArray pda(mesh_p_->queue_ptr(), pt);
-  mesh_p_->queue_ptr()->submit([&](sycl::handler& cgh)
-  {
-    auto kernel = UpdateMaskFromPointKernel<Mesh,FieldMapping>
-      (cgh, mesh_p_, list_, pda);
-    cgh.parallel_for(sycl::range<1>(list_.size()), kernel);
-  });
+  encoding_ = MeshSelectionEncoding::intervals;
+  std::vector<size_t>& runs = list_.host_vector();
+  runs.clear();
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (i == 0 or ids[i] != ids[i-1] + 1) {
+      runs.push_back(ids[i]);
+      runs.push_back(i);
+    }
+  }
 }
 
 template<typename Mesh, MeshComponent FieldMapping>
-void MeshSelection<Mesh,FieldMapping>::
-update_mask_from_geometry_(const std::shared_ptr<Geometry>& geom_ptr)
+void MeshSelection<Mesh, FieldMapping>::
+encode_bitset_(const std::vector<size_t>& ids)
 {
-  switch (geom_ptr->type()) {
-  case Geometry::Type::point:
-    update_mask_from_point_(std::dynamic_pointer_cast<Point>(geom_ptr));
-    return;
-  default:
-    std::cerr << "Cannot update mask with geometry of type: "
-	      << geom_ptr->type_str() << std::endl;
-    throw std::runtime_error("Cannot update mask with this type of geometry.");
-  };
+  encoding_ = MeshSelectionEncoding::bitset;
+  size_t idmax = mesh_p_->template object_count<FieldMappingType>();
+  size_t n_words = (idmax + 31) / 32;
+  std::vector<uint32_t>& words = bits_.host_vector();
+  words.assign(2 * n_words, 0);
+  for (auto&& id : ids) {
+    words.at(2 * (id / 32)) |= uint32_t(1) << (id % 32);
+  }
+  size_t count = 0;
+  for (size_t w = 0; w < n_words; ++w) {
+    words[2 * w + 1] = count;
+    for (uint32_t word = words[2 * w]; word != 0; word &= word - 1) {
+      ++count;
+    }
+  }
 }
 
 template<typename Mesh, MeshComponent FieldMapping>
 void MeshSelection<Mesh, FieldMapping>::
-finalize_id_list_(void)
+finalize_id_list_(std::vector<size_t>& ids,
+		  const std::string& encoding_str)
 {
   size_t idmax = mesh_p_->template object_count<FieldMappingType>();
-  std::vector<size_t>& id_list = list_.host_vector();
   // Sort the selected mesh component ids
-  std::sort(id_list.begin(), id_list.end());
+  std::sort(ids.begin(), ids.end());
   // Remove duplicates
-  auto last = std::unique(id_list.begin(), id_list.end());
-  id_list.erase(last, id_list.end());
-  // Add the end element (the mesh's object count)
-  id_list.push_back(idmax);
-  // Put the list on the device
+  auto last = std::unique(ids.begin(), ids.end());
+  ids.erase(last, ids.end());
+  // Ignore ids outside the mesh, such as those of points that are not
+  // in any object, and those outside the owned range
+  ids.erase(std::lower_bound(ids.begin(), ids.end(),
+			     std::min(idmax, owned_[1])), ids.end());
+  ids.erase(ids.begin(), std::lower_bound(ids.begin(), ids.end(), owned_[0]));
+  size_ = ids.size();
+  // Unless an encoding is requested, a selection of every object is
+  // global, and otherwise the smaller of a list and intervals is used
+  size_t n_runs = 0;
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (i == 0 or ids[i] != ids[i-1] + 1) ++n_runs;
+  }
+  size_t list_bytes = sizeof(size_t) * ids.size();
+  size_t intervals_bytes = 2 * sizeof(size_t) * n_runs;
+  if (encoding_str == "auto" and ids.size() == idmax) {
+    initialize_global_();
+    return;
+  } else if (encoding_str == "list" or
+	     (encoding_str == "auto" and list_bytes <= intervals_bytes)) {
+    encode_list_(ids);
+  } else if (encoding_str == "intervals" or encoding_str == "auto") {
+    encode_intervals_(ids);
+  } else if (encoding_str == "bitset") {
+    encode_bitset_(ids);
+  } else {
+    std::cerr << "Unknown mesh selection encoding: "
+	      << encoding_str << std::endl;
+    throw std::runtime_error("Unknown mesh selection encoding.");
+  }
+  // Put the arrays on the device
   list_.move_to_device();
+  bits_.move_to_device();
 }
 
 template<typename Mesh, MeshComponent FieldMapping>
 MeshSelection<Mesh, FieldMapping>::
 MeshSelection(const std::shared_ptr<MeshType>& mesh_p,
-	      const Config& conf)
+	      const Config& conf,
+	      const std::array<size_t,2>& owned)
   : mesh_p_(mesh_p),
-    list_(mesh_p->queue_ptr(), 0)
+    owned_(owned),
+    encoding_(MeshSelectionEncoding::global),
+    size_(0),
+    list_(mesh_p->queue_ptr(), 0),
+    bits_(mesh_p->queue_ptr(), 0)
 {
   // Parse the configuration to get a selection. Empty config must
   // equal global selection
   std::string sel_type_str = conf.get_value<std::string>("global");
+  std::string encoding_str = conf.get<std::string>("encoding", "auto");
   if (sel_type_str == "global" or sel_type_str == "") {
     initialize_global_();
   } else if (sel_type_str == "id list") {
-    // A selection via the cell/face/vertex IDs
-    std::vector<size_t>& id_list = list_.host_vector();
+    // A selection via the cell/face/vertex IDs, which are given in
+    // row-major order
+    std::vector<size_t> id_list;
     auto single_range = conf.equal_range("id");
     for (auto it = single_range.first; it != single_range.second; ++it) {
       id_list.push_back(it->second.get_value<size_t>());
@@ -169,23 +177,24 @@ MeshSelection(const std::shared_ptr<MeshType>& mesh_p,
 	id_list.push_back(id);
       }
     }
-    finalize_id_list_();
-  } else if (sel_type_str == "at") {
-    GeometryCollection gc(conf);
-    initialize_mask_();
-    for (auto&& geom_ptr : gc) {
-      update_mask_from_geometry_(geom_ptr);
+    size_t idmax = mesh_p_->template object_count<FieldMappingType>();
+    for (auto&& id : id_list) {
+      if (id < idmax) {
+	id = mesh_p_->template storage_index<FieldMappingType>(id);
+      }
     }
-    /*
-  } else if (sel_type_str == "at point") {
+    finalize_id_list_(id_list, encoding_str);
+  } else if (sel_type_str == "at") {
+    // A selection via the objects nearest to some geometry
     GeometryCollection gc(conf);
+    std::vector<std::array<double,2>> points;
     for (auto&& geom_ptr : gc) {
-      if (geom_ptr->type() == Geometry::Type::point) {
-	PointDataArray pda(mesh_p->queue_ptr(),
-			   std::dynamic_pointer_cast<Point>(geom_ptr));
-      }
+      add_points_from_geometry_(geom_ptr, points);
     }
-    */
+    // Locate all of the points in one kernel
+    std::vector<size_t> id_list =
+      MeshLocator<MeshType,FieldMappingType>::locate(mesh_p_, points);
+    finalize_id_list_(id_list, encoding_str);
   } else {
     std::cerr << "Unknown mesh selection method: "
 	      << sel_type_str << std::endl;
@@ -195,20 +204,40 @@ MeshSelection(const std::shared_ptr<MeshType>& mesh_p,
 }
 
 template<typename Mesh, MeshComponent FieldMapping>
-bool MeshSelection<Mesh, FieldMapping>::is_global(void) const
+std::vector<size_t> MeshSelection<Mesh, FieldMapping>::
+get_id_list(void) const
 {
-  if (list_.size() == 2 and
-      list_.host_vector().at(0) == list_.host_vector().at(1)) {
-    return true;
-  }
-  return false;
-}
-
-template<typename Mesh, MeshComponent FieldMapping>
-size_t MeshSelection<Mesh, FieldMapping>::size(void) const
-{
-  if (is_global()) {
-    return mesh_p_->template object_count<FieldMappingType>();
+  // The encoded arrays are only ever written on the host, so the host
+  // copies are up to date.
+  std::vector<size_t> ids;
+  ids.reserve(size_);
+  switch (encoding_) {
+  case MeshSelectionEncoding::list:
+    ids = list_.host_vector();
+    break;
+  case MeshSelectionEncoding::intervals:
+    {
+      const std::vector<size_t>& runs = list_.host_vector();
+      for (size_t r = 0; r < runs.size(); r += 2) {
+	size_t count_end = (r + 2 < runs.size()) ? runs[r + 3] : size_;
+	for (size_t i = runs[r + 1]; i < count_end; ++i) {
+	  ids.push_back(runs[r] + (i - runs[r + 1]));
+	}
+      }
+    }
+    break;
+  case MeshSelectionEncoding::bitset:
+    {
+      const std::vector<uint32_t>& words = bits_.host_vector();
+      for (size_t w = 0; 2 * w < words.size(); ++w) {
+	for (size_t b = 0; b < 32; ++b) {
+	  if (words[2 * w] & (uint32_t(1) << b)) ids.push_back(32 * w + b);
+	}
+      }
+    }
+    break;
+  default:
+    break;
   }
-  return list_.size() - 1;
+  return ids;
 }
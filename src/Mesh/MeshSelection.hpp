@@ -24,9 +24,52 @@
 #include "Config.hpp"
 #include "Geometry.hpp"
 
-template<typename Mesh, MeshComponent FieldMapping>
+#include <limits>
+#include <type_traits>
+
+/**
+   Enumeration of the ways in which a MeshSelection can store the
+   selected objects.
+ */
+enum class MeshSelectionEncoding
+  {
+    global,
+    list,
+    intervals,
+    bitset,
+  };
+
+template<typename Mesh, MeshComponent FieldMapping,
+	 MeshSelectionEncoding Encoding>
 class MeshSelectionAccessor;
 
+/**
+   Class representing a subset of the cells, faces or vertices of a
+   mesh. The selection is stored in one of the following encodings:
+
+   - global: every object is selected and nothing is stored;
+   - list: the sorted ids of the selected objects;
+   - intervals: for each run of consecutive ids, the first id of the
+     run and the number of selected objects before it;
+   - bitset: one bit per object, packed into 32-bit words, each
+     followed by the number of selected objects in the preceding
+     words.
+
+   The "encoding" key of the configuration chooses the encoding. By
+   default ("auto") a selection of every object is global and any
+   other selection is a list or intervals, whichever is smaller. The
+   bitset is only used when requested, since finding the i-th set bit
+   is slow for dense selections.
+
+   Objects chosen by id or location are only selected if they lie in
+   the owned range of ids, so that a point in the rows that a
+   subdomain shares with its neighbours is selected by only one of
+   them (see SaintVenantDecomposedSolver).
+
+   Kernels map the i-th of size() work items to an object id through a
+   MeshSelectionAccessor for the encoding, chosen once per launch with
+   dispatch().
+ */
 template<typename Mesh, MeshComponent FieldMapping>
 class MeshSelection
 {
@@ -35,32 +78,49 @@ public:
   using MeshType = Mesh;
   static const MeshComponent FieldMappingType = FieldMapping;
 
-  using Accessor = MeshSelectionAccessor<MeshType, FieldMappingType>;
+  template<MeshSelectionEncoding Encoding>
+  using Accessor = MeshSelectionAccessor<MeshType, FieldMappingType, Encoding>;
   
 private:
 
   void initialize_global_(void);
   
-  void initialize_mask_(void);
-  void update_mask_from_point_(const std::shared_ptr<Point>& pt);
-  void update_mask_from_geometry_(const std::shared_ptr<Geometry>& geom_ptr);
+  void add_points_from_geometry_(const std::shared_ptr<Geometry>& geom_ptr,
+				 std::vector<std::array<double,2>>& points);
   
-  void finalize_id_list_(void);
+  void finalize_id_list_(std::vector<size_t>& ids,
+			 const std::string& encoding_str);
+
+  void encode_list_(const std::vector<size_t>& ids);
+  void encode_intervals_(const std::vector<size_t>& ids);
+  void encode_bitset_(const std::vector<size_t>& ids);
   
   std::shared_ptr<MeshType> mesh_p_;
 
+  std::array<size_t,2> owned_;
+
+  MeshSelectionEncoding encoding_;
+
+  size_t size_;
+
   DataArray<size_t> list_;
 
+  DataArray<uint32_t> bits_;
+
 protected:
 
-  friend class MeshSelectionAccessor<MeshType, FieldMappingType>;
+  template<typename M, MeshComponent C, MeshSelectionEncoding E>
+  friend class MeshSelectionAccessor;
 
   const DataArray<size_t>& list(void) const { return list_; }
+
+  const DataArray<uint32_t>& bits(void) const { return bits_; }
   
 public:
   
   MeshSelection(const std::shared_ptr<MeshType>& mesh_p,
-		const Config& conf = Config());
+		const Config& conf = Config(),
+		const std::array<size_t,2>& owned = { 0, std::numeric_limits<size_t>::max() });
 
   const std::shared_ptr<MeshType>& mesh(void) const
   {
@@ -70,29 +130,72 @@ public:
   /**
      Returns true if all of the objects in the mesh should be selected.
    */
-  bool is_global(void) const;
+  bool is_global(void) const
+  {
+    return encoding_ == MeshSelectionEncoding::global;
+  }
 
   /**
-     Returns the number of mesh objects selected.
+     Returns the encoding used to store the selection.
    */
-  size_t size(void) const;
+  MeshSelectionEncoding encoding(void) const
+  {
+    return encoding_;
+  }
 
-  const std::vector<size_t>& get_id_list(void) const
+  /**
+     Returns the number of mesh objects selected.
+   */
+  size_t size(void) const
   {
-    // list_.move_to_host();
-    const std::vector<size_t>& list_cref = list_.host_vector();
-    // list_.move_to_device();
-    return list_cref;
+    return size_;
   }
 
-  ///**
-  //   Returns a pointer to the array of selected objects.
-  // */
-  //  std::shared_ptr<DataArray<size_t>> list_ptr(void) const { return list_; }
+  /**
+     Returns the sorted ids of the selected objects. For a global
+     selection the list is empty.
+   */
+  std::vector<size_t> get_id_list(void) const;
+
+  /**
+     Call fn with a std::integral_constant holding the encoding of
+     the selection, so that a kernel launched inside fn can use
+     Accessor<decltype(encoding)::value>, which maps work items to ids
+     without testing the encoding.
+   */
+  template<typename Fn>
+  void dispatch(Fn&& fn) const
+  {
+    switch (encoding_) {
+    case MeshSelectionEncoding::list:
+      fn(std::integral_constant<MeshSelectionEncoding,
+	 MeshSelectionEncoding::list>());
+      break;
+    case MeshSelectionEncoding::intervals:
+      fn(std::integral_constant<MeshSelectionEncoding,
+	 MeshSelectionEncoding::intervals>());
+      break;
+    case MeshSelectionEncoding::bitset:
+      fn(std::integral_constant<MeshSelectionEncoding,
+	 MeshSelectionEncoding::bitset>());
+      break;
+    default:
+      fn(std::integral_constant<MeshSelectionEncoding,
+	 MeshSelectionEncoding::global>());
+      break;
+    }
+  }
 
 };
 
-template<typename Mesh, MeshComponent FieldMapping>
+/**
+   Accessor mapping the i-th work item of a kernel launched over a
+   MeshSelection to the id of the i-th selected object. The encoding
+   is a template parameter and must be that of the selection (see
+   MeshSelection::dispatch).
+ */
+template<typename Mesh, MeshComponent FieldMapping,
+	 MeshSelectionEncoding Encoding>
 class MeshSelectionAccessor
 {
 private:
@@ -102,35 +205,86 @@ private:
 		      sycl::access::target::global_buffer,
 		      sycl::access::placeholder::true_t>;
 
+  using BitsAccessor = typename DataArray<uint32_t>::
+    template Accessor<sycl::access::mode::read,
+		      sycl::access::target::global_buffer,
+		      sycl::access::placeholder::true_t>;
+
+  size_t n_blocks_;
+
   ListAccessor list_ro_;
+
+  BitsAccessor bits_ro_;
+
+  /**
+     Returns the index of the last of the first n_blocks_ blocks of
+     stride entries whose count (at offset within the block) is not
+     greater than id.
+   */
+  template<typename A>
+  size_t find_block_(const A& acc, const size_t& stride,
+		     const size_t& offset, const size_t& id) const
+  {
+    size_t lo = 0;
+    size_t hi = n_blocks_;
+    while (hi - lo > 1) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (acc[stride * mid + offset] <= id) {
+	lo = mid;
+      } else {
+	hi = mid;
+      }
+    }
+    return lo;
+  }
   
 public:
 
   MeshSelectionAccessor(const MeshSelection<Mesh,FieldMapping>& ms)
-    : list_ro_(ms.list().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>())
-  {}
+    : n_blocks_(0),
+      list_ro_(ms.list().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+      bits_ro_(ms.bits().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>())
+  {
+    if (ms.encoding() != Encoding) {
+      throw std::logic_error("Mesh selection accessor does not match "
+			     "the selection encoding.");
+    }
+    if constexpr (Encoding == MeshSelectionEncoding::intervals) {
+      n_blocks_ = ms.list().size() / 2;
+    } else if constexpr (Encoding == MeshSelectionEncoding::bitset) {
+      n_blocks_ = ms.bits().size() / 2;
+    }
+  }
 
   void bind(sycl::handler& cgh)
   {
     cgh.require(list_ro_);
+    cgh.require(bits_ro_);
   }
 
   size_t operator()(const size_t& id) const
   {
-    if (list_ro_.size() == 2 and list_ro_[0] == list_ro_[1]) {
-      // Global selection
-      return id;
-    } else if (list_ro_.size() > 2 and
-	       list_ro_[list_ro_.size() - 1] == list_ro_[list_ro_.size() - 2]) {
-      // The list is actually a mask
-      if (list_ro_[id] > 0) {
-	return id;
-      } else {
-	return list_ro_[list_ro_.size() - 1];
+    if constexpr (Encoding == MeshSelectionEncoding::list) {
+      return list_ro_[id];
+    } else if constexpr (Encoding == MeshSelectionEncoding::intervals) {
+      // Runs are stored as (first id, count before run) pairs
+      size_t r = find_block_(list_ro_, 2, 1, id);
+      return list_ro_[2 * r] + (id - list_ro_[2 * r + 1]);
+    } else if constexpr (Encoding == MeshSelectionEncoding::bitset) {
+      // Words are stored as (bits, count before word) pairs
+      size_t w = find_block_(bits_ro_, 2, 1, id);
+      uint32_t word = bits_ro_[2 * w];
+      for (size_t j = bits_ro_[2 * w + 1]; j < id; ++j) {
+	word &= word - 1;
       }
+      size_t b = 0;
+      while (not (word & 1u)) {
+	word >>= 1;
+	++b;
+      }
+      return 32 * w + b;
     } else {
-      // List selection
-      return list_ro_[id];
+      return id;
     }
   }
   
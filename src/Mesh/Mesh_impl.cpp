@@ -17,13 +17,71 @@
  ***********************************************************************/
 
 #include "Cartesian2DMesh.cpp"
+#include "QuadtreeMesh.cpp"
+#include "RectilinearMesh.cpp"
+#include "SparseCartesian2DMesh.cpp"
+#include "UnstructuredMesh.cpp"
+#include "MultiCartesian2DMesh.cpp"
+#include "MeshLocator.cpp"
 #include "MeshSelection.cpp"
 
+template class OrderedCartesian2DMesh<RowMajorOrdering>;
+template class OrderedCartesian2DMesh<TiledOrdering>;
+template class OrderedCartesian2DMeshAccessor<RowMajorOrdering>;
+template class OrderedCartesian2DMeshAccessor<TiledOrdering>;
+
 template class MeshSelection<Cartesian2DMesh,MeshComponent::Cell>;
 template class MeshSelection<Cartesian2DMesh,MeshComponent::Face>;
 template class MeshSelection<Cartesian2DMesh,MeshComponent::Vertex>;
 
-template class MeshSelectionAccessor<Cartesian2DMesh,MeshComponent::Cell>;
-template class MeshSelectionAccessor<Cartesian2DMesh,MeshComponent::Face>;
-template class MeshSelectionAccessor<Cartesian2DMesh,MeshComponent::Vertex>;
+template class MeshLocator<Cartesian2DMesh,MeshComponent::Cell>;
+template class MeshLocator<Cartesian2DMesh,MeshComponent::Face>;
+template class MeshLocator<Cartesian2DMesh,MeshComponent::Vertex>;
+
+template class MeshSelection<TiledCartesian2DMesh,MeshComponent::Cell>;
+template class MeshSelection<TiledCartesian2DMesh,MeshComponent::Face>;
+template class MeshSelection<TiledCartesian2DMesh,MeshComponent::Vertex>;
+
+template class MeshLocator<TiledCartesian2DMesh,MeshComponent::Cell>;
+template class MeshLocator<TiledCartesian2DMesh,MeshComponent::Face>;
+template class MeshLocator<TiledCartesian2DMesh,MeshComponent::Vertex>;
+
+template class MeshSelection<QuadtreeMesh,MeshComponent::Cell>;
+template class MeshSelection<QuadtreeMesh,MeshComponent::Face>;
+template class MeshSelection<QuadtreeMesh,MeshComponent::Vertex>;
+
+template class MeshLocator<QuadtreeMesh,MeshComponent::Cell>;
+template class MeshLocator<QuadtreeMesh,MeshComponent::Face>;
+template class MeshLocator<QuadtreeMesh,MeshComponent::Vertex>;
+
+template class MeshSelection<RectilinearMesh,MeshComponent::Cell>;
+template class MeshSelection<RectilinearMesh,MeshComponent::Face>;
+template class MeshSelection<RectilinearMesh,MeshComponent::Vertex>;
+
+template class MeshLocator<RectilinearMesh,MeshComponent::Cell>;
+template class MeshLocator<RectilinearMesh,MeshComponent::Face>;
+template class MeshLocator<RectilinearMesh,MeshComponent::Vertex>;
+
+template class MeshSelection<SparseCartesian2DMesh,MeshComponent::Cell>;
+template class MeshSelection<SparseCartesian2DMesh,MeshComponent::Face>;
+template class MeshSelection<SparseCartesian2DMesh,MeshComponent::Vertex>;
+
+template class MeshLocator<SparseCartesian2DMesh,MeshComponent::Cell>;
+template class MeshLocator<SparseCartesian2DMesh,MeshComponent::Face>;
+template class MeshLocator<SparseCartesian2DMesh,MeshComponent::Vertex>;
+
+template class MeshSelection<UnstructuredMesh,MeshComponent::Cell>;
+template class MeshSelection<UnstructuredMesh,MeshComponent::Face>;
+template class MeshSelection<UnstructuredMesh,MeshComponent::Vertex>;
+
+template class MeshLocator<UnstructuredMesh,MeshComponent::Cell>;
+template class MeshLocator<UnstructuredMesh,MeshComponent::Face>;
+template class MeshLocator<UnstructuredMesh,MeshComponent::Vertex>;
+
+template class MeshSelection<MultiCartesian2DMesh,MeshComponent::Cell>;
+template class MeshSelection<MultiCartesian2DMesh,MeshComponent::Face>;
+template class MeshSelection<MultiCartesian2DMesh,MeshComponent::Vertex>;
 
+template class MeshLocator<MultiCartesian2DMesh,MeshComponent::Cell>;
+template class MeshLocator<MultiCartesian2DMesh,MeshComponent::Face>;
+template class MeshLocator<MultiCartesian2DMesh,MeshComponent::Vertex>;
@@ -0,0 +1,163 @@
+/***********************************************************************
+ * mfcm Mesh/MultiCartesian2DMesh.cpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#include <limits>
+
+#include "MultiCartesian2DMesh.hpp"
+#include "Config.hpp"
+
+MultiCartesian2DMesh::
+MultiCartesian2DMesh(const std::shared_ptr<sycl::queue>& queue,
+		     bool on_device)
+  : offsets_(queue, 3),
+    ncells_(queue, 0),
+    geotrans_(queue, 0),
+    clocks_(queue, 0),
+    cell_blocks_(queue, 0),
+    face_blocks_(queue, 0),
+    vertex_blocks_(queue, 0)
+{
+  const Config& conf = GlobalConfig::instance().mesh_configuration();
+  size_t nblocks = conf.get<size_t>("blocks", 1);
+  if (nblocks == 0) {
+    std::cerr << "ERROR: A multi-block mesh must have at least one block."
+	      << std::endl;
+    throw std::runtime_error("Invalid mesh block count.");
+  }
+  // Every block shares the geometry of the configured mesh
+  std::shared_ptr<Cartesian2DMesh> block =
+    std::make_shared<Cartesian2DMesh>(queue, on_device);
+  blocks_.assign(nblocks, block);
+  initialize_(on_device);
+}
+
+MultiCartesian2DMesh::
+MultiCartesian2DMesh(const std::shared_ptr<sycl::queue>& queue,
+		     const std::vector<std::shared_ptr<Cartesian2DMesh>>& blocks,
+		     bool on_device)
+  : blocks_(blocks),
+    offsets_(queue, 3),
+    ncells_(queue, 0),
+    geotrans_(queue, 0),
+    clocks_(queue, 0),
+    cell_blocks_(queue, 0),
+    face_blocks_(queue, 0),
+    vertex_blocks_(queue, 0)
+{
+  if (blocks_.empty()) {
+    std::cerr << "ERROR: A multi-block mesh must have at least one block."
+	      << std::endl;
+    throw std::runtime_error("Invalid mesh block count.");
+  }
+  initialize_(on_device);
+}
+
+void MultiCartesian2DMesh::initialize_(bool on_device)
+{
+  std::vector<size_t>& offsets = offsets_.host_vector();
+  std::vector<size_t>& ncells = ncells_.host_vector();
+  std::vector<double>& geotrans = geotrans_.host_vector();
+  if (blocks_.size() > size_t(std::numeric_limits<uint16_t>::max()) + 1) {
+    std::cerr << "ERROR: A multi-block mesh can have at most "
+	      << size_t(std::numeric_limits<uint16_t>::max()) + 1
+	      << " blocks." << std::endl;
+    throw std::runtime_error("Invalid mesh block count.");
+  }
+  offsets.assign(3, 0);
+  for (const std::shared_ptr<Cartesian2DMesh>& block : blocks_) {
+    if (block->object_count<MeshComponent::Cell>() == 0) {
+      std::cerr << "ERROR: Block " << offsets.size() / 3 - 1
+		<< " of a multi-block mesh has no cells." << std::endl;
+      throw std::runtime_error("Empty mesh block.");
+    }
+    size_t b = offsets.size() - 3;
+    offsets.push_back(offsets[b] + block->object_count<MeshComponent::Cell>());
+    offsets.push_back(offsets[b + 1] + block->object_count<MeshComponent::Face>());
+    offsets.push_back(offsets[b + 2] + block->object_count<MeshComponent::Vertex>());
+    const std::vector<size_t>& nc = block->ncells_data().host_vector();
+    ncells.insert(ncells.end(), nc.begin(), nc.end());
+    const std::vector<double>& gt = block->geotrans_data().host_vector();
+    geotrans.insert(geotrans.end(), gt.begin(), gt.end());
+    uint16_t id = b / 3;
+    cell_blocks_.host_vector().resize(offsets[b + 3], id);
+    face_blocks_.host_vector().resize(offsets[b + 4], id);
+    vertex_blocks_.host_vector().resize(offsets[b + 5], id);
+  }
+  // Every block starts with a whole step
+  clocks_.host_vector().assign(2 * blocks_.size(), 0.0);
+  for (size_t b = 0; b < blocks_.size(); ++b) {
+    clocks_.host_vector()[2 * b + 1] = 1.0;
+  }
+
+  if (on_device) {
+    move_to_device();
+  }
+}
+
+void MultiCartesian2DMesh::set_block_clocks(const std::vector<double>& clocks)
+{
+  if (clocks.size() != 2 * blocks_.size()) {
+    throw std::logic_error("Block clocks do not match the number of blocks.");
+  }
+  clocks_.write_range(0, clocks.size(), clocks.data());
+}
+
+void MultiCartesian2DMesh::move_to_device(void)
+{
+  offsets_.move_to_device();
+  ncells_.move_to_device();
+  geotrans_.move_to_device();
+  clocks_.move_to_device();
+  cell_blocks_.move_to_device();
+  face_blocks_.move_to_device();
+  vertex_blocks_.move_to_device();
+}
+
+void MultiCartesian2DMesh::move_to_host(void)
+{
+  offsets_.move_to_host();
+  ncells_.move_to_host();
+  geotrans_.move_to_host();
+  clocks_.move_to_host();
+  cell_blocks_.move_to_host();
+  face_blocks_.move_to_host();
+  vertex_blocks_.move_to_host();
+}
+
+MultiCartesian2DMeshAccessor::
+MultiCartesian2DMeshAccessor(const MultiCartesian2DMesh& mcm)
+  : nblocks_(mcm.block_count()),
+    offsets_ro_(mcm.offsets_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    ncells_ro_(mcm.ncells_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    geotrans_ro_(mcm.geotrans_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    clocks_ro_(mcm.clocks_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    cell_blocks_ro_(mcm.cell_blocks_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    face_blocks_ro_(mcm.face_blocks_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    vertex_blocks_ro_(mcm.vertex_blocks_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>())
+{}
+
+void MultiCartesian2DMeshAccessor::bind(sycl::handler& cgh)
+{
+  cgh.require(offsets_ro_);
+  cgh.require(ncells_ro_);
+  cgh.require(geotrans_ro_);
+  cgh.require(clocks_ro_);
+  cgh.require(cell_blocks_ro_);
+  cgh.require(face_blocks_ro_);
+  cgh.require(vertex_blocks_ro_);
+}
@@ -0,0 +1,724 @@
+/***********************************************************************
+ * mfcm Mesh/MultiCartesian2DMesh.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_Mesh_MultiCartesian2DMesh_hpp
+#define mfcm_Mesh_MultiCartesian2DMesh_hpp
+
+#include "Cartesian2DMesh.hpp"
+
+#include <vector>
+
+class MultiCartesian2DMeshAccessor;
+
+/**
+   Several Cartesian meshes (blocks) numbered one after another in a
+   single index space, so that one kernel launch covers every block.
+   The cells, faces and vertices of block b are numbered from
+   block_offset<C>(b) in the order of the block (see Cartesian2DMesh),
+   and no face or stencil crosses from one block to another, so each
+   block is solved as if it were alone. Row-major outputs are those of
+   the blocks, one after another.
+
+   Each block also has a clock: the time since the start of the step
+   at which its current timestep started, and the length of that
+   timestep (see set_block_clocks). Kernels on this mesh read the time
+   and timestep of the block of each cell from its clock (see
+   has_block_clocks) instead of their arguments, so that the blocks
+   can take different timesteps (see SaintVenantPackedSolver).
+ */
+class MultiCartesian2DMesh
+{
+public:
+
+  using Accessor = MultiCartesian2DMeshAccessor;
+
+  static constexpr bool has_hanging_faces = false;
+
+  static constexpr bool has_face_normals = false;
+
+  /**
+     Each block keeps its own time (see set_block_clocks).
+   */
+  static constexpr bool has_block_clocks = true;
+
+private:
+
+  std::vector<std::shared_ptr<Cartesian2DMesh>> blocks_;
+
+  // The first cell, face and vertex id of each block, followed by the
+  // number of cells, faces and vertices
+  DataArray<size_t> offsets_;
+
+  // The cell counts and tile size (see Cartesian2DMesh) of each block
+  DataArray<size_t> ncells_;
+
+  // The geotransform of each block (see Cartesian2DMesh)
+  DataArray<double> geotrans_;
+
+  // The time since the start of the step at which the current
+  // timestep of each block started, and its length
+  DataArray<double> clocks_;
+
+  // The block of each cell, face and vertex, so that kernels need not
+  // search the offsets for it
+  DataArray<uint16_t> cell_blocks_;
+  DataArray<uint16_t> face_blocks_;
+  DataArray<uint16_t> vertex_blocks_;
+
+  void initialize_(bool on_device);
+
+  template<MeshComponent C>
+  static constexpr size_t component_index(void)
+  {
+    return (C == MeshComponent::Cell) ? 0 : (C == MeshComponent::Face) ? 1 : 2;
+  }
+
+  /**
+     Return the block whose ids of component C include i.
+   */
+  template<MeshComponent C>
+  size_t block_of_(const size_t& i) const
+  {
+    if constexpr (C == MeshComponent::Cell) {
+      return cell_blocks_.host_vector()[i];
+    } else if constexpr (C == MeshComponent::Face) {
+      return face_blocks_.host_vector()[i];
+    } else {
+      return vertex_blocks_.host_vector()[i];
+    }
+  }
+
+public:
+
+  /**
+     Construct from the mesh configuration, which describes one
+     Cartesian2DMesh. The mesh has "blocks" (default 1) copies of it.
+   */
+  MultiCartesian2DMesh(const std::shared_ptr<sycl::queue>& queue,
+		       bool on_device = true);
+
+  /**
+     Construct from the blocks, which must have at least one cell
+     each.
+   */
+  MultiCartesian2DMesh(const std::shared_ptr<sycl::queue>& queue,
+		       const std::vector<std::shared_ptr<Cartesian2DMesh>>& blocks,
+		       bool on_device = true);
+
+  ~MultiCartesian2DMesh(void)
+  {
+    std::cout << "Freeing memory for mesh." << std::endl;
+  }
+
+  const std::shared_ptr<sycl::queue>& queue_ptr(void)
+  {
+    return offsets_.queue_ptr();
+  }
+
+  bool is_on_device(void)
+  {
+    return offsets_.is_on_device();
+  }
+
+  void move_to_device(void);
+
+  void move_to_host(void);
+
+  /**
+     Return the number of blocks.
+   */
+  size_t block_count(void) const
+  {
+    return blocks_.size();
+  }
+
+  /**
+     Return the mesh of block b, whose ids are those of the block
+     less block_offset<C>(b).
+   */
+  const std::shared_ptr<Cartesian2DMesh>& block(const size_t& b) const
+  {
+    return blocks_.at(b);
+  }
+
+  /**
+     Return the id of the first object of component C in block b. The
+     offset of block block_count() is the number of objects.
+   */
+  template<MeshComponent C>
+  size_t block_offset(const size_t& b) const
+  {
+    return offsets_.host_vector().at(3 * b + component_index<C>());
+  }
+
+  /**
+     Set the clock of each block: clocks[2 * b] is the time since the
+     start of the step at which the current timestep of block b
+     started, and clocks[2 * b + 1] is its length.
+   */
+  void set_block_clocks(const std::vector<double>& clocks);
+
+  template<MeshComponent C>
+  inline size_t object_count(void) const
+  {
+    return block_offset<C>(blocks_.size());
+  }
+
+  template<MeshComponent C>
+  inline std::array<double,2> get_object_location(const size_t& i) const
+  {
+    size_t b = block_of_<C>(i);
+    return blocks_[b]->template get_object_location<C>(i - block_offset<C>(b));
+  }
+
+  /**
+     Return the id of the object of component C nearest to loc in the
+     first block that contains loc, or object_count<C>() if no block
+     contains it. Blocks may overlap, in which case only the first is
+     found.
+   */
+  template<MeshComponent C>
+  size_t get_nearest_object_index(const std::array<double,2>& loc) const
+  {
+    for (size_t b = 0; b < blocks_.size(); ++b) {
+      size_t id = blocks_[b]->template get_nearest_object_index<C>(loc);
+      if (id < blocks_[b]->template object_count<C>()) {
+	return block_offset<C>(b) + id;
+      }
+    }
+    return object_count<C>();
+  }
+
+  /**
+     Return the id of the object that is the i-th in row-major order,
+     which is that of the blocks one after another.
+   */
+  template<MeshComponent C>
+  size_t storage_index(const size_t& i) const
+  {
+    size_t b = block_of_<C>(i);
+    size_t offset = block_offset<C>(b);
+    return offset + blocks_[b]->template storage_index<C>(i - offset);
+  }
+
+  /**
+     Return the row-major position of the object with id i. This is
+     the inverse of storage_index.
+   */
+  template<MeshComponent C>
+  size_t row_major_index(const size_t& i) const
+  {
+    size_t b = block_of_<C>(i);
+    size_t offset = block_offset<C>(b);
+    return offset + blocks_[b]->template row_major_index<C>(i - offset);
+  }
+
+  template<MeshComponent C>
+  size_t row_major_count(void) const
+  {
+    return object_count<C>();
+  }
+
+  template<MeshComponent C>
+  std::array<double,2> get_row_major_location(const size_t& i) const
+  {
+    return get_object_location<C>(storage_index<C>(i));
+  }
+
+protected:
+
+  friend class MultiCartesian2DMeshAccessor;
+
+  const DataArray<size_t>& offsets_data(void) const { return offsets_; }
+  const DataArray<size_t>& ncells_data(void) const { return ncells_; }
+  const DataArray<double>& geotrans_data(void) const { return geotrans_; }
+  const DataArray<double>& clocks_data(void) const { return clocks_; }
+  const DataArray<uint16_t>& cell_blocks_data(void) const { return cell_blocks_; }
+  const DataArray<uint16_t>& face_blocks_data(void) const { return face_blocks_; }
+  const DataArray<uint16_t>& vertex_blocks_data(void) const { return vertex_blocks_; }
+
+};
+
+class MultiCartesian2DMeshAccessor
+{
+protected:
+
+  using SizeAccessor =
+    typename DataArray<size_t>::
+    template Accessor<sycl::access::mode::read,
+		      sycl::access::target::global_buffer,
+		      sycl::access::placeholder::true_t>;
+
+  using DoubleAccessor =
+    typename DataArray<double>::
+    template Accessor<sycl::access::mode::read,
+		      sycl::access::target::global_buffer,
+		      sycl::access::placeholder::true_t>;
+
+  using BlockAccessor =
+    typename DataArray<uint16_t>::
+    template Accessor<sycl::access::mode::read,
+		      sycl::access::target::global_buffer,
+		      sycl::access::placeholder::true_t>;
+
+  size_t nblocks_;
+
+  SizeAccessor offsets_ro_;
+
+  SizeAccessor ncells_ro_;
+
+  DoubleAccessor geotrans_ro_;
+
+  DoubleAccessor clocks_ro_;
+
+  BlockAccessor cell_blocks_ro_;
+
+  BlockAccessor face_blocks_ro_;
+
+  BlockAccessor vertex_blocks_ro_;
+
+  template<MeshComponent C>
+  static constexpr size_t component_index(void)
+  {
+    return (C == MeshComponent::Cell) ? 0 : (C == MeshComponent::Face) ? 1 : 2;
+  }
+
+  /**
+     Return the block whose ids of component C include i.
+   */
+  template<MeshComponent C>
+  inline size_t block_of(const size_t& i) const
+  {
+    if constexpr (C == MeshComponent::Cell) {
+      return cell_blocks_ro_[i];
+    } else if constexpr (C == MeshComponent::Face) {
+      return face_blocks_ro_[i];
+    } else {
+      return vertex_blocks_ro_[i];
+    }
+  }
+
+  template<MeshComponent C>
+  inline const size_t& offset(const size_t& b) const
+  {
+    return offsets_ro_[3 * b + component_index<C>()];
+  }
+
+  inline const size_t& nxcells(const size_t& b) const { return ncells_ro_[3 * b]; }
+  inline const size_t& nycells(const size_t& b) const { return ncells_ro_[3 * b + 1]; }
+
+  inline const double& origin_x(const size_t& b) const { return geotrans_ro_[12 * b]; }
+  inline const double& cell_width(const size_t& b) const { return geotrans_ro_[12 * b + 1]; }
+  inline const double& row_rotation(const size_t& b) const { return geotrans_ro_[12 * b + 2]; }
+  inline const double& origin_y(const size_t& b) const { return geotrans_ro_[12 * b + 3]; }
+  inline const double& col_rotation(const size_t& b) const { return geotrans_ro_[12 * b + 4]; }
+  inline const double& cell_height(const size_t& b) const { return geotrans_ro_[12 * b + 5]; }
+  inline const double& inv_cell_width(const size_t& b) const { return geotrans_ro_[12 * b + 6]; }
+  inline const double& inv_cell_height(const size_t& b) const { return geotrans_ro_[12 * b + 7]; }
+  inline const double& inv_cell_size(const size_t& b) const { return geotrans_ro_[12 * b + 8]; }
+  inline const double& inv_denom(const size_t& b) const { return geotrans_ro_[12 * b + 9]; }
+  inline const double& block_dx(const size_t& b) const { return geotrans_ro_[12 * b + 10]; }
+  inline const double& block_dy(const size_t& b) const { return geotrans_ro_[12 * b + 11]; }
+
+  // Ids and coordinates of the objects of block b, which are
+  // numbered in row-major order as in Cartesian2DMesh
+  inline size_t cell_index(const size_t& b, const size_t& x, const size_t& y) const
+  {
+    return offset<MeshComponent::Cell>(b) +
+      RowMajorOrdering::index(x, y, nxcells(b), nycells(b), 0);
+  }
+  inline std::array<size_t,2> cell_coordinate(const size_t& b, const size_t& i) const
+  {
+    return RowMajorOrdering::coordinate(i - offset<MeshComponent::Cell>(b),
+					nxcells(b), nycells(b), 0);
+  }
+  inline size_t vface_index(const size_t& b, const size_t& x, const size_t& y) const
+  {
+    return offset<MeshComponent::Face>(b) +
+      RowMajorOrdering::index(x, y, nxcells(b) + 1, nycells(b), 0);
+  }
+  inline std::array<size_t,2> vface_coordinate(const size_t& b, const size_t& i) const
+  {
+    return RowMajorOrdering::coordinate(i - offset<MeshComponent::Face>(b),
+					nxcells(b) + 1, nycells(b), 0);
+  }
+  inline size_t hface_index(const size_t& b, const size_t& x, const size_t& y) const
+  {
+    return offset<MeshComponent::Face>(b) + (nxcells(b) + 1) * nycells(b) +
+      RowMajorOrdering::index(x, y, nxcells(b), nycells(b) + 1, 0);
+  }
+  inline std::array<size_t,2> hface_coordinate(const size_t& b, const size_t& i) const
+  {
+    return RowMajorOrdering::coordinate(i - offset<MeshComponent::Face>(b) -
+					(nxcells(b) + 1) * nycells(b),
+					nxcells(b), nycells(b) + 1, 0);
+  }
+  inline bool is_vface(const size_t& b, const size_t& i) const
+  {
+    return i - offset<MeshComponent::Face>(b) < (nxcells(b) + 1) * nycells(b);
+  }
+  inline size_t vertex_index(const size_t& b, const size_t& x, const size_t& y) const
+  {
+    return offset<MeshComponent::Vertex>(b) +
+      RowMajorOrdering::index(x, y, nxcells(b) + 1, nycells(b) + 1, 0);
+  }
+  inline std::array<size_t,2> vertex_coordinate(const size_t& b, const size_t& i) const
+  {
+    return RowMajorOrdering::coordinate(i - offset<MeshComponent::Vertex>(b),
+					nxcells(b) + 1, nycells(b) + 1, 0);
+  }
+
+  inline std::array<double,2> get_location(const size_t& b,
+					   const std::array<double,2>& ic) const
+  {
+    return { origin_x(b) + ic[0] * cell_width(b) + ic[1] * row_rotation(b),
+      origin_y(b) + ic[0] * col_rotation(b) + ic[1] * cell_height(b) };
+  }
+
+  inline std::array<double,2> get_coordinate(const size_t& b,
+					     const std::array<double,2>& c) const
+  {
+    return
+      {
+	((c[0] - origin_x(b)) * inv_cell_width(b) -
+	 (c[1] - origin_y(b)) * row_rotation(b) * inv_cell_size(b)) * inv_denom(b),
+	((c[1] - origin_y(b)) * inv_cell_height(b) -
+	 (c[0] - origin_x(b)) * col_rotation(b) * inv_cell_size(b)) * inv_denom(b)
+      };
+  }
+
+  inline bool contains(const size_t& b, const std::array<double,2>& coord) const
+  {
+    return (coord[0] >= 0.0 and coord[0] < nxcells(b) and
+	    coord[1] >= 0.0 and coord[1] < nycells(b));
+  }
+
+public:
+
+  static constexpr bool has_hanging_faces = false;
+
+  static constexpr bool has_face_normals = false;
+
+  static constexpr bool has_block_clocks = true;
+
+  /**
+     Width and height of cell i, which are those of its block.
+   */
+  inline const double& dx(const size_t& i) const
+  {
+    return block_dx(block_of<MeshComponent::Cell>(i));
+  }
+  inline const double& dy(const size_t& i) const
+  {
+    return block_dy(block_of<MeshComponent::Cell>(i));
+  }
+
+  MultiCartesian2DMeshAccessor(const MultiCartesian2DMesh& mcm);
+
+  void bind(sycl::handler& cgh);
+
+  template<MeshComponent C>
+  inline size_t object_count(void) const
+  {
+    return offset<C>(nblocks_);
+  }
+
+  struct block_clock_result
+  {
+    double time_now;
+    double timestep;
+  };
+
+  /**
+     Return the time since the start of the step and the timestep of
+     the block of cell i, at the fraction tau of its current timestep.
+   */
+  inline block_clock_result block_clock(const size_t& i, const double& tau) const
+  {
+    size_t b = block_of<MeshComponent::Cell>(i);
+    return { clocks_ro_[2 * b] + tau * clocks_ro_[2 * b + 1], clocks_ro_[2 * b + 1] };
+  }
+
+  inline double cell_area(const size_t& i) const
+  {
+    size_t b = block_of<MeshComponent::Cell>(i);
+    return block_dx(b) * block_dy(b);
+  }
+
+  template<MeshComponent C>
+  inline std::array<double,2> get_object_location(const size_t& i) const;
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t b = block_of<MeshComponent::Cell>(i);
+    std::array<size_t,2> c = cell_coordinate(b, i);
+    return get_location(b, { (double)c[0] + 0.5, (double)c[1] + 0.5 });
+  }
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Face>(const size_t& i) const
+  {
+    size_t b = block_of<MeshComponent::Face>(i);
+    if (is_vface(b, i)) {
+      std::array<size_t,2> c = vface_coordinate(b, i);
+      return get_location(b, { (double)c[0], (double)c[1] + 0.5 });
+    } else {
+      std::array<size_t,2> c = hface_coordinate(b, i);
+      return get_location(b, { (double)c[0] + 0.5, (double)c[1] });
+    }
+  }
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Vertex>(const size_t& i) const
+  {
+    size_t b = block_of<MeshComponent::Vertex>(i);
+    std::array<size_t,2> c = vertex_coordinate(b, i);
+    return get_location(b, { (double)c[0], (double)c[1] });
+  }
+
+  /**
+     As MultiCartesian2DMesh::get_nearest_object_index.
+   */
+  template<MeshComponent C>
+  size_t get_nearest_object_index(const std::array<double,2>& loc) const;
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Cell>(const std::array<double,2>& loc) const
+  {
+    for (size_t b = 0; b < nblocks_; ++b) {
+      std::array<double,2> coord = get_coordinate(b, loc);
+      if (contains(b, coord)) {
+	return cell_index(b, (size_t)coord[0], (size_t)coord[1]);
+      }
+    }
+    return object_count<MeshComponent::Cell>();
+  }
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Face>(const std::array<double,2>& loc) const
+  {
+    for (size_t b = 0; b < nblocks_; ++b) {
+      std::array<double,2> coord = get_coordinate(b, loc);
+      if (not contains(b, coord)) {
+	continue;
+      }
+      // The nearest face is the side of the containing cell nearest
+      // to loc
+      size_t cx = (size_t)coord[0];
+      size_t cy = (size_t)coord[1];
+      double rx = coord[0] - cx;
+      double ry = coord[1] - cy;
+      double dx_min = ((rx < 0.5) ? rx : 1.0 - rx) * cell_width(b);
+      double dy_min = ((ry < 0.5) ? ry : 1.0 - ry) * cell_height(b);
+      if (dx_min * dx_min <= dy_min * dy_min) {
+	return vface_index(b, cx + (rx < 0.5 ? 0 : 1), cy);
+      } else {
+	return hface_index(b, cx, cy + (ry < 0.5 ? 0 : 1));
+      }
+    }
+    return object_count<MeshComponent::Face>();
+  }
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Vertex>(const std::array<double,2>& loc) const
+  {
+    for (size_t b = 0; b < nblocks_; ++b) {
+      std::array<double,2> coord = get_coordinate(b, loc);
+      if (contains(b, coord)) {
+	return vertex_index(b, (size_t)(coord[0] + 0.5), (size_t)(coord[1] + 0.5));
+      }
+    }
+    return object_count<MeshComponent::Vertex>();
+  }
+
+  struct get_adjacent_cells_result
+  {
+    size_t lhs_id;
+    size_t rhs_id;
+    int edge;
+    int dir;
+    double dx;
+  };
+
+  /**
+     As get_adjacent_cells on a Cartesian2DMesh. The faces at the
+     edge of a block are at the edge of the mesh.
+   */
+  get_adjacent_cells_result get_adjacent_cells(const size_t& face_id) const
+  {
+    get_adjacent_cells_result result;
+    size_t b = block_of<MeshComponent::Face>(face_id);
+
+    if (is_vface(b, face_id)) {
+      // Face is vertical and has cells to the left and right.
+      result.dir = 0;
+      result.dx = block_dx(b);
+      auto [ fxid, fyid ] = vface_coordinate(b, face_id);
+
+      if (fxid < nxcells(b)) {
+	result.rhs_id = cell_index(b, fxid, fyid);
+	if (fxid > 0) {
+	  result.edge = 0;
+	  result.lhs_id = cell_index(b, fxid - 1, fyid);
+	} else {
+	  result.edge = -1;
+	  result.lhs_id = result.rhs_id;
+	}
+      } else {
+	result.lhs_id = cell_index(b, fxid - 1, fyid);
+	result.rhs_id = result.lhs_id;
+	result.edge = 1;
+      }
+    } else {
+      // Face is horizontal and has cells above and below
+      result.dir = 1;
+      result.dx = block_dy(b);
+      auto [ fxid, fyid ] = hface_coordinate(b, face_id);
+
+      if (fyid < nycells(b)) {
+	result.rhs_id = cell_index(b, fxid, fyid);
+	if (fyid > 0) {
+	  result.edge = 0;
+	  result.lhs_id = cell_index(b, fxid, fyid - 1);
+	} else {
+	  result.edge = -1;
+	  result.lhs_id = result.rhs_id;
+	}
+      } else {
+	result.lhs_id = cell_index(b, fxid, fyid - 1);
+	result.rhs_id = result.lhs_id;
+	result.edge = 1;
+      }
+    }
+
+    return result;
+  }
+
+  struct get_adjacent_faces_result
+  {
+    size_t face_w;
+    size_t face_e;
+    double dx;
+    size_t face_s;
+    size_t face_n;
+    double dy;
+  };
+
+  get_adjacent_faces_result get_adjacent_faces(const size_t& cell_id) const
+  {
+    size_t b = block_of<MeshComponent::Cell>(cell_id);
+    auto [ cxid, cyid ] = cell_coordinate(b, cell_id);
+
+    get_adjacent_faces_result result;
+    result.face_w = vface_index(b, cxid, cyid);
+    result.face_e = vface_index(b, cxid + 1, cyid);
+    result.dx = block_dx(b);
+    result.face_s = hface_index(b, cxid, cyid);
+    result.face_n = hface_index(b, cxid, cyid + 1);
+    result.dy = block_dy(b);
+    return result;
+  }
+
+  struct get_hanging_faces_result
+  {
+    size_t face_w;
+    size_t face_e;
+    size_t face_s;
+    size_t face_n;
+  };
+
+  /**
+     Return the second face on each side of a cell. Sides are never
+     split, so these are the faces returned by get_adjacent_faces.
+   */
+  get_hanging_faces_result get_hanging_faces(const size_t& cell_id) const
+  {
+    auto [ face_w, face_e, dx, face_s, face_n, dy ] = get_adjacent_faces(cell_id);
+    return { face_w, face_e, face_s, face_n };
+  }
+
+  struct offset_type
+  {
+    size_t i;
+    double dx;
+  };
+
+  template<MeshComponent C>
+  offset_type get_object_west(const size_t& i) const;
+  template<MeshComponent C>
+  offset_type get_object_east(const size_t& i) const;
+  template<MeshComponent C>
+  offset_type get_object_north(const size_t& i) const;
+  template<MeshComponent C>
+  offset_type get_object_south(const size_t& i) const;
+
+  template<>
+  offset_type get_object_west<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t b = block_of<MeshComponent::Cell>(i);
+    std::array<size_t,2> c = cell_coordinate(b, i);
+    if (c[0] > 0) {
+      return { cell_index(b, c[0] - 1, c[1]), block_dx(b) };
+    } else {
+      return { i, 0.0 };
+    }
+  }
+
+  template<>
+  offset_type get_object_east<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t b = block_of<MeshComponent::Cell>(i);
+    std::array<size_t,2> c = cell_coordinate(b, i);
+    if (c[0] < nxcells(b) - 1) {
+      return { cell_index(b, c[0] + 1, c[1]), block_dx(b) };
+    } else {
+      return { i, 0.0 };
+    }
+  }
+
+  template<>
+  offset_type get_object_north<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t b = block_of<MeshComponent::Cell>(i);
+    std::array<size_t,2> c = cell_coordinate(b, i);
+    if (c[1] < nycells(b) - 1) {
+      return { cell_index(b, c[0], c[1] + 1), block_dy(b) };
+    } else {
+      return { i, 0.0 };
+    }
+  }
+
+  template<>
+  offset_type get_object_south<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t b = block_of<MeshComponent::Cell>(i);
+    std::array<size_t,2> c = cell_coordinate(b, i);
+    if (c[1] > 0) {
+      return { cell_index(b, c[0], c[1] - 1), block_dy(b) };
+    } else {
+      return { i, 0.0 };
+    }
+  }
+
+};
+
+#endif
@@ -0,0 +1,427 @@
+/***********************************************************************
+ * mfcm Mesh/QuadtreeMesh.cpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#include "QuadtreeMesh.hpp"
+#include "Config.hpp"
+#include "Raster.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+
+namespace {
+
+  /**
+     A cell of a quadtree under construction, with its corner and size
+     in finest cells.
+   */
+  struct QuadtreeLeaf
+  {
+    size_t ix;
+    size_t iy;
+    size_t s;
+    size_t id;
+  };
+
+  /**
+     Summary of the bed levels within a square of finest cells.
+   */
+  struct QuadtreeBedStats
+  {
+    double zmin = std::numeric_limits<double>::infinity();
+    double zmax = -std::numeric_limits<double>::infinity();
+    bool has_nan = false;
+    bool has_value = false;
+    bool forced = false;
+
+    void combine(const QuadtreeBedStats& o)
+    {
+      zmin = std::min(zmin, o.zmin);
+      zmax = std::max(zmax, o.zmax);
+      has_nan = has_nan or o.has_nan;
+      has_value = has_value or o.has_value;
+      forced = forced or o.forced;
+    }
+  };
+
+}
+
+void QuadtreeMesh::build_(const Config& conf)
+{
+  using Ops = QuadtreeMeshOps;
+
+  std::array<size_t,2> ncells =
+    split_string<size_t,2>(conf.get<std::string>("cell count"));
+  std::array<double,2> origin =
+    split_string<double,2>(conf.get<std::string>("origin", "0.0, 0.0"));
+  std::array<double,2> cellsize =
+    split_string<double,2>(conf.get<std::string>("cell size"));
+  size_t levels = conf.get<size_t>("levels", 0);
+  size_t r = size_t(1) << levels;
+  if (ncells[0] % r != 0 or ncells[1] % r != 0) {
+    std::cerr << "ERROR: The quadtree mesh cell count must be a multiple of "
+	      << r << " (2^levels) in each direction." << std::endl;
+    throw std::runtime_error("Invalid quadtree mesh cell count.");
+  }
+  size_t nbx = ncells[0] / r;
+  size_t nby = ncells[1] / r;
+
+  geom_.host_vector() = { origin[0], origin[1], cellsize[0], cellsize[1] };
+  std::vector<size_t>& dims = dims_.host_vector();
+  dims.assign(Ops::size, 0);
+  dims[Ops::nx] = ncells[0];
+  dims[Ops::ny] = ncells[1];
+  dims[Ops::root] = r;
+  dims[Ops::nbx] = nbx;
+  dims[Ops::nby] = nby;
+
+  // Bed levels used for refinement, sampled at the centres of the
+  // finest cells
+  double bed_range = conf.get<double>("refine bed range",
+				      std::numeric_limits<double>::infinity());
+  std::string bed_name = conf.get<std::string>("refine bed", "");
+  std::shared_ptr<RasterField<double>> bed;
+  std::vector<double> bed_values;
+  if (bed_name != "") {
+    bed = RasterDatabase<double>::instance().
+      get_raster_field_ptr(queue_ptr(), bed_name);
+    DataArray<double> values(bed->data());
+    values.move_to_host();
+    bed_values = values.host_vector();
+  }
+  auto sample_bed = [&](size_t fx, size_t fy) -> double
+  {
+    if (not bed) return 0.0;
+    std::array<double,2> loc = Ops::location(geom_.host_vector(),
+					     fx + 0.5, fy + 0.5);
+    size_t j = bed->mesh()->get_nearest_object_index<MeshComponent::Cell>(loc);
+    if (j >= bed_values.size()) {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    return bed_values[j];
+  };
+
+  // Finest cells that must not be coarsened
+  std::map<size_t, std::vector<size_t>> forced;
+  if (conf.count("refine at") > 0) {
+    GeometryCollection gc(conf.get_child("refine at"));
+    for (auto&& geom_ptr : gc) {
+      if (geom_ptr->type() != Geometry::Type::point) {
+	std::cerr << "Cannot refine a quadtree mesh with geometry of type: "
+		  << geom_ptr->type_str() << std::endl;
+	throw std::runtime_error("Cannot refine a quadtree mesh with this type of geometry.");
+      }
+      auto pt = std::dynamic_pointer_cast<Point>(geom_ptr);
+      double fx, fy;
+      if (Ops::coordinate(dims, geom_.host_vector(), {pt->at(0), pt->at(1)},
+			  fx, fy)) {
+	size_t b = ((size_t)fy / r) * nbx + (size_t)fx / r;
+	forced[b].push_back(((size_t)fy % r) * r + (size_t)fx % r);
+      }
+    }
+  }
+
+  // Leaves keyed by root cell and then Morton order within it, which
+  // is the order in which cells are numbered
+  std::map<size_t, QuadtreeLeaf> leaves;
+  auto leaf_key = [&](size_t fx, size_t fy)
+  {
+    size_t bx = fx / r;
+    size_t by = fy / r;
+    return (by * nbx + bx) * r * r + Ops::morton(fx - bx * r, fy - by * r);
+  };
+  auto add_leaf = [&](size_t ix, size_t iy, size_t s)
+  {
+    leaves[leaf_key(ix, iy)] = { ix, iy, s, 0 };
+  };
+  auto find_leaf = [&](size_t fx, size_t fy) -> QuadtreeLeaf&
+  {
+    auto it = leaves.upper_bound(leaf_key(fx, fy));
+    return (--it)->second;
+  };
+
+  // Refine each root cell from the top down, using a pyramid of bed
+  // level statistics built from the bottom up
+  for (size_t by = 0; by < nby; ++by) {
+    for (size_t bx = 0; bx < nbx; ++bx) {
+      std::vector<std::vector<QuadtreeBedStats>> pyramid(levels + 1);
+      pyramid[0].resize(r * r);
+      for (size_t ly = 0; ly < r; ++ly) {
+	for (size_t lx = 0; lx < r; ++lx) {
+	  double z = sample_bed(bx * r + lx, by * r + ly);
+	  QuadtreeBedStats& st = pyramid[0][ly * r + lx];
+	  if (z != z) {
+	    st.has_nan = true;
+	  } else {
+	    st.has_value = true;
+	    st.zmin = z;
+	    st.zmax = z;
+	  }
+	}
+      }
+      auto fit = forced.find(by * nbx + bx);
+      if (fit != forced.end()) {
+	for (auto&& k : fit->second) pyramid[0][k].forced = true;
+      }
+      for (size_t l = 1; l <= levels; ++l) {
+	size_t n = r >> l;
+	pyramid[l].resize(n * n);
+	for (size_t ly = 0; ly < 2 * n; ++ly) {
+	  for (size_t lx = 0; lx < 2 * n; ++lx) {
+	    pyramid[l][(ly / 2) * n + lx / 2].combine(pyramid[l-1][ly * 2 * n + lx]);
+	  }
+	}
+      }
+
+      std::function<void(size_t,size_t,size_t)> refine =
+	[&](size_t lx, size_t ly, size_t l)
+      {
+	size_t s = size_t(1) << l;
+	const QuadtreeBedStats& st = pyramid[l][(ly >> l) * (r >> l) + (lx >> l)];
+	bool divide = l > 0 and
+	  (st.forced or (st.has_nan and st.has_value) or
+	   (st.has_value and st.zmax - st.zmin > bed_range));
+	if (divide) {
+	  size_t h = s / 2;
+	  refine(lx, ly, l - 1);
+	  refine(lx + h, ly, l - 1);
+	  refine(lx, ly + h, l - 1);
+	  refine(lx + h, ly + h, l - 1);
+	} else {
+	  add_leaf(bx * r + lx, by * r + ly, s);
+	}
+      };
+      refine(0, 0, levels);
+    }
+  }
+
+  // Divide cells until neighbouring cells differ in size by at most
+  // a factor of two
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    std::vector<QuadtreeLeaf> to_divide;
+    for (auto&& kv : leaves) {
+      const QuadtreeLeaf& c = kv.second;
+      if (c.s <= 2) continue;
+      bool divide = false;
+      // West and east sides
+      for (int side = 0; side < 2 and not divide; ++side) {
+	if ((side == 0 and c.ix == 0) or
+	    (side == 1 and c.ix + c.s == ncells[0])) continue;
+	size_t fx = (side == 0) ? c.ix - 1 : c.ix + c.s;
+	for (size_t fy = c.iy; fy < c.iy + c.s and not divide; ) {
+	  const QuadtreeLeaf& n = find_leaf(fx, fy);
+	  divide = (n.s < c.s / 2);
+	  fy = n.iy + n.s;
+	}
+      }
+      // South and north sides
+      for (int side = 0; side < 2 and not divide; ++side) {
+	if ((side == 0 and c.iy == 0) or
+	    (side == 1 and c.iy + c.s == ncells[1])) continue;
+	size_t fy = (side == 0) ? c.iy - 1 : c.iy + c.s;
+	for (size_t fx = c.ix; fx < c.ix + c.s and not divide; ) {
+	  const QuadtreeLeaf& n = find_leaf(fx, fy);
+	  divide = (n.s < c.s / 2);
+	  fx = n.ix + n.s;
+	}
+      }
+      if (divide) to_divide.push_back(c);
+    }
+    for (auto&& c : to_divide) {
+      size_t h = c.s / 2;
+      leaves.erase(leaf_key(c.ix, c.iy));
+      add_leaf(c.ix, c.iy, h);
+      add_leaf(c.ix + h, c.iy, h);
+      add_leaf(c.ix, c.iy + h, h);
+      add_leaf(c.ix + h, c.iy + h, h);
+      changed = true;
+    }
+  }
+
+  // Number the cells
+  std::vector<uint32_t>& cells = cells_.host_vector();
+  std::vector<size_t>& block_first = block_first_.host_vector();
+  cells.clear();
+  block_first.assign(nbx * nby + 1, 0);
+  size_t id = 0;
+  for (auto&& kv : leaves) {
+    QuadtreeLeaf& c = kv.second;
+    c.id = id++;
+    cells.push_back(c.ix);
+    cells.push_back(c.iy);
+    cells.push_back(c.s);
+    block_first[kv.first / (r * r) + 1] = id;
+  }
+  for (size_t b = 1; b < block_first.size(); ++b) {
+    block_first[b] = std::max(block_first[b], block_first[b-1]);
+  }
+  dims[Ops::ncells] = id;
+
+  // Create the faces. Each face between two cells is created from the
+  // smaller cell, or from the east/north cell if they are the same
+  // size. Faces on the edges of the mesh join a cell to itself.
+  struct FaceRecord { size_t lhs; size_t rhs; int edge; };
+  std::vector<FaceRecord> xfaces;
+  std::vector<FaceRecord> yfaces;
+  for (auto&& kv : leaves) {
+    const QuadtreeLeaf& c = kv.second;
+    if (c.ix == 0) {
+      xfaces.push_back({ c.id, c.id, -1 });
+    } else {
+      const QuadtreeLeaf& n = find_leaf(c.ix - 1, c.iy);
+      if (n.s >= c.s) xfaces.push_back({ n.id, c.id, 0 });
+    }
+    if (c.ix + c.s == ncells[0]) {
+      xfaces.push_back({ c.id, c.id, 1 });
+    } else {
+      const QuadtreeLeaf& n = find_leaf(c.ix + c.s, c.iy);
+      if (n.s > c.s) xfaces.push_back({ c.id, n.id, 0 });
+    }
+    if (c.iy == 0) {
+      yfaces.push_back({ c.id, c.id, -1 });
+    } else {
+      const QuadtreeLeaf& n = find_leaf(c.ix, c.iy - 1);
+      if (n.s >= c.s) yfaces.push_back({ n.id, c.id, 0 });
+    }
+    if (c.iy + c.s == ncells[1]) {
+      yfaces.push_back({ c.id, c.id, 1 });
+    } else {
+      const QuadtreeLeaf& n = find_leaf(c.ix, c.iy + c.s);
+      if (n.s > c.s) yfaces.push_back({ c.id, n.id, 0 });
+    }
+  }
+
+  // Record the faces on each side of each cell: two slots each for
+  // the west, east, south and north sides
+  const size_t unset = std::numeric_limits<size_t>::max();
+  std::vector<size_t>& face_cells = face_cells_.host_vector();
+  std::vector<int32_t>& face_info = face_info_.host_vector();
+  std::vector<size_t>& cell_faces = cell_faces_.host_vector();
+  face_cells.clear();
+  face_info.clear();
+  cell_faces.assign(8 * id, unset);
+  auto add_to_side = [&](size_t c, size_t side, size_t f)
+  {
+    size_t k = 8 * c + 2 * side;
+    cell_faces[(cell_faces[k] == unset) ? k : k + 1] = f;
+  };
+  for (int dir = 0; dir < 2; ++dir) {
+    for (auto&& fr : (dir == 0) ? xfaces : yfaces) {
+      size_t f = face_cells.size() / 2;
+      face_cells.push_back(fr.lhs);
+      face_cells.push_back(fr.rhs);
+      face_info.push_back(fr.edge);
+      face_info.push_back(dir);
+      // Sides are 0: west, 1: east, 2: south, 3: north
+      if (fr.edge != -1) add_to_side(fr.lhs, 2 * dir + 1, f);
+      if (fr.edge != 1) add_to_side(fr.rhs, 2 * dir, f);
+    }
+  }
+  for (size_t k = 0; k < cell_faces.size(); k += 2) {
+    if (cell_faces[k + 1] == unset) cell_faces[k + 1] = cell_faces[k];
+  }
+  dims[Ops::nfaces] = face_cells.size() / 2;
+
+  // The vertices are the corners of the cells
+  std::vector<size_t>& vertices = vertices_.host_vector();
+  vertices.clear();
+  for (auto&& kv : leaves) {
+    const QuadtreeLeaf& c = kv.second;
+    for (size_t k = 0; k < 4; ++k) {
+      size_t vx = c.ix + (k % 2) * c.s;
+      size_t vy = c.iy + (k / 2) * c.s;
+      vertices.push_back(vy * (ncells[0] + 1) + vx);
+    }
+  }
+  std::sort(vertices.begin(), vertices.end());
+  vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+  dims[Ops::nvertices] = vertices.size();
+
+  std::cout << "Quadtree mesh has " << dims[Ops::ncells] << " cells ("
+	    << ncells[0] * ncells[1] << " at the finest resolution)."
+	    << std::endl;
+}
+
+QuadtreeMesh::
+QuadtreeMesh(const std::shared_ptr<sycl::queue>& queue,
+	     bool on_device)
+  : dims_(queue, 0),
+    geom_(queue, 0),
+    cells_(queue, 0),
+    block_first_(queue, 0),
+    face_cells_(queue, 0),
+    face_info_(queue, 0),
+    cell_faces_(queue, 0),
+    vertices_(queue, 0)
+{
+  build_(GlobalConfig::instance().mesh_configuration());
+  if (on_device) {
+    move_to_device();
+  }
+}
+
+void QuadtreeMesh::move_to_device(void)
+{
+  dims_.move_to_device();
+  geom_.move_to_device();
+  cells_.move_to_device();
+  block_first_.move_to_device();
+  face_cells_.move_to_device();
+  face_info_.move_to_device();
+  cell_faces_.move_to_device();
+  vertices_.move_to_device();
+}
+
+void QuadtreeMesh::move_to_host(void)
+{
+  dims_.move_to_host();
+  geom_.move_to_host();
+  cells_.move_to_host();
+  block_first_.move_to_host();
+  face_cells_.move_to_host();
+  face_info_.move_to_host();
+  cell_faces_.move_to_host();
+  vertices_.move_to_host();
+}
+
+QuadtreeMeshAccessor::
+QuadtreeMeshAccessor(const QuadtreeMesh& qm)
+  : dims_ro_(qm.dims_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    geom_ro_(qm.geom_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    cells_ro_(qm.cells_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    block_first_ro_(qm.block_first_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    face_cells_ro_(qm.face_cells_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    face_info_ro_(qm.face_info_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    cell_faces_ro_(qm.cell_faces_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    vertices_ro_(qm.vertices_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>())
+{}
+
+void QuadtreeMeshAccessor::bind(sycl::handler& cgh)
+{
+  cgh.require(dims_ro_);
+  cgh.require(geom_ro_);
+  cgh.require(cells_ro_);
+  cgh.require(block_first_ro_);
+  cgh.require(face_cells_ro_);
+  cgh.require(face_info_ro_);
+  cgh.require(cell_faces_ro_);
+  cgh.require(vertices_ro_);
+}
@@ -0,0 +1,698 @@
+/***********************************************************************
+ * mfcm Mesh/QuadtreeMesh.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_Mesh_QuadtreeMesh_hpp
+#define mfcm_Mesh_QuadtreeMesh_hpp
+
+#include "Mesh.hpp"
+#include "DataArray.hpp"
+#include "Config.hpp"
+#include "../Geometry/Geometry.hpp"
+
+class QuadtreeMeshAccessor;
+
+/**
+   Index arithmetic shared by QuadtreeMesh (on the host) and
+   QuadtreeMeshAccessor (on the device). The mesh arrays are passed as
+   anything that can be indexed with [], so that the same code reads
+   host vectors and SYCL accessors.
+
+   The dims array holds, in order: the number of finest cells in x and
+   y, the root cell size (in finest cells), the number of root cells in
+   x and y, and the numbers of cells, faces and vertices.
+ */
+struct QuadtreeMeshOps
+{
+  enum Dim : size_t
+    {
+      nx = 0,
+      ny,
+      root,
+      nbx,
+      nby,
+      ncells,
+      nfaces,
+      nvertices,
+      size
+    };
+
+  /**
+     Interleave the bits of x and y.
+   */
+  static inline size_t morton(size_t x, size_t y)
+  {
+    size_t m = 0;
+    for (size_t b = 0; x > 0 or y > 0; ++b) {
+      m |= (x & 1) << (2 * b);
+      m |= (y & 1) << (2 * b + 1);
+      x >>= 1;
+      y >>= 1;
+    }
+    return m;
+  }
+
+  /**
+     Return the id of the cell containing the finest cell (fx, fy).
+   */
+  template<typename D, typename C, typename B>
+  static size_t find_cell(const D& dims, const C& cells, const B& block_first,
+			  const size_t& fx, const size_t& fy)
+  {
+    size_t r = dims[root];
+    size_t bx = fx / r;
+    size_t by = fy / r;
+    size_t b = by * dims[nbx] + bx;
+    size_t key = morton(fx - bx * r, fy - by * r);
+    // Cells within a root cell are stored in Morton order, so the
+    // containing cell is the last whose corner key is not after ours
+    size_t lo = block_first[b];
+    size_t hi = block_first[b + 1];
+    while (hi - lo > 1) {
+      size_t mid = lo + (hi - lo) / 2;
+      size_t mkey = morton(cells[3 * mid] - bx * r, cells[3 * mid + 1] - by * r);
+      if (mkey <= key) {
+	lo = mid;
+      } else {
+	hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  /**
+     Return the id of the vertex with the given row-major key, or the
+     vertex count if there is no such vertex.
+   */
+  template<typename D, typename V>
+  static size_t find_vertex(const D& dims, const V& vertices, const size_t& key)
+  {
+    size_t lo = 0;
+    size_t hi = dims[nvertices];
+    while (hi > lo) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (vertices[mid] < key) {
+	lo = mid + 1;
+      } else {
+	hi = mid;
+      }
+    }
+    return (lo < dims[nvertices] and vertices[lo] == key) ? lo : dims[nvertices];
+  }
+
+  template<typename G>
+  static std::array<double,2> location(const G& geom,
+				       const double& fx, const double& fy)
+  {
+    return { geom[0] + fx * geom[2], geom[1] + fy * geom[3] };
+  }
+
+  template<typename G, typename C>
+  static std::array<double,2> cell_location(const G& geom, const C& cells,
+					    const size_t& i)
+  {
+    double s = cells[3 * i + 2];
+    return location(geom, cells[3 * i] + 0.5 * s, cells[3 * i + 1] + 0.5 * s);
+  }
+
+  template<typename G, typename C, typename FC, typename FI>
+  static std::array<double,2> face_location(const G& geom, const C& cells,
+					    const FC& face_cells,
+					    const FI& face_info,
+					    const size_t& i)
+  {
+    size_t lhs = face_cells[2 * i];
+    size_t rhs = face_cells[2 * i + 1];
+    int edge = face_info[2 * i];
+    int dir = face_info[2 * i + 1];
+    // The face spans the side of the smaller of the two cells
+    size_t c = (cells[3 * lhs + 2] <= cells[3 * rhs + 2]) ? lhs : rhs;
+    double s = cells[3 * c + 2];
+    if (dir == 0) {
+      double fx = (edge == 1) ?
+	double(cells[3 * lhs] + cells[3 * lhs + 2]) : double(cells[3 * rhs]);
+      return location(geom, fx, cells[3 * c + 1] + 0.5 * s);
+    } else {
+      double fy = (edge == 1) ?
+	double(cells[3 * lhs + 1] + cells[3 * lhs + 2]) : double(cells[3 * rhs + 1]);
+      return location(geom, cells[3 * c] + 0.5 * s, fy);
+    }
+  }
+
+  template<typename D, typename G, typename V>
+  static std::array<double,2> vertex_location(const D& dims, const G& geom,
+					      const V& vertices,
+					      const size_t& i)
+  {
+    size_t key = vertices[i];
+    return location(geom, double(key % (dims[nx] + 1)),
+		    double(key / (dims[nx] + 1)));
+  }
+
+  /**
+     Return the finest-cell coordinate of a location, or false if it is
+     outside the mesh.
+   */
+  template<typename D, typename G>
+  static bool coordinate(const D& dims, const G& geom,
+			 const std::array<double,2>& loc,
+			 double& fx, double& fy)
+  {
+    fx = (loc[0] - geom[0]) / geom[2];
+    fy = (loc[1] - geom[1]) / geom[3];
+    return (fx >= 0.0 and fx < dims[nx] and fy >= 0.0 and fy < dims[ny]);
+  }
+
+};
+
+/**
+   Class representing a quadtree mesh: a grid of square root cells,
+   each of which is recursively divided into four until the
+   refinement criteria in the mesh configuration are met. Adjacent
+   cells differ in size by at most a factor of two, so each side of a
+   cell has either one face or two ("hanging") faces.
+
+   The configuration keys are those of Cartesian2DMesh ("cell count",
+   "cell size" and "origin", which describe the finest grid) and:
+
+   - "levels": the number of times a root cell may be divided, so root
+     cells are 2^levels finest cells across (default 0);
+   - "refine bed": the name of a raster. A cell is divided if the range
+     of bed levels within it exceeds "refine bed range", or if it
+     covers both coded-out (NaN) and active bed;
+   - "refine at": a geometry specification. The cells containing its
+     points are divided down to the finest level.
+
+   Cells are numbered root cell by root cell (in row-major order) and
+   in Morton order within each root cell. Faces normal to x come
+   before faces normal to y.
+ */
+class QuadtreeMesh
+{
+public:
+
+  using Accessor = QuadtreeMeshAccessor;
+
+  /**
+     Cell sides may be split between two faces.
+   */
+  static constexpr bool has_hanging_faces = true;
+
+  /**
+     Faces are aligned with the x and y axes.
+   */
+  static constexpr bool has_face_normals = false;
+
+  static constexpr bool has_block_clocks = false;
+
+private:
+
+  DataArray<size_t> dims_;
+
+  DataArray<double> geom_;
+
+  DataArray<uint32_t> cells_;
+
+  DataArray<size_t> block_first_;
+
+  DataArray<size_t> face_cells_;
+
+  DataArray<int32_t> face_info_;
+
+  DataArray<size_t> cell_faces_;
+
+  DataArray<size_t> vertices_;
+
+  void build_(const Config& conf);
+
+  inline const size_t& dim(QuadtreeMeshOps::Dim d) const
+  {
+    return dims_.host_vector()[d];
+  }
+
+public:
+
+  /**
+     Construct from the mesh configuration.
+   */
+  QuadtreeMesh(const std::shared_ptr<sycl::queue>& queue,
+	       bool on_device = true);
+
+  ~QuadtreeMesh(void)
+  {
+    std::cout << "Freeing memory for mesh." << std::endl;
+  }
+
+  const std::shared_ptr<sycl::queue>& queue_ptr(void)
+  {
+    return dims_.queue_ptr();
+  }
+
+  bool is_on_device(void)
+  {
+    return dims_.is_on_device();
+  }
+
+  void move_to_device(void);
+
+  void move_to_host(void);
+
+  template<MeshComponent C>
+  inline size_t object_count(void) const;
+
+  template<>
+  inline size_t object_count<MeshComponent::Cell>(void) const
+  {
+    return dim(QuadtreeMeshOps::ncells);
+  }
+
+  template<>
+  inline size_t object_count<MeshComponent::Face>(void) const
+  {
+    return dim(QuadtreeMeshOps::nfaces);
+  }
+
+  template<>
+  inline size_t object_count<MeshComponent::Vertex>(void) const
+  {
+    return dim(QuadtreeMeshOps::nvertices);
+  }
+
+  template<MeshComponent C>
+  inline std::array<double,2> get_object_location(const size_t& i) const;
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Cell>(const size_t& i) const
+  {
+    return QuadtreeMeshOps::cell_location(geom_.host_vector(),
+					  cells_.host_vector(), i);
+  }
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Face>(const size_t& i) const
+  {
+    return QuadtreeMeshOps::face_location(geom_.host_vector(),
+					  cells_.host_vector(),
+					  face_cells_.host_vector(),
+					  face_info_.host_vector(), i);
+  }
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Vertex>(const size_t& i) const
+  {
+    return QuadtreeMeshOps::vertex_location(dims_.host_vector(),
+					    geom_.host_vector(),
+					    vertices_.host_vector(), i);
+  }
+
+  template<MeshComponent C>
+  size_t get_nearest_object_index(const std::array<double,2>& loc) const;
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Cell>(const std::array<double,2>& loc) const
+  {
+    double fx, fy;
+    if (QuadtreeMeshOps::coordinate(dims_.host_vector(), geom_.host_vector(),
+				    loc, fx, fy)) {
+      return QuadtreeMeshOps::find_cell(dims_.host_vector(),
+					cells_.host_vector(),
+					block_first_.host_vector(),
+					(size_t)fx, (size_t)fy);
+    } else {
+      return dim(QuadtreeMeshOps::ncells);
+    }
+  }
+
+  /**
+     Return the id of the i-th object written to outputs. A quadtree
+     has no row-major order, so objects are written in storage order.
+   */
+  template<MeshComponent C>
+  size_t storage_index(const size_t& i) const
+  {
+    return i;
+  }
+
+  /**
+     Return the output position of the object with id i.
+   */
+  template<MeshComponent C>
+  size_t row_major_index(const size_t& i) const
+  {
+    return i;
+  }
+
+  /**
+     Return the number of objects in row-major order, which is the
+     number of rows written to outputs.
+   */
+  template<MeshComponent C>
+  size_t row_major_count(void) const
+  {
+    return object_count<C>();
+  }
+
+  /**
+     Return the location of the object at row-major position i.
+   */
+  template<MeshComponent C>
+  std::array<double,2> get_row_major_location(const size_t& i) const
+  {
+    return get_object_location<C>(storage_index<C>(i));
+  }
+
+protected:
+
+  friend class QuadtreeMeshAccessor;
+
+  const DataArray<size_t>& dims_data(void) const { return dims_; }
+  const DataArray<double>& geom_data(void) const { return geom_; }
+  const DataArray<uint32_t>& cells_data(void) const { return cells_; }
+  const DataArray<size_t>& block_first_data(void) const { return block_first_; }
+  const DataArray<size_t>& face_cells_data(void) const { return face_cells_; }
+  const DataArray<int32_t>& face_info_data(void) const { return face_info_; }
+  const DataArray<size_t>& cell_faces_data(void) const { return cell_faces_; }
+  const DataArray<size_t>& vertices_data(void) const { return vertices_; }
+
+};
+
+class QuadtreeMeshAccessor
+{
+private:
+
+  template<typename T>
+  using ReadAccessor =
+    typename DataArray<T>::
+    template Accessor<sycl::access::mode::read,
+		      sycl::access::target::global_buffer,
+		      sycl::access::placeholder::true_t>;
+
+  ReadAccessor<size_t> dims_ro_;
+  ReadAccessor<double> geom_ro_;
+  ReadAccessor<uint32_t> cells_ro_;
+  ReadAccessor<size_t> block_first_ro_;
+  ReadAccessor<size_t> face_cells_ro_;
+  ReadAccessor<int32_t> face_info_ro_;
+  ReadAccessor<size_t> cell_faces_ro_;
+  ReadAccessor<size_t> vertices_ro_;
+
+  inline size_t cell_size(const size_t& i) const { return cells_ro_[3 * i + 2]; }
+
+  inline size_t face_lhs(const size_t& f) const { return face_cells_ro_[2 * f]; }
+  inline size_t face_rhs(const size_t& f) const { return face_cells_ro_[2 * f + 1]; }
+  inline int face_edge(const size_t& f) const { return face_info_ro_[2 * f]; }
+
+  /**
+     Return the first cell across side k (0: west, 1: east, 2: south,
+     3: north) of cell i, or i itself if the side is on the edge of
+     the mesh.
+   */
+  inline size_t neighbour(const size_t& i, const size_t& k) const
+  {
+    size_t f = cell_faces_ro_[8 * i + 2 * k];
+    if (face_edge(f) != 0) {
+      return i;
+    }
+    return (k % 2 == 0) ? face_lhs(f) : face_rhs(f);
+  }
+
+public:
+
+  static constexpr bool has_hanging_faces = true;
+
+  static constexpr bool has_face_normals = false;
+
+  static constexpr bool has_block_clocks = false;
+
+  QuadtreeMeshAccessor(const QuadtreeMesh& qm);
+
+  void bind(sycl::handler& cgh);
+
+  /**
+     Width and height of the finest cells.
+   */
+  inline const double& dx(void) const { return geom_ro_[2]; }
+  inline const double& dy(void) const { return geom_ro_[3]; }
+
+  /**
+     Width and height of cell i.
+   */
+  inline double dx(const size_t& i) const { return cell_size(i) * dx(); }
+  inline double dy(const size_t& i) const { return cell_size(i) * dy(); }
+
+  template<MeshComponent C>
+  inline size_t object_count(void) const;
+
+  template<>
+  inline size_t object_count<MeshComponent::Cell>(void) const
+  {
+    return dims_ro_[QuadtreeMeshOps::ncells];
+  }
+
+  template<>
+  inline size_t object_count<MeshComponent::Face>(void) const
+  {
+    return dims_ro_[QuadtreeMeshOps::nfaces];
+  }
+
+  template<>
+  inline size_t object_count<MeshComponent::Vertex>(void) const
+  {
+    return dims_ro_[QuadtreeMeshOps::nvertices];
+  }
+
+  inline double cell_area(const size_t& i) const
+  {
+    return dx(i) * dy(i);
+  }
+
+  template<MeshComponent C>
+  inline std::array<double,2> get_object_location(const size_t& i) const;
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Cell>(const size_t& i) const
+  {
+    return QuadtreeMeshOps::cell_location(geom_ro_, cells_ro_, i);
+  }
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Face>(const size_t& i) const
+  {
+    return QuadtreeMeshOps::face_location(geom_ro_, cells_ro_,
+					  face_cells_ro_, face_info_ro_, i);
+  }
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Vertex>(const size_t& i) const
+  {
+    return QuadtreeMeshOps::vertex_location(dims_ro_, geom_ro_,
+					    vertices_ro_, i);
+  }
+
+  template<MeshComponent C>
+  size_t get_nearest_object_index(const std::array<double,2>& loc) const;
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Cell>(const std::array<double,2>& loc) const
+  {
+    double fx, fy;
+    if (QuadtreeMeshOps::coordinate(dims_ro_, geom_ro_, loc, fx, fy)) {
+      return QuadtreeMeshOps::find_cell(dims_ro_, cells_ro_, block_first_ro_,
+					(size_t)fx, (size_t)fy);
+    } else {
+      return object_count<MeshComponent::Cell>();
+    }
+  }
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Face>(const std::array<double,2>& loc) const
+  {
+    size_t c = get_nearest_object_index<MeshComponent::Cell>(loc);
+    if (c == object_count<MeshComponent::Cell>()) {
+      return object_count<MeshComponent::Face>();
+    }
+    // The nearest face is one of the faces of the containing cell
+    size_t nearest = cell_faces_ro_[8 * c];
+    double d2_min = -1.0;
+    for (size_t k = 0; k < 8; ++k) {
+      size_t f = cell_faces_ro_[8 * c + k];
+      std::array<double,2> fl = get_object_location<MeshComponent::Face>(f);
+      double d2 = (fl[0] - loc[0]) * (fl[0] - loc[0]) +
+	(fl[1] - loc[1]) * (fl[1] - loc[1]);
+      if (d2_min < 0.0 or d2 < d2_min) {
+	d2_min = d2;
+	nearest = f;
+      }
+    }
+    return nearest;
+  }
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Vertex>(const std::array<double,2>& loc) const
+  {
+    size_t c = get_nearest_object_index<MeshComponent::Cell>(loc);
+    if (c == object_count<MeshComponent::Cell>()) {
+      return object_count<MeshComponent::Vertex>();
+    }
+    // The nearest vertex is a corner of the containing cell or a
+    // hanging vertex at the middle of one of its sides
+    size_t ix = cells_ro_[3 * c];
+    size_t iy = cells_ro_[3 * c + 1];
+    size_t s = cell_size(c);
+    size_t nvx = dims_ro_[QuadtreeMeshOps::nx] + 1;
+    size_t nearest = object_count<MeshComponent::Vertex>();
+    double d2_min = -1.0;
+    for (size_t k = 0; k < 9; ++k) {
+      size_t vx = ix + (k % 3) * s / 2;
+      size_t vy = iy + (k / 3) * s / 2;
+      size_t v = QuadtreeMeshOps::find_vertex(dims_ro_, vertices_ro_,
+					      vy * nvx + vx);
+      if (v == object_count<MeshComponent::Vertex>()) continue;
+      std::array<double,2> vl = get_object_location<MeshComponent::Vertex>(v);
+      double d2 = (vl[0] - loc[0]) * (vl[0] - loc[0]) +
+	(vl[1] - loc[1]) * (vl[1] - loc[1]);
+      if (d2_min < 0.0 or d2 < d2_min) {
+	d2_min = d2;
+	nearest = v;
+      }
+    }
+    return nearest;
+  }
+
+  struct get_adjacent_cells_result
+  {
+    size_t lhs_id;
+    size_t rhs_id;
+    int edge;
+    int dir;
+    double dx;
+  };
+
+  get_adjacent_cells_result get_adjacent_cells(const size_t& face_id) const
+  {
+    get_adjacent_cells_result result;
+    result.lhs_id = face_lhs(face_id);
+    result.rhs_id = face_rhs(face_id);
+    result.edge = face_edge(face_id);
+    result.dir = face_info_ro_[2 * face_id + 1];
+    // Distance between the cell centres
+    double s = 0.5 * (cell_size(result.lhs_id) + cell_size(result.rhs_id));
+    result.dx = s * (result.dir == 0 ? dx() : dy());
+    return result;
+  }
+
+  struct get_adjacent_faces_result
+  {
+    size_t face_w;
+    size_t face_e;
+    double dx;
+    size_t face_s;
+    size_t face_n;
+    double dy;
+  };
+
+  /**
+     Return the faces on each side of a cell. Where a side is split
+     between two faces, the first is returned here and the second by
+     get_hanging_faces.
+   */
+  get_adjacent_faces_result get_adjacent_faces(const size_t& cell_id) const
+  {
+    get_adjacent_faces_result result;
+    result.face_w = cell_faces_ro_[8 * cell_id];
+    result.face_e = cell_faces_ro_[8 * cell_id + 2];
+    result.dx = dx(cell_id);
+    result.face_s = cell_faces_ro_[8 * cell_id + 4];
+    result.face_n = cell_faces_ro_[8 * cell_id + 6];
+    result.dy = dy(cell_id);
+    return result;
+  }
+
+  struct get_hanging_faces_result
+  {
+    size_t face_w;
+    size_t face_e;
+    size_t face_s;
+    size_t face_n;
+  };
+
+  /**
+     Return the second face on each side of a cell, which is the same
+     as the first if the side is not split.
+   */
+  get_hanging_faces_result get_hanging_faces(const size_t& cell_id) const
+  {
+    get_hanging_faces_result result;
+    result.face_w = cell_faces_ro_[8 * cell_id + 1];
+    result.face_e = cell_faces_ro_[8 * cell_id + 3];
+    result.face_s = cell_faces_ro_[8 * cell_id + 5];
+    result.face_n = cell_faces_ro_[8 * cell_id + 7];
+    return result;
+  }
+
+  struct offset_type
+  {
+    size_t i;
+    double dx;
+  };
+
+  template<MeshComponent C>
+  offset_type get_object_west(const size_t& i) const;
+  template<MeshComponent C>
+  offset_type get_object_east(const size_t& i) const;
+  template<MeshComponent C>
+  offset_type get_object_north(const size_t& i) const;
+  template<MeshComponent C>
+  offset_type get_object_south(const size_t& i) const;
+
+  template<>
+  offset_type get_object_west<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t j = neighbour(i, 0);
+    return { j, (j == i) ? 0.0 : 0.5 * (dx(i) + dx(j)) };
+  }
+
+  template<>
+  offset_type get_object_east<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t j = neighbour(i, 1);
+    return { j, (j == i) ? 0.0 : 0.5 * (dx(i) + dx(j)) };
+  }
+
+  template<>
+  offset_type get_object_north<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t j = neighbour(i, 3);
+    return { j, (j == i) ? 0.0 : 0.5 * (dy(i) + dy(j)) };
+  }
+
+  template<>
+  offset_type get_object_south<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t j = neighbour(i, 2);
+    return { j, (j == i) ? 0.0 : 0.5 * (dy(i) + dy(j)) };
+  }
+
+};
+
+#endif
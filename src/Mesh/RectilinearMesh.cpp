@@ -0,0 +1,144 @@
+/***********************************************************************
+ * mfcm Mesh/RectilinearMesh.cpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#include "RectilinearMesh.hpp"
+#include "Config.hpp"
+#include <boost/lexical_cast.hpp>
+
+namespace {
+
+  /**
+     Return the coordinates of the edges of a sequence of columns (or
+     rows) that starts at origin. Each entry of the comma-separated
+     list of widths is either a width or "n*w" for n columns of width
+     w.
+   */
+  std::vector<double> parse_edges(const std::string& widths,
+				  const double& origin,
+				  const std::string& key)
+  {
+    std::vector<double> edges = { origin };
+    for (auto&& item : split_string<std::string>(widths)) {
+      size_t count = 1;
+      double width;
+      size_t star = item.find('*');
+      try {
+	if (star == std::string::npos) {
+	  width = boost::lexical_cast<double>(item);
+	} else {
+	  std::string n = item.substr(0, star);
+	  std::string w = item.substr(star + 1);
+	  boost::algorithm::trim(n);
+	  boost::algorithm::trim(w);
+	  count = boost::lexical_cast<size_t>(n);
+	  width = boost::lexical_cast<double>(w);
+	}
+      } catch (boost::bad_lexical_cast&) {
+	std::cerr << "ERROR: Cannot read \"" << item << "\" in mesh "
+		  << key << "." << std::endl;
+	throw std::runtime_error("Invalid rectilinear mesh configuration.");
+      }
+      if (not (width > 0.0)) {
+	std::cerr << "ERROR: The rectilinear mesh " << key
+		  << " must be positive." << std::endl;
+	throw std::runtime_error("Invalid rectilinear mesh configuration.");
+      }
+      for (size_t i = 0; i < count; ++i) {
+	edges.push_back(edges.back() + width);
+      }
+    }
+    if (edges.size() < 2) {
+      std::cerr << "ERROR: The rectilinear mesh " << key
+		<< " must contain at least one entry." << std::endl;
+      throw std::runtime_error("Invalid rectilinear mesh configuration.");
+    }
+    return edges;
+  }
+
+}
+
+RectilinearMesh::
+RectilinearMesh(const std::shared_ptr<sycl::queue>& queue,
+		bool on_device)
+  : ncells_(queue, 2),
+    xedges_(queue, 0),
+    yedges_(queue, 0)
+{
+  const Config& conf = GlobalConfig::instance().mesh_configuration();
+
+  std::array<double,2> origin =
+    split_string<double,2>(conf.get<std::string>("origin", "0.0, 0.0"));
+
+  // Columns and rows not listed explicitly are uniform
+  std::string widths = conf.get<std::string>("column widths", "");
+  std::string heights = conf.get<std::string>("row heights", "");
+  if (widths == "" or heights == "") {
+    std::array<size_t,2> ncells =
+      split_string<size_t,2>(conf.get<std::string>("cell count"));
+    std::array<double,2> cellsize =
+      split_string<double,2>(conf.get<std::string>("cell size"));
+    if (widths == "") {
+      widths = std::to_string(ncells[0]) + "*" +
+	boost::lexical_cast<std::string>(cellsize[0]);
+    }
+    if (heights == "") {
+      heights = std::to_string(ncells[1]) + "*" +
+	boost::lexical_cast<std::string>(cellsize[1]);
+    }
+  }
+
+  xedges_.host_vector() = parse_edges(widths, origin[0], "column widths");
+  yedges_.host_vector() = parse_edges(heights, origin[1], "row heights");
+  ncells_.host_vector() = { xedges_.host_vector().size() - 1,
+			    yedges_.host_vector().size() - 1 };
+
+  std::cout << "Created a rectilinear mesh with " << nxcells()
+	    << " columns and " << nycells() << " rows." << std::endl;
+
+  if (on_device) {
+    move_to_device();
+  }
+}
+
+void RectilinearMesh::move_to_device(void)
+{
+  ncells_.move_to_device();
+  xedges_.move_to_device();
+  yedges_.move_to_device();
+}
+
+void RectilinearMesh::move_to_host(void)
+{
+  ncells_.move_to_host();
+  xedges_.move_to_host();
+  yedges_.move_to_host();
+}
+
+RectilinearMeshAccessor::
+RectilinearMeshAccessor(const RectilinearMesh& rm)
+  : ncells_ro_(rm.ncells_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    xedges_ro_(rm.xedges_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    yedges_ro_(rm.yedges_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>())
+{}
+
+void RectilinearMeshAccessor::bind(sycl::handler& cgh)
+{
+  cgh.require(ncells_ro_);
+  cgh.require(xedges_ro_);
+  cgh.require(yedges_ro_);
+}
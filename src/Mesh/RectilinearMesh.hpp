@@ -0,0 +1,645 @@
+/***********************************************************************
+ * mfcm Mesh/RectilinearMesh.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_Mesh_RectilinearMesh_hpp
+#define mfcm_Mesh_RectilinearMesh_hpp
+
+#include "Mesh.hpp"
+#include "DataArray.hpp"
+#include "Config.hpp"
+
+class RectilinearMeshAccessor;
+
+/**
+   Index arithmetic shared by RectilinearMesh (on the host) and
+   RectilinearMeshAccessor (on the device). The cell counts and the
+   coordinates of the column and row edges are passed as anything
+   that can be indexed with [].
+
+   Cells, faces and vertices are numbered in the same way as in
+   Cartesian2DMesh with row-major ordering.
+ */
+struct RectilinearMeshOps
+{
+  /**
+     Return the index of the interval of the n+1 sorted edges that
+     contains v, or n if v is outside them.
+   */
+  template<typename E>
+  static size_t find_interval(const E& edges, const size_t& n, const double& v)
+  {
+    if (not (v >= edges[0] and v < edges[n])) {
+      return n;
+    }
+    size_t lo = 0;
+    size_t hi = n;
+    while (hi - lo > 1) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (edges[mid] <= v) {
+	lo = mid;
+      } else {
+	hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  /**
+     Return the index of the edge nearest to v.
+   */
+  template<typename E>
+  static size_t nearest_edge(const E& edges, const size_t& n, const double& v)
+  {
+    if (v <= edges[0]) return 0;
+    if (v >= edges[n]) return n;
+    size_t i = find_interval(edges, n, v);
+    return (v - edges[i] < edges[i + 1] - v) ? i : i + 1;
+  }
+
+  template<typename N, typename E>
+  static std::array<double,2> cell_location(const N& nc, const E& xe,
+					    const E& ye, const size_t& i)
+  {
+    size_t cx = i % nc[0];
+    size_t cy = i / nc[0];
+    return { 0.5 * (xe[cx] + xe[cx + 1]), 0.5 * (ye[cy] + ye[cy + 1]) };
+  }
+
+  template<typename N, typename E>
+  static std::array<double,2> face_location(const N& nc, const E& xe,
+					    const E& ye, const size_t& i)
+  {
+    if (i < (nc[0] + 1) * nc[1]) {
+      // Face is vertical
+      size_t fx = i % (nc[0] + 1);
+      size_t fy = i / (nc[0] + 1);
+      return { xe[fx], 0.5 * (ye[fy] + ye[fy + 1]) };
+    } else {
+      // Face is horizontal
+      size_t i2 = i - (nc[0] + 1) * nc[1];
+      size_t fx = i2 % nc[0];
+      size_t fy = i2 / nc[0];
+      return { 0.5 * (xe[fx] + xe[fx + 1]), ye[fy] };
+    }
+  }
+
+  template<typename N, typename E>
+  static std::array<double,2> vertex_location(const N& nc, const E& xe,
+					      const E& ye, const size_t& i)
+  {
+    return { xe[i % (nc[0] + 1)], ye[i / (nc[0] + 1)] };
+  }
+
+  template<typename N, typename E>
+  static size_t nearest_cell(const N& nc, const E& xe, const E& ye,
+			     const std::array<double,2>& loc)
+  {
+    size_t cx = find_interval(xe, nc[0], loc[0]);
+    size_t cy = find_interval(ye, nc[1], loc[1]);
+    if (cx == nc[0] or cy == nc[1]) {
+      return nc[0] * nc[1];
+    }
+    return cy * nc[0] + cx;
+  }
+
+};
+
+/**
+   Class representing a rectilinear mesh: a grid of cells whose widths
+   vary from column to column and whose heights vary from row to row.
+   This allows the resolution to be increased along a corridor (such
+   as a river channel) without increasing it across the whole domain.
+
+   The mesh is configured with "origin" and with "column widths" and
+   "row heights", each a comma-separated list in which an entry "n*w"
+   stands for n repeats of w. If either list is absent the columns or
+   rows are uniform, as given by "cell count" and "cell size".
+ */
+class RectilinearMesh
+{
+public:
+
+  using Accessor = RectilinearMeshAccessor;
+
+  /**
+     Every cell side is a single face.
+   */
+  static constexpr bool has_hanging_faces = false;
+
+  /**
+     Faces are aligned with the x and y axes.
+   */
+  static constexpr bool has_face_normals = false;
+
+  static constexpr bool has_block_clocks = false;
+
+private:
+
+  DataArray<size_t> ncells_;
+
+  DataArray<double> xedges_;
+
+  DataArray<double> yedges_;
+
+  inline const size_t& nxcells(void) const { return ncells_.host_vector()[0]; }
+  inline const size_t& nycells(void) const { return ncells_.host_vector()[1]; }
+
+public:
+
+  /**
+     Construct from the mesh configuration.
+   */
+  RectilinearMesh(const std::shared_ptr<sycl::queue>& queue,
+		  bool on_device = true);
+
+  ~RectilinearMesh(void)
+  {
+    std::cout << "Freeing memory for mesh." << std::endl;
+  }
+
+  const std::shared_ptr<sycl::queue>& queue_ptr(void)
+  {
+    return ncells_.queue_ptr();
+  }
+
+  bool is_on_device(void)
+  {
+    return ncells_.is_on_device();
+  }
+
+  void move_to_device(void);
+
+  void move_to_host(void);
+
+  template<MeshComponent C>
+  inline size_t object_count(void) const;
+
+  template<>
+  inline size_t object_count<MeshComponent::Cell>(void) const
+  {
+    return nxcells() * nycells();
+  }
+
+  template<>
+  inline size_t object_count<MeshComponent::Face>(void) const
+  {
+    return (nxcells() + 1) * nycells() +
+      (nycells() + 1) * nxcells();
+  }
+
+  template<>
+  inline size_t object_count<MeshComponent::Vertex>(void) const
+  {
+    return (nxcells() + 1) * (nycells() + 1);
+  }
+
+  template<MeshComponent C>
+  inline std::array<double,2> get_object_location(const size_t& i) const;
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Cell>(const size_t& i) const
+  {
+    return RectilinearMeshOps::cell_location(ncells_.host_vector(),
+					     xedges_.host_vector(),
+					     yedges_.host_vector(), i);
+  }
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Face>(const size_t& i) const
+  {
+    return RectilinearMeshOps::face_location(ncells_.host_vector(),
+					     xedges_.host_vector(),
+					     yedges_.host_vector(), i);
+  }
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Vertex>(const size_t& i) const
+  {
+    return RectilinearMeshOps::vertex_location(ncells_.host_vector(),
+					       xedges_.host_vector(),
+					       yedges_.host_vector(), i);
+  }
+
+  template<MeshComponent C>
+  size_t get_nearest_object_index(const std::array<double,2>& loc) const;
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Cell>(const std::array<double,2>& loc) const
+  {
+    return RectilinearMeshOps::nearest_cell(ncells_.host_vector(),
+					    xedges_.host_vector(),
+					    yedges_.host_vector(), loc);
+  }
+
+  /**
+     Return the id of the i-th object in row-major order, which is
+     the order in which objects are stored.
+   */
+  template<MeshComponent C>
+  size_t storage_index(const size_t& i) const
+  {
+    return i;
+  }
+
+  /**
+     Return the row-major position of the object with id i.
+   */
+  template<MeshComponent C>
+  size_t row_major_index(const size_t& i) const
+  {
+    return i;
+  }
+
+  /**
+     Return the number of objects in row-major order, which is the
+     number of rows written to outputs.
+   */
+  template<MeshComponent C>
+  size_t row_major_count(void) const
+  {
+    return object_count<C>();
+  }
+
+  /**
+     Return the location of the object at row-major position i.
+   */
+  template<MeshComponent C>
+  std::array<double,2> get_row_major_location(const size_t& i) const
+  {
+    return get_object_location<C>(storage_index<C>(i));
+  }
+
+protected:
+
+  friend class RectilinearMeshAccessor;
+
+  const DataArray<size_t>& ncells_data(void) const { return ncells_; }
+  const DataArray<double>& xedges_data(void) const { return xedges_; }
+  const DataArray<double>& yedges_data(void) const { return yedges_; }
+
+};
+
+class RectilinearMeshAccessor
+{
+private:
+
+  using NCAccessor =
+    typename DataArray<size_t>::
+    template Accessor<sycl::access::mode::read,
+		      sycl::access::target::global_buffer,
+		      sycl::access::placeholder::true_t>;
+
+  using EdgeAccessor =
+    typename DataArray<double>::
+    template Accessor<sycl::access::mode::read,
+		      sycl::access::target::global_buffer,
+		      sycl::access::placeholder::true_t>;
+
+  NCAccessor ncells_ro_;
+
+  EdgeAccessor xedges_ro_;
+
+  EdgeAccessor yedges_ro_;
+
+  inline const size_t& nxcells(void) const { return ncells_ro_[0]; }
+  inline const size_t& nycells(void) const { return ncells_ro_[1]; }
+
+  inline double column_width(const size_t& cx) const
+  {
+    return xedges_ro_[cx + 1] - xedges_ro_[cx];
+  }
+
+  inline double row_height(const size_t& cy) const
+  {
+    return yedges_ro_[cy + 1] - yedges_ro_[cy];
+  }
+
+  /**
+     Distance between the centres of adjacent columns (or rows)
+     either side of edge i.
+   */
+  inline double column_spacing(const size_t& i) const
+  {
+    return 0.5 * (xedges_ro_[i + 1] - xedges_ro_[i - 1]);
+  }
+
+  inline double row_spacing(const size_t& i) const
+  {
+    return 0.5 * (yedges_ro_[i + 1] - yedges_ro_[i - 1]);
+  }
+
+public:
+
+  static constexpr bool has_hanging_faces = false;
+
+  static constexpr bool has_face_normals = false;
+
+  static constexpr bool has_block_clocks = false;
+
+  RectilinearMeshAccessor(const RectilinearMesh& rm);
+
+  void bind(sycl::handler& cgh);
+
+  /**
+     Width and height of cell i.
+   */
+  inline double dx(const size_t& i) const { return column_width(i % nxcells()); }
+  inline double dy(const size_t& i) const { return row_height(i / nxcells()); }
+
+  template<MeshComponent C>
+  inline size_t object_count(void) const;
+
+  template<>
+  inline size_t object_count<MeshComponent::Cell>(void) const
+  {
+    return nxcells() * nycells();
+  }
+
+  template<>
+  inline size_t object_count<MeshComponent::Face>(void) const
+  {
+    return (nxcells() + 1) * nycells() +
+      (nycells() + 1) * nxcells();
+  }
+
+  template<>
+  inline size_t object_count<MeshComponent::Vertex>(void) const
+  {
+    return (nxcells() + 1) * (nycells() + 1);
+  }
+
+  inline double cell_area(const size_t& i) const
+  {
+    return dx(i) * dy(i);
+  }
+
+  template<MeshComponent C>
+  inline std::array<double,2> get_object_location(const size_t& i) const;
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Cell>(const size_t& i) const
+  {
+    return RectilinearMeshOps::cell_location(ncells_ro_, xedges_ro_,
+					     yedges_ro_, i);
+  }
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Face>(const size_t& i) const
+  {
+    return RectilinearMeshOps::face_location(ncells_ro_, xedges_ro_,
+					     yedges_ro_, i);
+  }
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Vertex>(const size_t& i) const
+  {
+    return RectilinearMeshOps::vertex_location(ncells_ro_, xedges_ro_,
+					       yedges_ro_, i);
+  }
+
+  template<MeshComponent C>
+  size_t get_nearest_object_index(const std::array<double,2>& loc) const;
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Cell>(const std::array<double,2>& loc) const
+  {
+    return RectilinearMeshOps::nearest_cell(ncells_ro_, xedges_ro_,
+					    yedges_ro_, loc);
+  }
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Face>(const std::array<double,2>& loc) const
+  {
+    size_t c = get_nearest_object_index<MeshComponent::Cell>(loc);
+    if (c == object_count<MeshComponent::Cell>()) {
+      return object_count<MeshComponent::Face>();
+    }
+    // The nearest face is the side of the cell nearest to loc
+    size_t cx = c % nxcells();
+    size_t cy = c / nxcells();
+    double dw = loc[0] - xedges_ro_[cx];
+    double de = xedges_ro_[cx + 1] - loc[0];
+    double ds = loc[1] - yedges_ro_[cy];
+    double dn = yedges_ro_[cy + 1] - loc[1];
+    double dmin = sycl::fmin(sycl::fmin(dw, de), sycl::fmin(ds, dn));
+    size_t hoffset = (nxcells() + 1) * nycells();
+    if (dmin == dw) {
+      return cy * (nxcells() + 1) + cx;
+    } else if (dmin == de) {
+      return cy * (nxcells() + 1) + cx + 1;
+    } else if (dmin == ds) {
+      return hoffset + cy * nxcells() + cx;
+    } else {
+      return hoffset + (cy + 1) * nxcells() + cx;
+    }
+  }
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Vertex>(const std::array<double,2>& loc) const
+  {
+    size_t c = get_nearest_object_index<MeshComponent::Cell>(loc);
+    if (c == object_count<MeshComponent::Cell>()) {
+      return object_count<MeshComponent::Vertex>();
+    }
+    size_t vx = RectilinearMeshOps::nearest_edge(xedges_ro_, nxcells(), loc[0]);
+    size_t vy = RectilinearMeshOps::nearest_edge(yedges_ro_, nycells(), loc[1]);
+    return vy * (nxcells() + 1) + vx;
+  }
+
+  struct get_adjacent_cells_result
+  {
+    size_t lhs_id;
+    size_t rhs_id;
+    int edge;
+    int dir;
+    double dx;
+  };
+
+  get_adjacent_cells_result get_adjacent_cells(const size_t& face_id) const
+  {
+    get_adjacent_cells_result result;
+
+    if (face_id < (nxcells() + 1) * nycells()) {
+      // Face is vertical and has cells to the left and right.
+      result.dir = 0;
+      size_t fxid = face_id % (nxcells() + 1);
+      size_t fyid = face_id / (nxcells() + 1);
+
+      if (fxid < nxcells()) {
+	result.rhs_id = fyid * nxcells() + fxid;
+	if (fxid > 0) {
+	  // Mid-row
+	  result.edge = 0;
+	  result.lhs_id = fyid * nxcells() + (fxid - 1);
+	  result.dx = column_spacing(fxid);
+	} else {
+	  // Left hand edge of row
+	  result.edge = -1;
+	  result.lhs_id = result.rhs_id;
+	  result.dx = column_width(fxid);
+	}
+      } else {
+	// Right-hand edge of row
+	result.lhs_id = fyid * nxcells() + (fxid - 1);
+	result.rhs_id = result.lhs_id;
+	result.edge = 1;
+	result.dx = column_width(fxid - 1);
+      }
+    } else {
+      // Face is horizontal and has cells above and below
+      result.dir = 1;
+      size_t f2id = face_id - (nxcells() + 1) * nycells();
+      size_t fxid = f2id % nxcells();
+      size_t fyid = f2id / nxcells();
+
+      if (fyid < nycells()) {
+	result.rhs_id = fyid * nxcells() + fxid;
+	if (fyid > 0) {
+	  // Mid-column
+	  result.edge = 0;
+	  result.lhs_id = (fyid - 1) * nxcells() + fxid;
+	  result.dx = row_spacing(fyid);
+	} else {
+	  // Bottom of column
+	  result.edge = -1;
+	  result.lhs_id = result.rhs_id;
+	  result.dx = row_height(fyid);
+	}
+      } else {
+	// Top of column
+	result.lhs_id = (fyid - 1) * nxcells() + fxid;
+	result.rhs_id = result.lhs_id;
+	result.edge = 1;
+	result.dx = row_height(fyid - 1);
+      }
+    }
+
+    return result;
+  }
+
+  struct get_adjacent_faces_result
+  {
+    size_t face_w;
+    size_t face_e;
+    double dx;
+    size_t face_s;
+    size_t face_n;
+    double dy;
+  };
+
+  get_adjacent_faces_result get_adjacent_faces(const size_t& cell_id) const
+  {
+    size_t cxid = cell_id % nxcells();
+    size_t cyid = cell_id / nxcells();
+
+    get_adjacent_faces_result result;
+    result.face_w = cyid * (nxcells() + 1) + cxid;
+    result.face_e = result.face_w + 1;
+    result.dx = column_width(cxid);
+    result.face_s = (nxcells() + 1) * nycells() + cyid * nxcells() + cxid;
+    result.face_n = result.face_s + nxcells();
+    result.dy = row_height(cyid);
+    return result;
+  }
+
+  struct get_hanging_faces_result
+  {
+    size_t face_w;
+    size_t face_e;
+    size_t face_s;
+    size_t face_n;
+  };
+
+  /**
+     Return the second face on each side of a cell. Sides are never
+     split, so these are the faces returned by get_adjacent_faces.
+   */
+  get_hanging_faces_result get_hanging_faces(const size_t& cell_id) const
+  {
+    auto [ face_w, face_e, dx, face_s, face_n, dy ] = get_adjacent_faces(cell_id);
+    return { face_w, face_e, face_s, face_n };
+  }
+
+  struct offset_type
+  {
+    size_t i;
+    double dx;
+  };
+
+  template<MeshComponent C>
+  offset_type get_object_west(const size_t& i) const;
+  template<MeshComponent C>
+  offset_type get_object_east(const size_t& i) const;
+  template<MeshComponent C>
+  offset_type get_object_north(const size_t& i) const;
+  template<MeshComponent C>
+  offset_type get_object_south(const size_t& i) const;
+
+  template<>
+  offset_type get_object_west<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t xi = i % nxcells();
+    if (xi > 0) {
+      return { i-1, column_spacing(xi) };
+    } else {
+      return { i, 0.0 };
+    }
+  }
+
+  template<>
+  offset_type get_object_east<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t xi = i % nxcells();
+    if (xi < nxcells() - 1) {
+      return { i+1, column_spacing(xi + 1) };
+    } else {
+      return { i, 0.0 };
+    }
+  }
+
+  template<>
+  offset_type get_object_north<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t yi = i / nxcells();
+    if (yi < nycells() - 1) {
+      return { i+nxcells(), row_spacing(yi + 1) };
+    } else {
+      return { i, 0.0 };
+    }
+  }
+
+  template<>
+  offset_type get_object_south<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t yi = i / nxcells();
+    if (yi > 0) {
+      return { i-nxcells(), row_spacing(yi) };
+    } else {
+      return { i, 0.0 };
+    }
+  }
+
+};
+
+#endif
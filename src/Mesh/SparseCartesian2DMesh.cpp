@@ -0,0 +1,221 @@
+/***********************************************************************
+ * mfcm Mesh/SparseCartesian2DMesh.cpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#include "SparseCartesian2DMesh.hpp"
+#include "Config.hpp"
+#include "Raster.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+void SparseCartesian2DMesh::build_(const Config& conf)
+{
+  using Ops = SparseCartesian2DMeshOps;
+
+  std::array<size_t,2> ncells =
+    split_string<size_t,2>(conf.get<std::string>("cell count"));
+  std::array<double,2> origin =
+    split_string<double,2>(conf.get<std::string>("origin", "0.0, 0.0"));
+  std::array<double,2> cellsize =
+    split_string<double,2>(conf.get<std::string>("cell size"));
+  size_t nx = ncells[0];
+  size_t ny = ncells[1];
+  size_t nvfaces = (nx + 1) * ny;
+
+  geom_.host_vector() = { origin[0], origin[1], cellsize[0], cellsize[1] };
+
+  // Active cells are those whose centres lie on a value of the mask
+  std::string mask_name = conf.get<std::string>("mask", "");
+  if (mask_name == "") {
+    std::cerr << "ERROR: A sparse mesh requires a \"mask\" raster."
+	      << std::endl;
+    throw std::runtime_error("No mask given for sparse mesh.");
+  }
+  auto mask = RasterDatabase<double>::instance().
+    get_raster_field_ptr(queue_ptr(), mask_name);
+  DataArray<double> values(mask->data());
+  values.move_to_host();
+  const std::vector<double>& mask_values = values.host_vector();
+
+  std::vector<size_t>& cells = cells_.host_vector();
+  for (size_t cy = 0; cy < ny; ++cy) {
+    for (size_t cx = 0; cx < nx; ++cx) {
+      std::array<double,2> loc = Ops::location(geom_.host_vector(),
+					       cx + 0.5, cy + 0.5);
+      size_t j = mask->mesh()->get_nearest_object_index<MeshComponent::Cell>(loc);
+      if (j < mask_values.size() and not std::isnan(mask_values[j])) {
+	cells.push_back(cy * nx + cx);
+      }
+    }
+  }
+  if (cells.empty()) {
+    std::cerr << "ERROR: The mask " << std::quoted(mask_name)
+	      << " leaves no active cells in the sparse mesh." << std::endl;
+    throw std::runtime_error("Sparse mesh has no active cells.");
+  }
+  size_t nc = cells.size();
+  auto find_cell = [&](size_t key) -> size_t
+  {
+    return Ops::find(cells, nc, key);
+  };
+
+  // Faces and vertices that bound active cells
+  std::vector<size_t>& faces = faces_.host_vector();
+  std::vector<size_t>& vertices = vertices_.host_vector();
+  for (auto&& key : cells) {
+    size_t cx = key % nx;
+    size_t cy = key / nx;
+    faces.push_back(cy * (nx + 1) + cx);
+    faces.push_back(cy * (nx + 1) + cx + 1);
+    faces.push_back(nvfaces + cy * nx + cx);
+    faces.push_back(nvfaces + (cy + 1) * nx + cx);
+    vertices.push_back(cy * (nx + 1) + cx);
+    vertices.push_back(cy * (nx + 1) + cx + 1);
+    vertices.push_back((cy + 1) * (nx + 1) + cx);
+    vertices.push_back((cy + 1) * (nx + 1) + cx + 1);
+  }
+  std::sort(faces.begin(), faces.end());
+  faces.erase(std::unique(faces.begin(), faces.end()), faces.end());
+  std::sort(vertices.begin(), vertices.end());
+  vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+  size_t nf = faces.size();
+
+  std::vector<size_t>& face_cells = face_cells_.host_vector();
+  std::vector<int32_t>& face_info = face_info_.host_vector();
+  face_cells.resize(2 * nf);
+  face_info.resize(2 * nf);
+  for (size_t f = 0; f < nf; ++f) {
+    size_t key = faces[f];
+    size_t lhs = nc;
+    size_t rhs = nc;
+    int32_t dir;
+    if (key < nvfaces) {
+      dir = 0;
+      size_t fx = key % (nx + 1);
+      size_t fy = key / (nx + 1);
+      if (fx > 0) lhs = find_cell(fy * nx + fx - 1);
+      if (fx < nx) rhs = find_cell(fy * nx + fx);
+    } else {
+      dir = 1;
+      size_t fx = (key - nvfaces) % nx;
+      size_t fy = (key - nvfaces) / nx;
+      if (fy > 0) lhs = find_cell((fy - 1) * nx + fx);
+      if (fy < ny) rhs = find_cell(fy * nx + fx);
+    }
+    int32_t edge = 0;
+    if (lhs == nc) {
+      lhs = rhs;
+      edge = -1;
+    } else if (rhs == nc) {
+      rhs = lhs;
+      edge = 1;
+    }
+    face_cells[2 * f] = lhs;
+    face_cells[2 * f + 1] = rhs;
+    face_info[2 * f] = edge;
+    face_info[2 * f + 1] = dir;
+  }
+
+  std::vector<size_t>& cell_faces = cell_faces_.host_vector();
+  cell_faces.resize(4 * nc);
+  for (size_t c = 0; c < nc; ++c) {
+    size_t cx = cells[c] % nx;
+    size_t cy = cells[c] / nx;
+    cell_faces[4 * c] = Ops::find(faces, nf, cy * (nx + 1) + cx);
+    cell_faces[4 * c + 1] = Ops::find(faces, nf, cy * (nx + 1) + cx + 1);
+    cell_faces[4 * c + 2] = Ops::find(faces, nf, nvfaces + cy * nx + cx);
+    cell_faces[4 * c + 3] = Ops::find(faces, nf, nvfaces + (cy + 1) * nx + cx);
+  }
+
+  std::vector<size_t>& dims = dims_.host_vector();
+  dims.assign(Ops::size, 0);
+  dims[Ops::nx] = nx;
+  dims[Ops::ny] = ny;
+  dims[Ops::ncells] = nc;
+  dims[Ops::nfaces] = nf;
+  dims[Ops::nvertices] = vertices.size();
+
+  std::cout << "Created a sparse mesh with " << nc << " active cells of "
+	    << nx * ny << "." << std::endl;
+}
+
+SparseCartesian2DMesh::
+SparseCartesian2DMesh(const std::shared_ptr<sycl::queue>& queue,
+		      bool on_device)
+  : dims_(queue, 0),
+    geom_(queue, 0),
+    cells_(queue, 0),
+    faces_(queue, 0),
+    vertices_(queue, 0),
+    face_cells_(queue, 0),
+    face_info_(queue, 0),
+    cell_faces_(queue, 0)
+{
+  build_(GlobalConfig::instance().mesh_configuration());
+  if (on_device) {
+    move_to_device();
+  }
+}
+
+void SparseCartesian2DMesh::move_to_device(void)
+{
+  dims_.move_to_device();
+  geom_.move_to_device();
+  cells_.move_to_device();
+  faces_.move_to_device();
+  vertices_.move_to_device();
+  face_cells_.move_to_device();
+  face_info_.move_to_device();
+  cell_faces_.move_to_device();
+}
+
+void SparseCartesian2DMesh::move_to_host(void)
+{
+  dims_.move_to_host();
+  geom_.move_to_host();
+  cells_.move_to_host();
+  faces_.move_to_host();
+  vertices_.move_to_host();
+  face_cells_.move_to_host();
+  face_info_.move_to_host();
+  cell_faces_.move_to_host();
+}
+
+SparseCartesian2DMeshAccessor::
+SparseCartesian2DMeshAccessor(const SparseCartesian2DMesh& sm)
+  : dims_ro_(sm.dims_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    geom_ro_(sm.geom_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    cells_ro_(sm.cells_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    faces_ro_(sm.faces_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    vertices_ro_(sm.vertices_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    face_cells_ro_(sm.face_cells_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    face_info_ro_(sm.face_info_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    cell_faces_ro_(sm.cell_faces_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>())
+{}
+
+void SparseCartesian2DMeshAccessor::bind(sycl::handler& cgh)
+{
+  cgh.require(dims_ro_);
+  cgh.require(geom_ro_);
+  cgh.require(cells_ro_);
+  cgh.require(faces_ro_);
+  cgh.require(vertices_ro_);
+  cgh.require(face_cells_ro_);
+  cgh.require(face_info_ro_);
+  cgh.require(cell_faces_ro_);
+}
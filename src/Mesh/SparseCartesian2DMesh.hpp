@@ -0,0 +1,641 @@
+/***********************************************************************
+ * mfcm Mesh/SparseCartesian2DMesh.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_Mesh_SparseCartesian2DMesh_hpp
+#define mfcm_Mesh_SparseCartesian2DMesh_hpp
+
+#include "Mesh.hpp"
+#include "DataArray.hpp"
+#include "Config.hpp"
+
+class SparseCartesian2DMeshAccessor;
+
+/**
+   Index arithmetic shared by SparseCartesian2DMesh (on the host) and
+   SparseCartesian2DMeshAccessor (on the device). The mesh arrays are
+   passed as anything that can be indexed with [].
+
+   Objects of the full grid are identified by their row-major index
+   ("key"), with vertical faces before horizontal faces as in
+   Cartesian2DMesh. The dims array holds, in order: the number of
+   cells of the full grid in x and y, and the numbers of active cells,
+   faces and vertices.
+ */
+struct SparseCartesian2DMeshOps
+{
+  enum Dim : size_t
+    {
+      nx = 0,
+      ny,
+      ncells,
+      nfaces,
+      nvertices,
+      size
+    };
+
+  /**
+     Return the position of key in the first n entries of the sorted
+     array keys, or n if it is not there.
+   */
+  template<typename K>
+  static size_t find(const K& keys, const size_t& n, const size_t& key)
+  {
+    size_t lo = 0;
+    size_t hi = n;
+    while (hi > lo) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (keys[mid] < key) {
+	lo = mid + 1;
+      } else {
+	hi = mid;
+      }
+    }
+    return (lo < n and keys[lo] == key) ? lo : n;
+  }
+
+  template<typename G>
+  static std::array<double,2> location(const G& geom,
+				       const double& fx, const double& fy)
+  {
+    return { geom[0] + fx * geom[2], geom[1] + fy * geom[3] };
+  }
+
+  template<typename D, typename G>
+  static std::array<double,2> cell_location(const D& dims, const G& geom,
+					    const size_t& key)
+  {
+    return location(geom, (key % dims[nx]) + 0.5, (key / dims[nx]) + 0.5);
+  }
+
+  template<typename D, typename G>
+  static std::array<double,2> face_location(const D& dims, const G& geom,
+					    const size_t& key)
+  {
+    size_t nvfaces = (dims[nx] + 1) * dims[ny];
+    if (key < nvfaces) {
+      return location(geom, double(key % (dims[nx] + 1)),
+		      (key / (dims[nx] + 1)) + 0.5);
+    } else {
+      return location(geom, ((key - nvfaces) % dims[nx]) + 0.5,
+		      double((key - nvfaces) / dims[nx]));
+    }
+  }
+
+  template<typename D, typename G>
+  static std::array<double,2> vertex_location(const D& dims, const G& geom,
+					      const size_t& key)
+  {
+    return location(geom, double(key % (dims[nx] + 1)),
+		    double(key / (dims[nx] + 1)));
+  }
+
+  /**
+     Return the cell coordinate of a location in the full grid, or
+     false if it is outside the grid.
+   */
+  template<typename D, typename G>
+  static bool coordinate(const D& dims, const G& geom,
+			 const std::array<double,2>& loc,
+			 double& fx, double& fy)
+  {
+    fx = (loc[0] - geom[0]) / geom[2];
+    fy = (loc[1] - geom[1]) / geom[3];
+    return (fx >= 0.0 and fx < dims[nx] and fy >= 0.0 and fy < dims[ny]);
+  }
+
+  /**
+     Return the id of the active cell containing a location, or the
+     active cell count if there is none.
+   */
+  template<typename D, typename G, typename C>
+  static size_t nearest_cell(const D& dims, const G& geom, const C& cells,
+			     const std::array<double,2>& loc)
+  {
+    double fx, fy;
+    if (not coordinate(dims, geom, loc, fx, fy)) {
+      return dims[ncells];
+    }
+    return find(cells, dims[ncells], size_t(fy) * dims[nx] + size_t(fx));
+  }
+
+};
+
+/**
+   Class representing a Cartesian grid of which only the cells inside
+   a mask (typically a catchment) are stored. Fields on the mesh hold
+   one value per active cell, so the memory and work spent on cells
+   that can never be wet is avoided.
+
+   The full grid is configured with "cell count", "cell size" and
+   "origin", as for Cartesian2DMesh, and "mask" gives the name of a
+   raster. Cells whose centres lie on a value of the mask that is not
+   NaN are active.
+
+   Active cells, and the faces and vertices that bound them, are
+   numbered in the row-major order of the full grid (vertical faces
+   first). A face with an active cell on only one side is treated as
+   the edge of the mesh. Outputs are written for every object of the
+   full grid, with NaN for objects that are not stored.
+ */
+class SparseCartesian2DMesh
+{
+public:
+
+  using Accessor = SparseCartesian2DMeshAccessor;
+
+  /**
+     Every cell side is a single face.
+   */
+  static constexpr bool has_hanging_faces = false;
+
+  /**
+     Faces are aligned with the x and y axes.
+   */
+  static constexpr bool has_face_normals = false;
+
+  static constexpr bool has_block_clocks = false;
+
+private:
+
+  DataArray<size_t> dims_;
+
+  DataArray<double> geom_;
+
+  DataArray<size_t> cells_;
+
+  DataArray<size_t> faces_;
+
+  DataArray<size_t> vertices_;
+
+  DataArray<size_t> face_cells_;
+
+  DataArray<int32_t> face_info_;
+
+  DataArray<size_t> cell_faces_;
+
+  void build_(const Config& conf);
+
+  inline const size_t& dim(SparseCartesian2DMeshOps::Dim d) const
+  {
+    return dims_.host_vector()[d];
+  }
+
+  template<MeshComponent C>
+  inline const std::vector<size_t>& keys(void) const;
+
+  template<>
+  inline const std::vector<size_t>& keys<MeshComponent::Cell>(void) const
+  {
+    return cells_.host_vector();
+  }
+
+  template<>
+  inline const std::vector<size_t>& keys<MeshComponent::Face>(void) const
+  {
+    return faces_.host_vector();
+  }
+
+  template<>
+  inline const std::vector<size_t>& keys<MeshComponent::Vertex>(void) const
+  {
+    return vertices_.host_vector();
+  }
+
+public:
+
+  /**
+     Construct from the mesh configuration.
+   */
+  SparseCartesian2DMesh(const std::shared_ptr<sycl::queue>& queue,
+			bool on_device = true);
+
+  ~SparseCartesian2DMesh(void)
+  {
+    std::cout << "Freeing memory for mesh." << std::endl;
+  }
+
+  const std::shared_ptr<sycl::queue>& queue_ptr(void)
+  {
+    return dims_.queue_ptr();
+  }
+
+  bool is_on_device(void)
+  {
+    return dims_.is_on_device();
+  }
+
+  void move_to_device(void);
+
+  void move_to_host(void);
+
+  template<MeshComponent C>
+  inline size_t object_count(void) const;
+
+  template<>
+  inline size_t object_count<MeshComponent::Cell>(void) const
+  {
+    return dim(SparseCartesian2DMeshOps::ncells);
+  }
+
+  template<>
+  inline size_t object_count<MeshComponent::Face>(void) const
+  {
+    return dim(SparseCartesian2DMeshOps::nfaces);
+  }
+
+  template<>
+  inline size_t object_count<MeshComponent::Vertex>(void) const
+  {
+    return dim(SparseCartesian2DMeshOps::nvertices);
+  }
+
+  template<MeshComponent C>
+  inline std::array<double,2> get_object_location(const size_t& i) const
+  {
+    return get_row_major_location<C>(keys<C>()[i]);
+  }
+
+  template<MeshComponent C>
+  size_t get_nearest_object_index(const std::array<double,2>& loc) const;
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Cell>(const std::array<double,2>& loc) const
+  {
+    return SparseCartesian2DMeshOps::nearest_cell(dims_.host_vector(),
+						  geom_.host_vector(),
+						  cells_.host_vector(), loc);
+  }
+
+  /**
+     Return the number of objects in the full grid.
+   */
+  template<MeshComponent C>
+  size_t row_major_count(void) const;
+
+  template<>
+  size_t row_major_count<MeshComponent::Cell>(void) const
+  {
+    return dim(SparseCartesian2DMeshOps::nx) * dim(SparseCartesian2DMeshOps::ny);
+  }
+
+  template<>
+  size_t row_major_count<MeshComponent::Face>(void) const
+  {
+    return (dim(SparseCartesian2DMeshOps::nx) + 1) * dim(SparseCartesian2DMeshOps::ny) +
+      (dim(SparseCartesian2DMeshOps::ny) + 1) * dim(SparseCartesian2DMeshOps::nx);
+  }
+
+  template<>
+  size_t row_major_count<MeshComponent::Vertex>(void) const
+  {
+    return (dim(SparseCartesian2DMeshOps::nx) + 1) *
+      (dim(SparseCartesian2DMeshOps::ny) + 1);
+  }
+
+  template<MeshComponent C>
+  std::array<double,2> get_row_major_location(const size_t& i) const;
+
+  template<>
+  std::array<double,2>
+  get_row_major_location<MeshComponent::Cell>(const size_t& i) const
+  {
+    return SparseCartesian2DMeshOps::cell_location(dims_.host_vector(),
+						   geom_.host_vector(), i);
+  }
+
+  template<>
+  std::array<double,2>
+  get_row_major_location<MeshComponent::Face>(const size_t& i) const
+  {
+    return SparseCartesian2DMeshOps::face_location(dims_.host_vector(),
+						   geom_.host_vector(), i);
+  }
+
+  template<>
+  std::array<double,2>
+  get_row_major_location<MeshComponent::Vertex>(const size_t& i) const
+  {
+    return SparseCartesian2DMeshOps::vertex_location(dims_.host_vector(),
+						     geom_.host_vector(), i);
+  }
+
+  /**
+     Return the id of the object at row-major position i of the full
+     grid, or the object count if it is not stored.
+   */
+  template<MeshComponent C>
+  size_t storage_index(const size_t& i) const
+  {
+    return SparseCartesian2DMeshOps::find(keys<C>(), object_count<C>(), i);
+  }
+
+  /**
+     Return the row-major position in the full grid of the object
+     with id i.
+   */
+  template<MeshComponent C>
+  size_t row_major_index(const size_t& i) const
+  {
+    return keys<C>()[i];
+  }
+
+protected:
+
+  friend class SparseCartesian2DMeshAccessor;
+
+  const DataArray<size_t>& dims_data(void) const { return dims_; }
+  const DataArray<double>& geom_data(void) const { return geom_; }
+  const DataArray<size_t>& cells_data(void) const { return cells_; }
+  const DataArray<size_t>& faces_data(void) const { return faces_; }
+  const DataArray<size_t>& vertices_data(void) const { return vertices_; }
+  const DataArray<size_t>& face_cells_data(void) const { return face_cells_; }
+  const DataArray<int32_t>& face_info_data(void) const { return face_info_; }
+  const DataArray<size_t>& cell_faces_data(void) const { return cell_faces_; }
+
+};
+
+class SparseCartesian2DMeshAccessor
+{
+private:
+
+  using Ops = SparseCartesian2DMeshOps;
+
+  template<typename T>
+  using ROAccessor =
+    typename DataArray<T>::
+    template Accessor<sycl::access::mode::read,
+		      sycl::access::target::global_buffer,
+		      sycl::access::placeholder::true_t>;
+
+  ROAccessor<size_t> dims_ro_;
+
+  ROAccessor<double> geom_ro_;
+
+  ROAccessor<size_t> cells_ro_;
+
+  ROAccessor<size_t> faces_ro_;
+
+  ROAccessor<size_t> vertices_ro_;
+
+  ROAccessor<size_t> face_cells_ro_;
+
+  ROAccessor<int32_t> face_info_ro_;
+
+  ROAccessor<size_t> cell_faces_ro_;
+
+  inline const size_t& nxcells(void) const { return dims_ro_[Ops::nx]; }
+
+public:
+
+  static constexpr bool has_hanging_faces = false;
+
+  static constexpr bool has_face_normals = false;
+
+  static constexpr bool has_block_clocks = false;
+
+  SparseCartesian2DMeshAccessor(const SparseCartesian2DMesh& sm);
+
+  void bind(sycl::handler& cgh);
+
+  inline const double& dx(void) const { return geom_ro_[2]; }
+  inline const double& dy(void) const { return geom_ro_[3]; }
+
+  inline const double& dx(const size_t& i) const { return dx(); }
+  inline const double& dy(const size_t& i) const { return dy(); }
+
+  template<MeshComponent C>
+  inline size_t object_count(void) const;
+
+  template<>
+  inline size_t object_count<MeshComponent::Cell>(void) const
+  {
+    return dims_ro_[Ops::ncells];
+  }
+
+  template<>
+  inline size_t object_count<MeshComponent::Face>(void) const
+  {
+    return dims_ro_[Ops::nfaces];
+  }
+
+  template<>
+  inline size_t object_count<MeshComponent::Vertex>(void) const
+  {
+    return dims_ro_[Ops::nvertices];
+  }
+
+  inline double cell_area(const size_t& i) const
+  {
+    return dx() * dy();
+  }
+
+  template<MeshComponent C>
+  inline std::array<double,2> get_object_location(const size_t& i) const;
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Cell>(const size_t& i) const
+  {
+    return Ops::cell_location(dims_ro_, geom_ro_, cells_ro_[i]);
+  }
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Face>(const size_t& i) const
+  {
+    return Ops::face_location(dims_ro_, geom_ro_, faces_ro_[i]);
+  }
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Vertex>(const size_t& i) const
+  {
+    return Ops::vertex_location(dims_ro_, geom_ro_, vertices_ro_[i]);
+  }
+
+  template<MeshComponent C>
+  size_t get_nearest_object_index(const std::array<double,2>& loc) const;
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Cell>(const std::array<double,2>& loc) const
+  {
+    return Ops::nearest_cell(dims_ro_, geom_ro_, cells_ro_, loc);
+  }
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Face>(const std::array<double,2>& loc) const
+  {
+    size_t c = get_nearest_object_index<MeshComponent::Cell>(loc);
+    if (c == object_count<MeshComponent::Cell>()) {
+      return object_count<MeshComponent::Face>();
+    }
+    // The nearest face is the side of the containing cell nearest to loc
+    double fx, fy;
+    Ops::coordinate(dims_ro_, geom_ro_, loc, fx, fy);
+    double rx = fx - sycl::floor(fx);
+    double ry = fy - sycl::floor(fy);
+    double dmin = sycl::fmin(sycl::fmin(rx, 1.0 - rx), sycl::fmin(ry, 1.0 - ry));
+    if (dmin == rx) {
+      return cell_faces_ro_[4 * c];
+    } else if (dmin == 1.0 - rx) {
+      return cell_faces_ro_[4 * c + 1];
+    } else if (dmin == ry) {
+      return cell_faces_ro_[4 * c + 2];
+    } else {
+      return cell_faces_ro_[4 * c + 3];
+    }
+  }
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Vertex>(const std::array<double,2>& loc) const
+  {
+    size_t c = get_nearest_object_index<MeshComponent::Cell>(loc);
+    if (c == object_count<MeshComponent::Cell>()) {
+      return object_count<MeshComponent::Vertex>();
+    }
+    double fx, fy;
+    Ops::coordinate(dims_ro_, geom_ro_, loc, fx, fy);
+    size_t key = size_t(sycl::round(fy)) * (nxcells() + 1) + size_t(sycl::round(fx));
+    return Ops::find(vertices_ro_, object_count<MeshComponent::Vertex>(), key);
+  }
+
+  struct get_adjacent_cells_result
+  {
+    size_t lhs_id;
+    size_t rhs_id;
+    int edge;
+    int dir;
+    double dx;
+  };
+
+  get_adjacent_cells_result get_adjacent_cells(const size_t& face_id) const
+  {
+    get_adjacent_cells_result result;
+    result.lhs_id = face_cells_ro_[2 * face_id];
+    result.rhs_id = face_cells_ro_[2 * face_id + 1];
+    result.edge = face_info_ro_[2 * face_id];
+    result.dir = face_info_ro_[2 * face_id + 1];
+    result.dx = (result.dir == 0) ? dx() : dy();
+    return result;
+  }
+
+  struct get_adjacent_faces_result
+  {
+    size_t face_w;
+    size_t face_e;
+    double dx;
+    size_t face_s;
+    size_t face_n;
+    double dy;
+  };
+
+  get_adjacent_faces_result get_adjacent_faces(const size_t& cell_id) const
+  {
+    get_adjacent_faces_result result;
+    result.face_w = cell_faces_ro_[4 * cell_id];
+    result.face_e = cell_faces_ro_[4 * cell_id + 1];
+    result.dx = dx();
+    result.face_s = cell_faces_ro_[4 * cell_id + 2];
+    result.face_n = cell_faces_ro_[4 * cell_id + 3];
+    result.dy = dy();
+    return result;
+  }
+
+  struct get_hanging_faces_result
+  {
+    size_t face_w;
+    size_t face_e;
+    size_t face_s;
+    size_t face_n;
+  };
+
+  /**
+     Return the second face on each side of a cell. Sides are never
+     split, so these are the faces returned by get_adjacent_faces.
+   */
+  get_hanging_faces_result get_hanging_faces(const size_t& cell_id) const
+  {
+    return { cell_faces_ro_[4 * cell_id], cell_faces_ro_[4 * cell_id + 1],
+	     cell_faces_ro_[4 * cell_id + 2], cell_faces_ro_[4 * cell_id + 3] };
+  }
+
+  struct offset_type
+  {
+    size_t i;
+    double dx;
+  };
+
+  template<MeshComponent C>
+  offset_type get_object_west(const size_t& i) const;
+  template<MeshComponent C>
+  offset_type get_object_east(const size_t& i) const;
+  template<MeshComponent C>
+  offset_type get_object_north(const size_t& i) const;
+  template<MeshComponent C>
+  offset_type get_object_south(const size_t& i) const;
+
+  // Neighbours are found through the faces. The neighbour across a
+  // face at the edge of the mesh is the cell itself.
+
+  template<>
+  offset_type get_object_west<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t f = cell_faces_ro_[4 * i];
+    if (face_info_ro_[2 * f] == 0) {
+      return { face_cells_ro_[2 * f], dx() };
+    } else {
+      return { i, 0.0 };
+    }
+  }
+
+  template<>
+  offset_type get_object_east<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t f = cell_faces_ro_[4 * i + 1];
+    if (face_info_ro_[2 * f] == 0) {
+      return { face_cells_ro_[2 * f + 1], dx() };
+    } else {
+      return { i, 0.0 };
+    }
+  }
+
+  template<>
+  offset_type get_object_north<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t f = cell_faces_ro_[4 * i + 3];
+    if (face_info_ro_[2 * f] == 0) {
+      return { face_cells_ro_[2 * f + 1], dy() };
+    } else {
+      return { i, 0.0 };
+    }
+  }
+
+  template<>
+  offset_type get_object_south<MeshComponent::Cell>(const size_t& i) const
+  {
+    size_t f = cell_faces_ro_[4 * i + 2];
+    if (face_info_ro_[2 * f] == 0) {
+      return { face_cells_ro_[2 * f], dy() };
+    } else {
+      return { i, 0.0 };
+    }
+  }
+
+};
+
+#endif
@@ -0,0 +1,689 @@
+/***********************************************************************
+ * mfcm Mesh/UnstructuredMesh.cpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#include "UnstructuredMesh.hpp"
+#include "Config.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+  const size_t no_vertex = std::numeric_limits<size_t>::max();
+
+  /**
+     Vertices and elements as read from a mesh file. Elements refer to
+     vertices by their ids in the file, and triangles have no_vertex
+     as their last vertex.
+   */
+  struct MeshFileContents
+  {
+    std::vector<size_t> vertex_ids;
+    std::vector<double> vertices;
+    std::vector<std::array<size_t,4>> elements;
+  };
+
+  void read_2dm(std::istream& in, MeshFileContents& contents)
+  {
+    std::string line;
+    while (std::getline(in, line)) {
+      std::istringstream ls(line);
+      std::string card;
+      size_t id;
+      ls >> card;
+      if (card == "ND") {
+	double x, y;
+	ls >> id >> x >> y;
+	contents.vertex_ids.push_back(id);
+	contents.vertices.push_back(x);
+	contents.vertices.push_back(y);
+      } else if (card == "E3T") {
+	std::array<size_t,4> e = { 0, 0, 0, no_vertex };
+	ls >> id >> e[0] >> e[1] >> e[2];
+	contents.elements.push_back(e);
+      } else if (card == "E4Q") {
+	std::array<size_t,4> e;
+	ls >> id >> e[0] >> e[1] >> e[2] >> e[3];
+	contents.elements.push_back(e);
+      } else {
+	continue;
+      }
+      if (ls.fail()) {
+	std::cerr << "ERROR: Cannot read 2DM line \"" << line << "\"." << std::endl;
+	throw std::runtime_error("Invalid 2DM file.");
+      }
+    }
+  }
+
+  void read_gmsh(std::istream& in, MeshFileContents& contents)
+  {
+    std::string line;
+    while (std::getline(in, line)) {
+      boost::algorithm::trim(line);
+      if (line == "$MeshFormat") {
+	double version;
+	int file_type;
+	in >> version >> file_type;
+	if (version >= 3.0 or file_type != 0) {
+	  std::cerr << "ERROR: Only ASCII Gmsh files in the version 2 format "
+		    << "can be read." << std::endl;
+	  throw std::runtime_error("Unsupported Gmsh file.");
+	}
+      } else if (line == "$Nodes") {
+	size_t n;
+	in >> n;
+	for (size_t i = 0; i < n; ++i) {
+	  size_t id;
+	  double x, y, z;
+	  in >> id >> x >> y >> z;
+	  contents.vertex_ids.push_back(id);
+	  contents.vertices.push_back(x);
+	  contents.vertices.push_back(y);
+	}
+      } else if (line == "$Elements") {
+	size_t n;
+	in >> n;
+	for (size_t i = 0; i < n; ++i) {
+	  size_t id, ntags;
+	  int type;
+	  in >> id >> type >> ntags;
+	  for (size_t t = 0; t < ntags; ++t) {
+	    long tag;
+	    in >> tag;
+	  }
+	  // Element types 2 and 3 are 3-node triangles and 4-node
+	  // quadrilaterals. Other elements (points, lines and
+	  // higher-order elements) are skipped.
+	  std::getline(in, line);
+	  std::istringstream ls(line);
+	  std::array<size_t,4> e = { 0, 0, 0, no_vertex };
+	  if (type == 2) {
+	    ls >> e[0] >> e[1] >> e[2];
+	  } else if (type == 3) {
+	    ls >> e[0] >> e[1] >> e[2] >> e[3];
+	  } else {
+	    continue;
+	  }
+	  contents.elements.push_back(e);
+	}
+      }
+      if (in.fail()) {
+	std::cerr << "ERROR: Cannot read Gmsh file." << std::endl;
+	throw std::runtime_error("Invalid Gmsh file.");
+      }
+    }
+  }
+
+  /**
+     Return the number of vertices of an element.
+   */
+  inline size_t element_size(const std::array<size_t,4>& e, const size_t& nv)
+  {
+    return (e[3] == nv) ? 3 : 4;
+  }
+
+  /**
+     Return the signed area and the centroid of an element.
+   */
+  std::array<double,3> element_geometry(const std::array<size_t,4>& e,
+					const std::vector<double>& xy,
+					const size_t& nv)
+  {
+    // Work relative to the first vertex to avoid losing precision
+    // with large coordinates
+    size_t n = element_size(e, nv);
+    double x0 = xy[2 * e[0]];
+    double y0 = xy[2 * e[0] + 1];
+    double a = 0.0;
+    double cx = 0.0;
+    double cy = 0.0;
+    for (size_t k = 0; k < n; ++k) {
+      double px = xy[2 * e[k]] - x0;
+      double py = xy[2 * e[k] + 1] - y0;
+      double qx = xy[2 * e[(k + 1) % n]] - x0;
+      double qy = xy[2 * e[(k + 1) % n] + 1] - y0;
+      double cross = px * qy - qx * py;
+      a += cross;
+      cx += (px + qx) * cross;
+      cy += (py + qy) * cross;
+    }
+    a *= 0.5;
+    return { x0 + cx / (6.0 * a), y0 + cy / (6.0 * a), a };
+  }
+
+  /**
+     Return the reverse Cuthill-McKee ordering of a graph.
+   */
+  std::vector<size_t> rcm_order(const std::vector<std::vector<size_t>>& adj)
+  {
+    size_t n = adj.size();
+    auto by_degree = [&](const size_t& a, const size_t& b)
+    {
+      return adj[a].size() < adj[b].size() or
+	(adj[a].size() == adj[b].size() and a < b);
+    };
+    std::vector<size_t> starts(n);
+    for (size_t i = 0; i < n; ++i) {
+      starts[i] = i;
+    }
+    std::sort(starts.begin(), starts.end(), by_degree);
+
+    std::vector<size_t> order;
+    order.reserve(n);
+    std::vector<bool> visited(n, false);
+    for (auto&& s : starts) {
+      if (visited[s]) {
+	continue;
+      }
+      // Breadth-first search of this component from a cell of lowest
+      // degree, visiting neighbours in order of increasing degree
+      size_t head = order.size();
+      visited[s] = true;
+      order.push_back(s);
+      while (head < order.size()) {
+	size_t c = order[head++];
+	std::vector<size_t> nbrs;
+	for (auto&& j : adj[c]) {
+	  if (not visited[j]) {
+	    visited[j] = true;
+	    nbrs.push_back(j);
+	  }
+	}
+	std::sort(nbrs.begin(), nbrs.end(), by_degree);
+	order.insert(order.end(), nbrs.begin(), nbrs.end());
+      }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+  }
+
+  /**
+     Return the order of points along a Morton (Z-order) curve.
+   */
+  std::vector<size_t> morton_order(const std::vector<std::array<double,3>>& geom)
+  {
+    size_t n = geom.size();
+    double xmin = std::numeric_limits<double>::infinity();
+    double ymin = xmin;
+    double xmax = -xmin;
+    double ymax = -xmin;
+    for (auto&& g : geom) {
+      xmin = std::min(xmin, g[0]);
+      xmax = std::max(xmax, g[0]);
+      ymin = std::min(ymin, g[1]);
+      ymax = std::max(ymax, g[1]);
+    }
+    double scale = 65535.0 / std::max(std::max(xmax - xmin, ymax - ymin), 1.0e-12);
+    auto spread = [](uint32_t v) -> uint32_t
+    {
+      v = (v | (v << 8)) & 0x00ff00ff;
+      v = (v | (v << 4)) & 0x0f0f0f0f;
+      v = (v | (v << 2)) & 0x33333333;
+      v = (v | (v << 1)) & 0x55555555;
+      return v;
+    };
+    std::vector<uint32_t> keys(n);
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i) {
+      uint32_t ix = uint32_t((geom[i][0] - xmin) * scale);
+      uint32_t iy = uint32_t((geom[i][1] - ymin) * scale);
+      keys[i] = spread(ix) | (spread(iy) << 1);
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(),
+		     [&](const size_t& a, const size_t& b) { return keys[a] < keys[b]; });
+    return order;
+  }
+
+}
+
+void UnstructuredMesh::build_(const Config& conf)
+{
+  using Ops = UnstructuredMeshOps;
+  const size_t nslots = Ops::max_cell_faces;
+
+  // Read the file
+  stdfs::path filepath = conf.get<stdfs::path>("filename");
+  if (not filepath.is_absolute()) {
+    filepath = GlobalConfig::instance().simulation_base_path() / filepath;
+  }
+  std::string format = conf.get<std::string>("format", "");
+  if (format == "") {
+    std::string ext = filepath.extension().string();
+    boost::algorithm::to_lower(ext);
+    format = (ext == ".msh") ? "gmsh" : "2dm";
+  }
+  std::ifstream in(filepath);
+  if (not in) {
+    std::cerr << "ERROR: Cannot open mesh file " << filepath << std::endl;
+    throw std::runtime_error("Cannot open mesh file.");
+  }
+  MeshFileContents contents;
+  if (format == "2dm") {
+    read_2dm(in, contents);
+  } else if (format == "gmsh") {
+    read_gmsh(in, contents);
+  } else {
+    std::cerr << "ERROR: Unknown mesh file format " << std::quoted(format)
+	      << std::endl;
+    throw std::runtime_error("Unknown mesh file format.");
+  }
+  if (contents.elements.empty()) {
+    std::cerr << "ERROR: The mesh file " << filepath
+	      << " contains no triangles or quadrilaterals." << std::endl;
+    throw std::runtime_error("Mesh file has no elements.");
+  }
+
+  // Keep only the vertices used by elements, in the order of the
+  // file, and refer to them by position
+  std::unordered_map<size_t,size_t> vertex_pos;
+  for (size_t i = 0; i < contents.vertex_ids.size(); ++i) {
+    vertex_pos[contents.vertex_ids[i]] = i;
+  }
+  std::vector<size_t> vertex_index(contents.vertex_ids.size(), no_vertex);
+  std::vector<double>& xy = vertices_.host_vector();
+  for (auto&& e : contents.elements) {
+    for (auto&& v : e) {
+      if (v == no_vertex) {
+	continue;
+      }
+      auto it = vertex_pos.find(v);
+      if (it == vertex_pos.end()) {
+	std::cerr << "ERROR: An element refers to node " << v
+		  << ", which is not in the mesh file." << std::endl;
+	throw std::runtime_error("Invalid mesh file.");
+      }
+      size_t& vi = vertex_index[it->second];
+      if (vi == no_vertex) {
+	vi = xy.size() / 2;
+	xy.push_back(contents.vertices[2 * it->second]);
+	xy.push_back(contents.vertices[2 * it->second + 1]);
+      }
+      v = vi;
+    }
+  }
+  size_t nv = xy.size() / 2;
+  size_t nc = contents.elements.size();
+
+  // Store vertices anticlockwise, with the vertex count marking the
+  // last vertex of triangles
+  std::vector<std::array<size_t,4>>& elements = contents.elements;
+  for (auto&& e : elements) {
+    if (e[3] == no_vertex) {
+      e[3] = nv;
+    }
+    double a = element_geometry(e, xy, nv)[2];
+    if (not (std::fabs(a) > 0.0)) {
+      std::cerr << "ERROR: The mesh file " << filepath
+		<< " contains an element with no area." << std::endl;
+      throw std::runtime_error("Invalid mesh.");
+    }
+    if (a < 0.0) {
+      std::reverse(e.begin(), e.begin() + element_size(e, nv));
+    }
+  }
+
+  // Renumber the cells
+  std::string reordering = conf.get<std::string>("reordering", "rcm");
+  std::vector<size_t>& order = cell_file_order_;
+  if (reordering == "rcm") {
+    std::map<std::pair<size_t,size_t>,size_t> edge_cell;
+    std::vector<std::vector<size_t>> adj(nc);
+    for (size_t c = 0; c < nc; ++c) {
+      size_t n = element_size(elements[c], nv);
+      for (size_t k = 0; k < n; ++k) {
+	size_t a = elements[c][k];
+	size_t b = elements[c][(k + 1) % n];
+	auto key = std::minmax(a, b);
+	auto it = edge_cell.find(key);
+	if (it == edge_cell.end()) {
+	  edge_cell[key] = c;
+	} else {
+	  adj[c].push_back(it->second);
+	  adj[it->second].push_back(c);
+	}
+      }
+    }
+    order = rcm_order(adj);
+  } else if (reordering == "morton") {
+    std::vector<std::array<double,3>> geom(nc);
+    for (size_t c = 0; c < nc; ++c) {
+      geom[c] = element_geometry(elements[c], xy, nv);
+    }
+    order = morton_order(geom);
+  } else if (reordering == "none") {
+    order.resize(nc);
+    for (size_t c = 0; c < nc; ++c) {
+      order[c] = c;
+    }
+  } else {
+    std::cerr << "ERROR: Unknown mesh reordering " << std::quoted(reordering)
+	      << std::endl;
+    throw std::runtime_error("Unknown mesh reordering.");
+  }
+  cell_storage_order_.resize(nc);
+  for (size_t c = 0; c < nc; ++c) {
+    cell_storage_order_[order[c]] = c;
+  }
+
+  std::vector<size_t>& cell_vertices = cell_vertices_.host_vector();
+  std::vector<double>& cell_geom = cell_geom_.host_vector();
+  cell_vertices.resize(nslots * nc);
+  cell_geom.resize(5 * nc);
+  for (size_t c = 0; c < nc; ++c) {
+    const std::array<size_t,4>& e = elements[order[c]];
+    std::copy(e.begin(), e.end(), cell_vertices.begin() + nslots * c);
+    std::array<double,3> g = element_geometry(e, xy, nv);
+    std::copy(g.begin(), g.end(), cell_geom.begin() + 5 * c);
+  }
+
+  // Faces, numbered in order of the first cell they bound
+  std::map<std::pair<size_t,size_t>,size_t> edge_face;
+  std::vector<std::array<size_t,4>> face_defs;   // { cell, a, b, other cell }
+  std::vector<size_t>& cell_faces = cell_faces_.host_vector();
+  cell_faces.assign(nslots * nc, 0);
+  for (size_t c = 0; c < nc; ++c) {
+    size_t n = element_size(elements[order[c]], nv);
+    for (size_t k = 0; k < nslots; ++k) {
+      if (k >= n) {
+	cell_faces[nslots * c + k] = no_vertex;
+	continue;
+      }
+      size_t a = cell_vertices[nslots * c + k];
+      size_t b = cell_vertices[nslots * c + (k + 1) % n];
+      auto key = std::minmax(a, b);
+      auto it = edge_face.find(key);
+      if (it == edge_face.end()) {
+	edge_face[key] = face_defs.size();
+	cell_faces[nslots * c + k] = face_defs.size();
+	face_defs.push_back({ c, a, b, nc });
+      } else {
+	if (face_defs[it->second][3] != nc) {
+	  std::cerr << "ERROR: A side of the mesh is shared by more than "
+		    << "two elements." << std::endl;
+	  throw std::runtime_error("Invalid mesh.");
+	}
+	face_defs[it->second][3] = c;
+	cell_faces[nslots * c + k] = it->second;
+      }
+    }
+  }
+  size_t nf = face_defs.size();
+  for (auto&& f : cell_faces) {
+    if (f == no_vertex) {
+      f = nf;
+    }
+  }
+
+  std::vector<size_t>& face_cells = face_cells_.host_vector();
+  std::vector<int32_t>& face_info = face_info_.host_vector();
+  std::vector<double>& face_geom = face_geom_.host_vector();
+  face_cells.resize(2 * nf);
+  face_info.resize(2 * nf);
+  face_geom.resize(6 * nf);
+  for (size_t f = 0; f < nf; ++f) {
+    auto [ c1, a, b, c2 ] = face_defs[f];
+    double ex = xy[2 * b] - xy[2 * a];
+    double ey = xy[2 * b + 1] - xy[2 * a + 1];
+    double len = std::hypot(ex, ey);
+    // Outward normal of c1, whose vertices are anticlockwise
+    double nx = ey / len;
+    double ny = -ex / len;
+    int32_t dir = (std::fabs(ny) > std::fabs(nx)) ? 1 : 0;
+    size_t lhs = c1;
+    size_t rhs = c2;
+    if ((dir == 0 and nx < 0.0) or (dir == 1 and ny < 0.0)) {
+      nx = -nx;
+      ny = -ny;
+      std::swap(lhs, rhs);
+    }
+    int32_t edge = 0;
+    if (lhs == nc) {
+      lhs = rhs;
+      edge = -1;
+    } else if (rhs == nc) {
+      rhs = lhs;
+      edge = 1;
+    }
+    double mx = 0.5 * (xy[2 * a] + xy[2 * b]);
+    double my = 0.5 * (xy[2 * a + 1] + xy[2 * b + 1]);
+    double dist;
+    if (edge == 0) {
+      dist = std::hypot(cell_geom[5 * rhs] - cell_geom[5 * lhs],
+			cell_geom[5 * rhs + 1] - cell_geom[5 * lhs + 1]);
+    } else {
+      dist = 2.0 * std::hypot(mx - cell_geom[5 * c1], my - cell_geom[5 * c1 + 1]);
+    }
+    face_cells[2 * f] = lhs;
+    face_cells[2 * f + 1] = rhs;
+    face_info[2 * f] = edge;
+    face_info[2 * f + 1] = dir;
+    face_geom[6 * f] = mx;
+    face_geom[6 * f + 1] = my;
+    face_geom[6 * f + 2] = nx;
+    face_geom[6 * f + 3] = ny;
+    face_geom[6 * f + 4] = len;
+    face_geom[6 * f + 5] = dist;
+  }
+
+  // The widths of each cell across the x and y axes are its area
+  // divided by half the lengths of its faces projected onto the
+  // other axis, which are the sides of a rectangular cell
+  std::vector<double> projected(2 * nc, 0.0);
+  for (size_t f = 0; f < nf; ++f) {
+    for (size_t c : { face_defs[f][0], face_defs[f][3] }) {
+      if (c < nc) {
+	projected[2 * c] += std::fabs(face_geom[6 * f + 2]) * face_geom[6 * f + 4];
+	projected[2 * c + 1] += std::fabs(face_geom[6 * f + 3]) * face_geom[6 * f + 4];
+      }
+    }
+  }
+  for (size_t c = 0; c < nc; ++c) {
+    cell_geom[5 * c + 3] = 2.0 * cell_geom[5 * c + 2] / projected[2 * c];
+    cell_geom[5 * c + 4] = 2.0 * cell_geom[5 * c + 2] / projected[2 * c + 1];
+  }
+
+  // The west, east, south and north neighbours of each cell are the
+  // adjacent cells whose centres lie most nearly in each direction
+  std::vector<size_t>& cell_neighbours = cell_neighbours_.host_vector();
+  cell_neighbours.resize(nslots * nc);
+  for (size_t c = 0; c < nc; ++c) {
+    std::array<double,4> best = { 0.0, 0.0, 0.0, 0.0 };
+    for (size_t k = 0; k < 4; ++k) {
+      cell_neighbours[nslots * c + k] = c;
+    }
+    for (size_t k = 0; k < nslots; ++k) {
+      size_t f = cell_faces[nslots * c + k];
+      if (f == nf or face_info[2 * f] != 0) {
+	continue;
+      }
+      size_t j = (face_cells[2 * f] == c) ? face_cells[2 * f + 1] : face_cells[2 * f];
+      double dx = cell_geom[5 * j] - cell_geom[5 * c];
+      double dy = cell_geom[5 * j + 1] - cell_geom[5 * c + 1];
+      double d = std::hypot(dx, dy);
+      std::array<double,4> align = { -dx / d, dx / d, -dy / d, dy / d };
+      for (size_t s = 0; s < 4; ++s) {
+	if (align[s] > std::sqrt(0.5) and align[s] > best[s]) {
+	  best[s] = align[s];
+	  cell_neighbours[nslots * c + s] = j;
+	}
+      }
+    }
+  }
+
+  // Bins for locating cells, about two cells across
+  double xmin = std::numeric_limits<double>::infinity();
+  double ymin = xmin;
+  double xmax = -xmin;
+  double ymax = -xmin;
+  double area = 0.0;
+  for (size_t v = 0; v < nv; ++v) {
+    xmin = std::min(xmin, xy[2 * v]);
+    xmax = std::max(xmax, xy[2 * v]);
+    ymin = std::min(ymin, xy[2 * v + 1]);
+    ymax = std::max(ymax, xy[2 * v + 1]);
+  }
+  for (size_t c = 0; c < nc; ++c) {
+    area += cell_geom[5 * c + 2];
+  }
+  double bin_size = 2.0 * std::sqrt(area / nc);
+  size_t nxbins = std::max(size_t(1), size_t(std::ceil((xmax - xmin) / bin_size)));
+  size_t nybins = std::max(size_t(1), size_t(std::ceil((ymax - ymin) / bin_size)));
+  // Widen the bins slightly so that points on the top and right
+  // edges of the mesh fall inside them
+  double bx = (xmax - xmin) * (1.0 + 1.0e-9) / nxbins + 1.0e-12;
+  double by = (ymax - ymin) * (1.0 + 1.0e-9) / nybins + 1.0e-12;
+  bin_geom_.host_vector() = { xmin, ymin, bx, by };
+
+  std::vector<std::vector<size_t>> bins(nxbins * nybins);
+  for (size_t c = 0; c < nc; ++c) {
+    double cxmin = std::numeric_limits<double>::infinity();
+    double cymin = cxmin;
+    double cxmax = -cxmin;
+    double cymax = -cxmin;
+    for (size_t k = 0; k < nslots; ++k) {
+      size_t v = cell_vertices[nslots * c + k];
+      if (v == nv) {
+	break;
+      }
+      cxmin = std::min(cxmin, xy[2 * v]);
+      cxmax = std::max(cxmax, xy[2 * v]);
+      cymin = std::min(cymin, xy[2 * v + 1]);
+      cymax = std::max(cymax, xy[2 * v + 1]);
+    }
+    size_t ix0 = size_t((cxmin - xmin) / bx);
+    size_t ix1 = std::min(size_t((cxmax - xmin) / bx), nxbins - 1);
+    size_t iy0 = size_t((cymin - ymin) / by);
+    size_t iy1 = std::min(size_t((cymax - ymin) / by), nybins - 1);
+    for (size_t iy = iy0; iy <= iy1; ++iy) {
+      for (size_t ix = ix0; ix <= ix1; ++ix) {
+	bins[iy * nxbins + ix].push_back(c);
+      }
+    }
+  }
+  std::vector<size_t>& bin_start = bin_start_.host_vector();
+  std::vector<size_t>& bin_cells = bin_cells_.host_vector();
+  bin_start.push_back(0);
+  for (auto&& bin : bins) {
+    bin_cells.insert(bin_cells.end(), bin.begin(), bin.end());
+    bin_start.push_back(bin_cells.size());
+  }
+
+  std::vector<size_t>& dims = dims_.host_vector();
+  dims.assign(Ops::size, 0);
+  dims[Ops::ncells] = nc;
+  dims[Ops::nfaces] = nf;
+  dims[Ops::nvertices] = nv;
+  dims[Ops::nxbins] = nxbins;
+  dims[Ops::nybins] = nybins;
+
+  std::cout << "Created an unstructured mesh from " << filepath << " with "
+	    << nc << " cells, " << nf << " faces and " << nv
+	    << " vertices." << std::endl;
+}
+
+UnstructuredMesh::
+UnstructuredMesh(const std::shared_ptr<sycl::queue>& queue,
+		 bool on_device)
+  : dims_(queue, 0),
+    vertices_(queue, 0),
+    cell_vertices_(queue, 0),
+    cell_faces_(queue, 0),
+    cell_neighbours_(queue, 0),
+    cell_geom_(queue, 0),
+    face_cells_(queue, 0),
+    face_info_(queue, 0),
+    face_geom_(queue, 0),
+    bin_geom_(queue, 0),
+    bin_start_(queue, 0),
+    bin_cells_(queue, 0)
+{
+  build_(GlobalConfig::instance().mesh_configuration());
+  if (on_device) {
+    move_to_device();
+  }
+}
+
+void UnstructuredMesh::move_to_device(void)
+{
+  dims_.move_to_device();
+  vertices_.move_to_device();
+  cell_vertices_.move_to_device();
+  cell_faces_.move_to_device();
+  cell_neighbours_.move_to_device();
+  cell_geom_.move_to_device();
+  face_cells_.move_to_device();
+  face_info_.move_to_device();
+  face_geom_.move_to_device();
+  bin_geom_.move_to_device();
+  bin_start_.move_to_device();
+  bin_cells_.move_to_device();
+}
+
+void UnstructuredMesh::move_to_host(void)
+{
+  dims_.move_to_host();
+  vertices_.move_to_host();
+  cell_vertices_.move_to_host();
+  cell_faces_.move_to_host();
+  cell_neighbours_.move_to_host();
+  cell_geom_.move_to_host();
+  face_cells_.move_to_host();
+  face_info_.move_to_host();
+  face_geom_.move_to_host();
+  bin_geom_.move_to_host();
+  bin_start_.move_to_host();
+  bin_cells_.move_to_host();
+}
+
+UnstructuredMeshAccessor::
+UnstructuredMeshAccessor(const UnstructuredMesh& um)
+  : dims_ro_(um.dims_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    vertices_ro_(um.vertices_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    cell_vertices_ro_(um.cell_vertices_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    cell_faces_ro_(um.cell_faces_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    cell_neighbours_ro_(um.cell_neighbours_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    cell_geom_ro_(um.cell_geom_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    face_cells_ro_(um.face_cells_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    face_info_ro_(um.face_info_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    face_geom_ro_(um.face_geom_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    bin_geom_ro_(um.bin_geom_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    bin_start_ro_(um.bin_start_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>()),
+    bin_cells_ro_(um.bin_cells_data().template get_placeholder_accessor<sycl::access::mode::read,sycl::access::target::global_buffer>())
+{}
+
+void UnstructuredMeshAccessor::bind(sycl::handler& cgh)
+{
+  cgh.require(dims_ro_);
+  cgh.require(vertices_ro_);
+  cgh.require(cell_vertices_ro_);
+  cgh.require(cell_faces_ro_);
+  cgh.require(cell_neighbours_ro_);
+  cgh.require(cell_geom_ro_);
+  cgh.require(face_cells_ro_);
+  cgh.require(face_info_ro_);
+  cgh.require(face_geom_ro_);
+  cgh.require(bin_geom_ro_);
+  cgh.require(bin_start_ro_);
+  cgh.require(bin_cells_ro_);
+}
@@ -0,0 +1,719 @@
+/***********************************************************************
+ * mfcm Mesh/UnstructuredMesh.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_Mesh_UnstructuredMesh_hpp
+#define mfcm_Mesh_UnstructuredMesh_hpp
+
+#include "Mesh.hpp"
+#include "DataArray.hpp"
+#include "Config.hpp"
+
+class UnstructuredMeshAccessor;
+
+/**
+   Geometric searches shared by UnstructuredMesh (on the host) and
+   UnstructuredMeshAccessor (on the device). The mesh arrays are
+   passed as anything that can be indexed with [].
+
+   Every cell has max_cell_faces vertex and face slots. Triangles
+   leave the last slot empty, which is marked by the vertex (or face)
+   count. Cell vertices are stored anticlockwise.
+
+   Cells are located through a uniform grid of bins over the bounding
+   box of the mesh. The cells overlapping bin b are
+   bin_cells[bin_start[b]] to bin_cells[bin_start[b + 1] - 1]. The
+   bin geometry is the origin and size of a bin, as in
+   Cartesian2DMesh.
+ */
+struct UnstructuredMeshOps
+{
+  static constexpr size_t max_cell_faces = 4;
+
+  enum Dim : size_t
+    {
+      ncells = 0,
+      nfaces,
+      nvertices,
+      nxbins,
+      nybins,
+      size
+    };
+
+  /**
+     Return true if loc is inside (or on the boundary of) cell c.
+   */
+  template<typename D, typename V, typename CV>
+  static bool contains(const D& dims, const V& vertices, const CV& cell_vertices,
+		       const size_t& c, const std::array<double,2>& loc)
+  {
+    for (size_t k = 0; k < max_cell_faces; ++k) {
+      size_t a = cell_vertices[max_cell_faces * c + k];
+      if (a == dims[nvertices]) {
+	break;
+      }
+      size_t b = cell_vertices[max_cell_faces * c + k + 1];
+      if (k + 1 == max_cell_faces or b == dims[nvertices]) {
+	b = cell_vertices[max_cell_faces * c];
+      }
+      double ex = vertices[2 * b] - vertices[2 * a];
+      double ey = vertices[2 * b + 1] - vertices[2 * a + 1];
+      double px = loc[0] - vertices[2 * a];
+      double py = loc[1] - vertices[2 * a + 1];
+      if (ex * py - ey * px < 0.0) {
+	return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+     Return the id of the cell containing a location, or the cell
+     count if there is none.
+   */
+  template<typename D, typename G, typename BS, typename BC,
+	   typename V, typename CV>
+  static size_t nearest_cell(const D& dims, const G& bin_geom,
+			     const BS& bin_start, const BC& bin_cells,
+			     const V& vertices, const CV& cell_vertices,
+			     const std::array<double,2>& loc)
+  {
+    double fx = (loc[0] - bin_geom[0]) / bin_geom[2];
+    double fy = (loc[1] - bin_geom[1]) / bin_geom[3];
+    if (not (fx >= 0.0 and fx < dims[nxbins] and fy >= 0.0 and fy < dims[nybins])) {
+      return dims[ncells];
+    }
+    size_t b = size_t(fy) * dims[nxbins] + size_t(fx);
+    for (size_t j = bin_start[b]; j < bin_start[b + 1]; ++j) {
+      if (contains(dims, vertices, cell_vertices, bin_cells[j], loc)) {
+	return bin_cells[j];
+      }
+    }
+    return dims[ncells];
+  }
+
+  template<typename V>
+  static double distance2(const V& xy, const size_t& i,
+			  const std::array<double,2>& loc)
+  {
+    double dx = xy[2 * i] - loc[0];
+    double dy = xy[2 * i + 1] - loc[1];
+    return dx * dx + dy * dy;
+  }
+
+  /**
+     Return the id of the object (of which the cell has the given
+     slots and whose locations are xy) nearest to loc, or n if the
+     cell count is given.
+   */
+  template<typename D, typename S, typename V>
+  static size_t nearest_slot(const D& dims, const S& slots, const V& xy,
+			     const size_t& c, const size_t& n,
+			     const std::array<double,2>& loc)
+  {
+    if (c == dims[ncells]) {
+      return n;
+    }
+    size_t best = n;
+    double dmin = 0.0;
+    for (size_t k = 0; k < max_cell_faces; ++k) {
+      size_t j = slots[max_cell_faces * c + k];
+      if (j == n) {
+	break;
+      }
+      double d = distance2(xy, j, loc);
+      if (best == n or d < dmin) {
+	best = j;
+	dmin = d;
+      }
+    }
+    return best;
+  }
+
+};
+
+/**
+   Class representing an unstructured mesh of triangles and
+   quadrilaterals, which can follow the lines of embankments,
+   channels and structures that a Cartesian grid cannot.
+
+   The mesh is read from "filename" in the mesh configuration, which
+   is either an SMS 2DM file (".2dm") or an ASCII Gmsh file in the
+   version 2 format (".msh"). The "format" key ("2dm" or "gmsh")
+   overrides the file extension. Only triangular and quadrilateral
+   elements are used.
+
+   Cells are renumbered when the mesh is read, so that cells that are
+   near each other in space are near each other in memory. The
+   "reordering" key selects reverse Cuthill-McKee ("rcm", the
+   default), a Morton space-filling curve ("morton") or the order of
+   the file ("none"). Faces are numbered in order of the first cell
+   they bound. Outputs are written in the element order of the file.
+
+   Each face has a unit normal pointing from its lhs cell to its rhs
+   cell. Normals are oriented so that their larger component is
+   positive, and dir is 0 if that is the x component and 1 if it is
+   the y component, so that faces of a Cartesian mesh read this way
+   match those of Cartesian2DMesh.
+ */
+class UnstructuredMesh
+{
+public:
+
+  using Accessor = UnstructuredMeshAccessor;
+
+  /**
+     Every cell side is a single face.
+   */
+  static constexpr bool has_hanging_faces = false;
+
+  /**
+     Faces have arbitrary orientations.
+   */
+  static constexpr bool has_face_normals = true;
+
+  static constexpr bool has_block_clocks = false;
+
+  static constexpr size_t max_cell_faces = UnstructuredMeshOps::max_cell_faces;
+
+private:
+
+  DataArray<size_t> dims_;
+
+  DataArray<double> vertices_;
+
+  DataArray<size_t> cell_vertices_;
+
+  DataArray<size_t> cell_faces_;
+
+  DataArray<size_t> cell_neighbours_;
+
+  DataArray<double> cell_geom_;
+
+  DataArray<size_t> face_cells_;
+
+  DataArray<int32_t> face_info_;
+
+  DataArray<double> face_geom_;
+
+  DataArray<double> bin_geom_;
+
+  DataArray<size_t> bin_start_;
+
+  DataArray<size_t> bin_cells_;
+
+  std::vector<size_t> cell_file_order_;
+
+  std::vector<size_t> cell_storage_order_;
+
+  void build_(const Config& conf);
+
+  inline const size_t& dim(UnstructuredMeshOps::Dim d) const
+  {
+    return dims_.host_vector()[d];
+  }
+
+public:
+
+  /**
+     Construct from the mesh configuration.
+   */
+  UnstructuredMesh(const std::shared_ptr<sycl::queue>& queue,
+		   bool on_device = true);
+
+  ~UnstructuredMesh(void)
+  {
+    std::cout << "Freeing memory for mesh." << std::endl;
+  }
+
+  const std::shared_ptr<sycl::queue>& queue_ptr(void)
+  {
+    return dims_.queue_ptr();
+  }
+
+  bool is_on_device(void)
+  {
+    return dims_.is_on_device();
+  }
+
+  void move_to_device(void);
+
+  void move_to_host(void);
+
+  template<MeshComponent C>
+  inline size_t object_count(void) const;
+
+  template<>
+  inline size_t object_count<MeshComponent::Cell>(void) const
+  {
+    return dim(UnstructuredMeshOps::ncells);
+  }
+
+  template<>
+  inline size_t object_count<MeshComponent::Face>(void) const
+  {
+    return dim(UnstructuredMeshOps::nfaces);
+  }
+
+  template<>
+  inline size_t object_count<MeshComponent::Vertex>(void) const
+  {
+    return dim(UnstructuredMeshOps::nvertices);
+  }
+
+  template<MeshComponent C>
+  inline std::array<double,2> get_object_location(const size_t& i) const;
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Cell>(const size_t& i) const
+  {
+    return { cell_geom_.host_vector()[5 * i], cell_geom_.host_vector()[5 * i + 1] };
+  }
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Face>(const size_t& i) const
+  {
+    return { face_geom_.host_vector()[6 * i], face_geom_.host_vector()[6 * i + 1] };
+  }
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Vertex>(const size_t& i) const
+  {
+    return { vertices_.host_vector()[2 * i], vertices_.host_vector()[2 * i + 1] };
+  }
+
+  template<MeshComponent C>
+  size_t get_nearest_object_index(const std::array<double,2>& loc) const;
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Cell>(const std::array<double,2>& loc) const
+  {
+    return UnstructuredMeshOps::nearest_cell(dims_.host_vector(),
+					     bin_geom_.host_vector(),
+					     bin_start_.host_vector(),
+					     bin_cells_.host_vector(),
+					     vertices_.host_vector(),
+					     cell_vertices_.host_vector(), loc);
+  }
+
+  /**
+     Return the number of objects written to outputs.
+   */
+  template<MeshComponent C>
+  size_t row_major_count(void) const
+  {
+    return object_count<C>();
+  }
+
+  /**
+     Return the location of the object at position i of the
+     outputs. Cells are written in the order of the mesh file.
+   */
+  template<MeshComponent C>
+  std::array<double,2> get_row_major_location(const size_t& i) const
+  {
+    return get_object_location<C>(storage_index<C>(i));
+  }
+
+  /**
+     Return the id of the object at position i of the outputs.
+   */
+  template<MeshComponent C>
+  size_t storage_index(const size_t& i) const
+  {
+    if constexpr (C == MeshComponent::Cell) {
+      return cell_storage_order_[i];
+    } else {
+      return i;
+    }
+  }
+
+  /**
+     Return the position in the outputs of the object with id i.
+   */
+  template<MeshComponent C>
+  size_t row_major_index(const size_t& i) const
+  {
+    if constexpr (C == MeshComponent::Cell) {
+      return cell_file_order_[i];
+    } else {
+      return i;
+    }
+  }
+
+protected:
+
+  friend class UnstructuredMeshAccessor;
+
+  const DataArray<size_t>& dims_data(void) const { return dims_; }
+  const DataArray<double>& vertices_data(void) const { return vertices_; }
+  const DataArray<size_t>& cell_vertices_data(void) const { return cell_vertices_; }
+  const DataArray<size_t>& cell_faces_data(void) const { return cell_faces_; }
+  const DataArray<size_t>& cell_neighbours_data(void) const { return cell_neighbours_; }
+  const DataArray<double>& cell_geom_data(void) const { return cell_geom_; }
+  const DataArray<size_t>& face_cells_data(void) const { return face_cells_; }
+  const DataArray<int32_t>& face_info_data(void) const { return face_info_; }
+  const DataArray<double>& face_geom_data(void) const { return face_geom_; }
+  const DataArray<double>& bin_geom_data(void) const { return bin_geom_; }
+  const DataArray<size_t>& bin_start_data(void) const { return bin_start_; }
+  const DataArray<size_t>& bin_cells_data(void) const { return bin_cells_; }
+
+};
+
+class UnstructuredMeshAccessor
+{
+private:
+
+  using Ops = UnstructuredMeshOps;
+
+  template<typename T>
+  using ROAccessor =
+    typename DataArray<T>::
+    template Accessor<sycl::access::mode::read,
+		      sycl::access::target::global_buffer,
+		      sycl::access::placeholder::true_t>;
+
+  ROAccessor<size_t> dims_ro_;
+
+  ROAccessor<double> vertices_ro_;
+
+  ROAccessor<size_t> cell_vertices_ro_;
+
+  ROAccessor<size_t> cell_faces_ro_;
+
+  ROAccessor<size_t> cell_neighbours_ro_;
+
+  ROAccessor<double> cell_geom_ro_;
+
+  ROAccessor<size_t> face_cells_ro_;
+
+  ROAccessor<int32_t> face_info_ro_;
+
+  ROAccessor<double> face_geom_ro_;
+
+  ROAccessor<double> bin_geom_ro_;
+
+  ROAccessor<size_t> bin_start_ro_;
+
+  ROAccessor<size_t> bin_cells_ro_;
+
+  /**
+     Return the face on side k (0 to 3 for west, east, south and
+     north) of cell i, i.e. the face whose outward normal is closest
+     to that direction.
+   */
+  size_t side_face(const size_t& i, const size_t& k) const
+  {
+    size_t best = object_count<MeshComponent::Face>();
+    double amax = 0.0;
+    for (size_t j = 0; j < Ops::max_cell_faces; ++j) {
+      size_t f = cell_face(i, j);
+      if (f == object_count<MeshComponent::Face>()) {
+	break;
+      }
+      std::array<double,2> n = outward_normal(i, f);
+      double a = (k < 2) ? n[0] : n[1];
+      a = (k % 2 == 0) ? -a : a;
+      if (best == object_count<MeshComponent::Face>() or a > amax) {
+	best = f;
+	amax = a;
+      }
+    }
+    return best;
+  }
+
+  inline std::array<double,2> outward_normal(const size_t& i, const size_t& f) const
+  {
+    std::array<double,2> n = face_normal(f);
+    if (face_cells_ro_[2 * f] == i and face_info_ro_[2 * f] != -1) {
+      return n;
+    }
+    return { -n[0], -n[1] };
+  }
+
+public:
+
+  static constexpr bool has_hanging_faces = false;
+
+  static constexpr bool has_face_normals = true;
+
+  static constexpr bool has_block_clocks = false;
+
+  static constexpr size_t max_cell_faces = Ops::max_cell_faces;
+
+  UnstructuredMeshAccessor(const UnstructuredMesh& um);
+
+  void bind(sycl::handler& cgh);
+
+  /**
+     Width of cell i across the x and y axes: its area divided by
+     half the lengths of its faces projected onto the other axis.
+     These are the sides of a rectangular cell.
+   */
+  inline const double& dx(const size_t& i) const { return cell_geom_ro_[5 * i + 3]; }
+  inline const double& dy(const size_t& i) const { return cell_geom_ro_[5 * i + 4]; }
+
+  template<MeshComponent C>
+  inline size_t object_count(void) const;
+
+  template<>
+  inline size_t object_count<MeshComponent::Cell>(void) const
+  {
+    return dims_ro_[Ops::ncells];
+  }
+
+  template<>
+  inline size_t object_count<MeshComponent::Face>(void) const
+  {
+    return dims_ro_[Ops::nfaces];
+  }
+
+  template<>
+  inline size_t object_count<MeshComponent::Vertex>(void) const
+  {
+    return dims_ro_[Ops::nvertices];
+  }
+
+  inline double cell_area(const size_t& i) const
+  {
+    return cell_geom_ro_[5 * i + 2];
+  }
+
+  /**
+     Return face k of cell i, or the face count if cell i has fewer
+     than k + 1 faces.
+   */
+  inline size_t cell_face(const size_t& i, const size_t& k) const
+  {
+    return cell_faces_ro_[Ops::max_cell_faces * i + k];
+  }
+
+  /**
+     Return the unit normal of face f, pointing from its lhs cell to
+     its rhs cell.
+   */
+  inline std::array<double,2> face_normal(const size_t& f) const
+  {
+    return { face_geom_ro_[6 * f + 2], face_geom_ro_[6 * f + 3] };
+  }
+
+  inline double face_length(const size_t& f) const
+  {
+    return face_geom_ro_[6 * f + 4];
+  }
+
+  template<MeshComponent C>
+  inline std::array<double,2> get_object_location(const size_t& i) const;
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Cell>(const size_t& i) const
+  {
+    return { cell_geom_ro_[5 * i], cell_geom_ro_[5 * i + 1] };
+  }
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Face>(const size_t& i) const
+  {
+    return { face_geom_ro_[6 * i], face_geom_ro_[6 * i + 1] };
+  }
+
+  template<>
+  inline std::array<double,2>
+  get_object_location<MeshComponent::Vertex>(const size_t& i) const
+  {
+    return { vertices_ro_[2 * i], vertices_ro_[2 * i + 1] };
+  }
+
+  template<MeshComponent C>
+  size_t get_nearest_object_index(const std::array<double,2>& loc) const;
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Cell>(const std::array<double,2>& loc) const
+  {
+    return Ops::nearest_cell(dims_ro_, bin_geom_ro_, bin_start_ro_, bin_cells_ro_,
+			     vertices_ro_, cell_vertices_ro_, loc);
+  }
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Face>(const std::array<double,2>& loc) const
+  {
+    // The nearest face is the side of the containing cell whose
+    // centre is nearest to loc
+    size_t c = get_nearest_object_index<MeshComponent::Cell>(loc);
+    size_t n = object_count<MeshComponent::Face>();
+    if (c == object_count<MeshComponent::Cell>()) {
+      return n;
+    }
+    size_t best = n;
+    double dmin = 0.0;
+    for (size_t k = 0; k < Ops::max_cell_faces; ++k) {
+      size_t f = cell_face(c, k);
+      if (f == n) {
+	break;
+      }
+      std::array<double,2> p = get_object_location<MeshComponent::Face>(f);
+      double d = (p[0] - loc[0]) * (p[0] - loc[0]) + (p[1] - loc[1]) * (p[1] - loc[1]);
+      if (best == n or d < dmin) {
+	best = f;
+	dmin = d;
+      }
+    }
+    return best;
+  }
+
+  template<>
+  size_t get_nearest_object_index<MeshComponent::Vertex>(const std::array<double,2>& loc) const
+  {
+    size_t c = get_nearest_object_index<MeshComponent::Cell>(loc);
+    return Ops::nearest_slot(dims_ro_, cell_vertices_ro_, vertices_ro_, c,
+			     object_count<MeshComponent::Vertex>(), loc);
+  }
+
+  struct get_adjacent_cells_result
+  {
+    size_t lhs_id;
+    size_t rhs_id;
+    int edge;
+    int dir;
+    double dx;
+  };
+
+  /**
+     Return the cells either side of a face. dx is the distance
+     between the cell centres, or twice the distance from the cell
+     centre to the face at the edge of the mesh.
+   */
+  get_adjacent_cells_result get_adjacent_cells(const size_t& face_id) const
+  {
+    get_adjacent_cells_result result;
+    result.lhs_id = face_cells_ro_[2 * face_id];
+    result.rhs_id = face_cells_ro_[2 * face_id + 1];
+    result.edge = face_info_ro_[2 * face_id];
+    result.dir = face_info_ro_[2 * face_id + 1];
+    result.dx = face_geom_ro_[6 * face_id + 5];
+    return result;
+  }
+
+  struct get_adjacent_faces_result
+  {
+    size_t face_w;
+    size_t face_e;
+    double dx;
+    size_t face_s;
+    size_t face_n;
+    double dy;
+  };
+
+  /**
+     Return the faces of a cell that face most nearly west, east,
+     south and north. Kernels that need every face of a cell should
+     use cell_face instead, since a cell may have faces that are none
+     of these.
+   */
+  get_adjacent_faces_result get_adjacent_faces(const size_t& cell_id) const
+  {
+    get_adjacent_faces_result result;
+    result.face_w = side_face(cell_id, 0);
+    result.face_e = side_face(cell_id, 1);
+    result.dx = dx(cell_id);
+    result.face_s = side_face(cell_id, 2);
+    result.face_n = side_face(cell_id, 3);
+    result.dy = dy(cell_id);
+    return result;
+  }
+
+  struct get_hanging_faces_result
+  {
+    size_t face_w;
+    size_t face_e;
+    size_t face_s;
+    size_t face_n;
+  };
+
+  /**
+     Return the second face on each side of a cell. Sides are never
+     split, so these are the faces returned by get_adjacent_faces.
+   */
+  get_hanging_faces_result get_hanging_faces(const size_t& cell_id) const
+  {
+    auto [ face_w, face_e, dx, face_s, face_n, dy ] = get_adjacent_faces(cell_id);
+    return { face_w, face_e, face_s, face_n };
+  }
+
+  struct offset_type
+  {
+    size_t i;
+    double dx;
+  };
+
+  template<MeshComponent C>
+  offset_type get_object_west(const size_t& i) const;
+  template<MeshComponent C>
+  offset_type get_object_east(const size_t& i) const;
+  template<MeshComponent C>
+  offset_type get_object_north(const size_t& i) const;
+  template<MeshComponent C>
+  offset_type get_object_south(const size_t& i) const;
+
+  // The neighbours of each cell along each axis are chosen when the
+  // mesh is read. The neighbour on a side with no cell is the cell
+  // itself.
+
+  template<>
+  offset_type get_object_west<MeshComponent::Cell>(const size_t& i) const
+  {
+    return neighbour(i, 0, 0);
+  }
+
+  template<>
+  offset_type get_object_east<MeshComponent::Cell>(const size_t& i) const
+  {
+    return neighbour(i, 1, 0);
+  }
+
+  template<>
+  offset_type get_object_north<MeshComponent::Cell>(const size_t& i) const
+  {
+    return neighbour(i, 3, 1);
+  }
+
+  template<>
+  offset_type get_object_south<MeshComponent::Cell>(const size_t& i) const
+  {
+    return neighbour(i, 2, 1);
+  }
+
+private:
+
+  /**
+     Return neighbour k (west, east, south or north) of cell i and
+     its distance from i along axis a.
+   */
+  inline offset_type neighbour(const size_t& i, const size_t& k, const size_t& a) const
+  {
+    size_t j = cell_neighbours_ro_[Ops::max_cell_faces * i + k];
+    return { j, sycl::fabs(cell_geom_ro_[5 * j + a] - cell_geom_ro_[5 * i + a]) };
+  }
+
+};
+
+#endif
@@ -20,7 +20,9 @@
 #define mfcm_Output_OutputFile_hpp
 
 #include "OutputFormat.hpp"
+#include "OutputWriter.hpp"
 #include "TimeParameters.hpp"
+#include "mpi.hpp"
 
 class OutputFile
 {
@@ -48,6 +50,10 @@ public:
     if (not output_filename_.is_absolute()) {
       output_filename_ = GlobalConfig::instance().simulation_base_path() / output_filename_;
     }
+    // Each rank writes the part of the mesh it solves
+    if (mpi_size() > 1) {
+      output_filename_ += "_rank" + std::to_string(mpi_rank());
+    }
     delimiter_ = conf.get<std::string>("delimiter", ", ");
   }
 
@@ -161,6 +167,13 @@ public:
 
   virtual void timed_output(const TimeType& time_now) const = 0;
 
+  /**
+     Wait until the outputs being written in the background are
+     finished, and rethrow the exception of one that failed.
+   */
+  virtual void wait(void) const
+  {}
+
 };
 
 template<typename Solver, MeshComponent C>
@@ -179,19 +192,44 @@ private:
 
   std::vector<std::string> output_field_names_;
 
+  // If not null, the files are written in the background
+  std::shared_ptr<OutputWriter> writer_;
+
 public:
 
   MultiFieldOutputFile(const std::string& name,
 		       const std::shared_ptr<TimeParameters<TimeType>> tparams,
 		       std::shared_ptr<SolverType>& solver,
-		       const std::vector<std::string>& field_names)
+		       const std::vector<std::string>& field_names,
+		       const std::shared_ptr<OutputWriter>& writer = nullptr)
     : TimedOutputFile<TimeType>(name, tparams),
-      solver_(solver), output_field_names_(field_names)
+      solver_(solver), output_field_names_(field_names), writer_(writer)
   {
+    for (auto&& field_name : output_field_names_) {
+      if (not solver_->template request_output_field<C>(field_name)) {
+	std::cerr << "WARNING: Field " << std::quoted(field_name)
+		  << " requested by output " << std::quoted(name)
+		  << " is not available." << std::endl;
+      }
+    }
   }
 
   virtual ~MultiFieldOutputFile(void)
-  {}
+  {
+    // The queued outputs refer to this file. A failure has been
+    // reported by the writer already.
+    try {
+      wait();
+    } catch (const std::exception&) {
+    }
+  }
+
+  virtual void wait(void) const
+  {
+    if (writer_) {
+      writer_->wait();
+    }
+  }
 
   virtual void timed_output(const TimeType& time_now) const
   {
@@ -217,18 +255,48 @@ public:
 	}
       }
 
-      auto output_func = std::make_shared<FieldOutputFunction<FieldType>>(output_field_ptrs);
       this->output_no_ += 1;
-      this->output(output_func, fn);
+      if (writer_) {
+	// Start copying the fields to the host, and leave the writer
+	// to wait for them and write the file
+	auto snapshot = std::make_shared<FieldSnapshotOutputFunction<FieldType>>(output_field_ptrs);
+	writer_->submit([this, snapshot, fn] (void)
+	{
+	  snapshot->wait();
+	  this->output(snapshot, fn);
+	});
+      } else {
+	auto output_func = std::make_shared<FieldOutputFunction<FieldType>>(output_field_ptrs);
+	this->output(output_func, fn);
+      }
     }
   }
 };
 
+/**
+   Create the writer for field output files, or return null if they
+   are written by the solver thread. The scheme configuration key
+   "output threads" (default 1) sets the number of writer threads,
+   and "outputs in flight" (default 2) the number of outputs that may
+   be queued or being written before the solver waits.
+ */
+inline std::shared_ptr<OutputWriter> make_output_writer(void)
+{
+  const Config& conf = GlobalConfig::instance().scheme_configuration();
+  size_t n_threads = conf.get<size_t>("output threads", 1);
+  if (n_threads == 0) {
+    return nullptr;
+  }
+  return std::make_shared<OutputWriter>(n_threads,
+					conf.get<size_t>("outputs in flight", 2));
+}
+
 template<typename Solver>
 std::shared_ptr<TimedOutputFile<typename Solver::TimeType>>
 make_field_output_file(const std::string& name,
 		       const std::shared_ptr<TimeParameters<typename Solver::TimeType>> tparams,
-		       std::shared_ptr<Solver>& solver)
+		       std::shared_ptr<Solver>& solver,
+		       const std::shared_ptr<OutputWriter>& writer = nullptr)
 {
   std::vector<std::string> output_field_names;
   const Config& conf = GlobalConfig::instance().output_file_configuration(name);
@@ -244,11 +312,11 @@ make_field_output_file(const std::string& name,
 
   std::string mc_str = conf.get<std::string>("at", "cells");
   if (mc_str == "cells") {
-    return std::make_shared<MultiFieldOutputFile<Solver,MeshComponent::Cell>>(name, tparams, solver, output_field_names);
+    return std::make_shared<MultiFieldOutputFile<Solver,MeshComponent::Cell>>(name, tparams, solver, output_field_names, writer);
   } else if (mc_str == "faces") {
-    return std::make_shared<MultiFieldOutputFile<Solver,MeshComponent::Face>>(name, tparams, solver, output_field_names);
+    return std::make_shared<MultiFieldOutputFile<Solver,MeshComponent::Face>>(name, tparams, solver, output_field_names, writer);
   } else if (mc_str == "vertices") {
-    return std::make_shared<MultiFieldOutputFile<Solver,MeshComponent::Vertex>>(name, tparams, solver, output_field_names);
+    return std::make_shared<MultiFieldOutputFile<Solver,MeshComponent::Vertex>>(name, tparams, solver, output_field_names, writer);
   } else {
     throw std::runtime_error("Invalid value for output.at");
   }
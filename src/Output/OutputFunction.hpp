@@ -23,6 +23,7 @@
 #include "Input/TimeSeries.hpp"
 #include <fstream>
 #include <iomanip>
+#include <limits>
 
 class OutputFunction
 {
@@ -171,7 +172,7 @@ public:
   virtual size_t nrows(void) const
   {
     if (ncols() > 0) {
-      return field_ptrs_.at(0)->size();
+      return field_ptrs_.at(0)->mesh()->template row_major_count<FieldMappingType>();
     } else {
       return 0;
     }
@@ -184,13 +185,24 @@ public:
   
   virtual std::array<double,2> location(const size_t& row) const
   {
-    return field_ptrs_.at(0)->mesh()->template get_object_location<FieldMappingType>(row);
+    const auto& mesh = field_ptrs_.at(0)->mesh();
+    return mesh->template get_row_major_location<FieldMappingType>(row);
   }
-  
+
+  /**
+     Return the value of the object at row-major position row, or NaN
+     if the mesh does not store that object.
+   */
   virtual ValueType at(const size_t& col,
 		       const size_t& row)
   {
-    return field_ptrs_.at(col)->data().host_vector().at(row);
+    const auto& mesh = field_ptrs_.at(col)->mesh();
+    const auto& values = field_ptrs_.at(col)->data().host_vector();
+    size_t id = mesh->template storage_index<FieldMappingType>(row);
+    if (id >= values.size()) {
+      return std::numeric_limits<ValueType>::quiet_NaN();
+    }
+    return values[id];
   }
 
   virtual std::string column_name(const size_t& col) const
@@ -205,6 +217,107 @@ public:
   
 };
 
+/**
+   An output function for copies of fields on the host, taken when it
+   is constructed. The copies from the device are not waited for until
+   wait() is called, so that the fields can be written by another
+   thread (see OutputWriter) while the solver carries on.
+ */
+template<typename Field>
+class FieldSnapshotOutputFunction
+  : public TypedOutputFunction<typename Field::ValueType>
+{
+public:
+
+  using FieldType = Field;
+
+  using ValueType = typename FieldType::ValueType;
+  using MeshType = typename FieldType::MeshType;
+  static const MeshComponent FieldMappingType = FieldType::FieldMappingType;
+
+private:
+
+  std::shared_ptr<MeshType> mesh_;
+  std::vector<std::string> names_;
+  std::vector<std::vector<ValueType>> values_;
+  std::vector<sycl::event> copies_;
+
+public:
+
+  FieldSnapshotOutputFunction(const std::vector<FieldType*> field_ptrs)
+    : TypedOutputFunction<ValueType>()
+  {
+    values_.reserve(field_ptrs.size());
+    for (auto&& fptr : field_ptrs) {
+      mesh_ = fptr->mesh();
+      names_.push_back(fptr->name());
+      values_.emplace_back(fptr->data().size());
+      copies_.push_back(fptr->data().copy_to_host_async(values_.back().data()));
+    }
+  }
+
+  virtual ~FieldSnapshotOutputFunction(void)
+  {
+    wait();
+  }
+
+  /**
+     Wait for the copies of the fields to reach the host.
+   */
+  void wait(void)
+  {
+    for (auto&& copy : copies_) {
+      copy.wait();
+    }
+    copies_.clear();
+  }
+
+  virtual size_t ncols(void) const
+  {
+    return values_.size();
+  }
+
+  virtual size_t nrows(void) const
+  {
+    if (ncols() > 0) {
+      return mesh_->template row_major_count<FieldMappingType>();
+    } else {
+      return 0;
+    }
+  }
+
+  virtual bool rows_have_location(void) const
+  {
+    return true;
+  }
+  
+  virtual std::array<double,2> location(const size_t& row) const
+  {
+    return mesh_->template get_row_major_location<FieldMappingType>(row);
+  }
+
+  /**
+     Return the value of the object at row-major position row, or NaN
+     if the mesh does not store that object.
+   */
+  virtual ValueType at(const size_t& col,
+		       const size_t& row)
+  {
+    const auto& values = values_.at(col);
+    size_t id = mesh_->template storage_index<FieldMappingType>(row);
+    if (id >= values.size()) {
+      return std::numeric_limits<ValueType>::quiet_NaN();
+    }
+    return values[id];
+  }
+
+  virtual std::string column_name(const size_t& col) const
+  {
+    return names_.at(col);
+  }
+  
+};
+
 template<typename Mesh,
 	 MeshComponent FieldMappingType>
 class MeshOutputFunction
@@ -245,7 +358,7 @@ public:
 
   virtual size_t nrows(void) const
   {
-    return mesh_ptr_->template object_count<FieldMappingType>();
+    return mesh_ptr_->template row_major_count<FieldMappingType>();
   }
 
   virtual bool rows_have_location(void) const
@@ -255,7 +368,7 @@ public:
 
   virtual std::array<double,2> location(const size_t& row) const
   {
-    return mesh_ptr_->template get_object_location<FieldMappingType>(row);
+    return mesh_ptr_->template get_row_major_location<FieldMappingType>(row);
   }
 
   virtual double at(const size_t& col, const size_t& row)
@@ -314,13 +427,21 @@ public:
     if (is_global_) {
       return mesh_->template object_count<FieldMappingType>();
     }
-    return id_list_.size() - 1;
+    return id_list_.size();
   }
 
   virtual ValueType at(const size_t& col,
 		       const size_t& row)
   {
-    return id_list_.at(row);
+    if (is_global_) {
+      // Every stored object, in row-major order
+      if (mesh_->template row_major_count<FieldMappingType>() ==
+	  mesh_->template object_count<FieldMappingType>()) {
+	return row;
+      }
+      return mesh_->template row_major_index<FieldMappingType>(row);
+    }
+    return mesh_->template row_major_index<FieldMappingType>(id_list_.at(row));
   }
 
   virtual std::string column_name(const size_t& col) const
@@ -0,0 +1,177 @@
+/***********************************************************************
+ * mfcm Output/OutputWriter.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_Output_OutputWriter_hpp
+#define mfcm_Output_OutputWriter_hpp
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+   A pool of threads that write output files in the background, so
+   that the solver can carry on while a snapshot of its fields is
+   formatted and written.
+
+   At most max_in_flight outputs are queued or being written at once.
+   Submitting another waits until one is finished, which bounds the
+   memory held by snapshots.
+
+   The first exception thrown by an output is kept and rethrown by the
+   next call to submit or wait.
+ */
+class OutputWriter
+{
+private:
+
+  std::mutex mutex_;
+  std::condition_variable task_added_;
+  std::condition_variable task_finished_;
+
+  std::deque<std::function<void(void)>> tasks_;
+  size_t in_flight_;
+  size_t max_in_flight_;
+  bool stopping_;
+
+  // The first exception thrown by an output that has not been
+  // rethrown
+  std::exception_ptr error_;
+
+  std::vector<std::thread> threads_;
+
+  /**
+     Rethrow the exception kept from an output, if any. The mutex must
+     be held.
+   */
+  void rethrow_error_(void)
+  {
+    if (error_) {
+      std::exception_ptr error = error_;
+      error_ = nullptr;
+      std::rethrow_exception(error);
+    }
+  }
+
+  void run(void)
+  {
+    while (true) {
+      std::function<void(void)> task;
+      {
+	std::unique_lock<std::mutex> lock(mutex_);
+	task_added_.wait(lock, [this] { return stopping_ or not tasks_.empty(); });
+	if (tasks_.empty()) {
+	  return;
+	}
+	task = std::move(tasks_.front());
+	tasks_.pop_front();
+      }
+
+      std::exception_ptr error;
+      try {
+	task();
+      } catch (const std::exception& e) {
+	std::cerr << "ERROR: Output failed: " << e.what() << std::endl;
+	error = std::current_exception();
+      }
+
+      {
+	std::lock_guard<std::mutex> lock(mutex_);
+	in_flight_ -= 1;
+	if (error and not error_) {
+	  error_ = error;
+	}
+      }
+      task_finished_.notify_all();
+    }
+  }
+
+public:
+
+  /**
+     Constructor.
+
+     @param n_threads Number of writer threads.
+     @param max_in_flight Largest number of outputs queued or being
+     written.
+   */
+  OutputWriter(size_t n_threads,
+	       size_t max_in_flight)
+    : in_flight_(0),
+      max_in_flight_(std::max<size_t>(max_in_flight, 1)),
+      stopping_(false)
+  {
+    for (size_t i = 0; i < n_threads; ++i) {
+      threads_.emplace_back(&OutputWriter::run, this);
+    }
+  }
+
+  /**
+     Destructor. Finishes the outputs already submitted.
+   */
+  ~OutputWriter(void)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    task_added_.notify_all();
+    for (auto&& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  OutputWriter(const OutputWriter&) = delete;
+  void operator=(const OutputWriter&) = delete;
+
+  /**
+     Queue an output, waiting first if max_in_flight are already
+     queued or being written. Rethrows the exception of an earlier
+     output that failed, without queuing this one.
+   */
+  void submit(std::function<void(void)>&& task)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_finished_.wait(lock, [this] { return in_flight_ < max_in_flight_; });
+      rethrow_error_();
+      in_flight_ += 1;
+      tasks_.push_back(std::move(task));
+    }
+    task_added_.notify_one();
+  }
+
+  /**
+     Wait until every output submitted has been written, and rethrow
+     the exception of one that failed.
+   */
+  void wait(void)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    task_finished_.wait(lock, [this] { return in_flight_ == 0; });
+    rethrow_error_();
+  }
+
+};
+
+#endif
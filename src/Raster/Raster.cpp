@@ -26,9 +26,30 @@ template<typename T>
 RasterDatabase<T>&
 RasterDatabase<T>::instance(void)
 {
+  size_t config_id = GlobalConfig::instance().id();
   if (not rdb_) {
     rdb_ = new RasterDatabase<T>();
   }
+  if (rdb_->configs_.count(config_id) == 0) {
+    // Forget the configurations no longer in use, and keep their
+    // rasters for the configurations that follow them only
+    bool released = false;
+    for (auto it = rdb_->configs_.begin(); it != rdb_->configs_.end(); ) {
+      if (it->second.expired()) {
+	rdb_->db_.erase(it->first);
+	it = rdb_->configs_.erase(it);
+	released = true;
+      } else {
+	++it;
+      }
+    }
+    if (released) {
+      rdb_->previous_cache_ = std::move(rdb_->cache_);
+      rdb_->cache_.clear();
+    }
+    rdb_->configs_[config_id] = GlobalConfig::current();
+  }
+  rdb_->config_id_ = config_id;
   return *rdb_;
 }
 
@@ -39,9 +60,18 @@ get_raster_field_ptr(const std::shared_ptr<sycl::queue>& queue,
 		     const std::string& name)
 {
   using boost::algorithm::to_lower_copy;
-  if (db_.count(name) == 0) {
+  RasterMap& db = db_[config_id_];
+  if (db.count(name) == 0) {
     const GlobalConfig& gc = GlobalConfig::instance();
     const Config& conf = gc.raster_configuration(name);
+
+    std::string key = name + "\n" + gc.input_key(conf);
+    if (cache_.count(key) > 0) {
+      return db[name] = cache_[key];
+    } else if (previous_cache_.count(key) > 0) {
+      std::cout << "Reusing raster field " << name << std::endl;
+      return db[name] = cache_[key] = previous_cache_[key];
+    }
     
     stdfs::path filepath = conf.get<stdfs::path>("filename", ".");
     if (not filepath.is_absolute()) {
@@ -52,17 +82,18 @@ get_raster_field_ptr(const std::shared_ptr<sycl::queue>& queue,
       to_lower_copy(conf.get<std::string>("source"));
     if (source_type_str == "gdal") {
 #if MFCM_HAS_GDAL
-      db_[name] = GDALRasterFormat<T>(filepath, conf)(queue, name);
+      db[name] = GDALRasterFormat<T>(filepath, conf)(queue, name);
 #else
       throw std::runtime_error("GDAL not supported in this build.");
 #endif
     } else if (source_type_str == "nimrod") {
-      db_[name] = NIMRODRasterFormat<T>(filepath, conf)(queue, name);
+      db[name] = NIMRODRasterFormat<T>(filepath, conf)(queue, name);
     } else {
       std::cerr << "Unknown source type '" << source_type_str
 		<< "' for raster field: " << name << std::endl;
       throw std::runtime_error("Unknown source type for raster field");
     }
+    cache_[key] = db[name];
   }
-  return db_[name];
+  return db[name];
 }
@@ -20,6 +20,7 @@
 #define mfcm_Raster_Raster_hpp
 
 #include "RasterFormat.hpp"
+#include "Config.hpp"
 #include <map>
 
 template<typename T>
@@ -27,10 +28,26 @@ class RasterDatabase
 {
 private:
 
-  std::map<std::string, std::shared_ptr<RasterField<T>>> db_;
+  using RasterMap = std::map<std::string, std::shared_ptr<RasterField<T>>>;
+
+  // The rasters of each configuration in use (see GlobalConfig::id)
+  // by name, since a batch run makes the configurations of the
+  // models it packs the instance in turn (see GlobalConfig::activate)
+  std::map<size_t, RasterMap> db_;
+  std::map<size_t, std::weak_ptr<GlobalConfig>> configs_;
+  size_t config_id_;
+
+  // The rasters of the current and previous configurations by input
+  // key (see GlobalConfig::input_key), so that a resident process
+  // can reuse them for its next job
+  RasterMap cache_;
+  RasterMap previous_cache_;
 
 protected:
 
+  // Never deleted: the fields it holds own SYCL buffers, which must
+  // not be destroyed during static destruction, after the SYCL
+  // runtime may have gone
   static RasterDatabase<T>* rdb_;
 
   RasterDatabase(void) {}
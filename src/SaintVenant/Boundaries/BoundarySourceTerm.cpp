@@ -29,15 +29,19 @@ std::shared_ptr<SaintVenantSourceTerm<TT,T,Mesh>>
 BoundarySourceTerm<TT,T,Mesh>::
 create_boundary(const Config& conf,
 		const std::shared_ptr<MeshType>& mesh,
+		const std::array<size_t,2>& owned_cells,
 		bool on_device)
 {
   std::string btype = conf.get_value<std::string>();
   if (btype == "discharge") {
-    return DischargeBoundarySourceTerm<TT,T,Mesh>::create_boundary(conf, mesh, on_device);
+    return DischargeBoundarySourceTerm<TT,T,Mesh>::create_boundary(conf, mesh, owned_cells,
+								  on_device);
   } else if (btype == "head") {
-    return HeadBoundarySourceTerm<TT,T,Mesh>::create_boundary(conf, mesh, on_device);
+    return HeadBoundarySourceTerm<TT,T,Mesh>::create_boundary(conf, mesh, owned_cells,
+								  on_device);
   } else if (btype == "stage") {
-    return StageBoundarySourceTerm<TT,T,Mesh>::create_boundary(conf, mesh, on_device);
+    return StageBoundarySourceTerm<TT,T,Mesh>::create_boundary(conf, mesh, owned_cells,
+								  on_device);
   } else {
     std::cerr << "ERROR: Unknown boundary type: " << std::quoted(btype)
 	      << std::endl;
@@ -39,13 +39,25 @@ public:
 
 protected:
 
+  // The configuration of the boundary, which is read again at the
+  // start of each step
+  Config conf_;
+
   std::shared_ptr<MeshType> mesh_;
 
+  // The range of cells [owned_cells_[0], owned_cells_[1]) in which
+  // the boundary may select cells
+  std::array<size_t,2> owned_cells_;
+
   FieldType xbdy0_;
   FieldType xbdy1_;
 
+  const Config& configuration(void) const { return conf_; }
+
   const std::shared_ptr<MeshType>& mesh(void) const { return mesh_; }
 
+  const std::array<size_t,2>& owned_cells(void) const { return owned_cells_; }
+
   FieldType& xbdy0(void) { return xbdy0_; }
   FieldType& xbdy1(void) { return xbdy1_; }
 
@@ -86,20 +98,37 @@ protected:
   
 public:
 
-  BoundarySourceTerm(const std::shared_ptr<MeshType>& mesh,
+  BoundarySourceTerm(const Config& conf,
+		     const std::shared_ptr<MeshType>& mesh,
+		     const std::array<size_t,2>& owned_cells,
 		     const FieldType& xbdy0,
 		     const FieldType& xbdy1)
     : SaintVenantSourceTerm<TimeType,ValueType,MeshType>(),
-      mesh_(mesh), xbdy0_(xbdy0), xbdy1_(xbdy1)
+      conf_(conf), mesh_(mesh), owned_cells_(owned_cells),
+      xbdy0_(xbdy0), xbdy1_(xbdy1)
   {
   }
 
   virtual ~BoundarySourceTerm(void)
   {}
 
+  /**
+     The values of the boundary at the start and the end of the
+     current step.
+   */
+  const FieldType& values_at_step_start(void) const { return xbdy0_; }
+  const FieldType& values_at_step_end(void) const { return xbdy1_; }
+
+  /**
+     Create the boundary in the configuration. Only cells in the range
+     [owned_cells[0], owned_cells[1]) are selected, so that a mesh
+     which is one subdomain of a larger mesh leaves the cells it
+     shares with its neighbours to the subdomains that own them.
+   */
   static std::shared_ptr<SaintVenantSourceTerm<TT,T,Mesh>>
   create_boundary(const Config& conf,
 		  const std::shared_ptr<MeshType>& mesh,
+		  const std::array<size_t,2>& owned_cells = { 0, std::numeric_limits<size_t>::max() },
 		  bool on_device = true);
   
 };
@@ -122,10 +151,13 @@ public:
   using State = SaintVenantState<ValueType,MeshType>;
   using Constants = SaintVenantConstants<ValueType,MeshType>;
 
-  KernelBoundarySourceTerm(const std::shared_ptr<MeshType>& mesh,
+  KernelBoundarySourceTerm(const Config& conf,
+			   const std::shared_ptr<MeshType>& mesh,
+			   const std::array<size_t,2>& owned_cells,
 			   const FieldType&& xbdy0,
 			   const FieldType&& xbdy1)
-    : BoundarySourceTerm<TimeType,ValueType,MeshType>(mesh, xbdy0, xbdy1)
+    : BoundarySourceTerm<TimeType,ValueType,MeshType>(conf, mesh, owned_cells,
+						      xbdy0, xbdy1)
   {}
 
   virtual ~KernelBoundarySourceTerm(void) {}
@@ -141,7 +173,7 @@ public:
 			   this->xbdy0_, this->xbdy1_,
 			   dUdt, timestep, time_now,
 			   tp_ptr->step_duration());
-      cgh.parallel_for(sycl::range<1>(ncells), kernel);
+      launch_kernel(cgh, ncells, kernel, this->launch_);
     });
   }
 
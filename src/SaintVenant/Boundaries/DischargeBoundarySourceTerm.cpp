@@ -40,9 +40,18 @@ template<typename T,
 	 typename Mesh>
 void
 DischargeBoundarySourceKernel<T,Mesh>::
-operator()(sycl::item<1> item) const
+operator()(sycl::id<1> idx) const
 {
-  size_t cell_c = item.get_linear_id();
+  size_t cell_c = idx[0];
+
+  // Block-local time and timestep (see HeadBoundarySourceKernel)
+  double time_now = time_now_;
+  double timestep = timestep_;
+  if constexpr (MeshType::has_block_clocks) {
+    auto clock = h_.mesh().block_clock(cell_c, time_now_);
+    time_now = clock.time_now;
+    timestep = clock.timestep;
+  }
 
   ValueType q0 = qbdy0_.data()[cell_c];
   ValueType q1 = qbdy1_.data()[cell_c];
@@ -55,12 +64,12 @@ operator()(sycl::item<1> item) const
     ValueType v = v_.data()[cell_c];
     
     ValueType dqdt = (q1 - q0) / step_length_;
-    ValueType qnow = q0 + time_now_ * dqdt;
-    ValueType qnext = qnow + timestep_ * dqdt;
+    ValueType qnow = q0 + time_now * dqdt;
+    ValueType qnext = qnow + timestep * dqdt;
     ValueType dhdt = ValueType(0.5) * (qnow + qnext); // / cell_area;
 
-    if (h - dhdt * timestep_ <= 0.0) {
-      dhdt = -h / timestep_;
+    if (h - dhdt * timestep <= 0.0) {
+      dhdt = -h / timestep;
     }
 
     dhdt_.data()[cell_c] += dhdt;
@@ -75,7 +84,10 @@ std::shared_ptr<SaintVenantSourceTerm<TT,T,Mesh>>
 DischargeBoundarySourceTerm<TT,T,Mesh>::
 create_boundary(const Config& conf,
 		const std::shared_ptr<MeshType>& mesh,
+		const std::array<size_t,2>& owned_cells,
 		bool on_device)
 {
-  return std::make_shared<DischargeBoundarySourceTerm<TT,T,Mesh>>(mesh, on_device);
+  return std::make_shared<DischargeBoundarySourceTerm<TT,T,Mesh>>(conf, mesh,
+									owned_cells,
+									on_device);
 }
@@ -73,7 +73,7 @@ public:
 				const double& time_now,
 				const double& step_length);
 
-  void operator()(sycl::item<1> item) const;
+  void operator()(sycl::id<1> idx) const;
   
 };
 
@@ -99,10 +99,12 @@ public:
 
 public:
 
-  DischargeBoundarySourceTerm(const std::shared_ptr<MeshType>& mesh,
+  DischargeBoundarySourceTerm(const Config& conf,
+			      const std::shared_ptr<MeshType>& mesh,
+			      const std::array<size_t,2>& owned_cells,
 			      bool on_device = true)
     : KernelBoundarySourceTerm<TimeType,ValueType,MeshType,KernelType>
-    (mesh,
+    (conf, mesh, owned_cells,
      FieldType(mesh->queue_ptr(), "qbdy0", mesh, ValueType(0.0), on_device),
      FieldType(mesh->queue_ptr(), "qbdy1", mesh, ValueType(0.0), on_device))
   {
@@ -116,15 +118,15 @@ public:
 			      const std::shared_ptr<TimeParameters<TimeType>>& tp_ptr)
   {
     const TimeType& step_duration = tp_ptr->step_duration();
-    const Config& conf =
-      GlobalConfig::instance().boundary_configuration("discharge");
+    const Config& conf = this->configuration();
     this->clear_values();
     for (auto&& kv : conf) {
       std::string key = kv.first;
       std::string name = kv.second.get_value<std::string>();
       std::cout << "Updating discharge boundary: " << name << std::endl;
       MeshSelection<MeshType,MeshComponent::Cell> sel(this->mesh(),
-						      kv.second.get_child("cells"));
+						      kv.second.get_child("cells"),
+						      this->owned_cells());
       
       if (key == "constant") {
 	ValueType value = kv.second.get<ValueType>("value");
@@ -148,6 +150,7 @@ public:
   static std::shared_ptr<SaintVenantSourceTerm<TT,T,Mesh>>
   create_boundary(const Config& conf,
 		  const std::shared_ptr<MeshType>& mesh,
+		  const std::array<size_t,2>& owned_cells,
 		  bool on_device);
   
 };
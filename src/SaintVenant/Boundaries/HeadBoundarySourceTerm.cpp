@@ -40,9 +40,19 @@ template<typename T,
 	 typename Mesh>
 void
 HeadBoundarySourceKernel<T,Mesh>::
-operator()(sycl::item<1> item) const
+operator()(sycl::id<1> idx) const
 {
-  size_t cell_c = item.get_linear_id();
+  size_t cell_c = idx[0];
+
+  // On a multi-block mesh the time and timestep are those of the
+  // block of the cell, and time_now_ is the fraction of its timestep
+  double time_now = time_now_;
+  double timestep = timestep_;
+  if constexpr (MeshType::has_block_clocks) {
+    auto clock = h_.mesh().block_clock(cell_c, time_now_);
+    time_now = clock.time_now;
+    timestep = clock.timestep;
+  }
 
   ValueType h0 = hbdy0_.data()[cell_c];
   ValueType h1 = hbdy1_.data()[cell_c];
@@ -51,15 +61,15 @@ operator()(sycl::item<1> item) const
     ValueType h = h_.data()[cell_c];
 
     ValueType dhbdydt = (h1 - h0) / step_length_;
-    ValueType hbdy_now = h0 + time_now_ * dhbdydt;
-    ValueType hbdy_next = hbdy_now + timestep_ * dhbdydt;
+    ValueType hbdy_now = h0 + time_now * dhbdydt;
+    ValueType hbdy_next = hbdy_now + timestep * dhbdydt;
     ValueType target_h = ValueType(0.5) * (hbdy_now + hbdy_next);
 
     if (target_h <= 0.0) {
       target_h = 0.0;
     }
     
-    ValueType dhdt = (target_h - h) / timestep_;
+    ValueType dhdt = (target_h - h) / timestep;
 
     dhdt_.data()[cell_c] = dhdt;
   }
@@ -73,7 +83,10 @@ std::shared_ptr<SaintVenantSourceTerm<TT,T,Mesh>>
 HeadBoundarySourceTerm<TT,T,Mesh>::
 create_boundary(const Config& conf,
 		const std::shared_ptr<MeshType>& mesh,
+		const std::array<size_t,2>& owned_cells,
 		bool on_device)
 {
-  return std::make_shared<HeadBoundarySourceTerm<TT,T,Mesh>>(mesh, on_device);
+  return std::make_shared<HeadBoundarySourceTerm<TT,T,Mesh>>(conf, mesh,
+									owned_cells,
+									on_device);
 }
@@ -0,0 +1,162 @@
+/***********************************************************************
+ * mfcm SaintVenant/Boundaries/PackedBoundarySourceTerm.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_SaintVenant_Boundaries_PackedBoundarySourceTerm_hpp
+#define mfcm_SaintVenant_Boundaries_PackedBoundarySourceTerm_hpp
+
+#include "DischargeBoundarySourceTerm.hpp"
+#include "HeadBoundarySourceTerm.hpp"
+#include "StageBoundarySourceTerm.hpp"
+
+#include "Cartesian2DMesh.hpp"
+#include "MultiCartesian2DMesh.hpp"
+
+/**
+   A boundary on a MultiCartesian2DMesh made of boundaries of the same
+   type on each of its blocks. At the start of each step the boundary
+   of each block updates its values, which are copied into those of
+   the packed boundary at the offset of the block, and the kernel then
+   runs over every block at once. If the blocks are the meshes of
+   models with configurations of their own, each boundary is updated
+   with that of its model as the instance.
+ */
+template<typename TT,
+	 typename T,
+	 typename Kernel>
+class PackedBoundarySourceTerm
+  : public KernelBoundarySourceTerm<TT,T,MultiCartesian2DMesh,Kernel>
+{
+public:
+
+  using TimeType = TT;
+  using ValueType = T;
+  using MeshType = MultiCartesian2DMesh;
+  using FieldType = CellField<ValueType,MeshType>;
+
+  using State = SaintVenantState<ValueType,MeshType>;
+  using Constants = SaintVenantConstants<ValueType,MeshType>;
+
+  using BlockMeshType = Cartesian2DMesh;
+  using BlockBoundary = BoundarySourceTerm<TimeType,ValueType,BlockMeshType>;
+  using BlockConstants = SaintVenantConstants<ValueType,BlockMeshType>;
+
+private:
+
+  std::vector<std::shared_ptr<BlockBoundary>> blocks_;
+  std::vector<std::shared_ptr<BlockConstants>> block_constants_;
+  std::vector<std::shared_ptr<GlobalConfig>> block_configs_;
+
+  void pack_values_(void)
+  {
+    for (size_t b = 0; b < blocks_.size(); ++b) {
+      size_t offset = this->mesh_->template block_offset<MeshComponent::Cell>(b);
+      const typename BlockBoundary::FieldType& v0 = blocks_.at(b)->values_at_step_start();
+      const typename BlockBoundary::FieldType& v1 = blocks_.at(b)->values_at_step_end();
+      this->xbdy0_.data().copy_range(offset, v0.size(), v0.data(), 0);
+      this->xbdy1_.data().copy_range(offset, v1.size(), v1.data(), 0);
+    }
+  }
+
+public:
+
+  /**
+     Constructor.
+
+     @param conf Configuration of the boundary of the first block.
+     @param mesh The multi-block mesh.
+     @param blocks The boundary of each block of the mesh.
+     @param block_constants The constants of each block, with which
+     its boundary is updated.
+     @param block_configs The configuration of each block, or none if
+     the blocks share the instance.
+   */
+  PackedBoundarySourceTerm(const Config& conf,
+			   const std::shared_ptr<MeshType>& mesh,
+			   const std::vector<std::shared_ptr<BlockBoundary>>& blocks,
+			   const std::vector<std::shared_ptr<BlockConstants>>& block_constants,
+			   const std::vector<std::shared_ptr<GlobalConfig>>& block_configs,
+			   bool on_device = true)
+    : KernelBoundarySourceTerm<TimeType,ValueType,MeshType,Kernel>
+    (conf, mesh, { 0, std::numeric_limits<size_t>::max() },
+     FieldType(mesh->queue_ptr(), "xbdy0", mesh,
+	       std::numeric_limits<ValueType>::quiet_NaN(), on_device),
+     FieldType(mesh->queue_ptr(), "xbdy1", mesh,
+	       std::numeric_limits<ValueType>::quiet_NaN(), on_device)),
+      blocks_(blocks),
+      block_constants_(block_constants),
+      block_configs_(block_configs)
+  {
+    if (blocks_.size() != mesh->block_count() or
+	block_constants_.size() != mesh->block_count() or
+	(not block_configs_.empty() and block_configs_.size() != mesh->block_count())) {
+      throw std::logic_error("Packed boundary does not match the mesh blocks.");
+    }
+    pack_values_();
+  }
+
+  virtual ~PackedBoundarySourceTerm(void)
+  {}
+
+  virtual void start_new_step(Constants& constants,
+			      const TimeType& time_now,
+			      const std::shared_ptr<TimeParameters<TimeType>>& tp_ptr)
+  {
+    for (size_t b = 0; b < blocks_.size(); ++b) {
+      if (not block_configs_.empty()) {
+	GlobalConfig::activate(block_configs_.at(b));
+      }
+      blocks_.at(b)->start_new_step(*(block_constants_.at(b)), time_now, tp_ptr);
+    }
+    pack_values_();
+  }
+
+};
+
+/**
+   Create the boundary on a MultiCartesian2DMesh that packs the
+   boundaries of its blocks, which must all be of the type of conf.
+ */
+template<typename TT,
+	 typename T>
+std::shared_ptr<SaintVenantSourceTerm<TT,T,MultiCartesian2DMesh>>
+create_packed_boundary(const Config& conf,
+		       const std::shared_ptr<MultiCartesian2DMesh>& mesh,
+		       const std::vector<std::shared_ptr<BoundarySourceTerm<TT,T,Cartesian2DMesh>>>& blocks,
+		       const std::vector<std::shared_ptr<SaintVenantConstants<T,Cartesian2DMesh>>>& block_constants,
+		       const std::vector<std::shared_ptr<GlobalConfig>>& block_configs,
+		       bool on_device = true)
+{
+  using MeshType = MultiCartesian2DMesh;
+  std::string btype = conf.get_value<std::string>();
+  if (btype == "discharge") {
+    return std::make_shared<PackedBoundarySourceTerm<TT,T,DischargeBoundarySourceKernel<T,MeshType>>>
+      (conf, mesh, blocks, block_constants, block_configs, on_device);
+  } else if (btype == "head") {
+    return std::make_shared<PackedBoundarySourceTerm<TT,T,HeadBoundarySourceKernel<T,MeshType>>>
+      (conf, mesh, blocks, block_constants, block_configs, on_device);
+  } else if (btype == "stage") {
+    return std::make_shared<PackedBoundarySourceTerm<TT,T,StageBoundarySourceKernel<T,MeshType>>>
+      (conf, mesh, blocks, block_constants, block_configs, on_device);
+  } else {
+    std::cerr << "ERROR: Unknown boundary type: " << std::quoted(btype)
+	      << std::endl;
+    throw std::runtime_error("Unknown boundary type.");
+  }
+}
+
+#endif
@@ -40,9 +40,18 @@ template<typename T,
 	 typename Mesh>
 void
 StageBoundarySourceKernel<T,Mesh>::
-operator()(sycl::item<1> item) const
+operator()(sycl::id<1> idx) const
 {
-  size_t cell_c = item.get_linear_id();
+  size_t cell_c = idx[0];
+
+  // Block-local time and timestep (see HeadBoundarySourceKernel)
+  double time_now = time_now_;
+  double timestep = timestep_;
+  if constexpr (MeshType::has_block_clocks) {
+    auto clock = h_.mesh().block_clock(cell_c, time_now_);
+    time_now = clock.time_now;
+    timestep = clock.timestep;
+  }
 
   ValueType z = z_bed_.data()[cell_c];
   
@@ -53,15 +62,15 @@ operator()(sycl::item<1> item) const
     ValueType h = h_.data()[cell_c];
 
     ValueType dhbdydt = (h1 - h0) / step_length_;
-    ValueType hbdy_now = h0 + time_now_ * dhbdydt;
-    ValueType hbdy_next = hbdy_now + timestep_ * dhbdydt;
+    ValueType hbdy_now = h0 + time_now * dhbdydt;
+    ValueType hbdy_next = hbdy_now + timestep * dhbdydt;
     ValueType target_h = ValueType(0.5) * (hbdy_now + hbdy_next);
 
     if (target_h <= 0.0) {
       target_h = 0.0;
     }
     
-    ValueType dhdt = (target_h - h) / timestep_;
+    ValueType dhdt = (target_h - h) / timestep;
 
     dhdt_.data()[cell_c] = dhdt;
   }
@@ -75,7 +84,10 @@ std::shared_ptr<SaintVenantSourceTerm<TT,T,Mesh>>
 StageBoundarySourceTerm<TT,T,Mesh>::
 create_boundary(const Config& conf,
 		const std::shared_ptr<MeshType>& mesh,
+		const std::array<size_t,2>& owned_cells,
 		bool on_device)
 {
-  return std::make_shared<StageBoundarySourceTerm<TT,T,Mesh>>(mesh, on_device);
+  return std::make_shared<StageBoundarySourceTerm<TT,T,Mesh>>(conf, mesh,
+									owned_cells,
+									on_device);
 }
@@ -30,8 +30,43 @@ SaintVenantConstants(const std::shared_ptr<MeshType>& mesh,
     z_bed_(FieldGenerator<ValueType,MeshType,MeshComponent::Cell>
 	   (mesh_->queue_ptr(), "z_bed", mesh_, 0.0f, on_device)()),
     dzdx_bed_(mesh_->queue_ptr(), "dzdx_bed", mesh_, 0.0f, on_device),
-    dzdy_bed_(mesh_->queue_ptr(), "dzdy_bed", mesh_, 0.0f, on_device)
+    dzdy_bed_(mesh_->queue_ptr(), "dzdy_bed", mesh_, 0.0f, on_device),
+    subgrid_(Subgrid::create(mesh_)),
+    face_bed_(mesh_->queue_ptr(),
+	      mesh_->template object_count<MeshComponent::Face>(),
+	      FaceBedType(ValueType(0.0)), true)
 {
+  initialize_();
+}
+
+template<typename T, typename Mesh>
+SaintVenantConstants<T,Mesh>::
+SaintVenantConstants(const std::shared_ptr<MeshType>& mesh,
+		     const FieldType& z_bed,
+		     bool on_device)
+  : mesh_(mesh),
+    z_bed_(z_bed),
+    dzdx_bed_(mesh_->queue_ptr(), "dzdx_bed", mesh_, 0.0f, on_device),
+    dzdy_bed_(mesh_->queue_ptr(), "dzdy_bed", mesh_, 0.0f, on_device),
+    subgrid_(),
+    face_bed_(mesh_->queue_ptr(),
+	      mesh_->template object_count<MeshComponent::Face>(),
+	      FaceBedType(ValueType(0.0)), true)
+{
+  z_bed_.rename("z_bed");
+  initialize_();
+}
+
+template<typename T, typename Mesh>
+void
+SaintVenantConstants<T,Mesh>::initialize_(void)
+{
+  // With sub-grid bathymetry the bed level of a cell is its lowest
+  // point
+  if (subgrid_) {
+    subgrid_->cell_base(z_bed_);
+  }
+
   using SpatialDerivative = SpatialDerivativeOperator<ValueType,
 						      MeshType,
 						      MeshComponent::Cell,
@@ -39,6 +74,102 @@ SaintVenantConstants(const std::shared_ptr<MeshType>& mesh,
   SpatialDerivative::template apply<SpatialDerivativeAxis::X>(z_bed_, dzdx_bed_);
   SpatialDerivative::template apply<SpatialDerivativeAxis::Y>(z_bed_, dzdy_bed_);
 
+  if (subgrid_) {
+    compute_face_bed_<true>();
+  } else {
+    compute_face_bed_<false>();
+  }
+
   FieldCheckFile<FieldType> cf("constants");
   cf.output({&z_bed_, &dzdx_bed_, &dzdy_bed_});
 }
+
+template<typename T, typename Mesh>
+template<bool UseSubgrid>
+void
+SaintVenantConstants<T,Mesh>::compute_face_bed_(void)
+{
+  using ReadAccessor = typename FieldType::
+    template Accessor<sycl::access::mode::read>;
+  using SubgridAccessor = typename Subgrid::template Accessor<UseSubgrid>;
+
+  size_t nfaces = mesh_->template object_count<MeshComponent::Face>();
+
+  mesh_->queue_ptr()->submit([&] (sycl::handler& cgh) {
+    ReadAccessor zb(z_bed_, cgh);
+    ReadAccessor dzbdx(dzdx_bed_, cgh);
+    ReadAccessor dzbdy(dzdy_bed_, cgh);
+    SubgridAccessor sg_acc(subgrid_.get(), cgh);
+    auto fb_acc = face_bed_.get_discard_write_accessor(cgh);
+
+    cgh.parallel_for(sycl::range<1>(nfaces), [=](sycl::item<1> item) {
+      size_t fid = item.get_linear_id();
+      auto mesh_acc = zb.mesh();
+      auto [ lhs_id, rhs_id, edge, dir, dx ] = mesh_acc.get_adjacent_cells(fid);
+
+      ValueType xdir, ydir;
+      if constexpr (MeshType::has_face_normals) {
+	auto n = mesh_acc.face_normal(fid);
+	xdir = n[0];
+	ydir = n[1];
+      } else {
+	xdir = 1.0 - ValueType(dir);
+	ydir = ValueType(dir);
+      }
+
+      // Check if either of the surrounding cells are coded out
+      ValueType zb_L = zb.data()[lhs_id];
+      ValueType zb_R = zb.data()[rhs_id];
+      if (zb_L != zb_L) {
+	lhs_id = rhs_id;
+	if (edge == 1) {
+	  fb_acc[fid] = FaceBedType(ValueType(0.0), ValueType(0.0),
+				     ValueType(0.0), ValueType(2.0));
+	  return;
+	}
+	edge = -1;
+      }
+      if (zb_R != zb_R) {
+	if (edge == -1) {
+	  fb_acc[fid] = FaceBedType(ValueType(0.0), ValueType(0.0),
+				     ValueType(0.0), ValueType(2.0));
+	  return;
+	}
+	rhs_id = lhs_id;
+	edge = 1;
+      }
+
+      ValueType zb_m, zb_p, zb_f;
+      if constexpr (UseSubgrid) {
+	// The face bed level is its lowest point
+	zb_f = sg_acc.face_base(fid);
+	zb_m = zb_f;
+	zb_p = zb_f;
+      } else {
+	ValueType dzbdx_L = dzbdx.data()[lhs_id] * (edge < 0 ? 0 : 1);
+	ValueType dzbdx_R = dzbdx.data()[rhs_id] * (edge > 0 ? 0 : 1);
+	ValueType dzbdy_L = dzbdy.data()[lhs_id] * (edge < 0 ? 0 : 1);
+	ValueType dzbdy_R = dzbdy.data()[rhs_id] * (edge > 0 ? 0 : 1);
+
+	// The bed level of a coded out cell is raised above the water
+	// level in the other cell by the flux kernel. Only the static
+	// part of it is stored here.
+	if (edge < 0) {
+	  zb_L = zb_R;
+	}
+	if (edge > 0) {
+	  zb_R = zb_L;
+	}
+
+	zb_m = zb_L +
+	  ValueType(0.5) * dx * dzbdx_L * xdir +
+	  ValueType(0.5) * dx * dzbdy_L * ydir;
+	zb_p = zb_R +
+	  ValueType(-0.5) * dx * dzbdx_R * xdir +
+	  ValueType(-0.5) * dx * dzbdy_R * ydir;
+	zb_f = sycl::fmax(zb_m, zb_p);
+      }
+      fb_acc[fid] = FaceBedType(zb_m, zb_p, zb_f, ValueType(edge));
+    });
+  });
+}
@@ -20,6 +20,7 @@
 #define mfcm_SaintVenant_Constants_hpp
 
 #include "Field.hpp"
+#include "Subgrid.hpp"
 #include <memory>
 
 template<typename T,
@@ -31,6 +32,14 @@ public:
   using ValueType = T;
   using MeshType = Mesh;
   using FieldType = CellField<ValueType,MeshType>;
+  using Subgrid = SaintVenantSubgrid<ValueType,MeshType>;
+
+  /**
+     Per-face bed record: the projected bed levels on the lhs and rhs
+     of the face, the face bed level and the edge code (see
+     face_bed()).
+   */
+  using FaceBedType = sycl::vec<ValueType,4>;
 
 private:
 
@@ -40,14 +49,52 @@ private:
   FieldType dzdx_bed_;
   FieldType dzdy_bed_;
 
+  std::shared_ptr<Subgrid> subgrid_;
+
+  DataArray<FaceBedType> face_bed_;
+
+  template<bool UseSubgrid>
+  void compute_face_bed_(void);
+
+  void initialize_(void);
+
 public:
 
   SaintVenantConstants(const std::shared_ptr<MeshType>& mesh,
 		       bool on_device = true);
 
+  /**
+     Construct from a given bed level, without sub-grid bathymetry,
+     eg one packed from the beds of several meshes (see
+     SaintVenantPackedSolver).
+   */
+  SaintVenantConstants(const std::shared_ptr<MeshType>& mesh,
+		       const FieldType& z_bed,
+		       bool on_device = true);
+
   const CellField<ValueType,MeshType>& z_bed(void) const { return z_bed_; }
   const CellField<ValueType,MeshType>& dzdx_bed(void) const { return dzdx_bed_; }
   const CellField<ValueType,MeshType>& dzdy_bed(void) const { return dzdy_bed_; }
+
+  /**
+     Sub-grid bathymetry tables, or nullptr if they are not used.
+   */
+  const Subgrid* subgrid(void) const { return subgrid_.get(); }
+
+  /**
+     Bed levels at each face, computed once from z_bed, dzdx_bed and
+     dzdy_bed. Components 0 and 1 are the bed levels projected from
+     the lhs and rhs cells to the face, and component 2 is the bed
+     level of the face itself. Component 3 is the edge code: 0 for a
+     face between two active cells, -1 or 1 if the lhs or rhs cell is
+     coded out or off the mesh, and 2 if there is no flow across the
+     face at all.
+
+     Where a cell is coded out its bed level depends on the depth in
+     the other cell, so components 0 or 1 hold only the static part
+     (the bed level of the other cell) and component 2 is not valid.
+   */
+  const DataArray<FaceBedType>& face_bed(void) const { return face_bed_; }
   
 };
 
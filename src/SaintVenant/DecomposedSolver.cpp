@@ -0,0 +1,300 @@
+/***********************************************************************
+ * mfcm SaintVenant/DecomposedSolver.cpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#include "DecomposedSolver.hpp"
+
+template<typename TT,
+	 typename T>
+SaintVenantDecomposedSolver<TT,T>::
+SaintVenantDecomposedSolver(const std::shared_ptr<sycl::queue>& queue,
+			    size_t no_of_states,
+			    const std::shared_ptr<TimeParameters<TT>>& tparams)
+{
+  const Config& mesh_conf = GlobalConfig::instance().mesh_configuration();
+  size_t n_local = mesh_conf.get<size_t>("subdomains", 1);
+  overlap_ = mesh_conf.get<size_t>("subdomain overlap", 2);
+
+  size_t rank = mpi_rank();
+  size_t n_ranks = mpi_size();
+
+  auto mesh = std::make_shared<MeshType>(queue, true);
+  auto [ nx, ny ] = mesh->cell_dimensions();
+
+  // Each rank owns an equal share of the rows. The rows next to
+  // another rank's form a strip of their own, so that the rest can be
+  // updated while they wait for that rank's rows.
+  size_t n_strips = 0;
+  for (size_t r = 0; r < n_ranks; ++r) {
+    size_t y0 = (r * ny) / n_ranks;
+    size_t y1 = ((r + 1) * ny) / n_ranks;
+    size_t b0 = (r > 0) ? overlap_ : 0;
+    size_t b1 = (r + 1 < n_ranks) ? overlap_ : 0;
+    if (n_local == 0 or overlap_ == 0 or y1 - y0 < b0 + b1 or
+	(y1 - y0 - b0 - b1) / n_local < overlap_) {
+      std::cerr << "ERROR: Cannot split " << y1 - y0 << " rows into "
+		<< n_local << " subdomains overlapping by " << overlap_
+		<< " rows." << std::endl;
+      throw std::runtime_error("Invalid subdomains.");
+    }
+    if (r == rank) {
+      first_ = owned_rows_.size();
+    }
+    if (b0 > 0) {
+      owned_rows_.push_back({ y0, y0 + b0 });
+    }
+    size_t m = y1 - y0 - b0 - b1;
+    for (size_t j = 0; j < n_local; ++j) {
+      owned_rows_.push_back({ y0 + b0 + (j * m) / n_local,
+			      y0 + b0 + ((j + 1) * m) / n_local });
+    }
+    if (b1 > 0) {
+      owned_rows_.push_back({ y1 - b1, y1 });
+    }
+    if (r == rank) {
+      n_strips = owned_rows_.size() - first_;
+    }
+  }
+  size_t n = owned_rows_.size();
+  for (size_t k = 0; k < n; ++k) {
+    size_t y0 = owned_rows_.at(k)[0];
+    size_t y1 = owned_rows_.at(k)[1];
+    rows_.push_back({ (k == 0) ? y0 : y0 - overlap_,
+		      (k + 1 == n) ? y1 : y1 + overlap_ });
+  }
+
+  if (n_ranks > 1) {
+    size_t y0 = owned_rows_.at(first_)[0];
+    size_t y1 = owned_rows_.at(first_ + n_strips - 1)[1];
+    mesh_ = mesh->row_block(queue, y0, y1 - y0);
+  } else {
+    mesh_ = mesh;
+  }
+
+  // The strips next to other ranks share the queue of the strip they
+  // border
+  std::vector<std::shared_ptr<sycl::queue>> queues = get_sycl_queues(queue, n_local);
+  size_t leading = (rank > 0) ? 1 : 0;
+  for (size_t k = first_; k < first_ + n_strips; ++k) {
+    size_t y0 = owned_rows_.at(k)[0];
+    size_t y1 = owned_rows_.at(k)[1];
+    size_t r0 = rows_.at(k)[0];
+    size_t j = k - first_;
+    j = (j < leading) ? 0 : std::min(j - leading, n_local - 1);
+    const std::shared_ptr<sycl::queue>& q = queues.at(j);
+    std::cout << "Subdomain " << k << ": rows " << y0 << " to " << y1 - 1
+	      << " on " << q->get_device().template get_info<sycl::info::device::name>()
+	      << std::endl;
+    subdomains_.push_back(std::make_shared<SubdomainSolver>(mesh->row_block(q, r0,
+									     rows_.at(k)[1] - r0),
+							    no_of_states, tparams,
+							    std::array<size_t,2>{ (y0 - r0) * nx,
+										  (y1 - r0) * nx }));
+  }
+}
+
+template<typename TT,
+	 typename T>
+void
+SaintVenantDecomposedSolver<TT,T>::pack_rows(const size_t& k,
+					     const size_t& row,
+					     const size_t& state_no,
+					     T* buffer)
+{
+  size_t nx = mesh_->cell_dimensions()[0];
+  size_t count = overlap_ * nx;
+  size_t offset = (row - rows_.at(k)[0]) * nx;
+
+  auto& U = subdomain(k).state(state_no);
+  U.h().data().read_range(offset, count, buffer);
+  U.u().data().read_range(offset, count, buffer + count);
+  U.v().data().read_range(offset, count, buffer + 2 * count);
+}
+
+template<typename TT,
+	 typename T>
+void
+SaintVenantDecomposedSolver<TT,T>::unpack_rows(const size_t& k,
+					       const size_t& row,
+					       const size_t& state_no,
+					       const T* buffer)
+{
+  size_t nx = mesh_->cell_dimensions()[0];
+  size_t count = overlap_ * nx;
+  size_t offset = (row - rows_.at(k)[0]) * nx;
+
+  auto& U = subdomain(k).state(state_no);
+  U.h().data().write_range(offset, count, buffer);
+  U.u().data().write_range(offset, count, buffer + count);
+  U.v().data().write_range(offset, count, buffer + 2 * count);
+}
+
+template<typename TT,
+	 typename T>
+template<typename Update>
+void
+SaintVenantDecomposedSolver<TT,T>::exchange_overlaps(const size_t& state_no,
+						     Update&& update)
+{
+  // The subdomains may be on different devices or ranks, so the rows
+  // are staged through the host
+  size_t size = 3 * overlap_ * mesh_->cell_dimensions()[0];
+  size_t last = first_ + subdomains_.size() - 1;
+  bool remote_first = (first_ > 0);
+  bool remote_last = (last + 1 < owned_rows_.size());
+
+#ifdef MFCM_USE_MPI
+  // Start the exchanges with the neighbouring ranks, which hold the
+  // subdomains either side of ours
+  std::vector<MPI_Request> requests;
+  std::vector<std::vector<ValueType>> received;
+  std::vector<std::vector<ValueType>> sent;
+  int rank = mpi_rank();
+  auto exchange = [&](const size_t& k_local, const size_t& k_remote, int neighbour)
+  {
+    // The neighbour sends the rows it owns next to us, and we send the
+    // rows we own next to it
+    size_t send_row = (k_remote > k_local) ?
+      owned_rows_.at(k_local)[1] - overlap_ : owned_rows_.at(k_local)[0];
+    received.emplace_back(size);
+    sent.emplace_back(size);
+    requests.emplace_back();
+    MPI_Irecv(received.back().data(), size, mpi_datatype<ValueType>(),
+	      neighbour, 0, MPI_COMM_WORLD, &requests.back());
+    pack_rows(k_local, send_row, state_no, sent.back().data());
+    requests.emplace_back();
+    MPI_Isend(sent.back().data(), size, mpi_datatype<ValueType>(),
+	      neighbour, 0, MPI_COMM_WORLD, &requests.back());
+  };
+  received.reserve(2);
+  sent.reserve(2);
+  requests.reserve(4);
+  if (remote_first) {
+    exchange(first_, first_ - 1, rank - 1);
+  }
+  if (remote_last) {
+    exchange(last, last + 1, rank + 1);
+  }
+#endif
+
+  // Exchange the rows between our own subdomains meanwhile
+  std::vector<ValueType> buffer(size);
+  for (size_t k = first_; k < last; ++k) {
+    // The last rows owned by subdomain k and the first rows owned by
+    // subdomain k + 1
+    pack_rows(k, owned_rows_.at(k)[1] - overlap_, state_no, buffer.data());
+    unpack_rows(k + 1, owned_rows_.at(k)[1] - overlap_, state_no, buffer.data());
+    pack_rows(k + 1, owned_rows_.at(k + 1)[0], state_no, buffer.data());
+    unpack_rows(k, owned_rows_.at(k + 1)[0], state_no, buffer.data());
+  }
+
+  // Every row of the strips without a neighbour on another rank is
+  // now current, so update them while the other rows are in flight
+  for (size_t k = first_; k <= last; ++k) {
+    if (not ((k == first_ and remote_first) or (k == last and remote_last))) {
+      update(subdomain(k));
+    }
+  }
+
+#ifdef MFCM_USE_MPI
+  MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+  size_t r = 0;
+  if (remote_first) {
+    unpack_rows(first_, owned_rows_.at(first_ - 1)[1] - overlap_, state_no,
+		received.at(r++).data());
+  }
+  if (remote_last) {
+    unpack_rows(last, owned_rows_.at(last + 1)[0], state_no,
+		received.at(r++).data());
+  }
+#endif
+
+  if (remote_first) {
+    update(subdomain(first_));
+  }
+  if (remote_last and last != first_) {
+    update(subdomain(last));
+  }
+}
+
+template<typename TT,
+	 typename T>
+void
+SaintVenantDecomposedSolver<TT,T>::update_dUdt(const size_t& state_no,
+					       const TT& time_now,
+					       const TT& timestep)
+{
+  // Each subdomain submits its kernels to its own queue, so they run
+  // concurrently
+  exchange_overlaps(state_no, [&] (SubdomainSolver& subdomain) {
+    subdomain.update_dUdt(state_no, time_now, timestep);
+  });
+}
+
+template<typename TT,
+	 typename T>
+T
+SaintVenantDecomposedSolver<TT,T>::control_number(const size_t& state_no,
+						  const TT& timestep)
+{
+  // Each subdomain only counts the rows it owns, since the
+  // overlapping rows still hold its own estimate of its neighbours'
+  // state
+  ValueType cn = ValueType(0.0);
+  for (auto&& subdomain : subdomains_) {
+    cn = std::max(cn, subdomain->control_number(state_no, timestep));
+  }
+#ifdef MFCM_USE_MPI
+  MPI_Allreduce(MPI_IN_PLACE, &cn, 1, mpi_datatype<ValueType>(),
+		MPI_MAX, MPI_COMM_WORLD);
+#endif
+  return cn;
+}
+
+template<typename TT,
+	 typename T>
+CellField<T,Cartesian2DMesh>*
+SaintVenantDecomposedSolver<TT,T>::gather_output_field(const std::string& name)
+{
+  auto [ nx, ny ] = mesh_->cell_dimensions();
+  size_t base = owned_rows_.at(first_)[0];
+  std::vector<ValueType> row_major(nx * ny);
+
+  std::string field_name = name;
+  for (size_t k = first_; k < first_ + subdomains_.size(); ++k) {
+    CellField<ValueType,MeshType>* ptr =
+      subdomain(k).template get_output_field_ptr<MeshComponent::Cell>(name);
+    if (not ptr) {
+      return nullptr;
+    }
+    field_name = ptr->name();
+    size_t y0 = owned_rows_.at(k)[0];
+    size_t y1 = owned_rows_.at(k)[1];
+    ptr->data().read_range((y0 - rows_.at(k)[0]) * nx, (y1 - y0) * nx,
+			   row_major.data() + (y0 - base) * nx);
+  }
+
+  std::vector<ValueType> values(row_major.size());
+  for (size_t i = 0; i < row_major.size(); ++i) {
+    values[mesh_->template storage_index<MeshComponent::Cell>(i)] = row_major[i];
+  }
+
+  auto& field = output_fields_[name];
+  field = std::make_shared<CellField<ValueType,MeshType>>(mesh_->queue_ptr(), field_name,
+							  mesh_, values, false);
+  return field.get();
+}
@@ -0,0 +1,203 @@
+/***********************************************************************
+ * mfcm SaintVenant/DecomposedSolver.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_SaintVenant_DecomposedSolver_hpp
+#define mfcm_SaintVenant_DecomposedSolver_hpp
+
+#include "Solver.hpp"
+#include "StateGroup.hpp"
+#include "Cartesian2DMesh.hpp"
+#include "mpi.hpp"
+
+#include <map>
+
+/**
+   A solver for the Saint Venant equations on a Cartesian mesh split
+   into strips of rows, each solved by a SaintVenantSolver on its own
+   SYCL queue (see get_sycl_queues).
+
+   The mesh configuration key "subdomains" sets the number of strips
+   in each process, and "subdomain overlap" (default 2) the number of
+   rows each strip shares with its neighbours. The shared rows are
+   copied from the strip that owns them before every derivative
+   evaluation, ie after each stage of the temporal scheme, and the
+   control number is the largest over the rows owned by each strip.
+
+   If mfcm is built with MPI, each rank solves a consecutive group of
+   strips and exchanges the shared rows at the ends of its group with
+   its neighbouring ranks. The last "subdomain overlap" rows next to
+   another rank form a strip of their own, so that the other strips
+   are updated while the exchange is in flight. Output fields then
+   cover the rows owned by the rank.
+ */
+template<typename TT,
+	 typename T>
+class SaintVenantDecomposedSolver
+{
+public:
+
+  using TimeType = TT;
+  using ValueType = T;
+  using MeshType = Cartesian2DMesh;
+
+  using SubdomainSolver = SaintVenantSolver<TimeType,ValueType,MeshType>;
+  using State = SaintVenantStateGroup<ValueType,MeshType>;
+
+private:
+
+  // The mesh on which output fields are gathered: the whole mesh, or
+  // the rows owned by this rank if there is more than one
+  std::shared_ptr<MeshType> mesh_;
+  size_t overlap_;
+
+  // The first and one-past-last rows of the whole mesh covered by
+  // each subdomain's mesh, and owned by each subdomain
+  std::vector<std::array<size_t,2>> rows_;
+  std::vector<std::array<size_t,2>> owned_rows_;
+
+  // The subdomains solved by this rank, starting with subdomain
+  // first_
+  size_t first_;
+  std::vector<std::shared_ptr<SubdomainSolver>> subdomains_;
+
+  // Output fields gathered on mesh_
+  std::map<std::string, std::shared_ptr<CellField<ValueType,MeshType>>> output_fields_;
+
+  SubdomainSolver& subdomain(const size_t& k)
+  {
+    return *(subdomains_.at(k - first_));
+  }
+
+  bool is_local(const size_t& k) const
+  {
+    return (k >= first_ and k < first_ + subdomains_.size());
+  }
+
+  void pack_rows(const size_t& k,
+		 const size_t& row,
+		 const size_t& state_no,
+		 ValueType* buffer);
+
+  void unpack_rows(const size_t& k,
+		   const size_t& row,
+		   const size_t& state_no,
+		   const ValueType* buffer);
+
+  /**
+     Copy the shared rows of state state_no from the subdomains that
+     own them, calling update with each local subdomain once its rows
+     are current: those without a neighbour on another rank first,
+     while the rows from the other ranks are in flight.
+   */
+  template<typename Update>
+  void exchange_overlaps(const size_t& state_no, Update&& update);
+
+  CellField<ValueType,MeshType>* gather_output_field(const std::string& name);
+
+public:
+
+  /**
+     Constructor. Create a solver for the Saint Venant equations
+     decomposed over several subdomains.
+
+     @param queue Pointer to SYCL queue object. Its device is shared
+     or partitioned between the subdomains.
+     @param no_of_states Number of intermediate states that the
+     program must store.
+     @param tparams Pointer to the time parameters of the scheme.
+  */
+  SaintVenantDecomposedSolver(const std::shared_ptr<sycl::queue>& queue,
+			      size_t no_of_states,
+			      const std::shared_ptr<TimeParameters<TimeType>>& tparams);
+
+  const std::shared_ptr<sycl::queue>& queue(void)
+  {
+    return mesh_->queue_ptr();
+  }
+
+  void end_of_step(const TimeType& time_now)
+  {
+    for (auto&& subdomain : subdomains_) {
+      subdomain->end_of_step(time_now);
+    }
+  }
+
+  void update_dUdt(const size_t& state_no,
+		   const TimeType& time_now,
+		   const TimeType& timestep);
+
+  void start_new_step(const TimeType& time_now,
+		      const std::shared_ptr<TimeParameters<TimeType>>& tp_ptr)
+  {
+    for (auto&& subdomain : subdomains_) {
+      subdomain->start_new_step(time_now, tp_ptr);
+    }
+  }
+
+  State state(const size_t& i = 0)
+  {
+    std::vector<typename State::StateType*> parts;
+    for (auto&& subdomain : subdomains_) {
+      parts.push_back(&(subdomain->state(i)));
+    }
+    return State(parts);
+  }
+
+  State dUdt(const size_t& i)
+  {
+    std::vector<typename State::StateType*> parts;
+    for (auto&& subdomain : subdomains_) {
+      parts.push_back(&(subdomain->dUdt(i)));
+    }
+    return State(parts);
+  }
+
+  ValueType control_number(const size_t& state_no,
+			   const TimeType& timestep);
+
+  /**
+     Register interest in an output field with every subdomain. Only
+     fields on the cells can be gathered on the whole mesh.
+   */
+  template<MeshComponent C>
+  bool request_output_field(const std::string& name)
+  {
+    if constexpr (C != MeshComponent::Cell) {
+      return false;
+    } else {
+      bool available = true;
+      for (auto&& subdomain : subdomains_) {
+	available = subdomain->template request_output_field<C>(name) and available;
+      }
+      return available;
+    }
+  }
+
+  template<MeshComponent C>
+  Field<ValueType,MeshType,C>* get_output_field_ptr(const std::string& name)
+  {
+    if constexpr (C != MeshComponent::Cell) {
+      return nullptr;
+    } else {
+      return gather_output_field(name);
+    }
+  }
+
+};
+
+#endif
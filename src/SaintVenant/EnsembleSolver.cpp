@@ -0,0 +1,82 @@
+/***********************************************************************
+ * mfcm SaintVenant/EnsembleSolver.cpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#include "EnsembleSolver.hpp"
+
+template<typename TT,
+	 typename T>
+SaintVenantEnsembleSolver<TT,T>::
+SaintVenantEnsembleSolver(const std::shared_ptr<sycl::queue>& queue,
+			  size_t no_of_states,
+			  const std::shared_ptr<TimeParameters<TT>>& tparams)
+  : members_(std::make_shared<PackedSolver>(queue, no_of_states, tparams,
+					    member_overrides()))
+{
+}
+
+template<typename TT,
+	 typename T>
+std::vector<const Config*>
+SaintVenantEnsembleSolver<TT,T>::member_overrides(void)
+{
+  const Config& ens_conf = GlobalConfig::instance().ensemble_configuration();
+  std::vector<const Config*> overrides;
+  auto m_crange = ens_conf.equal_range("member");
+  for (auto it = m_crange.first; it != m_crange.second; ++it) {
+    overrides.push_back(&(it->second));
+  }
+  size_t n = ens_conf.get<size_t>("members", overrides.size());
+  if (n == 0 or n < overrides.size()) {
+    std::cerr << "ERROR: An ensemble of " << n << " members cannot have "
+	      << overrides.size() << " member sections." << std::endl;
+    throw std::runtime_error("Invalid ensemble.");
+  }
+
+  std::cout << "Ensemble of " << n << " members" << std::endl;
+  overrides.resize(n, nullptr);
+  return overrides;
+}
+
+template<typename TT,
+	 typename T>
+bool
+SaintVenantEnsembleSolver<TT,T>::split_member_name(const std::string& name,
+						   std::string& base_name,
+						   size_t& member) const
+{
+  size_t open = name.rfind('[');
+  if (open == std::string::npos or name.back() != ']') {
+    return false;
+  }
+  base_name = name.substr(0, open);
+  std::string member_str = name.substr(open + 1, name.size() - open - 2);
+  try {
+    member = std::stoul(member_str);
+  } catch (const std::exception& e) {
+    std::cerr << "ERROR: Invalid ensemble member in output field "
+	      << std::quoted(name) << std::endl;
+    throw std::runtime_error("Invalid ensemble member.");
+  }
+  if (member >= members_->block_count()) {
+    std::cerr << "ERROR: Output field " << std::quoted(name)
+	      << " refers to member " << member << " of an ensemble of "
+	      << members_->block_count() << " members." << std::endl;
+    throw std::runtime_error("Invalid ensemble member.");
+  }
+  return true;
+}
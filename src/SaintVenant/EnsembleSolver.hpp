@@ -0,0 +1,226 @@
+/***********************************************************************
+ * mfcm SaintVenant/EnsembleSolver.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_SaintVenant_EnsembleSolver_hpp
+#define mfcm_SaintVenant_EnsembleSolver_hpp
+
+#include "PackedSolver.hpp"
+
+#include <map>
+
+/**
+   A solver for an ensemble of runs of the Saint Venant equations on
+   the same Cartesian mesh, packed into one SaintVenantPackedSolver
+   with a block of the mesh for each run, so that each kernel is
+   launched once over every member and each member takes the timestep
+   that it allows (see RungeKuttaBlockSolver).
+
+   The ensemble configuration key "members" sets the number of runs,
+   which otherwise is the number of "member" sections. The "source
+   term" and "boundary" sections of the i-th "member" section are
+   merged into those of the same type for the i-th run, eg to perturb
+   the Manning's n or to use another inflow hydrograph.
+
+   An output field "name" is the mean over the members, and
+   "name[i]" is that of the i-th member. Measures are those of the
+   first member.
+ */
+template<typename TT,
+	 typename T>
+class SaintVenantEnsembleSolver
+{
+public:
+
+  using TimeType = TT;
+  using ValueType = T;
+  using MeshType = Cartesian2DMesh;
+
+  using PackedSolver = SaintVenantPackedSolver<TimeType,ValueType>;
+  using State = typename PackedSolver::State;
+
+  template<MeshComponent C>
+  using OutputFieldMap = std::map<std::string,
+				  std::shared_ptr<Field<ValueType,MeshType,C>>>;
+
+private:
+
+  std::shared_ptr<PackedSolver> members_;
+
+  // Output fields copied from a member or averaged over the members
+  OutputFieldMap<MeshComponent::Cell> cell_output_fields_;
+  OutputFieldMap<MeshComponent::Face> face_output_fields_;
+  OutputFieldMap<MeshComponent::Vertex> vertex_output_fields_;
+
+  template<MeshComponent C>
+  OutputFieldMap<C>& output_fields(void)
+  {
+    if constexpr (C == MeshComponent::Cell) {
+      return cell_output_fields_;
+    } else if constexpr (C == MeshComponent::Face) {
+      return face_output_fields_;
+    } else {
+      return vertex_output_fields_;
+    }
+  }
+
+  /**
+     Split an output field name of the form "name[i]" into the name
+     and the member i. Returns false if the name has no member.
+   */
+  bool split_member_name(const std::string& name,
+			 std::string& base_name,
+			 size_t& member) const;
+
+  static std::vector<const Config*> member_overrides(void);
+
+public:
+
+  /**
+     Constructor. Create a solver for an ensemble of runs of the
+     Saint Venant equations.
+
+     @param queue Pointer to SYCL queue object to be used for the
+     solution.
+     @param no_of_states Number of intermediate states that the
+     program must store.
+     @param tparams Pointer to the time parameters of the scheme.
+  */
+  SaintVenantEnsembleSolver(const std::shared_ptr<sycl::queue>& queue,
+			    size_t no_of_states,
+			    const std::shared_ptr<TimeParameters<TimeType>>& tparams);
+
+  const std::shared_ptr<sycl::queue>& queue(void)
+  {
+    return members_->queue();
+  }
+
+  size_t block_count(void) const
+  {
+    return members_->block_count();
+  }
+
+  void set_block_clocks(const std::vector<double>& clocks)
+  {
+    members_->set_block_clocks(clocks);
+  }
+
+  void end_of_step(const TimeType& time_now)
+  {
+    members_->end_of_step(time_now);
+  }
+
+  void update_dUdt(const size_t& state_no,
+		   const TimeType& time_now,
+		   const TimeType& timestep)
+  {
+    members_->update_dUdt(state_no, time_now, timestep);
+  }
+
+  void start_new_step(const TimeType& time_now,
+		      const std::shared_ptr<TimeParameters<TimeType>>& tp_ptr)
+  {
+    members_->start_new_step(time_now, tp_ptr);
+  }
+
+  State& state(const size_t& i = 0)
+  {
+    return members_->state(i);
+  }
+
+  State& dUdt(const size_t& i)
+  {
+    return members_->dUdt(i);
+  }
+
+  std::vector<ValueType> block_control_numbers(const size_t& state_no)
+  {
+    return members_->block_control_numbers(state_no);
+  }
+
+  ValueType control_number(const size_t& state_no,
+			   const TimeType& timestep)
+  {
+    return members_->control_number(state_no, timestep);
+  }
+
+  void accept_blocks(const size_t& state_no,
+		     const std::vector<bool>& accepted)
+  {
+    members_->accept_blocks(state_no, accepted);
+  }
+
+  /**
+     Register interest in an output field of the members.
+   */
+  template<MeshComponent C>
+  bool request_output_field(const std::string& name)
+  {
+    std::string base_name;
+    size_t member;
+    if (not split_member_name(name, base_name, member)) {
+      base_name = name;
+    }
+    return members_->template request_output_field<C>(base_name);
+  }
+
+  template<MeshComponent C>
+  Field<ValueType,MeshType,C>* get_output_field_ptr(const std::string& name)
+  {
+    using OutputFieldType = Field<ValueType,MeshType,C>;
+
+    std::string base_name;
+    size_t member;
+    bool one_member = split_member_name(name, base_name, member);
+    if (not one_member) {
+      base_name = name;
+      member = 0;
+    }
+
+    OutputFieldType* ptr =
+      members_->template get_block_output_field_ptr<C>(member, base_name);
+    if (not ptr) {
+      return nullptr;
+    }
+
+    // Copy the member's field, renamed after the member if it is one
+    // member's field
+    auto& field = output_fields<C>()[name];
+    if (not field) {
+      field = std::make_shared<OutputFieldType>("", *ptr,
+						one_member ? name.substr(base_name.size()) : "");
+    } else {
+      *field = *ptr;
+    }
+
+    if (not one_member) {
+      for (size_t i = 1; i < members_->block_count(); ++i) {
+	ptr = members_->template get_block_output_field_ptr<C>(i, base_name);
+	if (not ptr) {
+	  return nullptr;
+	}
+	*field += *ptr;
+      }
+      *field *= ValueType(1.0) / ValueType(members_->block_count());
+    }
+
+    return field.get();
+  }
+
+};
+
+#endif
@@ -19,91 +19,101 @@
 #include "FluxKernel.hpp"
 
 template<typename T,
-	 typename Mesh>
-SaintVenantFluxKernel<T,Mesh>::
+	 typename Mesh,
+	 bool ReconstructSlopes,
+	 bool WriteDiagnostics,
+	 bool UseSubgrid>
+SaintVenantFluxKernel<T,Mesh,ReconstructSlopes,WriteDiagnostics,UseSubgrid>::
 SaintVenantFluxKernel(sycl::handler& cgh,
 		      const State& U, const Constants& K,
 		      const State& dUdx, const State& dUdy,
 		      FaceField<ValueType,MeshType>& hflux,
 		      FaceField<ValueType,MeshType>& uflux,
 		      FaceField<ValueType,MeshType>& vflux,
-		      FaceField<ValueType,MeshType>& zflux
-#if MFCM_FLUX_BRANCH_OUTPUT
-			, FaceField<ValueType,MeshType>& branchflux
-#endif
-			)
+		      FaceField<ValueType,MeshType>& zflux,
+		      FaceField<ValueType,MeshType>* branchflux)
   : h_(U.h(), cgh), u_(U.u(), cgh), v_(U.v(), cgh),
-    zb_(K.z_bed(), cgh), dzbdx_(K.dzdx_bed(), cgh), dzbdy_(K.dzdy_bed(), cgh),
+    face_bed_(K.face_bed().get_read_accessor(cgh)),
     dhdx_(dUdx.h(), cgh), dudx_(dUdx.u(), cgh), dvdx_(dUdx.v(), cgh),
     dhdy_(dUdy.h(), cgh), dudy_(dUdy.u(), cgh), dvdy_(dUdy.v(), cgh),
     hflux_(hflux, cgh), uflux_(uflux, cgh),
-    vflux_(vflux, cgh), zflux_(zflux, cgh)
-#if MFCM_FLUX_BRANCH_OUTPUT
-  , branchflux_(branchflux, cgh)
-#endif
+    vflux_(vflux, cgh), zflux_(zflux, cgh),
+    branchflux_(branchflux, cgh),
+    subgrid_(K.subgrid(), cgh)
 {
 }
 
 template<typename T,
-	 typename Mesh>
+	 typename Mesh,
+	 bool ReconstructSlopes,
+	 bool WriteDiagnostics,
+	 bool UseSubgrid>
 void
-SaintVenantFluxKernel<T,Mesh>::
+SaintVenantFluxKernel<T,Mesh,ReconstructSlopes,WriteDiagnostics,UseSubgrid>::
 zero_flux(const size_t& fid) const
 {
   hflux_.data()[fid] = ValueType(0.0);
   uflux_.data()[fid] = ValueType(0.0);
   vflux_.data()[fid] = ValueType(0.0);
   zflux_.data()[fid] = ValueType(0.0);    
-#if MFCM_FLUX_BRANCH_OUTPUT
-branchflux_.data()[fid] = ValueType(0.0);
-#endif
+  branchflux_.set(fid, ValueType(0.0));
 }
   
 template<typename T,
-	 typename Mesh>
+	 typename Mesh,
+	 bool ReconstructSlopes,
+	 bool WriteDiagnostics,
+	 bool UseSubgrid>
 void
-SaintVenantFluxKernel<T,Mesh>::
-operator()(sycl::item<1> item) const
+SaintVenantFluxKernel<T,Mesh,ReconstructSlopes,WriteDiagnostics,UseSubgrid>::
+operator()(sycl::id<1> idx) const
 {
   // Get the face ID
-  size_t fid = item.get_linear_id();
+  size_t fid = idx[0];
 
   // Get the surrounding cell IDs
   auto mesh_acc = h_.mesh();
   auto [ lhs_id, rhs_id, edge, dir, dx ] = mesh_acc.get_adjacent_cells(fid);
 
-  // Direction of flow across this face
-  ValueType xdir = 1.0 - ValueType(dir);
-  ValueType ydir = ValueType(dir);
+  // Unit normal of this face, along which the cell values are
+  // projected to the face
+  ValueType nx, ny;
+  if constexpr (MeshType::has_face_normals) {
+    auto n = mesh_acc.face_normal(fid);
+    nx = n[0];
+    ny = n[1];
+  } else {
+    nx = 1.0 - ValueType(dir);
+    ny = ValueType(dir);
+  }
 
-  // Get the cell bed levels
-  ValueType zb_L = zb_.data()[lhs_id];
-  ValueType zb_R = zb_.data()[rhs_id];
+  // Direction of flow across this face in the frame in which the
+  // fluxes are calculated. On meshes whose faces have arbitrary
+  // orientations the velocities are rotated into the frame of the
+  // face, in which the flow is along the x axis (see below), and
+  // the velocity that is zeroed in coded out cells is the normal
+  // one rather than the one along the axis dir.
+  ValueType xdir = MeshType::has_face_normals ? ValueType(1.0) : nx;
+  ValueType ydir = MeshType::has_face_normals ? ValueType(0.0) : ny;
+  int vdir = MeshType::has_face_normals ? -1 : dir;
 
-  // Check if either of the surrounding cells are excluded from the
-  // computation ("coded out")
-  if (zb_L != zb_L) {
-    // LHS cell bed level is NaN ("coded out")
+  // Get the precomputed bed levels at the face. The edge code says
+  // whether either of the surrounding cells is excluded from the
+  // computation ("coded out") or off the mesh (see
+  // SaintVenantConstants::face_bed).
+  typename Constants::FaceBedType bed = face_bed_[fid];
+  edge = int(bed[3]);
+  if (edge == 2) {
+    // This face is between a coded out cell and the edge of the mesh
+    // or another coded out cell. Move on.
+    zero_flux(fid);
+    return;
+  }
+  if (edge < 0) {
     lhs_id = rhs_id;
-    if (edge == 1) {
-      // This face is between a coded out cell and the RHS of the
-      // mesh. Move on.
-      zero_flux(fid);
-      return;
-    }
-    edge = -1;
   }
-  if (zb_R != zb_R) {
-    // RHS cell bed level is NaN ("coded out")
-    if (edge == -1) {
-      // Either this face is between a coded out cell and the LHS of
-      // the mesh, or it's between a coded out cell and another
-      // coded out cell. Move on.
-      zero_flux(fid);
-      return;
-    }
+  if (edge > 0) {
     rhs_id = lhs_id;
-    edge = 1;
   }
 
   // Get surrounding water depths. Zero the depth if the cell is
@@ -113,86 +123,110 @@ operator()(sycl::item<1> item) const
 
   // Get the surrounding velocities in the x direction. Zero them if
   // the cell is coded out and the face is flowing horizontally.
-  ValueType u_L = u_.data()[lhs_id] * (edge < 0 && xdir == 1 ? 0 : 1);
-  ValueType u_R = u_.data()[rhs_id] * (edge > 0 && xdir == 1 ? 0 : 1);
+  ValueType u_L = u_.data()[lhs_id] * (edge < 0 && vdir == 0 ? 0 : 1);
+  ValueType u_R = u_.data()[rhs_id] * (edge > 0 && vdir == 0 ? 0 : 1);
 
   // Get the surrounding velocities in the y direction. Zero them if
   // the cell is coded out and the face is flowing vertically.
-  ValueType v_L = v_.data()[lhs_id] * (edge < 0 && ydir == 1 ? 0 : 1);
-  ValueType v_R = v_.data()[rhs_id] * (edge > 0 && ydir == 1 ? 0 : 1);
+  ValueType v_L = v_.data()[lhs_id] * (edge < 0 && vdir == 1 ? 0 : 1);
+  ValueType v_R = v_.data()[rhs_id] * (edge > 0 && vdir == 1 ? 0 : 1);
 
   // Get the water depth slopes. Zero if the cell is coded out.
-  ValueType dhdx_L = dhdx_.data()[lhs_id] * (edge < 0 ? 0 : 1);
-  ValueType dhdx_R = dhdx_.data()[rhs_id] * (edge > 0 ? 0 : 1);
-  ValueType dhdy_L = dhdy_.data()[lhs_id] * (edge < 0 ? 0 : 1);
-  ValueType dhdy_R = dhdy_.data()[rhs_id] * (edge > 0 ? 0 : 1);
+  ValueType dhdx_L = x_slope(h_, dhdx_, lhs_id) * (edge < 0 ? 0 : 1);
+  ValueType dhdx_R = x_slope(h_, dhdx_, rhs_id) * (edge > 0 ? 0 : 1);
+  ValueType dhdy_L = y_slope(h_, dhdy_, lhs_id) * (edge < 0 ? 0 : 1);
+  ValueType dhdy_R = y_slope(h_, dhdy_, rhs_id) * (edge > 0 ? 0 : 1);
 
   // Get the slopes of x-dir velocity. Zero if the face is flowing
   // horizontally and the cell is coded out
-  ValueType dudx_L = dudx_.data()[lhs_id] * (edge < 0 && xdir == 1 ? 0 : 1);
-  ValueType dudx_R = dudx_.data()[rhs_id] * (edge > 0 && xdir == 1 ? 0 : 1);
-  ValueType dudy_L = dudy_.data()[lhs_id] * (edge < 0 && xdir == 1 ? 0 : 1);
-  ValueType dudy_R = dudy_.data()[rhs_id] * (edge > 0 && xdir == 1 ? 0 : 1);
+  ValueType dudx_L = x_slope(u_, dudx_, lhs_id) * (edge < 0 && vdir == 0 ? 0 : 1);
+  ValueType dudx_R = x_slope(u_, dudx_, rhs_id) * (edge > 0 && vdir == 0 ? 0 : 1);
+  ValueType dudy_L = y_slope(u_, dudy_, lhs_id) * (edge < 0 && vdir == 0 ? 0 : 1);
+  ValueType dudy_R = y_slope(u_, dudy_, rhs_id) * (edge > 0 && vdir == 0 ? 0 : 1);
 
   // Get the slopes of y-dir velocity. Zero if the face is flowing
   // vertically and the cell is coded out
-  ValueType dvdx_L = dvdx_.data()[lhs_id] * (edge < 0 && ydir == 1 ? 0 : 1);
-  ValueType dvdx_R = dvdx_.data()[rhs_id] * (edge > 0 && ydir == 1 ? 0 : 1);
-  ValueType dvdy_L = dvdy_.data()[lhs_id] * (edge < 0 && ydir == 1 ? 0 : 1);
-  ValueType dvdy_R = dvdy_.data()[rhs_id] * (edge > 0 && ydir == 1 ? 0 : 1);
-
-  // Get the bed elevation slopes. Zero if the cell is coded out.
-  ValueType dzbdx_L = dzbdx_.data()[lhs_id] * (edge < 0 ? 0 : 1);
-  ValueType dzbdx_R = dzbdx_.data()[rhs_id] * (edge > 0 ? 0 : 1);
-  ValueType dzbdy_L = dzbdy_.data()[lhs_id] * (edge < 0 ? 0 : 1);
-  ValueType dzbdy_R = dzbdy_.data()[rhs_id] * (edge > 0 ? 0 : 1);
+  ValueType dvdx_L = x_slope(v_, dvdx_, lhs_id) * (edge < 0 && vdir == 1 ? 0 : 1);
+  ValueType dvdx_R = x_slope(v_, dvdx_, rhs_id) * (edge > 0 && vdir == 1 ? 0 : 1);
+  ValueType dvdy_L = y_slope(v_, dvdy_, lhs_id) * (edge < 0 && vdir == 1 ? 0 : 1);
+  ValueType dvdy_R = y_slope(v_, dvdy_, rhs_id) * (edge > 0 && vdir == 1 ? 0 : 1);
 
-  // If one of our cells is coded out, pretend its bed level is
-  // above the water level in the other cell.
-  if (edge < 0) {
-    zb_L = zb_R + h_R * 2.0f;
-  }
-  if (edge > 0) {
-    zb_R = zb_L + h_L * 2.0f;
+  // Projected bed levels either side of the face. If one of our
+  // cells is coded out, pretend its bed level is above the water
+  // level in the other cell.
+  ValueType zb_m = bed[0];
+  ValueType zb_p = bed[1];
+  if constexpr (not UseSubgrid) {
+    if (edge < 0) {
+      zb_m += h_R * 2.0f;
+    }
+    if (edge > 0) {
+      zb_p += h_L * 2.0f;
+    }
   }
 
   // Project estimates of each variable from the lhs cell rightward
   // to the lhs of the face
-  ValueType zb_m = zb_L +
-    ValueType(0.5) * dx * dzbdx_L * xdir +
-    ValueType(0.5) * dx * dzbdy_L * ydir;
   ValueType h_m = h_L +
-    ValueType(0.5) * dx * dhdx_L * xdir +
-    ValueType(0.5) * dx * dhdy_L * ydir;
+    ValueType(0.5) * dx * dhdx_L * nx +
+    ValueType(0.5) * dx * dhdy_L * ny;
   ValueType u_m = u_L +
-    ValueType(0.5) * dx * dudx_L * xdir +
-    ValueType(0.5) * dx * dudy_L * ydir;
+    ValueType(0.5) * dx * dudx_L * nx +
+    ValueType(0.5) * dx * dudy_L * ny;
   ValueType v_m = v_L +
-    ValueType(0.5) * dx * dvdx_L * xdir +
-    ValueType(0.5) * dx * dvdy_L * ydir;
+    ValueType(0.5) * dx * dvdx_L * nx +
+    ValueType(0.5) * dx * dvdy_L * ny;
 
   // Project estimates of each variable from the rhs cell leftward
   // to the rhs of the face
-  ValueType zb_p = zb_R +
-    ValueType(-0.5) * dx * dzbdx_R * xdir +
-    ValueType(-0.5) * dx * dzbdy_R * ydir;
   ValueType h_p = h_R +
-    ValueType(-0.5) * dx * dhdx_R * xdir +
-    ValueType(-0.5) * dx * dhdy_R * ydir;
+    ValueType(-0.5) * dx * dhdx_R * nx +
+    ValueType(-0.5) * dx * dhdy_R * ny;
   ValueType u_p = u_R +
-    ValueType(-0.5) * dx * dudx_R * xdir +
-    ValueType(-0.5) * dx * dudy_R * ydir;
+    ValueType(-0.5) * dx * dudx_R * nx +
+    ValueType(-0.5) * dx * dudy_R * ny;
   ValueType v_p = v_R +
-    ValueType(-0.5) * dx * dvdx_R * xdir +
-    ValueType(-0.5) * dx * dvdy_R * ydir;
+    ValueType(-0.5) * dx * dvdx_R * nx +
+    ValueType(-0.5) * dx * dvdy_R * ny;
 
-  // Calculate the bed level of the face (the maximum of the two
-  // projected bed levels)
-  ValueType zb_f = sycl::fmax(zb_m, zb_p);
+  ValueType zb_f, y_m, y_p;
+  if constexpr (UseSubgrid) {
+    // The depths are mean depths over each cell, so find the water
+    // level in each cell and then the mean flow depth across the face
+    // at that level. The face bed level is its lowest point, and the
+    // reconstruction is first order.
+    zb_f = bed[2];
+    y_m = (edge < 0) ? zb_f : subgrid_.cell_level(lhs_id, h_L);
+    y_p = (edge > 0) ? zb_f : subgrid_.cell_level(rhs_id, h_R);
+    h_m = subgrid_.face_depth(fid, y_m);
+    h_p = subgrid_.face_depth(fid, y_p);
+    u_m = u_L;
+    u_p = u_R;
+    v_m = v_L;
+    v_p = v_R;
+  } else {
+    // The bed level of the face is the maximum of the two projected
+    // bed levels. It only changes with the water level if one of the
+    // cells is coded out.
+    zb_f = (edge == 0) ? bed[2] : sycl::fmax(zb_m, zb_p);
 
-  // Calculate the water levels at the face
-  ValueType y_m = zb_m + h_m;
-  ValueType y_p = zb_p + h_p;
+    // Calculate the water levels at the face
+    y_m = zb_m + h_m;
+    y_p = zb_p + h_p;
+  }
+
+  if constexpr (MeshType::has_face_normals) {
+    // Rotate the velocities into the frame of the face: u becomes the
+    // component along the normal (nx, ny) and v the component along
+    // the tangent (-ny, nx). The normal velocity of a coded out cell
+    // is zero.
+    ValueType un_m = (u_m * nx + v_m * ny) * (edge < 0 ? 0 : 1);
+    ValueType un_p = (u_p * nx + v_p * ny) * (edge > 0 ? 0 : 1);
+    v_m = v_m * nx - u_m * ny;
+    v_p = v_p * nx - u_p * ny;
+    u_m = un_m;
+    u_p = un_p;
+  }
 
   // Limit the depths on each side of the face such that they are
   // never negative.
@@ -204,6 +238,7 @@ operator()(sycl::item<1> item) const
   ValueType c_p = sycl::sqrt(ValueType(9.81) * h_p);
 
   ValueType branch = 5;
+  ValueType h_flux, u_flux, v_flux, z_flux;
   // Calculate the face fluxes:
   if (y_m > zb_f and y_p > zb_f) {
     branch = 1;
@@ -225,32 +260,32 @@ operator()(sycl::item<1> item) const
     ValueType a = sycl::fmax(sycl::fabs(spd_p + sycl::sign(spd_p) * c_p),
 			     sycl::fabs(spd_m + sycl::sign(spd_m) * c_m));
       
-    hflux_.data()[fid] = ValueType(0.5) * (hf_p + hf_m) -
+    h_flux = ValueType(0.5) * (hf_p + hf_m) -
       ValueType(0.5) * a * (h_p - h_m);
-    uflux_.data()[fid] = ValueType(0.5) * (uf_p + uf_m) -
+    u_flux = ValueType(0.5) * (uf_p + uf_m) -
       ValueType(0.5) * a * (u_p - u_m);
-    vflux_.data()[fid] = ValueType(0.5) * (vf_p + vf_m) -
+    v_flux = ValueType(0.5) * (vf_p + vf_m) -
       ValueType(0.5) * a * (v_p - v_m);
-    zflux_.data()[fid] = (zb_m - zb_p) * ValueType(9.81);
+    z_flux = (zb_m - zb_p) * ValueType(9.81);
   } else if (y_m <= zb_f and y_p <= zb_f) {
     branch = 2;
     // Both water levels below the face, but we could have some
     // water in the lower cell
-    hflux_.data()[fid] = ValueType(0.0);
+    h_flux = ValueType(0.0);
     if (zb_p > zb_m) {
       branch += 0.25;
       ValueType uf_m = ValueType(9.81) * h_m * xdir;
       ValueType vf_m = ValueType(9.81) * h_m * ydir;
-      uflux_.data()[fid] = ValueType(0.5) * uf_m;
-      vflux_.data()[fid] = ValueType(0.5) * vf_m;
-      zflux_.data()[fid] = -h_m * ValueType(0.5) * ValueType(9.81);
+      u_flux = ValueType(0.5) * uf_m;
+      v_flux = ValueType(0.5) * vf_m;
+      z_flux = -h_m * ValueType(0.5) * ValueType(9.81);
     } else {
       branch += 0.75;
       ValueType uf_p = ValueType(9.81) * h_p * xdir;
       ValueType vf_p = ValueType(9.81) * h_p * ydir;
-      uflux_.data()[fid] = ValueType(-0.5) * uf_p;
-      vflux_.data()[fid] = ValueType(-0.5) * vf_p;
-      zflux_.data()[fid] = h_p * ValueType(0.5) * ValueType(9.81);
+      u_flux = ValueType(-0.5) * uf_p;
+      v_flux = ValueType(-0.5) * vf_p;
+      z_flux = h_p * ValueType(0.5) * ValueType(9.81);
     }
   } else if (y_m > zb_f) {
     branch = 3;
@@ -262,13 +297,13 @@ operator()(sycl::item<1> item) const
     ValueType vf_m = v_m * (ValueType(1.0 - 0.5 * ydir) * spd_m)
       + ValueType(9.81) * h_m * ydir;
     ValueType a = sycl::fabs(spd_m + sycl::sign(spd_m) * c_m);
-    hflux_.data()[fid] = ValueType(0.5) * hf_m -
+    h_flux = ValueType(0.5) * hf_m -
       ValueType(0.5) * a * (-h_m);
-    uflux_.data()[fid] = ValueType(0.5) * uf_m -
+    u_flux = ValueType(0.5) * uf_m -
       ValueType(0.5) * a * (-u_m);
-    vflux_.data()[fid] = ValueType(0.5) * vf_m -
+    v_flux = ValueType(0.5) * vf_m -
       ValueType(0.5) * a * (-v_m);
-    zflux_.data()[fid] = h_p / dx;
+    z_flux = h_p / dx;
   } else {
     branch = 4;
     // Water level above the face on the RHS but not on the left
@@ -279,17 +314,26 @@ operator()(sycl::item<1> item) const
     ValueType vf_p = v_p * (ValueType(1.0 - 0.5 * ydir) * spd_p)
       + ValueType(9.81) * h_p * ydir;      
     ValueType a = sycl::fabs(spd_p + sycl::sign(spd_p) * c_p);
-    hflux_.data()[fid] = ValueType(0.5) * hf_p -
+    h_flux = ValueType(0.5) * hf_p -
       ValueType(0.5) * a * (h_p);
-    uflux_.data()[fid] = ValueType(0.5) * uf_p -
+    u_flux = ValueType(0.5) * uf_p -
       ValueType(0.5) * a * (u_p);
-    vflux_.data()[fid] = ValueType(0.5) * vf_p -
+    v_flux = ValueType(0.5) * vf_p -
       ValueType(0.5) * a * (v_p);
-    zflux_.data()[fid] = h_m / dx;
+    z_flux = h_m / dx;
+  }
+
+  if constexpr (MeshType::has_face_normals) {
+    // Rotate the momentum fluxes back to the x and y axes
+    ValueType un_flux = u_flux;
+    u_flux = un_flux * nx - v_flux * ny;
+    v_flux = un_flux * ny + v_flux * nx;
   }
 
-#if MFCM_FLUX_BRANCH_OUTPUT
-  branchflux_.data()[fid] = ValueType(branch);
-#endif
+  hflux_.data()[fid] = h_flux;
+  uflux_.data()[fid] = u_flux;
+  vflux_.data()[fid] = v_flux;
+  zflux_.data()[fid] = z_flux;
+  branchflux_.set(fid, ValueType(branch));
   // zflux_.data()[fid] = ValueType(branch);
 }
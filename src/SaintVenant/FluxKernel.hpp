@@ -19,8 +19,22 @@
 #ifndef mfcm_SaintVenant_FluxKernel_hpp
 #define mfcm_SaintVenant_FluxKernel_hpp
 
+#include "SlopeReconstruction.hpp"
+
+/**
+   Kernel to calculate the fluxes at each face. If ReconstructSlopes
+   is true, the h, u and v slopes are recomputed from the state rather
+   than read from dUdx and dUdy (see cell_slope). If WriteDiagnostics
+   is true, the branch of the flux calculation taken at each face is
+   also written out. If UseSubgrid is true, the depths either side of each
+   face are taken from the sub-grid tables in the constants (see
+   SaintVenantSubgrid).
+ */
 template<typename T,
-	 typename Mesh>
+	 typename Mesh,
+	 bool ReconstructSlopes = false,
+	 bool WriteDiagnostics = false,
+	 bool UseSubgrid = false>
 class SaintVenantFluxKernel
 {
 public:
@@ -39,15 +53,22 @@ public:
     template Accessor<sycl::access::mode::write,
 		      sycl::access::target::global_buffer>;
 
+  using DiagnosticAccessor =
+    DiagnosticFieldAccessor<FaceField<ValueType,MeshType>, WriteDiagnostics>;
+
+  using SubgridAccessor = typename Constants::Subgrid::
+    template Accessor<UseSubgrid>;
+
+  using FaceBedAccessor = typename DataArray<typename Constants::FaceBedType>::
+    template Accessor<sycl::access::mode::read>;
+
 private:
 
   ReadAccessor h_;
   ReadAccessor u_;
   ReadAccessor v_;
 
-  ReadAccessor zb_;
-  ReadAccessor dzbdx_;
-  ReadAccessor dzbdy_;
+  FaceBedAccessor face_bed_;
 
   ReadAccessor dhdx_;
   ReadAccessor dudx_;
@@ -62,11 +83,11 @@ private:
   WriteAccessor vflux_;
   WriteAccessor zflux_;
 
-#if MFCM_FLUX_BRANCH_OUTPUT
-  WriteAccessor branchflux_;
-#endif
-  
+  DiagnosticAccessor branchflux_;
+
+  SubgridAccessor subgrid_;
   
+
 public:
 
   SaintVenantFluxKernel(sycl::handler& cgh,
@@ -75,15 +96,24 @@ public:
 			FaceField<ValueType,MeshType>& hflux,
 			FaceField<ValueType,MeshType>& uflux,
 			FaceField<ValueType,MeshType>& vflux,
-			FaceField<ValueType,MeshType>& zflux
-#if MFCM_FLUX_BRANCH_OUTPUT
-			, FaceField<ValueType,MeshType>& branchflux
-#endif
-			);
+			FaceField<ValueType,MeshType>& zflux,
+			FaceField<ValueType,MeshType>* branchflux);
 
   void zero_flux(const size_t& fid) const;
 
-  void operator()(sycl::item<1> item) const;
+  ValueType x_slope(const ReadAccessor& U, const ReadAccessor& dUdx,
+		    const size_t& i) const
+  {
+    return cell_slope<ReconstructSlopes,SpatialDerivativeAxis::X>(U, dUdx, i);
+  }
+
+  ValueType y_slope(const ReadAccessor& U, const ReadAccessor& dUdy,
+		    const size_t& i) const
+  {
+    return cell_slope<ReconstructSlopes,SpatialDerivativeAxis::Y>(U, dUdy, i);
+  }
+
+  void operator()(sycl::id<1> idx) const;
   
 };
 
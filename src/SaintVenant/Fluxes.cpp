@@ -18,6 +18,7 @@
 
 #include "Fluxes.hpp"
 #include "FluxKernel.hpp"
+#include "launch.hpp"
 
 template<typename T,
 	 typename Mesh>
@@ -35,31 +36,65 @@ SaintVenantFluxes(const std::shared_ptr<MeshType>& mesh,
        (mesh_->queue_ptr(), "v_flux", mesh_, 0.0f, on_device)),
     z_(Field<ValueType,MeshType,MeshComponent::Face>
        (mesh_->queue_ptr(), "z_flux", mesh_, 0.0f, on_device))
-#if MFCM_FLUX_BRANCH_OUTPUT
-  , branch_(Field<ValueType,MeshType,MeshComponent::Face>
-       (mesh_->queue_ptr(), "branch_flux", mesh_, 0.0f, on_device))
-#endif
-{}
+{
+  diagnostics_.declare("flux-branch", [=] () {
+    return std::make_shared<FieldType>(mesh_->queue_ptr(), "branch_flux",
+				       mesh_, 0.0f, on_device);
+  });
+}
 
 template<typename T,
 	 typename Mesh>
+template<bool ReconstructSlopes>
 void
 SaintVenantFluxes<T,Mesh>::
 update(const SaintVenantState<ValueType,MeshType>& U,
        const SaintVenantConstants<ValueType,MeshType>& constants,
        const SaintVenantState<ValueType,MeshType>& dUdx,
-       const SaintVenantState<ValueType,MeshType>& dUdy)
+       const SaintVenantState<ValueType,MeshType>& dUdy,
+       const LaunchConfiguration& lc)
+{
+  bool diagnostics = diagnostics_.get("flux-branch");
+  if (constants.subgrid()) {
+    if (diagnostics) {
+      this->template submit_update<ReconstructSlopes,true,true>(U, constants,
+								dUdx, dUdy, lc);
+    } else {
+      this->template submit_update<ReconstructSlopes,false,true>(U, constants,
+								 dUdx, dUdy, lc);
+    }
+  } else {
+    if (diagnostics) {
+      this->template submit_update<ReconstructSlopes,true,false>(U, constants,
+								 dUdx, dUdy, lc);
+    } else {
+      this->template submit_update<ReconstructSlopes,false,false>(U, constants,
+								  dUdx, dUdy, lc);
+    }
+  }
+}
+
+template<typename T,
+	 typename Mesh>
+template<bool ReconstructSlopes, bool WriteDiagnostics, bool UseSubgrid>
+void
+SaintVenantFluxes<T,Mesh>::
+submit_update(const SaintVenantState<ValueType,MeshType>& U,
+	      const SaintVenantConstants<ValueType,MeshType>& constants,
+	      const SaintVenantState<ValueType,MeshType>& dUdx,
+	      const SaintVenantState<ValueType,MeshType>& dUdy,
+	      const LaunchConfiguration& lc)
 {
-  using FluxKernel = SaintVenantFluxKernel<ValueType,MeshType>;
+  using FluxKernel = SaintVenantFluxKernel<ValueType,MeshType,
+					   ReconstructSlopes,
+					   WriteDiagnostics,
+					   UseSubgrid>;
     
   size_t nfaces = mesh_->template object_count<MeshComponent::Face>();
   mesh_->queue_ptr()->submit([&] (sycl::handler& cgh) {
     auto kernel = FluxKernel(cgh, U, constants, dUdx, dUdy,
-			     h_, u_, v_, z_
-#if MFCM_FLUX_BRANCH_OUTPUT
-			     , branch_
-#endif
-			     );
-    cgh.parallel_for(sycl::range<1>(nfaces), kernel);
+			     h_, u_, v_, z_,
+			     diagnostics_.get("flux-branch"));
+    launch_kernel(cgh, nfaces, kernel, lc);
   });
 }
@@ -19,10 +19,9 @@
 #ifndef mfcm_SaintVenant_Fluxes_hpp
 #define mfcm_SaintVenant_Fluxes_hpp
 
-#define MFCM_FLUX_BRANCH_OUTPUT 1
-
 #include "State.hpp"
 #include "Constants.hpp"
+#include "DiagnosticFields.hpp"
 
 template<typename T,
 	 typename Mesh>
@@ -45,9 +44,15 @@ private:
   FieldType v_;
   FieldType z_;
 
-#if MFCM_FLUX_BRANCH_OUTPUT
-  FieldType branch_;
-#endif
+  // Optional diagnostics ("flux-branch")
+  DiagnosticFields<FieldType> diagnostics_;
+
+  template<bool ReconstructSlopes, bool WriteDiagnostics, bool UseSubgrid>
+  void submit_update(const SaintVenantState<ValueType,MeshType>& U,
+		     const SaintVenantConstants<ValueType,MeshType>& constants,
+		     const SaintVenantState<ValueType,MeshType>& dUdx,
+		     const SaintVenantState<ValueType,MeshType>& dUdy,
+		     const LaunchConfiguration& lc);
   
 public:
 
@@ -66,10 +71,30 @@ public:
   const FieldType& v(void) const { return v_; }
   const FieldType& z(void) const { return z_; }
 
+  /**
+     Calculate the fluxes at every face. If ReconstructSlopes is true,
+     the slopes of h, u and v are recomputed from U inside the flux
+     kernel and dUdx and dUdy are not read. If the constants include
+     sub-grid tables the fluxes are calculated from them. The kernel
+     is launched with the launch configuration lc.
+   */
+  template<bool ReconstructSlopes = false>
   void update(const SaintVenantState<ValueType,MeshType>& U,
 	      const SaintVenantConstants<ValueType,MeshType>& constants,
 	      const SaintVenantState<ValueType,MeshType>& dUdx,
-	      const SaintVenantState<ValueType,MeshType>& dUdy);
+	      const SaintVenantState<ValueType,MeshType>& dUdy,
+	      const LaunchConfiguration& lc = LaunchConfiguration());
+
+  template<typename OutputFieldType>
+  void request_output_field(const std::string& name)
+  {
+  }
+
+  template<>
+  void request_output_field<FieldType>(const std::string& name)
+  {
+    diagnostics_.request(name);
+  }
 
   template<typename OutputFieldType>
   OutputFieldType* get_output_field_ptr(const std::string& name)
@@ -88,12 +113,8 @@ public:
       return &v_;
     } else if (name == "flux-z") {
       return &z_;
-#if MFCM_FLUX_BRANCH_OUTPUT
-    } else if (name == "flux-branch") {
-      return &branch_;
-#endif
     }
-    return nullptr;
+    return diagnostics_.get(name);
   }
   
 };
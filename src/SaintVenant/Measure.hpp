@@ -21,6 +21,9 @@
 
 #include "TimeSeries.hpp"
 #include "../Output/Measure.hpp"
+#include "MeshLocator.hpp"
+
+#include <limits>
 
 template<typename TT,
 	 typename T,
@@ -109,6 +112,18 @@ public:
     mesh_object_index_ = mesh->template get_nearest_object_index<FieldMappingType>(location);
   }
 
+  /**
+     Construct a measure of the object with the given id, which has
+     already been located.
+   */
+  SaintVenantPointMeasure(const std::shared_ptr<sycl::queue>& queue,
+			  const std::shared_ptr<TimeParameters<TimeType>>& tparams,
+			  const size_t& mesh_object_index,
+			  const Config& config)
+    : SaintVenantMeasure<TimeType,ValueType,MeshType>(queue, tparams, config),
+      mesh_object_index_(mesh_object_index)
+  {}
+
   virtual ~SaintVenantPointMeasure(void)
   {}
 
@@ -149,7 +164,7 @@ protected:
       
       cgh.parallel_for(val_acc.data().get_buffer().get_range(), val_reduction,
 		       [=](sycl::item<1> item, auto& val) {
-			 val.combine(val_acc.data()[item] * val_acc.mesh().cell_area());
+			 val.combine(val_acc.data()[item] * val_acc.mesh().cell_area(item.get_linear_id()));
 		       });
     });
     return val_buf.get_host_access()[0];
@@ -202,6 +217,16 @@ public:
 							   
   {}
 
+  SaintVenantHPointMeasure(const std::shared_ptr<sycl::queue>& queue,
+			   const std::shared_ptr<TimeParameters<TimeType>>& tparams,
+			   const size_t& mesh_object_index,
+			   const Config& config)
+    : SaintVenantPointMeasure<TimeType,ValueType,MeshType>(queue,
+							   tparams,
+							   mesh_object_index,
+							   config)
+  {}
+
   virtual ~SaintVenantHPointMeasure(void)
   {}
 
@@ -211,16 +236,45 @@ public:
     this->set_point(time_now, this->get_point_value(state.h()));
   }
 
+  /**
+     Create the h-point measures in the measure configuration. Only
+     measures located in the owned cells, the range [owned_cells[0],
+     owned_cells[1]), are created. If the mesh is one subdomain of a
+     larger mesh, measures outside it belong to another subdomain;
+     otherwise a measure outside the mesh is an error.
+   */
   static void create_measures(const std::shared_ptr<sycl::queue>& queue,
 			      const std::shared_ptr<TimeParameters<TimeType>>& tparams,
 			      const std::shared_ptr<MeshType>& mesh,
-			      std::vector<std::shared_ptr<SaintVenantMeasure<TimeType,ValueType,MeshType>>>& measures)
+			      std::vector<std::shared_ptr<SaintVenantMeasure<TimeType,ValueType,MeshType>>>& measures,
+			      const std::array<size_t,2>& owned_cells = { 0, std::numeric_limits<size_t>::max() })
   {
+    size_t count = mesh->template object_count<FieldMappingType>();
+    bool subdomain = (owned_cells[0] > 0 or owned_cells[1] < count);
     const Config& mconf = GlobalConfig::instance().measure_configuration();
     auto m_crange = mconf.equal_range("h-point");
+    // Locate all of the measures in one kernel
+    std::vector<std::array<double,2>> locations;
     for (auto it = m_crange.first; it != m_crange.second; ++it) {
+      locations.push_back(split_string<double,2>(it->second.template get<std::string>("location")));
+    }
+    std::vector<size_t> ids =
+      MeshLocator<MeshType,FieldMappingType>::locate(mesh, locations);
+    size_t n = 0;
+    for (auto it = m_crange.first; it != m_crange.second; ++it, ++n) {
+      if (subdomain) {
+	if (ids.at(n) < owned_cells[0] or ids.at(n) >= owned_cells[1]) {
+	  continue;
+	}
+      } else if (ids.at(n) >= count) {
+	std::cerr << "ERROR: The h-point measure at "
+		  << it->second.template get<std::string>("location")
+		  << " is outside the mesh." << std::endl;
+	throw std::runtime_error("Measure location outside mesh.");
+      }
       measures.push_back(std::make_shared<SaintVenantHPointMeasure<TT,T,Mesh>>(queue, tparams,
-									       mesh, it->second));
+									       ids.at(n),
+									       it->second));
     }
   }
   
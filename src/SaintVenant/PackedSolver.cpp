@@ -0,0 +1,398 @@
+/***********************************************************************
+ * mfcm SaintVenant/PackedSolver.cpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#include "PackedSolver.hpp"
+#include "Boundaries/PackedBoundarySourceTerm.hpp"
+
+#include "Measure.hpp"
+
+template<typename TT,
+	 typename T>
+SaintVenantPackedSolver<TT,T>::
+SaintVenantPackedSolver(const std::shared_ptr<sycl::queue>& queue,
+			size_t no_of_states,
+			const std::shared_ptr<TimeParameters<TT>>& tparams,
+			const std::vector<const Config*>& overrides)
+  : chunks_(queue, 0),
+    chunk_control_numbers_(queue, 0)
+{
+  initialize_(queue, no_of_states, tparams, overrides);
+}
+
+template<typename TT,
+	 typename T>
+SaintVenantPackedSolver<TT,T>::
+SaintVenantPackedSolver(const std::shared_ptr<sycl::queue>& queue,
+			size_t no_of_states,
+			const std::shared_ptr<TimeParameters<TT>>& tparams,
+			const std::vector<std::shared_ptr<GlobalConfig>>& models)
+  : block_configs_(models),
+    chunks_(queue, 0),
+    chunk_control_numbers_(queue, 0)
+{
+  initialize_(queue, no_of_states, tparams,
+	      std::vector<const Config*>(models.size(), nullptr));
+}
+
+template<typename TT,
+	 typename T>
+void
+SaintVenantPackedSolver<TT,T>::
+initialize_(const std::shared_ptr<sycl::queue>& queue,
+	    size_t no_of_states,
+	    const std::shared_ptr<TimeParameters<TT>>& tparams,
+	    const std::vector<const Config*>& overrides)
+{
+  size_t nblocks = overrides.size();
+  if (nblocks == 0) {
+    throw std::logic_error("A packed solver must have at least one block.");
+  }
+
+  // The runs of an ensemble share the mesh and the bed, and models
+  // each have their own
+  std::vector<std::shared_ptr<BlockMeshType>> block_meshes;
+  for (size_t b = 0; b < nblocks; ++b) {
+    if (b > 0 and block_configs_.empty()) {
+      block_meshes.push_back(block_meshes.front());
+      block_constants_.push_back(block_constants_.front());
+      continue;
+    }
+    activate_block_(b);
+    block_meshes.push_back(std::make_shared<BlockMeshType>(queue, true));
+    block_constants_.push_back(std::make_shared<BlockConstants>(block_meshes.back(), true));
+    if (block_constants_.back()->subgrid()) {
+      std::cerr << "ERROR: Runs with sub-grid bathymetry cannot be packed."
+		<< std::endl;
+      throw std::runtime_error("Sub-grid bathymetry cannot be packed.");
+    }
+  }
+  mesh_ = std::make_shared<MeshType>(queue, block_meshes, true);
+
+  std::vector<const CellField<ValueType,BlockMeshType>*> z_beds;
+  for (auto&& c : block_constants_) {
+    z_beds.push_back(&(c->z_bed()));
+  }
+  auto packed_constants =
+    std::make_shared<Constants>(mesh_, pack_fields_<MeshComponent::Cell>("z_bed", z_beds));
+
+  // The source terms and boundaries of each run, which must be of the
+  // same types in the same order
+  auto types = [] (const std::vector<std::reference_wrapper<Config>>& confs)
+  {
+    std::vector<std::string> t;
+    for (auto&& conf : confs) {
+      t.push_back(conf.get().get_value<std::string>());
+    }
+    return t;
+  };
+  std::vector<std::vector<std::reference_wrapper<Config>>> st_confs;
+  std::vector<std::vector<std::reference_wrapper<Config>>> b_confs;
+  for (size_t b = 0; b < nblocks; ++b) {
+    activate_block_(b);
+    st_confs.push_back(GlobalConfig::instance().source_term_configurations());
+    b_confs.push_back(GlobalConfig::instance().boundary_configurations());
+    if (types(st_confs.back()) != types(st_confs.front()) or
+	types(b_confs.back()) != types(b_confs.front())) {
+      std::cerr << "ERROR: The source terms and boundaries of run " << b
+		<< " are not of the types of those of run 0." << std::endl;
+      throw std::runtime_error("Runs cannot be packed.");
+    }
+  }
+
+  // Create the source terms of each run, and pack each in turn with
+  // those of the same position in the other runs
+  std::vector<std::shared_ptr<SourceTerm>> source_terms;
+  for (size_t k = 0; k < st_confs.front().size(); ++k) {
+    std::vector<CellField<ValueType,MeshType>> packed_fields;
+    std::vector<std::vector<CellField<ValueType,BlockMeshType>>> fields;
+    for (size_t b = 0; b < nblocks; ++b) {
+      activate_block_(b);
+      Config conf = PackedSolver::override_configuration(st_confs.at(b).at(k),
+							 "source term",
+							 overrides.at(b));
+      fields.push_back(BlockSourceTerm::create_source_term(conf, block_meshes.at(b))->parameter_fields());
+      if (fields.back().empty() or fields.back().size() != fields.front().size()) {
+	std::cerr << "ERROR: Source term " << std::quoted(conf.get_value<std::string>())
+		  << " cannot be packed with those of other runs." << std::endl;
+	throw std::runtime_error("Source term cannot be packed.");
+      }
+    }
+    for (size_t i = 0; i < fields.front().size(); ++i) {
+      std::vector<const CellField<ValueType,BlockMeshType>*> block_fields;
+      for (auto&& f : fields) {
+	block_fields.push_back(&(f.at(i)));
+      }
+      packed_fields.push_back(pack_fields_<MeshComponent::Cell>(fields.front().at(i).name(),
+								block_fields));
+    }
+    activate_block_(0);
+    Config conf = PackedSolver::override_configuration(st_confs.front().at(k),
+						       "source term",
+						       overrides.front());
+    source_terms.push_back(SourceTerm::create_packed_source_term(conf, mesh_,
+								 packed_fields));
+  }
+
+  // Likewise the boundaries, which keep those of the runs to update
+  // their values at each step
+  using BlockBoundary = BoundarySourceTerm<TT,T,BlockMeshType>;
+  std::vector<std::shared_ptr<SourceTerm>> boundaries;
+  for (size_t k = 0; k < b_confs.front().size(); ++k) {
+    std::vector<std::shared_ptr<BlockBoundary>> block_boundaries;
+    for (size_t b = 0; b < nblocks; ++b) {
+      activate_block_(b);
+      Config conf = PackedSolver::override_configuration(b_confs.at(b).at(k),
+							 "boundary",
+							 overrides.at(b));
+      block_boundaries.push_back(std::dynamic_pointer_cast<BlockBoundary>
+				 (BlockBoundary::create_boundary(conf, block_meshes.at(b))));
+    }
+    boundaries.push_back(create_packed_boundary<TT,T>(b_confs.front().at(k), mesh_,
+						      block_boundaries,
+						      block_constants_,
+						      block_configs_));
+  }
+
+  activate_block_(0);
+  solver_ = std::make_shared<PackedSolver>(mesh_, no_of_states, tparams,
+					   packed_constants, source_terms,
+					   boundaries);
+
+  // The initial states, which each run keeps only if it reports
+  // measures. Those of an ensemble are the same.
+  std::vector<std::shared_ptr<BlockState>> states;
+  for (size_t b = 0; b < nblocks; ++b) {
+    if (b > 0 and block_configs_.empty()) {
+      states.push_back(states.front());
+      continue;
+    }
+    activate_block_(b);
+    states.push_back(std::make_shared<BlockState>(block_meshes.at(b)));
+  }
+  std::vector<const CellField<ValueType,BlockMeshType>*> h, u, v;
+  for (auto&& s : states) {
+    h.push_back(&(s->h()));
+    u.push_back(&(s->u()));
+    v.push_back(&(s->v()));
+  }
+  solver_->state().h() = pack_fields_<MeshComponent::Cell>("h", h);
+  solver_->state().u() = pack_fields_<MeshComponent::Cell>("u", u);
+  solver_->state().v() = pack_fields_<MeshComponent::Cell>("v", v);
+
+  // Each model reports its measures, and an ensemble those of its
+  // first run
+  block_states_.resize(nblocks);
+  block_measures_.resize(nblocks);
+  for (size_t b = 0; b < nblocks; ++b) {
+    if (b > 0 and block_configs_.empty()) {
+      break;
+    }
+    activate_block_(b);
+    SaintVenantHPointMeasure<TT,T,BlockMeshType>::create_measures(queue, tparams,
+								   block_meshes.at(b),
+								   block_measures_.at(b));
+    if (not block_measures_.at(b).empty()) {
+      block_states_.at(b) = states.at(b);
+    }
+  }
+
+  cell_output_fields_.resize(nblocks);
+  face_output_fields_.resize(nblocks);
+  vertex_output_fields_.resize(nblocks);
+
+  clocks_.assign(2 * nblocks, 0.0);
+  initialize_chunks_();
+}
+
+template<typename TT,
+	 typename T>
+void
+SaintVenantPackedSolver<TT,T>::initialize_chunks_(void)
+{
+  // Each work item finds the largest control number of up to
+  // chunk_size cells of one block, so that the largest of each block
+  // can be found on the host from few values
+  const size_t chunk_size = 256;
+  std::vector<size_t>& chunks = chunks_.host_vector();
+  chunks.clear();
+  chunk_blocks_.clear();
+  for (size_t b = 0; b < block_count(); ++b) {
+    size_t end = mesh_->template block_offset<MeshComponent::Cell>(b + 1);
+    for (size_t i = mesh_->template block_offset<MeshComponent::Cell>(b);
+	 i < end; i += chunk_size) {
+      chunks.push_back(i);
+      chunks.push_back(std::min(i + chunk_size, end));
+      chunk_blocks_.push_back(b);
+    }
+  }
+  chunks_.move_to_device();
+  chunk_control_numbers_.host_vector().assign(chunk_blocks_.size(), ValueType(0.0));
+  chunk_control_numbers_.move_to_device();
+}
+
+template<typename TT,
+	 typename T>
+template<MeshComponent C>
+Field<T,MultiCartesian2DMesh,C>
+SaintVenantPackedSolver<TT,T>::
+pack_fields_(const std::string& name,
+	     const std::vector<const Field<ValueType,BlockMeshType,C>*>& fields) const
+{
+  Field<ValueType,MeshType,C> packed(mesh_->queue_ptr(), name, mesh_,
+				     ValueType(0.0), true);
+  for (size_t b = 0; b < fields.size(); ++b) {
+    packed.data().copy_range(mesh_->template block_offset<C>(b),
+			     fields.at(b)->size(), fields.at(b)->data(), 0);
+  }
+  return packed;
+}
+
+template<typename TT,
+	 typename T>
+template<MeshComponent C>
+void
+SaintVenantPackedSolver<TT,T>::
+unpack_field_(const size_t& b,
+	      const Field<ValueType,MeshType,C>& field,
+	      Field<ValueType,BlockMeshType,C>& block_field) const
+{
+  block_field.data().copy_range(0, block_field.size(), field.data(),
+				mesh_->template block_offset<C>(b));
+}
+
+template<typename TT,
+	 typename T>
+void
+SaintVenantPackedSolver<TT,T>::end_of_step(const TT& time_now)
+{
+  solver_->end_of_step(time_now);
+  for (size_t b = 0; b < block_count(); ++b) {
+    if (block_measures_.at(b).empty()) {
+      continue;
+    }
+    activate_block_(b);
+    BlockState& state = *(block_states_.at(b));
+    unpack_field_(b, solver_->state().h(), state.h());
+    unpack_field_(b, solver_->state().u(), state.u());
+    unpack_field_(b, solver_->state().v(), state.v());
+    for (auto&& measure : block_measures_.at(b)) {
+      measure->update(time_now, state);
+    }
+  }
+}
+
+template<typename TT,
+	 typename T>
+void
+SaintVenantPackedSolver<TT,T>::update_dUdt(const size_t& state_no,
+					   const TT& time_now,
+					   const TT& timestep)
+{
+  // The kernels take the time and timestep of each cell from the
+  // clock of its block (see MultiCartesian2DMeshAccessor::block_clock)
+  solver_->update_dUdt(state_no, time_now, TT(1.0));
+
+  // Scale the derivative by the timestep of each block. A block that
+  // is not advanced has a zero timestep, and the kernels may have
+  // divided by it.
+  State& dUdt = solver_->dUdt(state_no);
+  size_t ncells = mesh_->template object_count<MeshComponent::Cell>();
+  mesh_->queue_ptr()->submit([&] (sycl::handler& cgh) {
+    using Accessor = typename CellField<ValueType,MeshType>::
+      template Accessor<sycl::access::mode::read_write>;
+    Accessor h_acc(dUdt.h(), cgh);
+    Accessor u_acc(dUdt.u(), cgh);
+    Accessor v_acc(dUdt.v(), cgh);
+    launch_kernel(cgh, ncells, [=](sycl::id<1> idx) {
+      size_t i = idx[0];
+      ValueType w = h_acc.mesh().block_clock(i, 0.0).timestep;
+      bool advanced = (w > ValueType(0.0));
+      h_acc.data()[i] = advanced ? h_acc.data()[i] * w : ValueType(0.0);
+      u_acc.data()[i] = advanced ? u_acc.data()[i] * w : ValueType(0.0);
+      v_acc.data()[i] = advanced ? v_acc.data()[i] * w : ValueType(0.0);
+    });
+  });
+}
+
+template<typename TT,
+	 typename T>
+std::vector<T>
+SaintVenantPackedSolver<TT,T>::block_control_numbers(const size_t& state_no)
+{
+  const State& U = solver_->state(state_no);
+  size_t nchunks = chunk_blocks_.size();
+  mesh_->queue_ptr()->submit([&] (sycl::handler& cgh) {
+    using Accessor = typename CellField<ValueType,MeshType>::
+      template Accessor<sycl::access::mode::read>;
+    Accessor h_acc(U.h(), cgh);
+    Accessor u_acc(U.u(), cgh);
+    Accessor v_acc(U.v(), cgh);
+    auto chunks_acc = chunks_.get_read_accessor(cgh);
+    auto cn_acc = chunk_control_numbers_.get_discard_write_accessor(cgh);
+    launch_kernel(cgh, nchunks, [=](sycl::id<1> idx) {
+      size_t k = idx[0];
+      ValueType max_cn = ValueType(0.0);
+      for (size_t i = chunks_acc[2 * k]; i < chunks_acc[2 * k + 1]; ++i) {
+	ValueType h = sycl::fmax(h_acc.data()[i], ValueType(0.0));
+	ValueType u = sycl::fabs(u_acc.data()[i]);
+	ValueType v = sycl::fabs(v_acc.data()[i]);
+	ValueType c = sycl::sqrt(ValueType(9.81) * h);
+	ValueType dx = h_acc.mesh().dx(i);
+	ValueType dy = h_acc.mesh().dy(i);
+	max_cn = sycl::fmax(max_cn, ((u+c)/dx) + ((v+c)/dy));
+      }
+      cn_acc[k] = max_cn;
+    });
+  });
+
+  std::vector<ValueType> chunk_cn(nchunks);
+  chunk_control_numbers_.read_range(0, nchunks, chunk_cn.data());
+  std::vector<ValueType> cn(block_count(), ValueType(0.0));
+  for (size_t k = 0; k < nchunks; ++k) {
+    size_t b = chunk_blocks_.at(k);
+    cn.at(b) = std::max(cn.at(b), chunk_cn.at(k));
+  }
+  for (size_t b = 0; b < block_count(); ++b) {
+    cn.at(b) *= clocks_.at(2 * b + 1);
+  }
+  return cn;
+}
+
+template<typename TT,
+	 typename T>
+void
+SaintVenantPackedSolver<TT,T>::accept_blocks(const size_t& state_no,
+					     const std::vector<bool>& accepted)
+{
+  State& U = solver_->state();
+  const State& UN = solver_->state(state_no);
+  if (std::find(accepted.begin(), accepted.end(), false) == accepted.end()) {
+    U = UN;
+    return;
+  }
+  for (size_t b = 0; b < block_count(); ++b) {
+    if (not accepted.at(b)) {
+      continue;
+    }
+    size_t offset = mesh_->template block_offset<MeshComponent::Cell>(b);
+    size_t count = mesh_->template block_offset<MeshComponent::Cell>(b + 1) - offset;
+    U.h().data().copy_range(offset, count, UN.h().data(), offset);
+    U.u().data().copy_range(offset, count, UN.u().data(), offset);
+    U.v().data().copy_range(offset, count, UN.v().data(), offset);
+  }
+}
@@ -0,0 +1,370 @@
+/***********************************************************************
+ * mfcm SaintVenant/PackedSolver.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_SaintVenant_PackedSolver_hpp
+#define mfcm_SaintVenant_PackedSolver_hpp
+
+#include "Solver.hpp"
+#include "Cartesian2DMesh.hpp"
+#include "MultiCartesian2DMesh.hpp"
+
+#include <map>
+
+/**
+   A solver for several runs of the Saint Venant equations, each on a
+   Cartesian mesh of its own, packed into one SaintVenantSolver on a
+   MultiCartesian2DMesh whose blocks are those meshes.
+
+   The runs are either those of an ensemble, which share the mesh and
+   the bed of the configuration, or independent models, each read
+   into a configuration of its own, whose meshes may differ in size.
+
+   The states, the bed and the parameter fields of the source terms
+   and boundaries of the runs are concatenated in the order of the
+   blocks, so that each kernel is launched once over every run. The
+   source terms must be of the same types in the same order in each
+   run, and be able to give their parameters as fields (see
+   SaintVenantSourceTerm::parameter_fields); likewise the boundaries.
+
+   Each block has a timestep of its own. A temporal scheme sets the
+   start time and the timestep of each block within the step with
+   set_block_clocks, and then passes the fraction of the timestep of
+   each stage to update_dUdt, which returns the temporal derivatives
+   multiplied by the timestep of the block. A block whose timestep is
+   zero is not advanced. block_control_numbers and accept_blocks then
+   let each block accept or repeat its timestep.
+
+   Outputs are those of each block, on its own mesh, and so are the
+   measures of each model; those of an ensemble are of its first run.
+ */
+template<typename TT,
+	 typename T>
+class SaintVenantPackedSolver
+{
+public:
+
+  using TimeType = TT;
+  using ValueType = T;
+  using MeshType = MultiCartesian2DMesh;
+  using BlockMeshType = Cartesian2DMesh;
+
+  using PackedSolver = SaintVenantSolver<TimeType,ValueType,MeshType>;
+  using Constants = SaintVenantConstants<ValueType,MeshType>;
+  using State = SaintVenantState<ValueType,MeshType>;
+  using SourceTerm = SaintVenantSourceTerm<TimeType,ValueType,MeshType>;
+
+  using BlockConstants = SaintVenantConstants<ValueType,BlockMeshType>;
+  using BlockState = SaintVenantState<ValueType,BlockMeshType>;
+  using BlockSourceTerm = SaintVenantSourceTerm<TimeType,ValueType,BlockMeshType>;
+  using BlockMeasure = SaintVenantMeasure<TimeType,ValueType,BlockMeshType>;
+
+  template<MeshComponent C>
+  using BlockFieldMap = std::map<std::string,
+				 std::shared_ptr<Field<ValueType,BlockMeshType,C>>>;
+
+private:
+
+  std::shared_ptr<MeshType> mesh_;
+
+  // The configuration of the model of each block, or none if the
+  // blocks share the instance
+  std::vector<std::shared_ptr<GlobalConfig>> block_configs_;
+
+  std::vector<std::shared_ptr<BlockConstants>> block_constants_;
+
+  std::shared_ptr<PackedSolver> solver_;
+
+  // The start time and timestep of each block (see set_block_clocks)
+  std::vector<double> clocks_;
+
+  // The states and measures of the blocks that report measures
+  std::vector<std::shared_ptr<BlockState>> block_states_;
+  std::vector<std::vector<std::shared_ptr<BlockMeasure>>> block_measures_;
+
+  // The control numbers are found in chunks of cells of one block,
+  // given by their first and one-past-last cells
+  std::vector<size_t> chunk_blocks_;
+  DataArray<size_t> chunks_;
+  DataArray<ValueType> chunk_control_numbers_;
+
+  // Output fields of each block, copied from those of the packed
+  // solver
+  std::vector<BlockFieldMap<MeshComponent::Cell>> cell_output_fields_;
+  std::vector<BlockFieldMap<MeshComponent::Face>> face_output_fields_;
+  std::vector<BlockFieldMap<MeshComponent::Vertex>> vertex_output_fields_;
+
+  template<MeshComponent C>
+  BlockFieldMap<C>& output_fields(const size_t& b)
+  {
+    if constexpr (C == MeshComponent::Cell) {
+      return cell_output_fields_.at(b);
+    } else if constexpr (C == MeshComponent::Face) {
+      return face_output_fields_.at(b);
+    } else {
+      return vertex_output_fields_.at(b);
+    }
+  }
+
+  /**
+     Concatenate fields on the meshes of the blocks into a field on
+     the multi-block mesh.
+   */
+  template<MeshComponent C>
+  Field<ValueType,MeshType,C>
+  pack_fields_(const std::string& name,
+	       const std::vector<const Field<ValueType,BlockMeshType,C>*>& fields) const;
+
+  /**
+     Copy the part of a field on the multi-block mesh that covers
+     block b into a field on the mesh of the block.
+   */
+  template<MeshComponent C>
+  void unpack_field_(const size_t& b,
+		     const Field<ValueType,MeshType,C>& field,
+		     Field<ValueType,BlockMeshType,C>& block_field) const;
+
+  /**
+     Make the configuration of the model of block b the instance, if
+     the blocks have their own.
+   */
+  void activate_block_(const size_t& b) const
+  {
+    if (not block_configs_.empty()) {
+      GlobalConfig::activate(block_configs_.at(b));
+    }
+  }
+
+  void initialize_(const std::shared_ptr<sycl::queue>& queue,
+		   size_t no_of_states,
+		   const std::shared_ptr<TimeParameters<TimeType>>& tparams,
+		   const std::vector<const Config*>& overrides);
+
+  void initialize_chunks_(void);
+
+public:
+
+  /**
+     Constructor. Create a solver for runs of the Saint Venant
+     equations with the configuration of the instance, one on each
+     block of the mesh.
+
+     @param queue Pointer to SYCL queue object to be used for the
+     solution.
+     @param no_of_states Number of intermediate states that the
+     program must store.
+     @param tparams Pointer to the time parameters of the scheme.
+     @param overrides For each run, configuration sections that
+     override those of the source terms and boundaries with the same
+     type, or null (see SaintVenantSolver::override_configuration).
+     The runs share the mesh and the bed. Only the first run reports
+     measures.
+  */
+  SaintVenantPackedSolver(const std::shared_ptr<sycl::queue>& queue,
+			  size_t no_of_states,
+			  const std::shared_ptr<TimeParameters<TimeType>>& tparams,
+			  const std::vector<const Config*>& overrides);
+
+  /**
+     Constructor. Create a solver for models of the Saint Venant
+     equations, one on each block of the mesh, each with the mesh, the
+     bed, the source terms, the boundaries, the initial state and the
+     measures of its configuration.
+
+     @param queue Pointer to SYCL queue object to be used for the
+     solution.
+     @param no_of_states Number of intermediate states that the
+     program must store.
+     @param tparams Pointer to the time parameters of the scheme,
+     which the models share.
+     @param models The configuration of each model (see
+     GlobalConfig::current), which the solver makes the instance
+     whenever it works on that model alone.
+  */
+  SaintVenantPackedSolver(const std::shared_ptr<sycl::queue>& queue,
+			  size_t no_of_states,
+			  const std::shared_ptr<TimeParameters<TimeType>>& tparams,
+			  const std::vector<std::shared_ptr<GlobalConfig>>& models);
+
+  const std::shared_ptr<sycl::queue>& queue(void)
+  {
+    return mesh_->queue_ptr();
+  }
+
+  const std::shared_ptr<MeshType>& mesh(void) const
+  {
+    return mesh_;
+  }
+
+  size_t block_count(void) const
+  {
+    return mesh_->block_count();
+  }
+
+  const std::shared_ptr<BlockMeshType>& block_mesh(const size_t& b) const
+  {
+    return mesh_->block(b);
+  }
+
+  /**
+     Set the start time, relative to the start of the step, and the
+     timestep of each block, as pairs.
+   */
+  void set_block_clocks(const std::vector<double>& clocks)
+  {
+    mesh_->set_block_clocks(clocks);
+    clocks_ = clocks;
+  }
+
+  void end_of_step(const TimeType& time_now);
+
+  /**
+     Update the temporal derivative of state state_no, multiplied by
+     the timestep of each block.
+
+     @param time_now The fraction of the timestep of each block at
+     which the derivative is taken.
+   */
+  void update_dUdt(const size_t& state_no,
+		   const TimeType& time_now,
+		   const TimeType& timestep);
+
+  void start_new_step(const TimeType& time_now,
+		      const std::shared_ptr<TimeParameters<TimeType>>& tp_ptr)
+  {
+    solver_->start_new_step(time_now, tp_ptr);
+  }
+
+  State& state(const size_t& i = 0)
+  {
+    return solver_->state(i);
+  }
+
+  State& dUdt(const size_t& i)
+  {
+    return solver_->dUdt(i);
+  }
+
+  /**
+     Returns the control number of state state_no in each block, with
+     the timestep of the block.
+   */
+  std::vector<ValueType> block_control_numbers(const size_t& state_no);
+
+  /**
+     Returns the largest control number of state state_no in any
+     block, with the timestep of the block.
+   */
+  ValueType control_number(const size_t& state_no,
+			   const TimeType& timestep)
+  {
+    std::vector<ValueType> cn = block_control_numbers(state_no);
+    return *std::max_element(cn.begin(), cn.end());
+  }
+
+  /**
+     Copy state state_no to state 0 in the blocks whose timestep is
+     accepted.
+   */
+  void accept_blocks(const size_t& state_no,
+		     const std::vector<bool>& accepted);
+
+  /**
+     Register interest in an output field of the blocks.
+   */
+  template<MeshComponent C>
+  bool request_output_field(const std::string& name)
+  {
+    return solver_->template request_output_field<C>(name);
+  }
+
+  /**
+     Get an output field of block b on the mesh of the block. The
+     field is copied from the packed solver at each call.
+   */
+  template<MeshComponent C>
+  Field<ValueType,BlockMeshType,C>* get_block_output_field_ptr(const size_t& b,
+							       const std::string& name)
+  {
+    Field<ValueType,MeshType,C>* ptr =
+      solver_->template get_output_field_ptr<C>(name);
+    if (not ptr) {
+      return nullptr;
+    }
+
+    auto& field = output_fields<C>(b)[name];
+    if (not field) {
+      field = std::make_shared<Field<ValueType,BlockMeshType,C>>
+	(mesh_->queue_ptr(), ptr->name(), mesh_->block(b), ValueType(0.0), true);
+    }
+    unpack_field_(b, *ptr, *field);
+    return field.get();
+  }
+
+};
+
+/**
+   The run on one block of a SaintVenantPackedSolver, seen as a solver
+   on the mesh of the block, so that output files (see
+   make_field_output_file) can be made for each run.
+ */
+template<typename TT,
+	 typename T>
+class SaintVenantPackedBlock
+{
+public:
+
+  using TimeType = TT;
+  using ValueType = T;
+  using MeshType = Cartesian2DMesh;
+
+  using PackedSolver = SaintVenantPackedSolver<TimeType,ValueType>;
+
+private:
+
+  std::shared_ptr<PackedSolver> solver_;
+
+  size_t block_;
+
+public:
+
+  SaintVenantPackedBlock(const std::shared_ptr<PackedSolver>& solver,
+			 const size_t& block)
+    : solver_(solver),
+      block_(block)
+  {}
+
+  const std::shared_ptr<MeshType>& mesh(void) const
+  {
+    return solver_->block_mesh(block_);
+  }
+
+  template<MeshComponent C>
+  bool request_output_field(const std::string& name)
+  {
+    return solver_->template request_output_field<C>(name);
+  }
+
+  template<MeshComponent C>
+  Field<ValueType,MeshType,C>* get_output_field_ptr(const std::string& name)
+  {
+    return solver_->template get_block_output_field_ptr<C>(block_, name);
+  }
+
+};
+
+#endif
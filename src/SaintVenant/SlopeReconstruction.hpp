@@ -0,0 +1,54 @@
+/***********************************************************************
+ * mfcm SaintVenant/SlopeReconstruction.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_SaintVenant_SlopeReconstruction_hpp
+#define mfcm_SaintVenant_SlopeReconstruction_hpp
+
+#include "SpatialDerivative.hpp"
+#include "Minmod3.hpp"
+
+/**
+   Return the limited slope of a cell-centred variable at cell i along
+   the given axis.
+
+   If ReconstructSlopes is false the slope is read from the stored
+   derivative field dUd (as written by
+   SaintVenantState::calculate_spatial_derivatives). Otherwise it is
+   recomputed from U using the same Minmod3 stencil and dUd is not
+   read at all.
+ */
+template<bool ReconstructSlopes,
+	 SpatialDerivativeAxis Axis,
+	 typename CellAccessor>
+inline typename CellAccessor::ValueType
+cell_slope(const CellAccessor& U, const CellAccessor& dUd, const size_t& i)
+{
+  using ValueType = typename CellAccessor::ValueType;
+  using MeshType = typename CellAccessor::MeshType;
+  using SlopeOperator = SpatialDerivativeOperator<ValueType,
+						  MeshType,
+						  MeshComponent::Cell,
+						  Minmod3<ValueType>>;
+  if constexpr (ReconstructSlopes) {
+    return SlopeOperator::template stencil<Axis>(U, i);
+  } else {
+    return dUd.data()[i];
+  }
+}
+
+#endif
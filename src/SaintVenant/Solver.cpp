@@ -26,8 +26,10 @@
 #include "Boundaries/StageBoundarySourceTerm.hpp"
 
 #include "Measure.hpp"
+#include "Cartesian2DMesh.hpp"
 
 #include "Output/OutputFile.hpp"
+#include "LaunchTuner.hpp"
 
 template<typename TT,
 	 typename T,
@@ -36,15 +38,95 @@ SaintVenantSolver<TT,T,Mesh>::
 SaintVenantSolver(const std::shared_ptr<sycl::queue>& queue,
 		  size_t no_of_states,
 		  const std::shared_ptr<TimeParameters<TT>>& tparams)
+  : SaintVenantSolver(std::make_shared<MeshType>(queue, true),
+		      no_of_states, tparams)
+{
+}
+
+template<typename TT,
+	 typename T,
+	 typename Mesh>
+SaintVenantSolver<TT,T,Mesh>::
+SaintVenantSolver(const std::shared_ptr<MeshType>& mesh,
+		  size_t no_of_states,
+		  const std::shared_ptr<TimeParameters<TT>>& tparams,
+		  const std::array<size_t,2>& owned_cells,
+		  const std::shared_ptr<Constants>& constants,
+		  const Config* overrides,
+		  bool report_measures)
   : time_params_(tparams),
-    mesh_(std::make_shared<MeshType>(queue, true)),
-    constants_(std::make_shared<Constants>(mesh_, true)),
+    mesh_(mesh),
+    owned_cells_(owned_cells),
+    constants_(constants ? constants : std::make_shared<Constants>(mesh_, true)),
     stage_(mesh_->queue_ptr(), "stage", mesh_, 0.0f, true)
 {
+  for (auto&& st_conf : GlobalConfig::instance().source_term_configurations()) {
+    Config conf = override_configuration(st_conf, "source term", overrides);
+    source_terms_.push_back(SaintVenantSourceTerm<TT,T,Mesh>::create_source_term(conf, mesh_));
+  }
+
+  for (auto&& b_conf : GlobalConfig::instance().boundary_configurations()) {
+    Config conf = override_configuration(b_conf, "boundary", overrides);
+    boundaries_.push_back(BoundarySourceTerm<TT,T,Mesh>::create_boundary(conf, mesh_,
+									       owned_cells));
+  }
+
+  // Create the measures
+  if (report_measures) {
+    SaintVenantHPointMeasure<TT,T,Mesh>::create_measures(mesh_->queue_ptr(), time_params_,
+							  mesh_, measures_, owned_cells);
+  }
+
+  initialize_(no_of_states);
+}
+
+template<typename TT,
+	 typename T,
+	 typename Mesh>
+SaintVenantSolver<TT,T,Mesh>::
+SaintVenantSolver(const std::shared_ptr<MeshType>& mesh,
+		  size_t no_of_states,
+		  const std::shared_ptr<TimeParameters<TT>>& tparams,
+		  const std::shared_ptr<Constants>& constants,
+		  const std::vector<std::shared_ptr<SourceTerm>>& source_terms,
+		  const std::vector<std::shared_ptr<SourceTerm>>& boundaries)
+  : time_params_(tparams),
+    mesh_(mesh),
+    owned_cells_({ 0, std::numeric_limits<size_t>::max() }),
+    constants_(constants),
+    source_terms_(source_terms),
+    boundaries_(boundaries),
+    stage_(mesh_->queue_ptr(), "stage", mesh_, 0.0f, true)
+{
+  initialize_(no_of_states);
+}
+
+template<typename TT,
+	 typename T,
+	 typename Mesh>
+void
+SaintVenantSolver<TT,T,Mesh>::initialize_(size_t no_of_states)
+{
+  const Config& scheme_conf = GlobalConfig::instance().scheme_configuration();
+  // Reconstructing the slopes on the fly saves the six derivative
+  // fields, but evaluates the stencil twelve times for each face
+  // rather than six times for each cell. It trades memory for
+  // arithmetic, so slopes are stored unless asked otherwise.
+  std::string slope_str = scheme_conf.get<std::string>("slope reconstruction",
+							"stored");
+  if (slope_str == "stored") {
+    reconstruct_slopes_ = false;
+  } else if (slope_str == "on the fly") {
+    reconstruct_slopes_ = true;
+  } else {
+    std::cerr << "ERROR: Unknown slope reconstruction: "
+	      << std::quoted(slope_str) << std::endl;
+    throw std::runtime_error("Unknown slope reconstruction.");
+  }
+
   U_.push_back(std::make_shared<State>(mesh_));
   dUdt_.push_back(std::make_shared<State>(0.0, mesh_, "d", "⁄dt"));
   for (size_t i = 1; i < no_of_states; ++i) {
-    const State& U0 = *(U_.at(0));
     U_.push_back(std::make_shared<State>(0.0, mesh_, "", std::to_string(i)));
     dUdt_.push_back(std::make_shared<State>(0.0, mesh_, "", std::to_string(i)));
   }
@@ -54,20 +136,125 @@ SaintVenantSolver(const std::shared_ptr<sycl::queue>& queue,
     cf.output({ &(U_[0]->h()), &(U_[0]->u()), &(U_[0]->v()) });
   */
   
-  dUdx_ = std::make_shared<State>(0.0, mesh_, "d", "⁄dx");
-  dUdy_ = std::make_shared<State>(0.0, mesh_, "d", "⁄dy");
   fluxes_ = std::make_shared<Fluxes>(mesh_, "", "flux");
 
-  for (auto&& st_conf : GlobalConfig::instance().source_term_configurations()) {
-    source_terms_.push_back(SaintVenantSourceTerm<TT,T,Mesh>::create_source_term(st_conf, mesh_));
+  for (auto&& st : source_terms_) {
+    if (reconstruct_slopes_ and st->requires_spatial_derivatives()) {
+      std::cout << "A source term requires stored slopes: slopes will not be "
+		<< "reconstructed on the fly." << std::endl;
+      reconstruct_slopes_ = false;
+    }
   }
 
-  for (auto&& b_conf : GlobalConfig::instance().boundary_configurations()) {
-    boundaries_.push_back(BoundarySourceTerm<TT,T,Mesh>::create_boundary(b_conf, mesh_));
+  if (not reconstruct_slopes_) {
+    dUdx_ = std::make_shared<State>(0.0, mesh_, "d", "⁄dx");
+    dUdy_ = std::make_shared<State>(0.0, mesh_, "d", "⁄dy");
   }
 
-  // Create the measures
-  SaintVenantHPointMeasure<TT,T,Mesh>::create_measures(queue, time_params_, mesh_, measures_);
+  // Kernels launch as the engine of the device configuration asks
+  // unless tuning finds better
+  kernel_launch_ = default_launch_configuration();
+  flux_launch_ = kernel_launch_;
+  derivative_launch_ = kernel_launch_;
+  temporal_derivative_launch_ = kernel_launch_;
+  for (auto&& st : source_terms_) {
+    st->set_launch_configuration(kernel_launch_);
+  }
+  for (auto&& bdy : boundaries_) {
+    bdy->set_launch_configuration(kernel_launch_);
+  }
+
+  tune_launch_configurations();
+}
+
+template<typename TT,
+	 typename T,
+	 typename Mesh>
+void
+SaintVenantSolver<TT,T,Mesh>::tune_launch_configurations(void)
+{
+  // Time the kernels on the initial state. None of them writes to it,
+  // only to the fluxes and derivatives that each stage recalculates.
+  size_t tile = 0;
+  if constexpr (std::is_same_v<MeshType, TiledCartesian2DMesh>) {
+    tile = mesh_->tile_cell_count();
+  }
+  LaunchTuner tuner(mesh_->queue_ptr(),
+		    mesh_->template object_count<MeshComponent::Cell>(),
+		    reconstruct_slopes_ ? "reconstructed slopes" : "stored slopes",
+		    tile);
+  State& U = *(U_.at(0));
+  // The temporal derivative kernel reads the fluxes, which are
+  // calculated in tuning the flux kernel
+  if (reconstruct_slopes_) {
+    tuner.tune(KernelKind::Flux, flux_launch_, [&] () {
+      fluxes_->template update<true>(U, *constants_, U, U, flux_launch_);
+    });
+    tuner.tune(KernelKind::TemporalDerivative, temporal_derivative_launch_,
+	       [&] () {
+		 this->template update_temporal_derivative<true>(0, 0.0, 1.0);
+	       });
+  } else {
+    tuner.tune(KernelKind::Derivative, derivative_launch_, [&] () {
+      U.calculate_spatial_derivatives(*dUdx_, *dUdy_, derivative_launch_);
+    });
+    tuner.tune(KernelKind::Flux, flux_launch_, [&] () {
+      fluxes_->template update<false>(U, *constants_, *dUdx_, *dUdy_,
+				      flux_launch_);
+    });
+    tuner.tune(KernelKind::TemporalDerivative, temporal_derivative_launch_,
+	       [&] () {
+		 this->template update_temporal_derivative<false>(0, 0.0, 1.0);
+	       });
+  }
+  tuner.tune(KernelKind::Reduction, reduction_launch_, [&] () {
+    U.max_control_number(1.0, reduction_launch_);
+  });
+}
+
+/**
+   Merge the entries of an overriding configuration section into a
+   configuration. Sections present in both are merged in turn, and
+   other entries replace those with the same key.
+ */
+inline void merge_configuration(Config& conf, const Config& overrides)
+{
+  for (auto&& kv : overrides) {
+    boost::optional<Config&> child = conf.get_child_optional(kv.first);
+    if (child and not kv.second.empty()) {
+      if (not kv.second.data().empty()) {
+	child->data() = kv.second.data();
+      }
+      merge_configuration(*child, kv.second);
+    } else if (child) {
+      child->data() = kv.second.data();
+    } else {
+      conf.add_child(kv.first, kv.second);
+    }
+  }
+}
+
+template<typename TT,
+	 typename T,
+	 typename Mesh>
+Config
+SaintVenantSolver<TT,T,Mesh>::override_configuration(const Config& conf,
+						     const std::string& key,
+						     const Config* overrides)
+{
+  // Sections under key with the same type, such as
+  // source term "manning roughness", override the configuration
+  Config merged = conf;
+  if (overrides) {
+    std::string type = conf.get_value<std::string>();
+    auto crange = overrides->equal_range(key);
+    for (auto it = crange.first; it != crange.second; ++it) {
+      if (it->second.get_value<std::string>() == type) {
+	merge_configuration(merged, it->second);
+      }
+    }
+  }
+  return merged;
 }
 
 template<typename TT,
@@ -78,27 +265,30 @@ SaintVenantSolver<TT,T,Mesh>::update_dUdt(const size_t& state_no,
 					  const TT& time_now,
 					  const TT& timestep)
 {
-  // Update the spatial derivatives
-  U_.at(state_no)->calculate_spatial_derivatives(*dUdx_, *dUdy_);
+  if (not reconstruct_slopes_) {
+    // Update the spatial derivatives
+    U_.at(state_no)->calculate_spatial_derivatives(*dUdx_, *dUdy_,
+						    derivative_launch_);
+  }
 
-  // Calculate the flux at each face
-  fluxes_->update(*(U_.at(state_no)), *constants_, *dUdx_, *dUdy_);
+  // If the slopes are reconstructed on the fly there are no stored
+  // derivatives. No source term reads them in that case (see
+  // SaintVenantSourceTerm::requires_spatial_derivatives), so pass the
+  // state in their place.
+  State& dUdx = dUdx_ ? *dUdx_ : *(U_.at(state_no));
+  State& dUdy = dUdy_ ? *dUdy_ : *(U_.at(state_no));
 
-  // Calculate the temporal derivative
-  using TDKernel = SaintVenantTemporalDerivativeKernel<ValueType,MeshType>;
-  size_t ncells = mesh_->template object_count<MeshComponent::Cell>();
-  mesh_->queue_ptr()->submit([&] (sycl::handler& cgh) {
-    auto kernel = TDKernel(cgh, *(U_.at(state_no)), *constants_,
-			   *dUdx_, *dUdy_, *fluxes_,
-			   *(dUdt_.at(state_no)), time_now, timestep);
-    cgh.parallel_for(sycl::range<1>(ncells), kernel);
-  });
+  if (reconstruct_slopes_) {
+    this->template update_fluxes_and_dUdt<true>(state_no, time_now, timestep);
+  } else {
+    this->template update_fluxes_and_dUdt<false>(state_no, time_now, timestep);
+  }
 
   // Apply source terms
   for (auto&& st : source_terms_) {
     st->apply(*(U_.at(state_no)),
 	      *(constants_),
-		*(dUdx_), *(dUdy_),
+	      dUdx, dUdy,
 	      *(dUdt_.at(state_no)),
 	      timestep, time_now, time_params_);
   }
@@ -107,12 +297,62 @@ SaintVenantSolver<TT,T,Mesh>::update_dUdt(const size_t& state_no,
   for (auto&& bdy : boundaries_) {
     bdy->apply(*(U_.at(state_no)),
 	       *(constants_),
-		*(dUdx_), *(dUdy_),
+	       dUdx, dUdy,
 	       *(dUdt_.at(state_no)),
 	       timestep, time_now, time_params_);
   }
 }
 
+template<typename TT,
+	 typename T,
+	 typename Mesh>
+template<bool ReconstructSlopes>
+void
+SaintVenantSolver<TT,T,Mesh>::update_fluxes_and_dUdt(const size_t& state_no,
+						     const TT& time_now,
+						     const TT& timestep)
+{
+  // The flux and temporal derivative kernels do not read the stored
+  // derivatives when reconstructing slopes, but their accessors must
+  // still be bound to something.
+  const State& U = *(U_.at(state_no));
+  const State& dUdx = ReconstructSlopes ? U : *dUdx_;
+  const State& dUdy = ReconstructSlopes ? U : *dUdy_;
+
+  // Calculate the flux at each face
+  fluxes_->template update<ReconstructSlopes>(U, *constants_, dUdx, dUdy,
+					      flux_launch_);
+
+  // Calculate the temporal derivative
+  this->template update_temporal_derivative<ReconstructSlopes>(state_no,
+							       time_now,
+							       timestep);
+}
+
+template<typename TT,
+	 typename T,
+	 typename Mesh>
+template<bool ReconstructSlopes>
+void
+SaintVenantSolver<TT,T,Mesh>::update_temporal_derivative(const size_t& state_no,
+							 const TT& time_now,
+							 const TT& timestep)
+{
+  const State& U = *(U_.at(state_no));
+  const State& dUdx = ReconstructSlopes ? U : *dUdx_;
+  const State& dUdy = ReconstructSlopes ? U : *dUdy_;
+
+  using TDKernel = SaintVenantTemporalDerivativeKernel<ValueType,MeshType,
+						       ReconstructSlopes>;
+  size_t ncells = mesh_->template object_count<MeshComponent::Cell>();
+  mesh_->queue_ptr()->submit([&] (sycl::handler& cgh) {
+    auto kernel = TDKernel(cgh, U, *constants_,
+			   dUdx, dUdy, *fluxes_,
+			   *(dUdt_.at(state_no)), time_now, timestep);
+    launch_kernel(cgh, ncells, kernel, temporal_derivative_launch_);
+  });
+}
+
 template<typename TT,
 	 typename T,
 	 typename Mesh>
@@ -50,14 +50,31 @@ private:
   std::shared_ptr<TimeParameters<TimeType>> time_params_;
   std::shared_ptr<MeshType> mesh_;
 
+  // The range of cells whose control numbers limit the timestep (see
+  // the owned_cells constructor parameter)
+  std::array<size_t,2> owned_cells_;
+
   std::shared_ptr<Constants> constants_;
   std::vector<std::shared_ptr<State>> U_;
   std::vector<std::shared_ptr<State>> dUdt_;
 
+  // Spatial derivatives of the state. These are only allocated if
+  // the slopes are stored rather than reconstructed on the fly.
+  bool reconstruct_slopes_;
   std::shared_ptr<State> dUdx_;
   std::shared_ptr<State> dUdy_;
+
   std::shared_ptr<Fluxes> fluxes_;
 
+  // The launch configurations of the flux, spatial derivative,
+  // temporal derivative and reduction kernels, tuned for the mesh (see
+  // tune_launch_configurations), and of the other kernels
+  LaunchConfiguration flux_launch_;
+  LaunchConfiguration derivative_launch_;
+  LaunchConfiguration temporal_derivative_launch_;
+  LaunchConfiguration reduction_launch_;
+  LaunchConfiguration kernel_launch_;
+
   std::vector<std::shared_ptr<SourceTerm>> source_terms_;
   std::vector<std::shared_ptr<SourceTerm>> boundaries_;
   // std::shared_ptr<SourceTerm> q_boundary_;
@@ -66,6 +83,34 @@ private:
   std::vector<std::shared_ptr<MeasureType>> measures_;
 
   CellField<ValueType, MeshType> stage_;
+
+  /**
+     Read the scheme configuration and allocate the states, fluxes
+     and derivatives. The source terms must already be in place,
+     since some of them require stored slopes.
+   */
+  void initialize_(size_t no_of_states);
+
+  /**
+     Set the launch configurations of the flux, spatial derivative,
+     temporal derivative and reduction kernels for the mesh, the
+     engine and the slope mode (see LaunchTuner).
+   */
+  void tune_launch_configurations(void);
+
+  template<bool ReconstructSlopes>
+  void update_fluxes_and_dUdt(const size_t& state_no,
+			      const TimeType& time_now,
+			      const TimeType& timestep);
+
+  /**
+     Submit the temporal derivative kernel, which sums the fluxes of
+     each cell of state state_no into its derivative.
+   */
+  template<bool ReconstructSlopes>
+  void update_temporal_derivative(const size_t& state_no,
+				  const TimeType& time_now,
+				  const TimeType& timestep);
   
 public:
 
@@ -82,6 +127,63 @@ public:
 		    size_t no_of_states,
 		    const std::shared_ptr<TimeParameters<TimeType>>& tparams);
 
+  /**
+     Constructor. Create a solver for the Saint Venant equations on
+     a given mesh, which may be one subdomain of a larger mesh (see
+     SaintVenantDecomposedSolver).
+
+     @param mesh Pointer to the mesh. Its queue is used for the
+     solution.
+     @param no_of_states Number of intermediate states that the
+     program must store.
+     @param owned_cells The range of cells [owned_cells[0],
+     owned_cells[1]) for which this solver reports measures, applies
+     boundaries and calculates the control number.
+     @param constants Pointer to the constants, shared with other
+     solvers on the same mesh (see SaintVenantEnsembleSolver), or
+     null to create them.
+     @param overrides Configuration sections that override those of
+     the source terms and boundaries with the same type, or null.
+     @param report_measures Whether the solver reports measures at
+     all, which only one member of an ensemble does.
+  */
+  SaintVenantSolver(const std::shared_ptr<MeshType>& mesh,
+		    size_t no_of_states,
+		    const std::shared_ptr<TimeParameters<TimeType>>& tparams,
+		    const std::array<size_t,2>& owned_cells = { 0, std::numeric_limits<size_t>::max() },
+		    const std::shared_ptr<Constants>& constants = nullptr,
+		    const Config* overrides = nullptr,
+		    bool report_measures = true);
+
+  /**
+     Constructor. Create a solver for the Saint Venant equations on
+     a given mesh from source terms and boundaries that have already
+     been created, eg by packing those of several meshes (see
+     SaintVenantPackedSolver). The solver reports no measures.
+
+     @param mesh Pointer to the mesh. Its queue is used for the
+     solution.
+     @param no_of_states Number of intermediate states that the
+     program must store.
+     @param constants Pointer to the constants.
+     @param source_terms The source terms.
+     @param boundaries The boundaries.
+  */
+  SaintVenantSolver(const std::shared_ptr<MeshType>& mesh,
+		    size_t no_of_states,
+		    const std::shared_ptr<TimeParameters<TimeType>>& tparams,
+		    const std::shared_ptr<Constants>& constants,
+		    const std::vector<std::shared_ptr<SourceTerm>>& source_terms,
+		    const std::vector<std::shared_ptr<SourceTerm>>& boundaries);
+
+  /**
+     Merge the sections under key in overrides with the same type as
+     conf, eg source term "manning roughness", into a copy of conf.
+   */
+  static Config override_configuration(const Config& conf,
+				       const std::string& key,
+				       const Config* overrides);
+
   const std::shared_ptr<sycl::queue>& queue(void)
   {
     return mesh_->queue_ptr();
@@ -89,8 +191,13 @@ public:
 
   void end_of_step(const TimeType& time_now)
   {
-    // Update stage field
-    stage_ = constants_->z_bed() + U_.at(0)->h();
+    // Update stage field. With sub-grid bathymetry the depth is the
+    // mean depth over the cell, so the stage comes from the tables.
+    if (constants_->subgrid()) {
+      constants_->subgrid()->stage(U_.at(0)->h(), stage_);
+    } else {
+      stage_ = constants_->z_bed() + U_.at(0)->h();
+    }
     // Update measures
     for (auto&& measure : measures_) {
       measure->update(time_now, *(U_.at(0)));
@@ -118,7 +225,8 @@ public:
 			   const TimeType& timestep)
   {
     // std::cout << "Calculating control number for state " << state_no << std::endl;
-    return U_.at(state_no)->max_control_number(timestep);
+    return U_.at(state_no)->max_control_number(timestep, reduction_launch_,
+					       owned_cells_);
   }
 
   template<typename OutputFieldType>
@@ -136,6 +244,23 @@ public:
     return nullptr;
   }
   
+  /**
+     Register interest in an output field, allocating it if it is an
+     optional diagnostic. Returns true if the field is available.
+   */
+  template<MeshComponent C>
+  bool request_output_field(const std::string& name)
+  {
+    using OutputFieldType = Field<ValueType,MeshType,C>;
+
+    for (auto&& source_term : source_terms_) {
+      source_term->template request_output_field<C>(name);
+    }
+    fluxes_->template request_output_field<OutputFieldType>(name);
+
+    return (this->template get_output_field_ptr<C>(name) != nullptr);
+  }
+  
   template<MeshComponent C>
   Field<ValueType,MeshType,C>* get_output_field_ptr(const std::string& name)
   {
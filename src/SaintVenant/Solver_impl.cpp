@@ -21,8 +21,12 @@
 #endif
 
 #include "Solver.cpp"
+#include "DecomposedSolver.cpp"
+#include "PackedSolver.cpp"
+#include "EnsembleSolver.cpp"
 #include "State.cpp"
 #include "Constants.cpp"
+#include "Subgrid.cpp"
 #include "Fluxes.cpp"
 
 #include "FluxKernel.cpp"
@@ -31,7 +35,43 @@
 #include "SourceTerm.cpp"
 
 #include "Cartesian2DMesh.hpp"
+#include "QuadtreeMesh.hpp"
+#include "RectilinearMesh.hpp"
+#include "SparseCartesian2DMesh.hpp"
+#include "UnstructuredMesh.hpp"
+#include "MultiCartesian2DMesh.hpp"
 
 template class SaintVenantSolver<float,float,Cartesian2DMesh>;
 template class SaintVenantSolver<double,float,Cartesian2DMesh>;
 template class SaintVenantState<float,Cartesian2DMesh>;
+template class SaintVenantDecomposedSolver<float,float>;
+template class SaintVenantDecomposedSolver<double,float>;
+
+template class SaintVenantSolver<float,float,TiledCartesian2DMesh>;
+template class SaintVenantSolver<double,float,TiledCartesian2DMesh>;
+template class SaintVenantState<float,TiledCartesian2DMesh>;
+
+template class SaintVenantSolver<float,float,QuadtreeMesh>;
+template class SaintVenantSolver<double,float,QuadtreeMesh>;
+template class SaintVenantState<float,QuadtreeMesh>;
+
+template class SaintVenantSolver<float,float,RectilinearMesh>;
+template class SaintVenantSolver<double,float,RectilinearMesh>;
+template class SaintVenantState<float,RectilinearMesh>;
+
+template class SaintVenantSolver<float,float,SparseCartesian2DMesh>;
+template class SaintVenantSolver<double,float,SparseCartesian2DMesh>;
+template class SaintVenantState<float,SparseCartesian2DMesh>;
+
+template class SaintVenantSolver<float,float,UnstructuredMesh>;
+template class SaintVenantSolver<double,float,UnstructuredMesh>;
+template class SaintVenantState<float,UnstructuredMesh>;
+
+template class SaintVenantSolver<float,float,MultiCartesian2DMesh>;
+template class SaintVenantSolver<double,float,MultiCartesian2DMesh>;
+template class SaintVenantState<float,MultiCartesian2DMesh>;
+
+template class SaintVenantPackedSolver<float,float>;
+template class SaintVenantPackedSolver<double,float>;
+template class SaintVenantEnsembleSolver<float,float>;
+template class SaintVenantEnsembleSolver<double,float>;
@@ -48,3 +48,36 @@ create_source_term(const Config& conf,
     throw std::runtime_error("Unknown source term type.");
   }
 }
+
+template<typename TT,
+	 typename T,
+	 typename Mesh>
+std::shared_ptr<SaintVenantSourceTerm<TT,T,Mesh>>
+SaintVenantSourceTerm<TT,T,Mesh>::
+create_packed_source_term(const Config& conf,
+			  const std::shared_ptr<MeshType>& mesh,
+			  const std::vector<Field<ValueType,MeshType,MeshComponent::Cell>>& fields,
+			  bool on_device)
+{
+  using FieldType = Field<ValueType,MeshType,MeshComponent::Cell>;
+  std::string st_type = conf.get_value<std::string>();
+  if (st_type == "manning roughness" and fields.size() == 4) {
+    return create_with_parameter_storage<ManningRoughnessSourceTerm,TT,T,Mesh>
+      (conf, mesh, fields.at(0), fields.at(1), fields.at(2), fields.at(3),
+       on_device);
+  } else if (st_type == "energy loss" and fields.size() == 2) {
+    return std::make_shared<EnergyLossSourceTerm<TT,T,Mesh>>
+      (mesh, std::make_shared<FieldType>(fields.at(0)),
+       std::make_shared<FieldType>(fields.at(1)), on_device);
+  } else if (st_type == "eddy viscosity" and fields.size() == 1) {
+    return std::make_shared<EddyViscositySourceTerm<TT,T,Mesh>>
+      (mesh, std::make_shared<FieldType>(fields.at(0)), on_device);
+  } else if (st_type == "infiltration" and fields.size() == 2) {
+    return create_with_parameter_storage<InfiltrationSourceTerm,TT,T,Mesh>
+      (conf, mesh, fields.at(0), std::make_shared<FieldType>(fields.at(1)));
+  } else {
+    std::cerr << "ERROR: Source term " << std::quoted(st_type)
+	      << " cannot be packed with those of other meshes." << std::endl;
+    throw std::runtime_error("Source term cannot be packed.");
+  }
+}
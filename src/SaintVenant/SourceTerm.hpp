@@ -20,6 +20,7 @@
 #define mfcm_SaintVenant_SourceTerm_hpp
 
 #include "TimeParameters.hpp"
+#include "launch.hpp"
 
 template<typename TT,
 	 typename T,
@@ -35,6 +36,11 @@ public:
   using State = SaintVenantState<ValueType,MeshType>;
   using Constants = SaintVenantConstants<ValueType,MeshType>;
   using Fluxes = SaintVenantFluxes<ValueType,MeshType>;
+
+protected:
+
+  // The launch configuration of the kernels of apply()
+  LaunchConfiguration launch_;
   
 public:
 
@@ -49,6 +55,15 @@ public:
 		     const TimeType& timestep, const TimeType& time_now,
 		     const std::shared_ptr<TimeParameters<TimeType>>& tp_ptr) = 0;
 
+  /**
+     Set the launch configuration with which apply() launches the
+     kernels of the source term (see launch_kernel).
+   */
+  void set_launch_configuration(const LaunchConfiguration& lc)
+  {
+    launch_ = lc;
+  }
+
   virtual void start_new_step(Constants& constants,
 			      const TimeType& time_now,
 			      const std::shared_ptr<TimeParameters<TimeType>>& tp_ptr)
@@ -56,6 +71,51 @@ public:
     // Do nothing by default
   }
 
+  /**
+     Return true if apply() reads the spatial derivatives dUdx and
+     dUdy, so that they must be stored rather than reconstructed in
+     the flux kernel.
+   */
+  virtual bool requires_spatial_derivatives(void) const
+  {
+    return false;
+  }
+
+  /**
+     Register interest in an output field so that the source term can
+     allocate (and write) optional diagnostic fields. Called for each
+     output field before the simulation starts.
+   */
+  virtual void request_output_cell_field(const std::string& name)
+  {}
+
+  virtual void request_output_face_field(const std::string& name)
+  {}
+
+  virtual void request_output_vertex_field(const std::string& name)
+  {}
+
+  template<MeshComponent C>
+  void request_output_field(const std::string& name);
+
+  template<>
+  void request_output_field<MeshComponent::Cell>(const std::string& name)
+  {
+    this->request_output_cell_field(name);
+  }
+
+  template<>
+  void request_output_field<MeshComponent::Face>(const std::string& name)
+  {
+    this->request_output_face_field(name);
+  }
+
+  template<>
+  void request_output_field<MeshComponent::Vertex>(const std::string& name)
+  {
+    this->request_output_vertex_field(name);
+  }
+
   virtual Field<ValueType,MeshType,MeshComponent::Cell>*
   get_output_cell_field_ptr(const std::string& name)
   {
@@ -95,10 +155,33 @@ public:
     return this->get_output_vertex_field_ptr(name);
   }
 
+  /**
+     Return the parameter fields of the source term in the order that
+     create_packed_source_term takes them, or none if the source term
+     cannot be packed with those of other meshes (see
+     SaintVenantPackedSolver).
+   */
+  virtual std::vector<Field<ValueType,MeshType,MeshComponent::Cell>>
+  parameter_fields(void) const
+  {
+    return {};
+  }
+
   static std::shared_ptr<SaintVenantSourceTerm<TT,T,Mesh>>
   create_source_term(const Config& conf,
 		     const std::shared_ptr<MeshType>& mesh,
 		     bool on_device = true);
+
+  /**
+     Create a source term of the type of conf from parameter fields
+     in the order returned by parameter_fields, eg the parameters of
+     several meshes packed into one.
+   */
+  static std::shared_ptr<SaintVenantSourceTerm<TT,T,Mesh>>
+  create_packed_source_term(const Config& conf,
+			    const std::shared_ptr<MeshType>& mesh,
+			    const std::vector<Field<ValueType,MeshType,MeshComponent::Cell>>& fields,
+			    bool on_device = true);
   
 };
 
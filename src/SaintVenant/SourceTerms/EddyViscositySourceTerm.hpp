@@ -80,7 +80,7 @@ public:
 			    State& dUdt,
 			    const TimeType& timestep);
 
-  void operator()(sycl::item<1> item) const;
+  void operator()(sycl::id<1> idx) const;
   
 };
 
@@ -125,7 +125,7 @@ public:
 			       const FieldType& dvdy,
 			       FieldType& mu);
 
-  void operator()(sycl::item<1> item) const;
+  void operator()(sycl::id<1> idx) const;
   
 };
 
@@ -203,9 +203,46 @@ public:
   {
   }
 
+  EddyViscositySourceTerm(const std::shared_ptr<MeshType>& mesh,
+			  const std::shared_ptr<FieldType>& mu,
+			  bool on_device = true)
+    : SaintVenantSourceTerm<TimeType,ValueType,MeshType>(),
+      mesh_(mesh),
+      mu_(mu),
+      d2udx2_(std::make_shared<FieldType>
+	      (mesh_->queue_ptr(), "d2udx2", mesh_, 0.0, on_device)),
+      d2udy2_(std::make_shared<FieldType>
+	      (mesh_->queue_ptr(), "d2udy2", mesh_, 0.0, on_device)),
+      d2vdx2_(std::make_shared<FieldType>
+	      (mesh_->queue_ptr(), "d2vdx2", mesh_, 0.0, on_device)),
+      d2vdy2_(std::make_shared<FieldType>
+	      (mesh_->queue_ptr(), "d2vdy2", mesh_, 0.0, on_device)),
+      mu_const_(std::numeric_limits<ValueType>::quiet_NaN()),
+      mu_smag_(std::numeric_limits<ValueType>::quiet_NaN())
+  {
+  }
+
   virtual ~EddyViscositySourceTerm(void)
   {}
 
+  /**
+     The viscosity, unless it is computed from the flow
+     (Smagorinsky).
+   */
+  virtual std::vector<FieldType> parameter_fields(void) const
+  {
+    if (not (mu_const_ != mu_const_) and
+	not (mu_smag_ != mu_smag_)) {
+      return {};
+    }
+    return { *mu_ };
+  }
+
+  virtual bool requires_spatial_derivatives(void) const
+  {
+    return true;
+  }
+
   /*
   virtual FieldType* get_output_cell_field_ptr(const std::string& name)
   {
@@ -239,7 +276,7 @@ public:
 								       dUdx.v(),
 								       dUdy.v(),
 								       *mu_);
-	cgh.parallel_for(sycl::range<1>(ncells), kernel);
+	launch_kernel(cgh, ncells, kernel, this->launch_);
       });
     }
     
@@ -249,7 +286,7 @@ public:
 			   *d2udx2_, *d2udy2_,
 			   *d2vdx2_, *d2vdy2_,
 			   dUdt, timestep);
-      cgh.parallel_for(sycl::range<1>(ncells), kernel);
+      launch_kernel(cgh, ncells, kernel, this->launch_);
     });
   }
 
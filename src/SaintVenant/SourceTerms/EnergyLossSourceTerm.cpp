@@ -58,9 +58,15 @@ template<typename TT,
 	 typename Mesh>
 void
 EnergyLossSourceKernel<TT,T,Mesh>::
-operator()(sycl::item<1> item) const
+operator()(sycl::id<1> idx) const
 {
-  size_t cell_c = item.get_linear_id();
+  size_t cell_c = idx[0];
+
+  // Block-local timestep (see ManningRoughnessSourceKernel)
+  double timestep = timestep_;
+  if constexpr (MeshType::has_block_clocks) {
+    timestep = h_.mesh().block_clock(cell_c, 0.0).timestep;
+  }
 
   ValueType h = h_.data()[cell_c];
   ValueType u = u_.data()[cell_c];
@@ -73,13 +79,13 @@ operator()(sycl::item<1> item) const
 
     // If the change in velocity is enough to push the water backwards
     // relative to it's current velocity, cap it.
-    if (sycl::fabs(dudt * timestep_) > sycl::fabs(u) and
-	sycl::sign(dudt * timestep_) != sycl::sign(u)) {
-      dudt = -u / timestep_;
+    if (sycl::fabs(dudt * timestep) > sycl::fabs(u) and
+	sycl::sign(dudt * timestep) != sycl::sign(u)) {
+      dudt = -u / timestep;
     }
-    if (sycl::fabs(dvdt * timestep_) > sycl::fabs(v) and
-	sycl::sign(dvdt * timestep_) != sycl::sign(v)) {
-      dvdt = -v / timestep_;
+    if (sycl::fabs(dvdt * timestep) > sycl::fabs(v) and
+	sycl::sign(dvdt * timestep) != sycl::sign(v)) {
+      dvdt = -v / timestep;
     }
 
     dudt_.data()[cell_c] += dudt;
@@ -157,7 +157,7 @@ public:
 			 State& dUdt,
 			 const TimeType& timestep);
 
-  void operator()(sycl::item<1> item) const;
+  void operator()(sycl::id<1> idx) const;
   
 };
 
@@ -233,6 +233,17 @@ public:
   virtual ~EnergyLossSourceTerm(void)
   {}
 
+  /**
+     The coefficients, unless they are computed by models.
+   */
+  virtual std::vector<FieldType> parameter_fields(void) const
+  {
+    if (models_.size() > 0) {
+      return {};
+    }
+    return { *fdx_, *fdy_ };
+  }
+
   virtual FieldType* get_output_cell_field_ptr(const std::string& name)
   {
     if (name == "fx") {
@@ -262,7 +273,7 @@ public:
       auto kernel = Kernel(cgh, U, constants,
 			   *fdx_, *fdy_,
 			   dUdt, timestep);
-      cgh.parallel_for(sycl::range<1>(ncells), kernel);
+      launch_kernel(cgh, ncells, kernel, this->launch_);
     });
   }
 
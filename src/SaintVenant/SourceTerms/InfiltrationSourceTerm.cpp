@@ -20,12 +20,13 @@
 
 template<typename TT,
 	 typename T,
-	 typename Mesh>
-InfiltrationSourceKernel<TT,T,Mesh>::
+	 typename Mesh,
+	 typename ParamField>
+InfiltrationSourceKernel<TT,T,Mesh,ParamField>::
 InfiltrationSourceKernel(sycl::handler& cgh,
 			 const State& U,
 			 const Constants& K,
-			 const FieldType& i_rate,
+			 const ParamFieldType& i_rate,
 			 FieldType& i_cap,
 			 State& dUdt,
 			 const TT& timestep)
@@ -37,17 +38,24 @@ InfiltrationSourceKernel(sycl::handler& cgh,
 
 template<typename TT,
 	 typename T,
-	 typename Mesh>
-void InfiltrationSourceKernel<TT,T,Mesh>::
-operator()(sycl::item<1> item) const
+	 typename Mesh,
+	 typename ParamField>
+void InfiltrationSourceKernel<TT,T,Mesh,ParamField>::
+operator()(sycl::id<1> idx) const
 {
-  size_t cell_c = item.get_linear_id();
+  size_t cell_c = idx[0];
+
+  // Block-local timestep (see ManningRoughnessSourceKernel)
+  double timestep = timestep_;
+  if constexpr (MeshType::has_block_clocks) {
+    timestep = h_.mesh().block_clock(cell_c, 0.0).timestep;
+  }
 
   // Get the depth of water in the cell
   ValueType h = h_.data()[cell_c];
 
   // Calculate how much we want to infiltrate this timestep.
-  ValueType dh = i_rate_.data()[cell_c] * timestep_;
+  ValueType dh = i_rate_.data()[cell_c] * timestep;
 
   // Cannot take more water than is in the cell
   if (dh > h) {
@@ -59,23 +67,22 @@ operator()(sycl::item<1> item) const
     dh = i_cap_.data()[cell_c];
   }
 
-  dhdt_.data()[cell_c] -= dh / timestep_;
+  dhdt_.data()[cell_c] -= dh / timestep;
   i_cap_.data()[cell_c] -= dh;
 }
 
 template<typename TT,
 	 typename T,
-	 typename Mesh>
+	 typename Mesh,
+	 typename ParamField>
 std::shared_ptr<SaintVenantSourceTerm<TT,T,Mesh>>
-InfiltrationSourceTerm<TT,T,Mesh>::
+InfiltrationSourceTerm<TT,T,Mesh,ParamField>::
 create_source_term(const Config& conf,
 		   const std::shared_ptr<MeshType>& mesh,
 		   bool on_device)
 {
   ValueType i_rate_val = conf.get<ValueType>("default infiltration rate", 1e-6);
   ValueType i_cap_val = conf.get<ValueType>("default infiltration capacity", 0.1);
-  return std::make_shared<InfiltrationSourceTerm<TT,T,Mesh>>(mesh,
-							     i_rate_val,
-							     i_cap_val,
-							     on_device);
+  return create_with_parameter_storage<InfiltrationSourceTerm,TT,T,Mesh>
+    (conf, mesh, i_rate_val, i_cap_val, on_device);
 }
@@ -21,11 +21,13 @@
 
 #include "SourceTerm.hpp"
 #include "FieldGenerator.hpp"
+#include "ParameterStorage.hpp"
 #include "../Output/CheckFile.hpp"
 
 template<typename TT,
 	 typename T,
-	 typename Mesh>
+	 typename Mesh,
+	 typename ParamField = CellField<T,Mesh>>
 class InfiltrationSourceKernel
 {
 public:
@@ -34,6 +36,7 @@ public:
   using ValueType = T;
   using MeshType = Mesh;
   using FieldType = CellField<ValueType,MeshType>;
+  using ParamFieldType = ParamField;
 
   using State = SaintVenantState<ValueType, MeshType>;
   using Constants = SaintVenantConstants<ValueType, MeshType>;
@@ -42,6 +45,10 @@ public:
     template Accessor<sycl::access::mode::read,
     sycl::access::target::global_buffer>;
   
+  using ParamReadAccessor = typename ParamFieldType::
+    template Accessor<sycl::access::mode::read,
+		      sycl::access::target::global_buffer>;
+
   using CellReadWriteAccessor = typename FieldType::
     template Accessor<sycl::access::mode::read_write,
 		      sycl::access::target::global_buffer>;
@@ -50,7 +57,7 @@ private:
 
   CellReadAccessor h_;
 
-  CellReadAccessor i_rate_;
+  ParamReadAccessor i_rate_;
   CellReadWriteAccessor i_cap_;
 
   CellReadWriteAccessor dhdt_;
@@ -62,18 +69,25 @@ public:
   InfiltrationSourceKernel(sycl::handler& cgh,
 			   const State& U,
 			   const Constants& K,
-			   const FieldType& i_rate,
+			   const ParamFieldType& i_rate,
 			   FieldType& i_cap,
 			   State& dUdt,
 			   const TimeType& timestep);
 
-  void operator()(sycl::item<1> item) const;
+  void operator()(sycl::id<1> idx) const;
   
 };
 
+/**
+   Infiltration source term. The (static) infiltration rate is stored
+   as ParamField, which may be a CellField, ZonedField or PackedField
+   (see create_with_parameter_storage). The infiltration capacity is
+   updated every step so is always a full CellField.
+ */
 template<typename TT,
 	 typename T,
-	 typename Mesh>
+	 typename Mesh,
+	 typename ParamField = CellField<T,Mesh>>
 class InfiltrationSourceTerm : public SaintVenantSourceTerm<TT,T,Mesh>
 {
 public:
@@ -82,17 +96,19 @@ public:
   using ValueType = T;
   using MeshType = Mesh;
   using FieldType = CellField<ValueType,MeshType>;
+  using ParamFieldType = ParamField;
 
   using State = SaintVenantState<ValueType,MeshType>;
   using Constants = SaintVenantConstants<ValueType,MeshType>;
 
-  using Kernel = InfiltrationSourceKernel<TimeType,ValueType,MeshType>;
+  using Kernel = InfiltrationSourceKernel<TimeType,ValueType,MeshType,
+					  ParamFieldType>;
 
 private:
 
   std::shared_ptr<MeshType> mesh_;
 
-  std::shared_ptr<FieldType> infiltration_rate_;
+  std::shared_ptr<ParamFieldType> infiltration_rate_;
   std::shared_ptr<FieldType> infiltration_capacity_;
 
 public:
@@ -101,32 +117,38 @@ public:
 			 const ValueType& i_rate_val = 1e-6,
 			 const ValueType& i_cap_val = 0.1,
 			 bool on_device = true)
-    : SaintVenantSourceTerm<TimeType,ValueType,MeshType>(),
-      mesh_(mesh),
-      infiltration_rate_(FieldGenerator<ValueType,MeshType,MeshComponent::Cell>
-			 (mesh_->queue_ptr(), "IR", mesh_, i_rate_val, on_device).make_shared()),
-      infiltration_capacity_(FieldGenerator<ValueType,MeshType,MeshComponent::Cell>
-			     (mesh_->queue_ptr(), "IC", mesh_, i_cap_val, on_device).make_shared())
+    : InfiltrationSourceTerm<TimeType,ValueType,MeshType,ParamFieldType>
+      (mesh,
+       FieldGenerator<ValueType,MeshType,MeshComponent::Cell>
+       (mesh->queue_ptr(), "IR", mesh, i_rate_val, on_device)(),
+       FieldGenerator<ValueType,MeshType,MeshComponent::Cell>
+       (mesh->queue_ptr(), "IC", mesh, i_cap_val, on_device).make_shared())
   {
-    FieldCheckFile<FieldType> cf("infiltration");
-    cf.output({infiltration_rate_.get(), infiltration_capacity_.get()});
   }
 
   InfiltrationSourceTerm(const std::shared_ptr<MeshType>& mesh,
-			 const std::shared_ptr<FieldType>& i_rate_field,
+			 FieldType i_rate_field,
 			 const std::shared_ptr<FieldType>& i_cap_field)
     : SaintVenantSourceTerm<TimeType,ValueType,MeshType>(),
       mesh_(mesh),
-      infiltration_rate_(i_rate_field),
+      infiltration_rate_(std::make_shared<ParamFieldType>(i_rate_field)),
       infiltration_capacity_(i_cap_field)
   {
     FieldCheckFile<FieldType> cf("infiltration");
-    cf.output({infiltration_rate_.get(), infiltration_capacity_.get()});
+    cf.output({&i_rate_field, infiltration_capacity_.get()});
   }    
   
   virtual ~InfiltrationSourceTerm(void)
   {}
 
+  /**
+     The infiltration rate and the remaining infiltration capacity.
+   */
+  virtual std::vector<FieldType> parameter_fields(void) const
+  {
+    return { full_parameter_field(*infiltration_rate_), *infiltration_capacity_ };
+  }
+
   /*
   virtual FieldType* get_output_cell_field_ptr(const std::string& name)
   {
@@ -144,7 +166,7 @@ public:
       auto kernel = Kernel(cgh, U, constants,
 			   *infiltration_rate_, *infiltration_capacity_,
 			   dUdt, timestep);
-      cgh.parallel_for(sycl::range<1>(ncells), kernel);
+      launch_kernel(cgh, ncells, kernel, this->launch_);
     });
   }
 
@@ -20,17 +20,19 @@
 
 template<typename TT,
 	 typename T,
-	 typename Mesh>
-ManningRoughnessSourceKernel<TT,T,Mesh>::
+	 typename Mesh,
+	 typename ParamField,
+	 bool WriteDiagnostics>
+ManningRoughnessSourceKernel<TT,T,Mesh,ParamField,WriteDiagnostics>::
 ManningRoughnessSourceKernel(sycl::handler& cgh,
 			     const State& U,
 			     const Constants& K,
-			     const FieldType& n_shallow,
-			     const FieldType& n_deep,
-			     const FieldType& d_shallow,
-			     const FieldType& d_deep,
-			     FieldType& nh,
-			     FieldType& Sf,
+			     const ParamFieldType& n_shallow,
+			     const ParamFieldType& n_deep,
+			     const ParamFieldType& d_shallow,
+			     const ParamFieldType& d_deep,
+			     FieldType* nh,
+			     FieldType* Sf,
 			     State& dUdt,
 			     const TT& timestep)
   : h_(U.h(), cgh), u_(U.u(), cgh), v_(U.v(), cgh),
@@ -43,12 +45,21 @@ ManningRoughnessSourceKernel(sycl::handler& cgh,
 
 template<typename TT,
 	 typename T,
-	 typename Mesh>
+	 typename Mesh,
+	 typename ParamField,
+	 bool WriteDiagnostics>
 void
-ManningRoughnessSourceKernel<TT,T,Mesh>::
-operator()(sycl::item<1> item) const
+ManningRoughnessSourceKernel<TT,T,Mesh,ParamField,WriteDiagnostics>::
+operator()(sycl::id<1> idx) const
 {
-  size_t cell_c = item.get_linear_id();
+  size_t cell_c = idx[0];
+
+  // On a multi-block mesh the timestep is that of the block of the
+  // cell
+  double timestep = timestep_;
+  if constexpr (MeshType::has_block_clocks) {
+    timestep = h_.mesh().block_clock(cell_c, 0.0).timestep;
+  }
 
   ValueType h = h_.data()[cell_c];
   ValueType u = u_.data()[cell_c];
@@ -58,40 +69,41 @@ operator()(sycl::item<1> item) const
 				  n_deep_.data()[cell_c],
 				  sycl::smoothstep(d_shallow_.data()[cell_c],
 						   d_deep_.data()[cell_c], h));
-  nh_.data()[cell_c] = manning_n;
+  nh_.set(cell_c, manning_n);
   if (h > 1e-6) {
     ValueType inv_h = h / (h*h + 1e-3);
     ValueType Sf = manning_n * manning_n * sycl::sqrt(u*u + v*v)
       * sycl::pow(inv_h, ValueType(4.0)/ValueType(3.0));
 
-    Sf_.data()[cell_c] = Sf;
+    Sf_.set(cell_c, Sf);
 
     ValueType dudt = -ValueType(9.81) * Sf * u;
     ValueType dvdt = -ValueType(9.81) * Sf * v;
 
     // If the change in velocity due to friction is enough to push the
     // water backwards relative to it's current velocity, cap it.
-    if (sycl::fabs(dudt * timestep_) > sycl::fabs(u) and
-	sycl::sign(dudt * timestep_) != sycl::sign(u)) {
-      dudt = -u / timestep_;
+    if (sycl::fabs(dudt * timestep) > sycl::fabs(u) and
+	sycl::sign(dudt * timestep) != sycl::sign(u)) {
+      dudt = -u / timestep;
     }
-    if (sycl::fabs(dvdt * timestep_) > sycl::fabs(v) and
-	sycl::sign(dvdt * timestep_) != sycl::sign(v)) {
-      dvdt = -v / timestep_;
+    if (sycl::fabs(dvdt * timestep) > sycl::fabs(v) and
+	sycl::sign(dvdt * timestep) != sycl::sign(v)) {
+      dvdt = -v / timestep;
     }
 
     dudt_.data()[cell_c] += dudt;
     dvdt_.data()[cell_c] += dvdt;
   } else {
-    Sf_.data()[cell_c] = 0.0;
+    Sf_.set(cell_c, 0.0);
   }
 }
 
 template<typename TT,
 	 typename T,
-	 typename Mesh>
+	 typename Mesh,
+	 typename ParamField>
 std::shared_ptr<SaintVenantSourceTerm<TT,T,Mesh>>
-ManningRoughnessSourceTerm<TT,T,Mesh>::
+ManningRoughnessSourceTerm<TT,T,Mesh,ParamField>::
 create_source_term(const Config& conf,
 		   const std::shared_ptr<MeshType>& mesh,
 		   bool on_device)
@@ -100,11 +112,8 @@ create_source_term(const Config& conf,
   ValueType n_deep_val = conf.get<ValueType>("default deep n", 0.3);
   ValueType d_shallow_val = conf.get<ValueType>("default shallow depth", 0.1);
   ValueType d_deep_val = conf.get<ValueType>("default deep depth", 0.3);
-  return std::make_shared<ManningRoughnessSourceTerm<TT,T,Mesh>>(mesh,
-								 n_shallow_val,
-								 n_deep_val,
-								 d_shallow_val,
-								 d_deep_val,
-								 on_device);
+  return create_with_parameter_storage<ManningRoughnessSourceTerm,TT,T,Mesh>
+    (conf, mesh, n_shallow_val, n_deep_val, d_shallow_val, d_deep_val,
+     on_device);
 }
 
@@ -21,11 +21,15 @@
 
 #include "SourceTerm.hpp"
 #include "FieldGenerator.hpp"
+#include "ParameterStorage.hpp"
+#include "DiagnosticFields.hpp"
 #include "../Output/CheckFile.hpp"
 
 template<typename TT,
 	 typename T,
-	 typename Mesh>
+	 typename Mesh,
+	 typename ParamField = CellField<T,Mesh>,
+	 bool WriteDiagnostics = false>
 class ManningRoughnessSourceKernel
 {
 public:
@@ -34,6 +38,7 @@ public:
   using ValueType = T;
   using MeshType = Mesh;
   using FieldType = CellField<ValueType,MeshType>;
+  using ParamFieldType = ParamField;
 
   using State = SaintVenantState<ValueType,MeshType>;
   using Constants = SaintVenantConstants<ValueType,MeshType>;
@@ -42,10 +47,13 @@ public:
     template Accessor<sycl::access::mode::read,
 		      sycl::access::target::global_buffer>;
 
-  using CellWriteAccessor = typename FieldType::
-    template Accessor<sycl::access::mode::write,
+  using ParamReadAccessor = typename ParamFieldType::
+    template Accessor<sycl::access::mode::read,
 		      sycl::access::target::global_buffer>;
 
+  using DiagnosticAccessor =
+    DiagnosticFieldAccessor<FieldType, WriteDiagnostics>;
+
   using ReadWriteAccessor = typename FieldType::
     template Accessor<sycl::access::mode::read_write,
 		      sycl::access::target::global_buffer>;
@@ -56,13 +64,13 @@ private:
   CellReadAccessor u_;
   CellReadAccessor v_;
 
-  CellReadAccessor n_shallow_;
-  CellReadAccessor n_deep_;
-  CellReadAccessor d_shallow_;
-  CellReadAccessor d_deep_;
+  ParamReadAccessor n_shallow_;
+  ParamReadAccessor n_deep_;
+  ParamReadAccessor d_shallow_;
+  ParamReadAccessor d_deep_;
 
-  CellWriteAccessor nh_;
-  CellWriteAccessor Sf_;
+  DiagnosticAccessor nh_;
+  DiagnosticAccessor Sf_;
   
   ReadWriteAccessor dudt_;
   ReadWriteAccessor dvdt_;
@@ -74,22 +82,28 @@ public:
   ManningRoughnessSourceKernel(sycl::handler& cgh,
 			       const State& U,
 			       const Constants& K,
-			       const FieldType& n_shallow,
-			       const FieldType& n_deep,
-			       const FieldType& d_shallow,
-			       const FieldType& d_deep,
-			       FieldType& nh,
-			       FieldType& Sf,
+			       const ParamFieldType& n_shallow,
+			       const ParamFieldType& n_deep,
+			       const ParamFieldType& d_shallow,
+			       const ParamFieldType& d_deep,
+			       FieldType* nh,
+			       FieldType* Sf,
 			       State& dUdt,
 			       const TimeType& timestep);
 
-  void operator()(sycl::item<1> item) const;
+  void operator()(sycl::id<1> idx) const;
   
 };
 
+/**
+   Manning's roughness source term. The four static parameter fields
+   are stored as ParamField, which may be a CellField, ZonedField or
+   PackedField (see create_with_parameter_storage).
+ */
 template<typename TT,
 	 typename T,
-	 typename Mesh>
+	 typename Mesh,
+	 typename ParamField = CellField<T,Mesh>>
 class ManningRoughnessSourceTerm : public SaintVenantSourceTerm<TT,T,Mesh>
 {
 public:
@@ -98,23 +112,43 @@ public:
   using ValueType = T;
   using MeshType = Mesh;
   using FieldType = CellField<ValueType,MeshType>;
+  using ParamFieldType = ParamField;
 
   using State = SaintVenantState<ValueType,MeshType>;
   using Constants = SaintVenantConstants<ValueType,MeshType>;
 
-  using Kernel = ManningRoughnessSourceKernel<TimeType,ValueType,MeshType>;
+  template<bool WriteDiagnostics>
+  using Kernel = ManningRoughnessSourceKernel<TimeType,ValueType,MeshType,
+					      ParamFieldType,
+					      WriteDiagnostics>;
 
 private:
 
   std::shared_ptr<MeshType> mesh_;
 
-  FieldType n_shallow_;
-  FieldType n_deep_;
-  FieldType d_shallow_;
-  FieldType d_deep_;
+  ParamFieldType n_shallow_;
+  ParamFieldType n_deep_;
+  ParamFieldType d_shallow_;
+  ParamFieldType d_deep_;
 
-  FieldType nh_;
-  FieldType Sf_;
+  // Optional diagnostics ("mannings_n" and "friction_slope")
+  DiagnosticFields<FieldType> diagnostics_;
+
+  template<bool WriteDiagnostics>
+  void submit_apply(State& U, Constants& constants, State& dUdt,
+		    const TimeType& timestep)
+  {
+    size_t ncells = mesh_->template object_count<MeshComponent::Cell>();
+    mesh_->queue_ptr()->submit([&] (sycl::handler& cgh) {
+      auto kernel = Kernel<WriteDiagnostics>(cgh, U, constants,
+					     n_shallow_, n_deep_,
+					     d_shallow_, d_deep_,
+					     diagnostics_.get("mannings_n"),
+					     diagnostics_.get("friction_slope"),
+					     dUdt, timestep);
+      launch_kernel(cgh, ncells, kernel, this->launch_);
+    });
+  }
 
 public:
   
@@ -124,38 +158,65 @@ public:
 			     const ValueType& d_shallow_val = 0.1,
 			     const ValueType& d_deep_val = 0.3,
 			     bool on_device = true)
+    : ManningRoughnessSourceTerm<TimeType,ValueType,MeshType,ParamFieldType>
+      (mesh,
+       FieldGenerator<ValueType,MeshType,MeshComponent::Cell>
+       (mesh->queue_ptr(), "n_shallow", mesh, n_shallow_val, on_device)(),
+       FieldGenerator<ValueType,MeshType,MeshComponent::Cell>
+       (mesh->queue_ptr(), "n_deep", mesh, n_deep_val, on_device)(),
+       FieldGenerator<ValueType,MeshType,MeshComponent::Cell>
+       (mesh->queue_ptr(), "d_shallow", mesh, d_shallow_val, on_device)(),
+       FieldGenerator<ValueType,MeshType,MeshComponent::Cell>
+       (mesh->queue_ptr(), "d_deep", mesh, d_deep_val, on_device)(),
+       on_device)
+  {
+  }
+
+  ManningRoughnessSourceTerm(const std::shared_ptr<MeshType>& mesh,
+			     FieldType n_shallow,
+			     FieldType n_deep,
+			     FieldType d_shallow,
+			     FieldType d_deep,
+			     bool on_device = true)
     : SaintVenantSourceTerm<TimeType,ValueType,MeshType>(),
       mesh_(mesh),
-      n_shallow_(FieldGenerator<ValueType,MeshType,MeshComponent::Cell>
-		 (mesh_->queue_ptr(), "n_shallow", mesh_,
-		  n_shallow_val, on_device)()),
-      n_deep_(FieldGenerator<ValueType,MeshType,MeshComponent::Cell>
-	      (mesh_->queue_ptr(), "n_deep", mesh_,
-	       n_deep_val, on_device)()),
-      d_shallow_(FieldGenerator<ValueType,MeshType,MeshComponent::Cell>
-		 (mesh_->queue_ptr(), "d_shallow", mesh_,
-		  d_shallow_val, on_device)()),
-      d_deep_(FieldGenerator<ValueType,MeshType,MeshComponent::Cell>
-	      (mesh_->queue_ptr(), "d_deep", mesh_,
-	       d_deep_val, on_device)()),
-      nh_(mesh_->queue_ptr(), "mannings_n", mesh_, 0.0f, on_device),
-      Sf_(mesh_->queue_ptr(), "friction_slope", mesh_, 0.0f, on_device)
+      n_shallow_(n_shallow),
+      n_deep_(n_deep),
+      d_shallow_(d_shallow),
+      d_deep_(d_deep)
   {
+    for (auto&& name : { "mannings_n", "friction_slope" }) {
+      diagnostics_.declare(name, [=] () {
+	return std::make_shared<FieldType>(mesh_->queue_ptr(), name, mesh_,
+					   0.0f, on_device);
+      });
+    }
+
     FieldCheckFile<FieldType> cf("manning");
-    cf.output({&n_shallow_, &n_deep_, &d_shallow_, &d_deep_});
+    cf.output({&n_shallow, &n_deep, &d_shallow, &d_deep});
   }
 
   virtual ~ManningRoughnessSourceTerm(void)
   {}
 
-  virtual FieldType* get_output_cell_field_ptr(const std::string& name)
+  virtual void request_output_cell_field(const std::string& name)
   {
-    if (name == "mannings_n") {
-      return &nh_;
-    } else if (name == "friction_slope") {
-      return &Sf_;
+    // The kernel writes both diagnostics together
+    if (diagnostics_.is_declared(name)) {
+      diagnostics_.request("mannings_n");
+      diagnostics_.request("friction_slope");
     }
-    return nullptr;
+  }
+
+  virtual FieldType* get_output_cell_field_ptr(const std::string& name)
+  {
+    return diagnostics_.get(name);
+  }
+
+  virtual std::vector<FieldType> parameter_fields(void) const
+  {
+    return { full_parameter_field(n_shallow_), full_parameter_field(n_deep_),
+	     full_parameter_field(d_shallow_), full_parameter_field(d_deep_) };
   }
   
   virtual void apply(State& U, Constants& constants,
@@ -163,15 +224,11 @@ public:
 		     const TimeType& timestep, const TimeType& time_now,
 		     const std::shared_ptr<TimeParameters<TimeType>>& tp_ptr)
   {
-    size_t ncells = mesh_->template object_count<MeshComponent::Cell>();
-    mesh_->queue_ptr()->submit([&] (sycl::handler& cgh) {
-      auto kernel = Kernel(cgh, U, constants,
-			   n_shallow_, n_deep_,
-			   d_shallow_, d_deep_,
-			   nh_, Sf_,
-			   dUdt, timestep);
-      cgh.parallel_for(sycl::range<1>(ncells), kernel);
-    });
+    if (diagnostics_.get("mannings_n")) {
+      this->template submit_apply<true>(U, constants, dUdt, timestep);
+    } else {
+      this->template submit_apply<false>(U, constants, dUdt, timestep);
+    }
   }
 
   static std::shared_ptr<SaintVenantSourceTerm<TT,T,Mesh>>
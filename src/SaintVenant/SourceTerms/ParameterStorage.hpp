@@ -0,0 +1,94 @@
+/***********************************************************************
+ * mfcm SaintVenant/SourceTerms/ParameterStorage.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_SaintVenant_ParameterStorage_hpp
+#define mfcm_SaintVenant_ParameterStorage_hpp
+
+#include "SourceTerm.hpp"
+#include "PackedField.hpp"
+#include "ZonedField.hpp"
+
+/**
+   Create a source term of type Term<TT,T,Mesh,ParamField>, choosing
+   how its static parameter fields are stored from the "parameter
+   storage" key of the source term configuration:
+
+   - "full" (default): a full-precision CellField;
+   - "zoned": a ZonedField (a single value, or a zone table with a
+     per-cell zone index);
+   - "16-bit" or "8-bit": a PackedField with per-field scale and offset.
+
+   The remaining arguments are passed to the source term constructor.
+ */
+template<template<typename,typename,typename,typename> class Term,
+	 typename TT,
+	 typename T,
+	 typename Mesh,
+	 typename... Args>
+std::shared_ptr<SaintVenantSourceTerm<TT,T,Mesh>>
+create_with_parameter_storage(const Config& conf,
+			      const std::shared_ptr<Mesh>& mesh,
+			      Args&&... args)
+{
+  std::string storage = conf.get<std::string>("parameter storage", "full");
+  if (storage == "full") {
+    using ParamField = CellField<T,Mesh>;
+    return std::make_shared<Term<TT,T,Mesh,ParamField>>(mesh, args...);
+  } else if (storage == "zoned") {
+    using ParamField = ZonedField<T,Mesh,MeshComponent::Cell>;
+    return std::make_shared<Term<TT,T,Mesh,ParamField>>(mesh, args...);
+  } else if (storage == "16-bit") {
+    using ParamField = PackedField<T,uint16_t,Mesh,MeshComponent::Cell>;
+    return std::make_shared<Term<TT,T,Mesh,ParamField>>(mesh, args...);
+  } else if (storage == "8-bit") {
+    using ParamField = PackedField<T,uint8_t,Mesh,MeshComponent::Cell>;
+    return std::make_shared<Term<TT,T,Mesh,ParamField>>(mesh, args...);
+  } else {
+    std::cerr << "ERROR: Unknown parameter storage: " << std::quoted(storage)
+	      << std::endl;
+    throw std::runtime_error("Unknown parameter storage.");
+  }
+}
+
+/**
+   Return the values of a parameter field as a full-precision
+   CellField on the device.
+ */
+template<typename T,
+	 typename Mesh>
+CellField<T,Mesh> full_parameter_field(const CellField<T,Mesh>& f)
+{
+  return f;
+}
+
+template<typename T,
+	 typename Mesh>
+CellField<T,Mesh> full_parameter_field(const ZonedField<T,Mesh,MeshComponent::Cell>& f)
+{
+  return f.expand(true);
+}
+
+template<typename T,
+	 typename P,
+	 typename Mesh>
+CellField<T,Mesh> full_parameter_field(const PackedField<T,P,Mesh,MeshComponent::Cell>& f)
+{
+  return f.unpack(true);
+}
+
+#endif
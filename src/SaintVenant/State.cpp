@@ -178,25 +178,28 @@ template<typename T,
 void
 SaintVenantState<T,Mesh>::
 calculate_spatial_derivatives(SaintVenantState<ValueType,MeshType>& dUdx,
-			      SaintVenantState<ValueType,MeshType>& dUdy)
+			      SaintVenantState<ValueType,MeshType>& dUdy,
+			      const LaunchConfiguration& lc)
 {
   using SpatialDerivative = SpatialDerivativeOperator<ValueType,
 						      MeshType,
 						      MeshComponent::Cell,
 						      Minmod3<ValueType>>;
-  SpatialDerivative::template apply<SpatialDerivativeAxis::X>(h_, dUdx.h());
-  SpatialDerivative::template apply<SpatialDerivativeAxis::X>(u_, dUdx.u());
-  SpatialDerivative::template apply<SpatialDerivativeAxis::X>(v_, dUdx.v());
-  SpatialDerivative::template apply<SpatialDerivativeAxis::Y>(h_, dUdy.h());
-  SpatialDerivative::template apply<SpatialDerivativeAxis::Y>(u_, dUdy.u());
-  SpatialDerivative::template apply<SpatialDerivativeAxis::Y>(v_, dUdy.v());
+  SpatialDerivative::template apply<SpatialDerivativeAxis::X>(h_, dUdx.h(), lc);
+  SpatialDerivative::template apply<SpatialDerivativeAxis::X>(u_, dUdx.u(), lc);
+  SpatialDerivative::template apply<SpatialDerivativeAxis::X>(v_, dUdx.v(), lc);
+  SpatialDerivative::template apply<SpatialDerivativeAxis::Y>(h_, dUdy.h(), lc);
+  SpatialDerivative::template apply<SpatialDerivativeAxis::Y>(u_, dUdy.u(), lc);
+  SpatialDerivative::template apply<SpatialDerivativeAxis::Y>(v_, dUdy.v(), lc);
 }
 
 template<typename T,
 	 typename Mesh>
 T
 SaintVenantState<T,Mesh>::
-max_control_number(const double& timestep)
+max_control_number(const double& timestep,
+		   const LaunchConfiguration& lc,
+		   const std::array<size_t,2>& cells)
 {
   ValueType max_cn = 0.0;
   sycl::buffer<ValueType> max_cn_buf(&max_cn, 1);
@@ -212,19 +215,21 @@ max_control_number(const double& timestep)
 					    sycl::maximum<T>());
 
     size_t ncells = h_.mesh()->template object_count<MeshComponent::Cell>();
-    cgh.parallel_for(sycl::range<1>(ncells), max_cn_reduction,
-		     [=](sycl::item<1> item, auto& max) {
-		       size_t i = item.get_linear_id();
+    size_t first = std::min(cells[0], ncells);
+    size_t count = std::min(cells[1], ncells) - first;
+    launch_reduction(cgh, count, max_cn_reduction,
+		     [=](sycl::id<1> idx, auto& max) {
+		       size_t i = first + idx[0];
 		       ValueType h = sycl::fmax(h_acc.data()[i],
 						ValueType(0.0));
 		       ValueType u = sycl::fabs(u_acc.data()[i]);
 		       ValueType v = sycl::fabs(v_acc.data()[i]);
 		       ValueType c = sycl::sqrt(ValueType(9.81) * h);
-		       ValueType dx = h_acc.mesh().dx();
-		       ValueType dy = h_acc.mesh().dy();
+		       ValueType dx = h_acc.mesh().dx(i);
+		       ValueType dy = h_acc.mesh().dy(i);
 		       ValueType cn = timestep * (((u+c)/dx) + ((v+c)/dy));
 		       max.combine(cn);
-		     });
+		     }, lc);
   });
   return max_cn_buf.get_host_access()[0];
 }
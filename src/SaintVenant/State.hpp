@@ -20,6 +20,7 @@
 #define mfcm_SaintVenant_State_hpp
 
 #include "Field.hpp"
+#include "SpatialDerivative.hpp"
 
 template<typename T,
 	 typename Mesh>
@@ -149,9 +150,17 @@ public:
   }
   
   void calculate_spatial_derivatives(SaintVenantState<ValueType,MeshType>& dUdx,
-				     SaintVenantState<ValueType,MeshType>& dUdy);
-
-  ValueType max_control_number(const double& timestep);
+				     SaintVenantState<ValueType,MeshType>& dUdy,
+				     const LaunchConfiguration& lc = LaunchConfiguration());
+
+  /**
+     Return the largest control number of the cells in the range
+     [cells[0], cells[1]) for the given timestep.
+   */
+  ValueType max_control_number(const double& timestep,
+			       const LaunchConfiguration& lc = LaunchConfiguration(),
+			       const std::array<size_t,2>& cells =
+			       { 0, std::numeric_limits<size_t>::max() });
 
 };
 
@@ -0,0 +1,95 @@
+/***********************************************************************
+ * mfcm SaintVenant/StateGroup.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_SaintVenant_StateGroup_hpp
+#define mfcm_SaintVenant_StateGroup_hpp
+
+#include "State.hpp"
+
+#include <memory>
+#include <vector>
+
+/**
+   A group of states held by several solvers, such as the subdomains
+   of a SaintVenantDecomposedSolver or the members of a
+   SaintVenantEnsembleSolver. Copies refer to the same states, and
+   assignment and arithmetic apply to each state in turn, so that the
+   temporal schemes can use it like a SaintVenantState.
+ */
+template<typename T,
+	 typename Mesh>
+class SaintVenantStateGroup
+{
+public:
+
+  using ValueType = T;
+  using MeshType = Mesh;
+  using StateType = SaintVenantState<ValueType,MeshType>;
+  using FieldType = typename StateType::FieldType;
+
+private:
+
+  std::vector<StateType*> parts_;
+
+  // Storage for the states of a temporary
+  std::vector<std::shared_ptr<StateType>> storage_;
+
+public:
+
+  explicit SaintVenantStateGroup(const std::vector<StateType*>& parts)
+    : parts_(parts)
+  {}
+
+  SaintVenantStateGroup(const SaintVenantStateGroup& state) = default;
+
+  SaintVenantStateGroup& operator=(const SaintVenantStateGroup& rhs)
+  {
+    for (size_t i = 0; i < parts_.size(); ++i) {
+      *(parts_.at(i)) = *(rhs.parts_.at(i));
+    }
+    return *this;
+  }
+
+  SaintVenantStateGroup& operator+=(const SaintVenantStateGroup& rhs)
+  {
+    for (size_t i = 0; i < parts_.size(); ++i) {
+      *(parts_.at(i)) += *(rhs.parts_.at(i));
+    }
+    return *this;
+  }
+
+  friend SaintVenantStateGroup operator*(const SaintVenantStateGroup& lhs,
+					 const ValueType& rhs)
+  {
+    SaintVenantStateGroup result(std::vector<StateType*>{});
+    for (auto&& part : lhs.parts_) {
+      result.storage_.push_back(std::make_shared<StateType>((*part) * rhs));
+      result.parts_.push_back(result.storage_.back().get());
+    }
+    return result;
+  }
+
+  /**
+     The fields of the first state, for debugging output.
+   */
+  FieldType& h(void) { return parts_.at(0)->h(); }
+  FieldType& u(void) { return parts_.at(0)->u(); }
+  FieldType& v(void) { return parts_.at(0)->v(); }
+};
+
+#endif
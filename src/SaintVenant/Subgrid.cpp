@@ -0,0 +1,205 @@
+/***********************************************************************
+ * mfcm SaintVenant/Subgrid.cpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#include "Subgrid.hpp"
+#include "Config.hpp"
+#include "Raster.hpp"
+#include <iomanip>
+#include <limits>
+
+template<typename T, typename Mesh>
+SaintVenantSubgrid<T,Mesh>::
+SaintVenantSubgrid(const std::shared_ptr<MeshType>& mesh,
+		   const std::string& dem_name,
+		   const size_t& nlevels,
+		   const size_t& nsamples)
+  : mesh_(mesh),
+    nlevels_(nlevels),
+    cell_tables_(mesh_->queue_ptr(),
+		 (nlevels + 2) * mesh_->template object_count<MeshComponent::Cell>(),
+		 ValueType(0.0), true),
+    face_tables_(mesh_->queue_ptr(),
+		 (nlevels + 2) * mesh_->template object_count<MeshComponent::Face>(),
+		 ValueType(0.0), true)
+{
+  const auto& dem = RasterDatabase<double>::instance().
+    get_raster_field_ptr(mesh_->queue_ptr(), dem_name);
+  if (not dem->is_on_device()) {
+    dem->move_to_device();
+  }
+
+  std::cout << "Building sub-grid tables from " << std::quoted(dem_name)
+	    << " with " << nlevels_ << " levels." << std::endl;
+
+  this->template build_<MeshComponent::Cell>(*dem, nsamples, cell_tables_);
+  this->template build_<MeshComponent::Face>(*dem, nsamples, face_tables_);
+}
+
+template<typename T, typename Mesh>
+std::shared_ptr<SaintVenantSubgrid<T,Mesh>>
+SaintVenantSubgrid<T,Mesh>::create(const std::shared_ptr<MeshType>& mesh)
+{
+  const Config& conf = GlobalConfig::instance().scheme_configuration();
+  std::string dem_name = conf.get<std::string>("subgrid bed", "");
+  if (dem_name == "") {
+    return nullptr;
+  }
+  size_t nlevels = conf.get<size_t>("subgrid levels", 16);
+  size_t nsamples = conf.get<size_t>("subgrid samples", 8);
+  if (nlevels < 2 or nsamples < 1) {
+    std::cerr << "ERROR: Sub-grid tables need at least 2 levels and 1 sample."
+	      << std::endl;
+    throw std::runtime_error("Invalid sub-grid configuration.");
+  }
+  return std::make_shared<SaintVenantSubgrid<T,Mesh>>(mesh, dem_name,
+						      nlevels, nsamples);
+}
+
+template<typename T, typename Mesh>
+template<MeshComponent C>
+void
+SaintVenantSubgrid<T,Mesh>::build_(const RasterField<double>& dem,
+				   const size_t& nsamples,
+				   DataArray<ValueType>& tables)
+{
+  using DEMAccessor = typename RasterField<double>::
+    template Accessor<sycl::access::mode::read>;
+
+  size_t n = mesh_->template object_count<C>();
+  size_t nlevels = nlevels_;
+  // Cells are sampled on a square grid of points, faces along a line
+  size_t npoints = (C == MeshComponent::Cell) ? nsamples * nsamples : nsamples;
+
+  mesh_->queue_ptr()->submit([&] (sycl::handler& cgh) {
+    typename MeshType::Accessor mesh_acc(*mesh_);
+    mesh_acc.bind(cgh);
+    DEMAccessor dem_acc(dem, cgh);
+    auto t_acc = tables.get_read_write_accessor(cgh);
+
+    cgh.parallel_for(sycl::range<1>(n), [=](sycl::item<1> item) {
+      size_t i = item.get_linear_id();
+      size_t b = (nlevels + 2) * i;
+      const double nan = std::numeric_limits<double>::quiet_NaN();
+
+      auto sample_dem = [&](const std::array<double,2>& loc) -> double
+      {
+	size_t j = dem_acc.mesh().template get_nearest_object_index<MeshComponent::Cell>(loc);
+	if (j < dem_acc.mesh().template object_count<MeshComponent::Cell>()) {
+	  return dem_acc.data()[j];
+	}
+	return nan;
+      };
+
+      // Bed level at the p-th sample point of object i. Along a face
+      // this is the higher of the DEM levels either side of it.
+      auto sample = [&](const size_t& p) -> double
+      {
+	double t = (double(p % nsamples) + 0.5) / double(nsamples) - 0.5;
+	if constexpr (C == MeshComponent::Cell) {
+	  auto c = mesh_acc.template get_object_location<MeshComponent::Cell>(i);
+	  double s = (double(p / nsamples) + 0.5) / double(nsamples) - 0.5;
+	  return sample_dem({ c[0] + t * mesh_acc.dx(i),
+			      c[1] + s * mesh_acc.dy(i) });
+	} else {
+	  auto c = mesh_acc.template get_object_location<MeshComponent::Face>(i);
+	  auto [ lhs_id, rhs_id, edge, dir, dx ] = mesh_acc.get_adjacent_cells(i);
+	  double z_m, z_p;
+	  if (dir == 0) {
+	    double len = sycl::fmin(mesh_acc.dy(lhs_id), mesh_acc.dy(rhs_id));
+	    double e = 0.5 * dem_acc.mesh().dx();
+	    z_m = sample_dem({ c[0] - e, c[1] + t * len });
+	    z_p = sample_dem({ c[0] + e, c[1] + t * len });
+	  } else {
+	    double len = sycl::fmin(mesh_acc.dx(lhs_id), mesh_acc.dx(rhs_id));
+	    double e = 0.5 * dem_acc.mesh().dy();
+	    z_m = sample_dem({ c[0] + t * len, c[1] - e });
+	    z_p = sample_dem({ c[0] + t * len, c[1] + e });
+	  }
+	  return sycl::fmax(z_m, z_p);
+	}
+      };
+
+      // Range of bed levels
+      double zmin = std::numeric_limits<double>::infinity();
+      double zmax = -std::numeric_limits<double>::infinity();
+      size_t nvalid = 0;
+      for (size_t p = 0; p < npoints; ++p) {
+	double z = sample(p);
+	if (z == z) {
+	  zmin = sycl::fmin(zmin, z);
+	  zmax = sycl::fmax(zmax, z);
+	  ++nvalid;
+	}
+      }
+      for (size_t k = 0; k < nlevels; ++k) {
+	t_acc[b + 2 + k] = T(0.0);
+      }
+      if (nvalid == 0) {
+	// Entirely coded out
+	t_acc[b] = T(nan);
+	t_acc[b + 1] = T(1.0);
+	return;
+      }
+      double dz = (zmax > zmin) ? (zmax - zmin) / double(nlevels - 1) : 1.0;
+      t_acc[b] = T(zmin);
+      t_acc[b + 1] = T(dz);
+
+      // Mean depth at each level over the parts that are not coded out
+      for (size_t p = 0; p < npoints; ++p) {
+	double z = sample(p);
+	if (z == z) {
+	  for (size_t k = 0; k < nlevels; ++k) {
+	    t_acc[b + 2 + k] += T(sycl::fmax(zmin + k * dz - z, 0.0) / nvalid);
+	  }
+	}
+      }
+    });
+  });
+}
+
+template<typename T, typename Mesh>
+void
+SaintVenantSubgrid<T,Mesh>::cell_base(CellFieldType& z) const
+{
+  size_t ncells = mesh_->template object_count<MeshComponent::Cell>();
+  size_t stride = nlevels_ + 2;
+  mesh_->queue_ptr()->submit([&] (sycl::handler& cgh) {
+    typename CellFieldType::template Accessor<sycl::access::mode::write> z_acc(z, cgh);
+    auto t_acc = cell_tables_.get_read_accessor(cgh);
+    cgh.parallel_for(sycl::range<1>(ncells), [=](sycl::item<1> item) {
+      size_t i = item.get_linear_id();
+      z_acc.data()[i] = t_acc[stride * i];
+    });
+  });
+}
+
+template<typename T, typename Mesh>
+void
+SaintVenantSubgrid<T,Mesh>::stage(const CellFieldType& h, CellFieldType& eta) const
+{
+  size_t ncells = mesh_->template object_count<MeshComponent::Cell>();
+  mesh_->queue_ptr()->submit([&] (sycl::handler& cgh) {
+    typename CellFieldType::template Accessor<sycl::access::mode::read> h_acc(h, cgh);
+    typename CellFieldType::template Accessor<sycl::access::mode::write> eta_acc(eta, cgh);
+    Accessor<true> sg_acc(this, cgh);
+    cgh.parallel_for(sycl::range<1>(ncells), [=](sycl::item<1> item) {
+      size_t i = item.get_linear_id();
+      eta_acc.data()[i] = sg_acc.cell_level(i, h_acc.data()[i]);
+    });
+  });
+}
@@ -0,0 +1,252 @@
+/***********************************************************************
+ * mfcm SaintVenant/Subgrid.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_SaintVenant_Subgrid_hpp
+#define mfcm_SaintVenant_Subgrid_hpp
+
+#include "Field.hpp"
+#include "RasterFormat.hpp"
+#include <memory>
+
+template<typename T,
+	 typename Mesh,
+	 bool Enabled>
+class SaintVenantSubgridAccessor;
+
+/**
+   Sub-grid bathymetry tables, which allow the solver to run on cells
+   much coarser than the DEM while still representing features (such
+   as small channels and embankments) that the DEM resolves.
+
+   For each cell the table gives the mean water depth over the cell
+   (i.e. the stored volume divided by the cell area) at a number of
+   water levels, from the lowest DEM level in the cell to the
+   highest. For each face it gives the mean flow depth across the face
+   (the flow area divided by the face length), where the bed along the
+   face is the higher of the DEM levels either side of it. Between
+   table levels depths are interpolated linearly, and above the top
+   level every part of the object is wet so depth increases with level.
+
+   Each table is stored as the base level, the level interval and the
+   depths at each level. The tables are built from the raster named by
+   "subgrid bed" in the scheme configuration, sampling "subgrid
+   samples" points across each cell side (default 8) and using
+   "subgrid levels" levels (default 16).
+
+   When sub-grid tables are used the water depth in the state is the
+   mean depth over each cell, and the bed level of each cell is its
+   lowest DEM level.
+ */
+template<typename T,
+	 typename Mesh>
+class SaintVenantSubgrid
+{
+public:
+
+  using ValueType = T;
+  using MeshType = Mesh;
+  using CellFieldType = CellField<ValueType,MeshType>;
+
+  template<bool Enabled>
+  using Accessor = SaintVenantSubgridAccessor<ValueType,MeshType,Enabled>;
+
+private:
+
+  std::shared_ptr<MeshType> mesh_;
+
+  size_t nlevels_;
+
+  DataArray<ValueType> cell_tables_;
+
+  DataArray<ValueType> face_tables_;
+
+  template<MeshComponent C>
+  void build_(const RasterField<double>& dem,
+	      const size_t& nsamples,
+	      DataArray<ValueType>& tables);
+
+public:
+
+  SaintVenantSubgrid(const std::shared_ptr<MeshType>& mesh,
+		     const std::string& dem_name,
+		     const size_t& nlevels,
+		     const size_t& nsamples);
+
+  /**
+     Create sub-grid tables if the scheme configuration asks for
+     them, otherwise return a null pointer.
+   */
+  static std::shared_ptr<SaintVenantSubgrid<ValueType,MeshType>>
+  create(const std::shared_ptr<MeshType>& mesh);
+
+  const size_t& nlevels(void) const { return nlevels_; }
+
+  const DataArray<ValueType>& cell_tables(void) const { return cell_tables_; }
+
+  const DataArray<ValueType>& face_tables(void) const { return face_tables_; }
+
+  /**
+     Set z to the lowest bed level in each cell.
+   */
+  void cell_base(CellFieldType& z) const;
+
+  /**
+     Set eta to the water level in each cell given the mean depth h.
+   */
+  void stage(const CellFieldType& h, CellFieldType& eta) const;
+
+};
+
+/**
+   Device access to sub-grid tables. If Enabled is false the accessor
+   binds nothing, so that kernels instantiated without sub-grid
+   bathymetry do not need tables.
+ */
+template<typename T,
+	 typename Mesh>
+class SaintVenantSubgridAccessor<T,Mesh,true>
+{
+public:
+
+  using ValueType = T;
+
+  using SubgridType = SaintVenantSubgrid<T,Mesh>;
+
+  using TableAccessor = typename DataArray<ValueType>::
+    template Accessor<sycl::access::mode::read>;
+
+private:
+
+  size_t nlevels_;
+
+  TableAccessor cell_tables_;
+
+  TableAccessor face_tables_;
+
+  /**
+     Return the depth in table i at level eta.
+   */
+  ValueType depth(const TableAccessor& t, const size_t& i,
+		  const ValueType& eta) const
+  {
+    size_t b = (nlevels_ + 2) * i;
+    ValueType z0 = t[b];
+    ValueType dz = t[b + 1];
+    if (not (eta > z0)) {
+      return ValueType(0.0);
+    }
+    ValueType k = (eta - z0) / dz;
+    if (k >= ValueType(nlevels_ - 1)) {
+      return t[b + 1 + nlevels_] + (eta - z0 - ValueType(nlevels_ - 1) * dz);
+    }
+    size_t k0 = size_t(k);
+    ValueType r = k - ValueType(k0);
+    return (ValueType(1.0) - r) * t[b + 2 + k0] + r * t[b + 3 + k0];
+  }
+
+public:
+
+  SaintVenantSubgridAccessor(const SubgridType* sg, sycl::handler& cgh)
+    : nlevels_(sg->nlevels()),
+      cell_tables_(sg->cell_tables().get_read_accessor(cgh)),
+      face_tables_(sg->face_tables().get_read_accessor(cgh))
+  {}
+
+  /**
+     Lowest bed level of face f.
+   */
+  ValueType face_base(const size_t& f) const
+  {
+    return face_tables_[(nlevels_ + 2) * f];
+  }
+
+  /**
+     Mean depth over cell i when the water level is eta.
+   */
+  ValueType cell_depth(const size_t& i, const ValueType& eta) const
+  {
+    return depth(cell_tables_, i, eta);
+  }
+
+  /**
+     Mean flow depth across face f when the water level is eta.
+   */
+  ValueType face_depth(const size_t& f, const ValueType& eta) const
+  {
+    return depth(face_tables_, f, eta);
+  }
+
+  /**
+     Water level in cell i when the mean depth is h. This is the
+     inverse of cell_depth.
+   */
+  ValueType cell_level(const size_t& i, const ValueType& h) const
+  {
+    size_t b = (nlevels_ + 2) * i;
+    ValueType z0 = cell_tables_[b];
+    ValueType dz = cell_tables_[b + 1];
+    if (not (h > ValueType(0.0))) {
+      return z0;
+    }
+    ValueType h_top = cell_tables_[b + 1 + nlevels_];
+    if (h >= h_top) {
+      return z0 + ValueType(nlevels_ - 1) * dz + (h - h_top);
+    }
+    // Depths increase with level, so find the interval containing h
+    size_t lo = 0;
+    size_t hi = nlevels_ - 1;
+    while (hi - lo > 1) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (cell_tables_[b + 2 + mid] <= h) {
+	lo = mid;
+      } else {
+	hi = mid;
+      }
+    }
+    ValueType h0 = cell_tables_[b + 2 + lo];
+    ValueType h1 = cell_tables_[b + 2 + hi];
+    ValueType r = (h1 > h0) ? (h - h0) / (h1 - h0) : ValueType(0.0);
+    return z0 + (ValueType(lo) + r) * dz;
+  }
+
+};
+
+template<typename T,
+	 typename Mesh>
+class SaintVenantSubgridAccessor<T,Mesh,false>
+{
+public:
+
+  using ValueType = T;
+
+  using SubgridType = SaintVenantSubgrid<T,Mesh>;
+
+  SaintVenantSubgridAccessor(const SubgridType* sg, sycl::handler& cgh)
+  {}
+
+  ValueType face_base(const size_t& f) const { return ValueType(0.0); }
+
+  ValueType cell_depth(const size_t& i, const ValueType& eta) const { return ValueType(0.0); }
+
+  ValueType face_depth(const size_t& f, const ValueType& eta) const { return ValueType(0.0); }
+
+  ValueType cell_level(const size_t& i, const ValueType& h) const { return ValueType(0.0); }
+
+};
+
+#endif
@@ -19,8 +19,9 @@
 #include "TemporalDerivativeKernel.hpp"
 
 template<typename T,
-	 typename Mesh>
-SaintVenantTemporalDerivativeKernel<T,Mesh>::
+	 typename Mesh,
+	 bool ReconstructSlopes>
+SaintVenantTemporalDerivativeKernel<T,Mesh,ReconstructSlopes>::
 SaintVenantTemporalDerivativeKernel(sycl::handler& cgh,
 				    const State& U,
 				    const Constants& K,
@@ -41,30 +42,97 @@ SaintVenantTemporalDerivativeKernel(sycl::handler& cgh,
 }
 
 template<typename T,
-	 typename Mesh>
+	 typename Mesh,
+	 bool ReconstructSlopes>
 void
-SaintVenantTemporalDerivativeKernel<T,Mesh>::
-operator()(sycl::item<1> item) const
+SaintVenantTemporalDerivativeKernel<T,Mesh,ReconstructSlopes>::
+operator()(sycl::id<1> idx) const
 {
-  size_t cell_c = item.get_linear_id();
+  size_t cell_c = idx[0];
     
-  // Get the surrounding face IDs
   auto mesh_acc = h_.mesh();
-  auto [ face_w, face_e, dx, face_s, face_n, dy ] =
-    mesh_acc.get_adjacent_faces(cell_c);
+  ValueType dhdt, dudt, dvdt, dudt_wall, dvdt_wall, dx, dy;
 
-  // Calculate the changes in each variable due to the h, u and v fluxes
-  ValueType dhdt = (hflux_.data()[face_w] - hflux_.data()[face_e]) / dx
-    + (hflux_.data()[face_s] - hflux_.data()[face_n]) / dy;
-  ValueType dudt = (uflux_.data()[face_w] - uflux_.data()[face_e]) / dx
-    + (uflux_.data()[face_s] - uflux_.data()[face_n]) / dy;
-  ValueType dvdt = (vflux_.data()[face_w] - vflux_.data()[face_e]) / dx
-    + (vflux_.data()[face_s] - vflux_.data()[face_n]) / dy;
+  if constexpr (MeshType::has_face_normals) {
+    // Faces have arbitrary orientations, so sum the fluxes over every
+    // face of the cell. Fluxes are per unit length of face in the
+    // direction of its normal, which points from its lhs cell to its
+    // rhs cell. The widths of the cell limit the bed slope below.
+    ValueType area = mesh_acc.cell_area(cell_c);
+    dx = mesh_acc.dx(cell_c);
+    dy = mesh_acc.dy(cell_c);
+    dhdt = ValueType(0.0);
+    dudt = ValueType(0.0);
+    dvdt = ValueType(0.0);
+    dudt_wall = ValueType(0.0);
+    dvdt_wall = ValueType(0.0);
+    for (size_t k = 0; k < MeshType::max_cell_faces; ++k) {
+      size_t f = mesh_acc.cell_face(cell_c, k);
+      if (f == mesh_acc.template object_count<MeshComponent::Face>()) {
+	break;
+      }
+      auto adj = mesh_acc.get_adjacent_cells(f);
+      ValueType w = mesh_acc.face_length(f) / area;
+      if (adj.rhs_id != cell_c or adj.edge == 1) {
+	w = -w;
+      }
+      auto n = mesh_acc.face_normal(f);
+      dhdt += w * hflux_.data()[f];
+      dudt += w * uflux_.data()[f];
+      dvdt += w * vflux_.data()[f];
+      dudt_wall += w * zflux_.data()[f] * ValueType(n[0]);
+      dvdt_wall += w * zflux_.data()[f] * ValueType(n[1]);
+    }
+  } else {
+    // Get the surrounding face IDs
+    auto [ face_w, face_e, dx_c, face_s, face_n, dy_c ] =
+      mesh_acc.get_adjacent_faces(cell_c);
+    auto [ face_w2, face_e2, face_s2, face_n2 ] =
+      mesh_acc.get_hanging_faces(cell_c);
+    dx = dx_c;
+    dy = dy_c;
+
+    // Flux across one side of the cell. If the mesh has hanging faces
+    // the side may be split between two faces of half its length, so
+    // the flux is the mean of the two.
+    auto side_flux = [](const FaceReadAccessor& flux,
+			const size_t& f1, const size_t& f2) -> ValueType
+    {
+      if constexpr (MeshType::has_hanging_faces) {
+	return ValueType(0.5) * (flux.data()[f1] + flux.data()[f2]);
+      } else {
+	return flux.data()[f1];
+      }
+    };
+
+    // Calculate the changes in each variable due to the h, u and v fluxes
+    dhdt = (side_flux(hflux_, face_w, face_w2) -
+	    side_flux(hflux_, face_e, face_e2)) / dx
+      + (side_flux(hflux_, face_s, face_s2) -
+	 side_flux(hflux_, face_n, face_n2)) / dy;
+    dudt = (side_flux(uflux_, face_w, face_w2) -
+	    side_flux(uflux_, face_e, face_e2)) / dx
+      + (side_flux(uflux_, face_s, face_s2) -
+	 side_flux(uflux_, face_n, face_n2)) / dy;
+    dvdt = (side_flux(vflux_, face_w, face_w2) -
+	    side_flux(vflux_, face_e, face_e2)) / dx
+      + (side_flux(vflux_, face_s, face_s2) -
+	 side_flux(vflux_, face_n, face_n2)) / dy;
+
+    // Calculate the forces on the water in the cell due to vertical
+    // walls at the cell faces (the zflux_ term)
+    dudt_wall = (side_flux(zflux_, face_w, face_w2) -
+		 side_flux(zflux_, face_e, face_e2)) / dx;
+    dvdt_wall = (side_flux(zflux_, face_s, face_s2) -
+		 side_flux(zflux_, face_n, face_n2)) / dy;
+  }
 
   // Calculate the horizontal forces on the cell due to the water
   // depth slope:
-  dudt += dhdx_.data()[cell_c] * ValueType(-9.81);
-  dvdt += dhdy_.data()[cell_c] * ValueType(-9.81);
+  dudt += cell_slope<ReconstructSlopes,SpatialDerivativeAxis::X>(h_, dhdx_, cell_c)
+    * ValueType(-9.81);
+  dvdt += cell_slope<ReconstructSlopes,SpatialDerivativeAxis::Y>(h_, dhdy_, cell_c)
+    * ValueType(-9.81);
   
   // Calculate the cell's bed slope and apply the horizontal
   // component of the gravity reaction force. The magnitude of this
@@ -80,11 +148,10 @@ operator()(sycl::item<1> item) const
   ValueType dudt_bed = ValueType(-9.81) * dzdx;
   ValueType dvdt_bed = ValueType(-9.81) * dzdy;
 
-  // Calculate the forces on the water in the cell due to vertical
-  // walls at the cell faces (the zflux_ term) and add this to our
+  // Add the forces due to vertical walls at the cell faces to our
   // momentum terms d[uv]dt
-  dudt += (zflux_.data()[face_w] - zflux_.data()[face_e]) / dx;
-  dvdt += (zflux_.data()[face_s] - zflux_.data()[face_n]) / dy;
+  dudt += dudt_wall;
+  dvdt += dvdt_wall;
 
   dudt += dudt_bed;
   dvdt += dvdt_bed;
@@ -19,8 +19,16 @@
 #ifndef mfcm_SaintVenant_TemporalDerivativeKernel_hpp
 #define mfcm_SaintVenant_TemporalDerivativeKernel_hpp
 
+#include "SlopeReconstruction.hpp"
+
+/**
+   Kernel to calculate the temporal derivative of the state in each
+   cell. If ReconstructSlopes is true, the depth slopes are recomputed
+   from the state rather than read from dUdx and dUdy.
+ */
 template<typename T,
-	 typename Mesh>
+	 typename Mesh,
+	 bool ReconstructSlopes = false>
 class SaintVenantTemporalDerivativeKernel
 {
 public:
@@ -86,7 +94,7 @@ public:
 				      const double& time_now,
 				      const double& timestep);
 
-  void operator()(sycl::item<1> item) const;
+  void operator()(sycl::id<1> idx) const;
   
 };
 
@@ -25,13 +25,14 @@ template<typename T,
 template<SpatialDerivativeAxis Axis>
 void
 SpatialDerivativeOperator<T,Mesh,FieldMapping,OperatorFn>::
-apply(const FieldType& s, FieldType& d)
+apply(const FieldType& s, FieldType& d,
+      const LaunchConfiguration& lc)
 {
   MeshSelection<Mesh,FieldMapping> ms(d.mesh());
   return SpatialDerivativeOperator<T,
 				   Mesh,
 				   FieldMapping,
-				   OperatorFn>::apply<Axis>(s, d, ms);
+				   OperatorFn>::apply<Axis>(s, d, ms, lc);
 }
 
 template<typename T,
@@ -42,7 +43,8 @@ template<SpatialDerivativeAxis Axis>
 void
 SpatialDerivativeOperator<T,Mesh,FieldMapping,OperatorFn>::
 apply(const FieldType& s, FieldType& d,
-      const SelectionType& selection)
+      const SelectionType& selection,
+      const LaunchConfiguration& lc)
 {
   if (s.is_on_device()) {
     if (not d.is_on_device()) {
@@ -56,16 +58,20 @@ apply(const FieldType& s, FieldType& d,
 			     "context in spatial derivative operator");
     }
 
-    op_queue.submit([&](sycl::handler& cgh)
+    selection.dispatch([&](auto encoding)
     {
-      auto op_kernel =
-	SpatialDerivativeOperationKernel<SpatialDerivativeOperator<ValueType,
-								   MeshType,
-								   FieldMappingType,
-								   OperatorFn>,
-					 Axis>
-	(cgh, s, d, selection);
-      cgh.parallel_for(sycl::range<1>(selection.size()), op_kernel);
+      op_queue.submit([&](sycl::handler& cgh)
+      {
+	auto op_kernel =
+	  SpatialDerivativeOperationKernel<SpatialDerivativeOperator<ValueType,
+								     MeshType,
+								     FieldMappingType,
+								     OperatorFn>,
+					   Axis,
+					   decltype(encoding)::value>
+	  (cgh, s, d, selection);
+	launch_kernel(cgh, selection.size(), op_kernel, lc);
+      });
     });
   } else {
     if (d.is_on_device()) {
@@ -21,6 +21,7 @@
 
 #include "Field.hpp"
 #include "MeshSelection.hpp"
+#include "launch.hpp"
 
 enum class SpatialDerivativeAxis {
   X,
@@ -46,11 +47,13 @@ public:
 				      FieldMappingType>;
 
   template<SpatialDerivativeAxis Axis>
-  static void apply(const FieldType& s, FieldType& d);
+  static void apply(const FieldType& s, FieldType& d,
+		    const LaunchConfiguration& lc = LaunchConfiguration());
 
   template<SpatialDerivativeAxis Axis>
   static void apply(const FieldType& s, FieldType& d,
-		    const SelectionType& selection);
+		    const SelectionType& selection,
+		    const LaunchConfiguration& lc = LaunchConfiguration());
   
   constexpr ValueType operator()(const ValueType& l,
 				 const double& dxl,
@@ -60,11 +63,34 @@ public:
   {
     return Op()(l,dxl,c,dxr,r);
   }
+
+  /**
+     Calculate the derivative of a field at object i from the object
+     and its two neighbours along the given axis. Source is any field
+     accessor, so that the derivative can be reconstructed inside
+     other kernels instead of being read from a stored field.
+   */
+  template<SpatialDerivativeAxis Axis,
+	   typename SourceAccessor>
+  static ValueType stencil(const SourceAccessor& s, const size_t& i)
+  {
+    const auto& mesh_ro = s.mesh();
+    if constexpr (Axis == SpatialDerivativeAxis::X) {
+      auto [il, dxl] { mesh_ro.template get_object_west<FieldMappingType>(i) };
+      auto [ir, dxr] { mesh_ro.template get_object_east<FieldMappingType>(i) };
+      return Op()(s.data()[il], dxl, s.data()[i], dxr, s.data()[ir]);
+    } else {
+      auto [il, dxl] { mesh_ro.template get_object_north<FieldMappingType>(i) };
+      auto [ir, dxr] { mesh_ro.template get_object_south<FieldMappingType>(i) };
+      return Op()(s.data()[il], dxl, s.data()[i], dxr, s.data()[ir]);
+    }
+  }
   
 };
 
 template<typename SDO,
-	 SpatialDerivativeAxis Axis>
+	 SpatialDerivativeAxis Axis,
+	 MeshSelectionEncoding Encoding>
 class SpatialDerivativeOperationKernel
 {
 public:
@@ -78,7 +104,7 @@ public:
   using DestAccessor =
     typename FieldType::template Accessor<sycl::access::mode::write>;
   using DestSelectionAccessor =
-    typename SelectionType::Accessor;
+    typename SelectionType::template Accessor<Encoding>;
 
 private:
 
@@ -101,24 +127,10 @@ public:
     d_sel_ro_.bind(cgh);
   }
 
-  void operator()(sycl::item<1> item) const
+  void operator()(sycl::id<1> idx) const
   {
-    size_t i = d_sel_ro_(item.get_linear_id());
-    const auto& mesh_ro = s_ro_.mesh();
-    if constexpr (Axis == SpatialDerivativeAxis::X) {
-      auto [il, dxl] { mesh_ro.template get_object_west<FieldMappingType>(i) };
-      auto [ir, dxr] { mesh_ro.template get_object_east<FieldMappingType>(i) };
-      d_wo_.data()[i] = SDO()(s_ro_.data()[il], dxl,
-			      s_ro_.data()[i], dxr,
-			      s_ro_.data()[ir]);			      
-    } else {
-      auto [il, dxl] { mesh_ro.template get_object_north<FieldMappingType>(i) };
-      auto [ir, dxr] { mesh_ro.template get_object_south<FieldMappingType>(i) };
-      d_wo_.data()[i] = SDO()(s_ro_.data()[il], dxl,
-			      s_ro_.data()[i], dxr,
-			      s_ro_.data()[ir]);
-    }
-
+    size_t i = d_sel_ro_(idx[0]);
+    d_wo_.data()[i] = SDO::template stencil<Axis>(s_ro_, i);
   }
   
 };
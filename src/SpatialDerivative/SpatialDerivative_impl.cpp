@@ -23,14 +23,73 @@
 #include "SpatialDerivative.cpp"
 #include "Minmod3.hpp"
 #include "Cartesian2DMesh.hpp"
+#include "QuadtreeMesh.hpp"
+#include "RectilinearMesh.hpp"
+#include "SparseCartesian2DMesh.hpp"
+#include "UnstructuredMesh.hpp"
+#include "MultiCartesian2DMesh.hpp"
 
 template class SpatialDerivativeOperator<float, Cartesian2DMesh, MeshComponent::Cell, Minmod3<float>>;
 //template class SpatialDerivativeOperator<float, Cartesian2DMesh, MeshComponent::Cell, Minmod3<float>>;
 template class SpatialDerivativeOperator<double, Cartesian2DMesh, MeshComponent::Cell, Minmod3<double>>;
 //template class SpatialDerivativeOperator<double, Cartesian2DMesh, MeshComponent::Cell, Minmod3<double>>;
 
-template void SpatialDerivativeOperator<float, Cartesian2DMesh, MeshComponent::Cell, Minmod3<float>>::apply<SpatialDerivativeAxis::X>(const FieldType& s, FieldType& d);
-template void SpatialDerivativeOperator<float, Cartesian2DMesh, MeshComponent::Cell, Minmod3<float>>::apply<SpatialDerivativeAxis::Y>(const FieldType& s, FieldType& d);
+template void SpatialDerivativeOperator<float, Cartesian2DMesh, MeshComponent::Cell, Minmod3<float>>::apply<SpatialDerivativeAxis::X>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+template void SpatialDerivativeOperator<float, Cartesian2DMesh, MeshComponent::Cell, Minmod3<float>>::apply<SpatialDerivativeAxis::Y>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
 
-template void SpatialDerivativeOperator<double, Cartesian2DMesh, MeshComponent::Cell, Minmod3<double>>::apply<SpatialDerivativeAxis::X>(const FieldType& s, FieldType& d);
-template void SpatialDerivativeOperator<double, Cartesian2DMesh, MeshComponent::Cell, Minmod3<double>>::apply<SpatialDerivativeAxis::Y>(const FieldType& s, FieldType& d);
+template void SpatialDerivativeOperator<double, Cartesian2DMesh, MeshComponent::Cell, Minmod3<double>>::apply<SpatialDerivativeAxis::X>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+template void SpatialDerivativeOperator<double, Cartesian2DMesh, MeshComponent::Cell, Minmod3<double>>::apply<SpatialDerivativeAxis::Y>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+
+template class SpatialDerivativeOperator<float, TiledCartesian2DMesh, MeshComponent::Cell, Minmod3<float>>;
+template class SpatialDerivativeOperator<double, TiledCartesian2DMesh, MeshComponent::Cell, Minmod3<double>>;
+
+template void SpatialDerivativeOperator<float, TiledCartesian2DMesh, MeshComponent::Cell, Minmod3<float>>::apply<SpatialDerivativeAxis::X>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+template void SpatialDerivativeOperator<float, TiledCartesian2DMesh, MeshComponent::Cell, Minmod3<float>>::apply<SpatialDerivativeAxis::Y>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+
+template void SpatialDerivativeOperator<double, TiledCartesian2DMesh, MeshComponent::Cell, Minmod3<double>>::apply<SpatialDerivativeAxis::X>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+template void SpatialDerivativeOperator<double, TiledCartesian2DMesh, MeshComponent::Cell, Minmod3<double>>::apply<SpatialDerivativeAxis::Y>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+
+template class SpatialDerivativeOperator<float, QuadtreeMesh, MeshComponent::Cell, Minmod3<float>>;
+template class SpatialDerivativeOperator<double, QuadtreeMesh, MeshComponent::Cell, Minmod3<double>>;
+
+template void SpatialDerivativeOperator<float, QuadtreeMesh, MeshComponent::Cell, Minmod3<float>>::apply<SpatialDerivativeAxis::X>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+template void SpatialDerivativeOperator<float, QuadtreeMesh, MeshComponent::Cell, Minmod3<float>>::apply<SpatialDerivativeAxis::Y>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+
+template void SpatialDerivativeOperator<double, QuadtreeMesh, MeshComponent::Cell, Minmod3<double>>::apply<SpatialDerivativeAxis::X>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+template void SpatialDerivativeOperator<double, QuadtreeMesh, MeshComponent::Cell, Minmod3<double>>::apply<SpatialDerivativeAxis::Y>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+
+template class SpatialDerivativeOperator<float, RectilinearMesh, MeshComponent::Cell, Minmod3<float>>;
+template class SpatialDerivativeOperator<double, RectilinearMesh, MeshComponent::Cell, Minmod3<double>>;
+
+template void SpatialDerivativeOperator<float, RectilinearMesh, MeshComponent::Cell, Minmod3<float>>::apply<SpatialDerivativeAxis::X>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+template void SpatialDerivativeOperator<float, RectilinearMesh, MeshComponent::Cell, Minmod3<float>>::apply<SpatialDerivativeAxis::Y>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+
+template void SpatialDerivativeOperator<double, RectilinearMesh, MeshComponent::Cell, Minmod3<double>>::apply<SpatialDerivativeAxis::X>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+template void SpatialDerivativeOperator<double, RectilinearMesh, MeshComponent::Cell, Minmod3<double>>::apply<SpatialDerivativeAxis::Y>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+
+template class SpatialDerivativeOperator<float, SparseCartesian2DMesh, MeshComponent::Cell, Minmod3<float>>;
+template class SpatialDerivativeOperator<double, SparseCartesian2DMesh, MeshComponent::Cell, Minmod3<double>>;
+
+template void SpatialDerivativeOperator<float, SparseCartesian2DMesh, MeshComponent::Cell, Minmod3<float>>::apply<SpatialDerivativeAxis::X>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+template void SpatialDerivativeOperator<float, SparseCartesian2DMesh, MeshComponent::Cell, Minmod3<float>>::apply<SpatialDerivativeAxis::Y>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+
+template void SpatialDerivativeOperator<double, SparseCartesian2DMesh, MeshComponent::Cell, Minmod3<double>>::apply<SpatialDerivativeAxis::X>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+template void SpatialDerivativeOperator<double, SparseCartesian2DMesh, MeshComponent::Cell, Minmod3<double>>::apply<SpatialDerivativeAxis::Y>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+
+template class SpatialDerivativeOperator<float, UnstructuredMesh, MeshComponent::Cell, Minmod3<float>>;
+template class SpatialDerivativeOperator<double, UnstructuredMesh, MeshComponent::Cell, Minmod3<double>>;
+
+template void SpatialDerivativeOperator<float, UnstructuredMesh, MeshComponent::Cell, Minmod3<float>>::apply<SpatialDerivativeAxis::X>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+template void SpatialDerivativeOperator<float, UnstructuredMesh, MeshComponent::Cell, Minmod3<float>>::apply<SpatialDerivativeAxis::Y>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+
+template void SpatialDerivativeOperator<double, UnstructuredMesh, MeshComponent::Cell, Minmod3<double>>::apply<SpatialDerivativeAxis::X>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+template void SpatialDerivativeOperator<double, UnstructuredMesh, MeshComponent::Cell, Minmod3<double>>::apply<SpatialDerivativeAxis::Y>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+
+template class SpatialDerivativeOperator<float, MultiCartesian2DMesh, MeshComponent::Cell, Minmod3<float>>;
+template class SpatialDerivativeOperator<double, MultiCartesian2DMesh, MeshComponent::Cell, Minmod3<double>>;
+
+template void SpatialDerivativeOperator<float, MultiCartesian2DMesh, MeshComponent::Cell, Minmod3<float>>::apply<SpatialDerivativeAxis::X>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+template void SpatialDerivativeOperator<float, MultiCartesian2DMesh, MeshComponent::Cell, Minmod3<float>>::apply<SpatialDerivativeAxis::Y>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+
+template void SpatialDerivativeOperator<double, MultiCartesian2DMesh, MeshComponent::Cell, Minmod3<double>>::apply<SpatialDerivativeAxis::X>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
+template void SpatialDerivativeOperator<double, MultiCartesian2DMesh, MeshComponent::Cell, Minmod3<double>>::apply<SpatialDerivativeAxis::Y>(const FieldType& s, FieldType& d, const LaunchConfiguration& lc);
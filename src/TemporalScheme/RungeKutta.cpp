@@ -151,9 +151,17 @@ RungeKuttaTemporalScheme<T>::do_timestep(const TimeType& local_time,
     this->update_k(substep, substep_time, dt);
     this->update_y(substep, dt);
   }
-  double cn_target = 1.0;
   double cn = this->get_latest_control_number(dt);
   // std::cout << "Step control number: " << cn << std::endl;
+  return control_timestep(dt, cn);
+}
+
+template<typename T>
+typename RungeKuttaTemporalScheme<T>::timestep_result
+RungeKuttaTemporalScheme<T>::control_timestep(const TimeType& dt,
+					      const double& cn) const
+{
+  double cn_target = 1.0;
   if (cn > cn_target) {
     if (cn > 5.0 * cn_target) {
       return { TimeType(dt / 5.0), true };
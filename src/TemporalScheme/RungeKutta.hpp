@@ -234,6 +234,16 @@ protected:
   virtual timestep_result do_timestep(const TimeType& local_time,
 				      const TimeType& dt);
 
+  /**
+     Decide from the control number of a timestep whether it must be
+     repeated, and the duration of the next one.
+
+     @param[in] dt The duration of the timestep.
+     @param[in] cn The control number of the timestep.
+  */
+  timestep_result control_timestep(const TimeType& dt,
+				   const double& cn) const;
+
   /**
      Get the control number from the result of the last timestep.
 
@@ -302,8 +312,10 @@ public:
 					   tparams)),
       step_debugging_(step_debugging)
   {
+    std::shared_ptr<OutputWriter> writer = make_output_writer();
     for (auto&& name : GlobalConfig::instance().output_files_list()) {
-      outputs_.push_back(make_field_output_file<SolverType>(name, tparams, solver_));
+      outputs_.push_back(make_field_output_file<SolverType>(name, tparams, solver_,
+							    writer));
     }
   }
 
@@ -325,11 +337,38 @@ public:
 					   tparams)),
       step_debugging_(step_debugging)
   {
+    std::shared_ptr<OutputWriter> writer = make_output_writer();
     for (auto&& name : GlobalConfig::instance().output_files_list()) {
-      outputs_.push_back(make_field_output_file<SolverType>(name, tparams, solver_));
+      outputs_.push_back(make_field_output_file<SolverType>(name, tparams, solver_,
+							    writer));
     }
   }
 
+  /**
+     Constructor from a set of named coefficients, a solver and its
+     output files, such as those of the models packed by a
+     SaintVenantPackedSolver.
+
+     @param[in] tparams Pointer to the time parameters object.
+     @param[in] coeffs Runge Kutta coefficients
+     @param[in] solver Pointer to the solver, which must store one
+     more state than the scheme has stages.
+     @param[in] outputs The output files.
+     @param[in] step_debugging Boolean to turn on super-verbose
+     outputs for debugging the numerical scheme.
+  */
+  RungeKuttaSolver(const std::shared_ptr<TimeParameters<TimeType>>& tparams,
+		   const std::string& named_coeffs,
+		   const std::shared_ptr<SolverType>& solver,
+		   const std::vector<std::shared_ptr<OutputFileType>>& outputs,
+		   bool step_debugging = false)
+    : RungeKuttaTemporalScheme<TimeType>(tparams, named_coeffs),
+      solver_(solver),
+      outputs_(outputs),
+      step_debugging_(step_debugging)
+  {
+  }
+
 protected:
   
   /**
@@ -350,8 +389,7 @@ protected:
     solver_->update_dUdt(step - 1, substep_time, timestep);
 
     if (step_debugging_) {
-      using FieldType = Field<typename SolverType::ValueType,
-			      typename SolverType::MeshType,MeshComponent::Cell>;
+      using FieldType = std::remove_reference_t<decltype(solver_->dUdt(0).h())>;
       FieldCheckFile<FieldType> cf("step debugging");
       cf.set_output_filename(GlobalConfig::instance().simulation_base_path() /
 			     "check" /
@@ -392,8 +430,7 @@ protected:
     }
 
     if (step_debugging_) {
-      using FieldType = Field<typename SolverType::ValueType,
-			      typename SolverType::MeshType,MeshComponent::Cell>;
+      using FieldType = std::remove_reference_t<decltype(solver_->dUdt(0).h())>;
       FieldCheckFile<FieldType> cf("step debugging");
       cf.set_output_filename(GlobalConfig::instance().simulation_base_path() /
 			     "check" /
@@ -448,6 +485,18 @@ public:
     }
   }
 
+  /**
+     Compute the solution, and wait for the outputs written in the
+     background, so that a failure to write one is thrown from here.
+  */
+  virtual void solve(void)
+  {
+    RungeKuttaTemporalScheme<TimeType>::solve();
+    for (auto&& output : outputs_) {
+      output->wait();
+    }
+  }
+
   /**
      Prepare the solver to start a new step. This method is used to
      update values in boundary conditions, source terms and the like.
@@ -462,4 +511,146 @@ public:
   
 };
 
+/**
+   Glue class linking the RungeKuttaTemporalScheme to a solver whose
+   mesh is made of blocks that each take a timestep of their own, such
+   as SaintVenantPackedSolver.
+
+   Each block advances through the step with the timestep allowed by
+   its control number, which it repeats on its own, and stops at the
+   end of the step. At each timestep the solver is given the local
+   time and the timestep of each block (zero for a block that has
+   finished the step), and the stages are evaluated at the fraction
+   c_i of the timestep with a unit timestep, since the solver scales
+   the derivatives of each block by its timestep.
+
+   @tparam Solver The type of solver object.
+*/
+template<typename Solver>
+class RungeKuttaBlockSolver : public RungeKuttaSolver<Solver>
+{
+public:
+
+  using TimeType = typename Solver::TimeType;
+  using SolverType = Solver;
+
+protected:
+
+  using step_result = typename TypedTemporalScheme<TimeType>::step_result;
+  
+  /**
+     Current timestep of each block.
+  */
+  std::vector<TimeType> block_dt_;
+
+public:
+
+  /**
+     Constructor from a set of named coefficients
+
+     @param[in] tparams Pointer to the time parameters object.
+     @param[in] coeffs Runge Kutta coefficients
+     @param[in] queue Pointer to the SYCL queue object
+     @param[in] step_debugging Boolean to turn on super-verbose
+     outputs for debugging the numerical scheme.
+  */
+  RungeKuttaBlockSolver(const std::shared_ptr<TimeParameters<TimeType>>& tparams,
+			const std::string& named_coeffs,
+			const std::shared_ptr<sycl::queue>& queue,
+			bool step_debugging = false)
+    : RungeKuttaSolver<Solver>(tparams, named_coeffs, queue, step_debugging),
+      block_dt_(this->solver_->block_count(), tparams->initial_timestep())
+  {
+  }
+
+  /**
+     Constructor from a set of named coefficients, a solver and its
+     output files (see RungeKuttaSolver).
+  */
+  RungeKuttaBlockSolver(const std::shared_ptr<TimeParameters<TimeType>>& tparams,
+			const std::string& named_coeffs,
+			const std::shared_ptr<SolverType>& solver,
+			const std::vector<std::shared_ptr<typename RungeKuttaSolver<Solver>::OutputFileType>>& outputs,
+			bool step_debugging = false)
+    : RungeKuttaSolver<Solver>(tparams, named_coeffs, solver, outputs, step_debugging),
+      block_dt_(this->solver_->block_count(), tparams->initial_timestep())
+  {
+  }
+
+protected:
+
+  /**
+     Compute a computational step, in which each block takes its own
+     timesteps (see TypedTemporalScheme::step).
+  */
+  virtual step_result step(void)
+  {
+    step_result result { 0, 0 };
+
+    TimeType step_duration = this->time_parameters()->step_duration();
+    size_t nblocks = block_dt_.size();
+    size_t nsteps = this->coeffs().nsteps();
+    std::vector<TimeType> t_local(nblocks, TimeType(0.0));
+    std::vector<double> clocks(2 * nblocks);
+    std::vector<bool> accepted(nblocks);
+
+    while (true) {
+      bool active = false;
+      for (size_t b = 0; b < nblocks; ++b) {
+	bool block_active = (t_local[b] < step_duration);
+	clocks[2 * b] = t_local[b];
+	clocks[2 * b + 1] = block_active ? block_dt_[b] : TimeType(0.0);
+	active = active or block_active;
+      }
+      if (not active) {
+	return result;
+      }
+
+      this->solver_->set_block_clocks(clocks);
+      for (size_t substep = 1; substep <= nsteps; ++substep) {
+	this->update_k(substep, this->coeffs().c(substep), TimeType(1.0));
+	this->update_y(substep, TimeType(1.0));
+      }
+      std::vector<typename SolverType::ValueType> cn =
+	this->solver_->block_control_numbers(nsteps);
+
+      bool repeated = false;
+      for (size_t b = 0; b < nblocks; ++b) {
+	accepted[b] = false;
+	if (clocks[2 * b + 1] == 0.0) {
+	  continue;
+	}
+	auto [ new_dt, repeat_timestep ] = this->control_timestep(block_dt_[b], cn[b]);
+	if (repeat_timestep) {
+	  std::cout << "Repeating timestep of block " << b
+		    << " at local time " << t_local[b] << std::endl;
+	  repeated = true;
+	} else {
+	  accepted[b] = true;
+	  t_local[b] += block_dt_[b];
+	}
+	block_dt_[b] = new_dt;
+
+	if (t_local[b] >= step_duration) {
+	  continue;
+	} else if (t_local[b] + block_dt_[b] > step_duration) {
+	  // Reduce the timestep to hit the end of step exactly, or
+	  // split the last two timesteps 40/60 (see
+	  // TypedTemporalScheme::step)
+	  block_dt_[b] = step_duration - t_local[b];
+	} else if (t_local[b] + 2.0 * block_dt_[b] > step_duration) {
+	  block_dt_[b] = (step_duration - t_local[b]) * 0.4;
+	}
+      }
+      this->solver_->accept_blocks(nsteps, accepted);
+
+      result.num_timesteps++;
+      if (repeated) {
+	result.num_repeated_timesteps++;
+      }
+    }
+  }
+
+};
+
 #endif
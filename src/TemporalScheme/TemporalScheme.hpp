@@ -109,7 +109,7 @@ protected:
      required to complete the step and the number of timesteps that
      were repeated.
   */
-  step_result step(void)
+  virtual step_result step(void)
   {
     step_result result { 0, 0 };
     
@@ -0,0 +1,93 @@
+#!/bin/sh
+#
+# Run a case on one rank and on four ranks, and check that the outputs
+# written by the ranks together match the single-rank output.
+#
+# Usage: mpi_compare.sh MPIEXEC NUMPROC_FLAG MFCM CASE WORK_DIR [OPTIONS...]
+#
+# The options are passed to mfcm (e.g. --accel-platform). The outputs
+# match if each value is within a relative tolerance TOLERANCE
+# (default 1e-5) of the single-rank value at the same location.
+
+set -e
+
+mpiexec=$1
+np_flag=$2
+mfcm=$3
+case_file=$4
+work_dir=$5
+shift 5
+tolerance=${TOLERANCE:-1e-5}
+
+rm -rf "$work_dir"
+mkdir -p "$work_dir/serial" "$work_dir/ranks"
+cp "$case_file" "$work_dir/serial/case.mf"
+cp "$case_file" "$work_dir/ranks/case.mf"
+
+"$mfcm" "$@" "$work_dir/serial/case.mf"
+"$mpiexec" $np_flag 4 "$mfcm" "$@" "$work_dir/ranks/case.mf"
+
+status=0
+count=0
+for serial_file in "$work_dir"/serial/output/*.csv; do
+    [ -e "$serial_file" ] || break
+    # The rank outputs are named <output>_rank<r>_<time>.csv
+    name=$(basename "$serial_file" .csv)
+    output=${name%_*}
+    time=${name##*_}
+    rank_files=
+    for r in 0 1 2 3; do
+	rank_file="$work_dir/ranks/output/${output}_rank${r}_${time}.csv"
+	if [ ! -e "$rank_file" ]; then
+	    echo "ERROR: Missing $rank_file" >&2
+	    status=1
+	fi
+	rank_files="$rank_files $rank_file"
+    done
+    [ $status -eq 0 ] || continue
+
+    if ! awk -F', *' -v tol="$tolerance" '
+	FNR == 1 { next }
+	NR == FNR { ref[$1 "," $2] = $0; next }
+	{
+	    key = $1 "," $2
+	    if (!(key in ref)) {
+		print "ERROR: No cell at (" key ") in the single-rank output"
+		bad = 1
+		next
+	    }
+	    if (key in seen) {
+		print "ERROR: Cell (" key ") written by more than one rank"
+		bad = 1
+	    }
+	    seen[key] = 1
+	    split(ref[key], r, /, */)
+	    for (c = 3; c <= NF; ++c) {
+		d = $c - r[c]
+		a = (r[c] < 0) ? -r[c] : r[c]
+		if (d > tol * (1 + a) || -d > tol * (1 + a)) {
+		    print "ERROR: Column " c " at (" key "): " $c " on the ranks, " r[c] " on one rank"
+		    bad = 1
+		}
+	    }
+	}
+	END {
+	    for (key in ref) {
+		if (!(key in seen)) {
+		    print "ERROR: Cell (" key ") not written by any rank"
+		    bad = 1
+		}
+	    }
+	    exit bad
+	}' "$serial_file" $rank_files >&2; then
+	echo "ERROR: $name differs between one rank and four" >&2
+	status=1
+    fi
+    count=$((count + 1))
+done
+
+if [ $count -eq 0 ]; then
+    echo "ERROR: No single-rank outputs to compare" >&2
+    status=1
+fi
+exit $status
@@ -0,0 +1,194 @@
+/***********************************************************************
+ * mfcm launch.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_launch_hpp
+#define mfcm_launch_hpp
+
+#include "sycl.hpp"
+
+/**
+   Kinds of kernel whose launch configuration is tuned separately (see
+   LaunchTuner).
+ */
+enum class KernelKind
+{
+  Flux,
+  Derivative,
+  TemporalDerivative,
+  Reduction
+};
+
+/**
+   The launch configuration of a kernel. Zero in either member leaves
+   the choice to the default: one object per work item, and
+   work-group size chosen by the runtime. A solver keeps the
+   configuration of each kind of kernel tuned for its mesh, and passes
+   it to launch_kernel or launch_reduction.
+ */
+struct LaunchConfiguration
+{
+  size_t block_size = 0;
+  size_t work_group_size = 0;
+};
+
+/**
+   Return the launch configuration of kernels on the device of the
+   configuration instance before any tuning. The "blocked" engine of
+   the device configuration launches one work item per block of
+   "block size" (default 256) objects, because on a CPU the cost of a
+   work item exceeds the arithmetic for one cell or face, and one work
+   item per object hides the loop from the vectoriser. The default
+   "sycl" engine launches one work item per object.
+ */
+LaunchConfiguration default_launch_configuration(void);
+
+/**
+   A kernel that applies another kernel, taking a sycl::id<1>, to a
+   contiguous block of objects in a loop marked for vectorisation,
+   which needs OpenMP SIMD directives enabled (see CMakeLists.txt and
+   the MFCM_VECTORIZE_REPORT option).
+ */
+template<typename Kernel>
+class BlockedKernel
+{
+private:
+
+  Kernel kernel_;
+  size_t count_;
+  size_t block_size_;
+
+public:
+
+  BlockedKernel(const Kernel& kernel,
+		const size_t& count,
+		const size_t& block_size)
+    : kernel_(kernel), count_(count), block_size_(block_size)
+  {}
+
+  void operator()(sycl::id<1> block) const
+  {
+    size_t begin = block[0] * block_size_;
+    size_t end = sycl::min(begin + block_size_, count_);
+#pragma omp simd
+    for (size_t i = begin; i < end; ++i) {
+      kernel_(sycl::id<1>(i));
+    }
+  }
+};
+
+/**
+   A kernel that applies another kernel, taking a sycl::id<1>, to the
+   work items of an nd_range, skipping those past count that pad the
+   range to a whole number of work groups.
+ */
+template<typename Kernel>
+class GroupedKernel
+{
+private:
+
+  Kernel kernel_;
+  size_t count_;
+
+public:
+
+  GroupedKernel(const Kernel& kernel,
+		const size_t& count)
+    : kernel_(kernel), count_(count)
+  {}
+
+  void operator()(sycl::nd_item<1> item) const
+  {
+    size_t i = item.get_global_id(0);
+    if (i < count_) {
+      kernel_(sycl::id<1>(i));
+    }
+  }
+};
+
+/**
+   Launch a kernel over count work items, in work groups of the given
+   size or, if it is zero, of the size chosen by the runtime.
+ */
+template<typename Kernel>
+void launch_work_items(sycl::handler& cgh,
+		       const size_t& count,
+		       const Kernel& kernel,
+		       const size_t& work_group_size)
+{
+  if (work_group_size > 0) {
+    size_t groups = (count + work_group_size - 1) / work_group_size;
+    cgh.parallel_for(sycl::nd_range<1>(groups * work_group_size, work_group_size),
+		     GroupedKernel<Kernel>(kernel, count));
+  } else {
+    cgh.parallel_for(sycl::range<1>(count), kernel);
+  }
+}
+
+/**
+   Launch a kernel over count objects, either with one work item per
+   object or with one work item per block of objects, using the given
+   launch configuration. The kernel must take a sycl::id<1>.
+ */
+template<typename Kernel>
+void launch_kernel(sycl::handler& cgh,
+		   const size_t& count,
+		   const Kernel& kernel,
+		   const LaunchConfiguration& lc = LaunchConfiguration())
+{
+  if (lc.block_size > 1) {
+    launch_work_items(cgh, (count + lc.block_size - 1) / lc.block_size,
+		      BlockedKernel<Kernel>(kernel, count, lc.block_size),
+		      lc.work_group_size);
+  } else {
+    launch_work_items(cgh, count, kernel, lc.work_group_size);
+  }
+}
+
+/**
+   Launch a reduction over count objects, in work groups of the size
+   given by the launch configuration. The kernel must take a
+   sycl::id<1> and the reducer.
+ */
+template<typename Reduction,
+	 typename Kernel>
+void launch_reduction(sycl::handler& cgh,
+		      const size_t& count,
+		      const Reduction& reduction,
+		      const Kernel& kernel,
+		      const LaunchConfiguration& lc = LaunchConfiguration())
+{
+  size_t work_group_size = lc.work_group_size;
+  if (work_group_size > 0) {
+    size_t groups = (count + work_group_size - 1) / work_group_size;
+    cgh.parallel_for(sycl::nd_range<1>(groups * work_group_size, work_group_size),
+		     reduction,
+		     [=](sycl::nd_item<1> item, auto& reducer) {
+		       size_t i = item.get_global_id(0);
+		       if (i < count) {
+			 kernel(sycl::id<1>(i), reducer);
+		       }
+		     });
+  } else {
+    cgh.parallel_for(sycl::range<1>(count), reduction,
+		     [=](sycl::item<1> item, auto& reducer) {
+		       kernel(item.get_id(), reducer);
+		     });
+  }
+}
+
+#endif
@@ -7,16 +7,37 @@
 #include "Config/Config.hpp"
   
 #include "Mesh/Cartesian2DMesh.hpp"
+#include "Mesh/QuadtreeMesh.hpp"
+#include "Mesh/RectilinearMesh.hpp"
+#include "Mesh/SparseCartesian2DMesh.hpp"
+#include "Mesh/UnstructuredMesh.hpp"
 #include "SaintVenant/Solver.hpp"
+#include "SaintVenant/DecomposedSolver.hpp"
+#include "SaintVenant/EnsembleSolver.hpp"
 #include "TemporalScheme/RungeKutta.hpp"
+#include "mpi.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <set>
+#include <thread>
 
 using ValueType = float;
 using TimeType = ValueType;
-using MeshType = Cartesian2DMesh;
+
+template<typename MeshType>
 using SolverType = SaintVenantSolver<TimeType,ValueType,MeshType>;
+using DecomposedSolverType = SaintVenantDecomposedSolver<TimeType,ValueType>;
+using EnsembleSolverType = SaintVenantEnsembleSolver<TimeType,ValueType>;
+using PackedSolverType = SaintVenantPackedSolver<TimeType,ValueType>;
+using PackedBlockType = SaintVenantPackedBlock<TimeType,ValueType>;
   
 
-template<typename Solver>
+template<typename Solver,
+	 template<typename> class RungeKuttaScheme = RungeKuttaSolver>
 std::shared_ptr<TemporalScheme> create_scheme(const std::shared_ptr<sycl::queue>& queue)
 {
   const Config& conf = GlobalConfig::instance().scheme_configuration();
@@ -25,7 +46,7 @@ std::shared_ptr<TemporalScheme> create_scheme(const std::shared_ptr<sycl::queue>
   if (scheme_type_str == "runge-kutta") {
     auto tparams = std::make_shared<RungeKuttaTimeParameters<typename Solver::TimeType>>(conf);
     std::string method_type_str = conf.get<std::string>("method", "classic");
-    return std::make_shared<RungeKuttaSolver<Solver>>(tparams,
+    return std::make_shared<RungeKuttaScheme<Solver>>(tparams,
 						      method_type_str,
 						      queue);
   }
@@ -35,15 +56,384 @@ std::shared_ptr<TemporalScheme> create_scheme(const std::shared_ptr<sycl::queue>
   throw std::runtime_error("Unknown scheme type.");
 }
 
+template<typename MeshType>
+std::shared_ptr<TemporalScheme> create_mesh_scheme(const std::shared_ptr<sycl::queue>& queue)
+{
+  const Config& conf = GlobalConfig::instance().ensemble_configuration();
+  if (conf.get<size_t>("members", conf.count("member")) > 1) {
+    // The members are packed into the blocks of one mesh, each of
+    // which takes its own timesteps
+    if constexpr (std::is_same_v<MeshType, Cartesian2DMesh>) {
+      return create_scheme<EnsembleSolverType,RungeKuttaBlockSolver>(queue);
+    } else {
+      std::cerr << "ERROR: Ensembles are only supported on row-major "
+		<< "Cartesian meshes." << std::endl;
+      throw std::runtime_error("Ensemble not supported on mesh.");
+    }
+  }
+  return create_scheme<SolverType<MeshType>>(queue);
+}
+
+/**
+   Create the scheme for the model of the configuration instance.
+ */
+std::shared_ptr<TemporalScheme> create_model_scheme(const std::shared_ptr<sycl::queue>& queue)
+{
+  const Config& mesh_conf = GlobalConfig::instance().mesh_configuration();
+  std::string mesh_type_str = mesh_conf.get<std::string>("type", "cartesian");
+
+  if (mesh_type_str == "cartesian" and
+      (mesh_conf.get<size_t>("subdomains", 1) > 1 or mpi_size() > 1)) {
+    return create_scheme<DecomposedSolverType>(queue);
+  } else if (mesh_type_str == "cartesian" and
+	     mesh_conf.get<std::string>("ordering", "row major") == "tiled") {
+    return create_mesh_scheme<TiledCartesian2DMesh>(queue);
+  } else if (mesh_type_str == "cartesian") {
+    return create_mesh_scheme<Cartesian2DMesh>(queue);
+  } else if (mesh_type_str == "quadtree") {
+    return create_mesh_scheme<QuadtreeMesh>(queue);
+  } else if (mesh_type_str == "rectilinear") {
+    return create_mesh_scheme<RectilinearMesh>(queue);
+  } else if (mesh_type_str == "sparse") {
+    return create_mesh_scheme<SparseCartesian2DMesh>(queue);
+  } else if (mesh_type_str == "unstructured") {
+    return create_mesh_scheme<UnstructuredMesh>(queue);
+  }
+
+  std::cerr << "Unknown mesh type: "
+	    << std::quoted(mesh_type_str) << std::endl;
+  throw std::runtime_error("Unknown mesh type.");
+}
+
+/**
+   Read a job list: a text file naming the configuration file of one
+   model on each line, relative to the job list. Blank lines and lines
+   starting with "#" are ignored.
+ */
+std::vector<stdfs::path> read_job_list(const stdfs::path& list_path)
+{
+  std::ifstream list(list_path);
+  if (not list) {
+    std::cerr << "ERROR: Cannot read job list "
+	      << std::quoted(list_path.native()) << std::endl;
+    throw std::runtime_error("Cannot read job list.");
+  }
+  std::vector<stdfs::path> jobs;
+  std::string line;
+  while (std::getline(list, line)) {
+    boost::algorithm::trim(line);
+    if (line.empty() or line.front() == '#') {
+      continue;
+    }
+    stdfs::path job(line);
+    if (not job.is_absolute()) {
+      job = list_path.parent_path() / job;
+    }
+    jobs.push_back(job);
+  }
+  return jobs;
+}
+
+/**
+   Get the key of the model of the configuration instance, or an empty
+   key if it cannot be packed with other models: its mesh must be
+   Cartesian, in row-major order and without subdomains, and it must
+   not be an ensemble. Models can be packed together (see create_pack_scheme)
+   if their keys are the same.
+ */
+std::string pack_key(void)
+{
+  GlobalConfig& gc = GlobalConfig::instance();
+  const Config& mesh_conf = gc.mesh_configuration();
+  const Config& ens_conf = gc.ensemble_configuration();
+  if (mesh_conf.get<std::string>("type", "cartesian") != "cartesian" or
+      mesh_conf.get<std::string>("ordering", "row major") != "row major" or
+      mesh_conf.get<size_t>("subdomains", 1) > 1 or mpi_size() > 1 or
+      ens_conf.get<size_t>("members", ens_conf.count("member")) > 1) {
+    return "";
+  }
+
+  // The models share the scheme and its time parameters, and the
+  // kernels of their source terms and boundaries
+  std::ostringstream key;
+  bpt::write_mf(key, gc.scheme_configuration());
+  for (auto&& conf : gc.source_term_configurations()) {
+    key << "source term " << conf.get().get_value<std::string>() << std::endl;
+  }
+  for (auto&& conf : gc.boundary_configurations()) {
+    key << "boundary " << conf.get().get_value<std::string>() << std::endl;
+  }
+  return key.str();
+}
+
+/**
+   Create the scheme for the models of the configurations, packed into
+   the blocks of one mesh (see SaintVenantPackedSolver), so that each
+   kernel is launched once over every model while each takes the
+   timesteps that it allows. Each model writes the outputs of its own
+   configuration.
+ */
+std::shared_ptr<TemporalScheme>
+create_pack_scheme(const std::shared_ptr<sycl::queue>& queue,
+		   const std::vector<std::shared_ptr<GlobalConfig>>& models)
+{
+  GlobalConfig::activate(models.front());
+  const Config& conf = GlobalConfig::instance().scheme_configuration();
+
+  std::string scheme_type_str = conf.get_value<std::string>("runge-kutta");
+  std::string method_type_str = conf.get<std::string>("method", "classic");
+  if (scheme_type_str != "runge-kutta" or
+      runge_kutta_named_coefficient_sets_.count(method_type_str) == 0) {
+    std::cerr << "ERROR: Only models with a named Runge Kutta method "
+	      << "can be packed." << std::endl;
+    throw std::runtime_error("Unknown scheme type.");
+  }
+  auto tparams = std::make_shared<RungeKuttaTimeParameters<TimeType>>(conf);
+  std::shared_ptr<OutputWriter> writer = make_output_writer();
+  size_t no_of_states =
+    runge_kutta_named_coefficient_sets_.at(method_type_str).nsteps() + 1;
+  auto solver = std::make_shared<PackedSolverType>(queue, no_of_states,
+						   tparams, models);
+
+  std::vector<std::shared_ptr<TimedOutputFile<TimeType>>> outputs;
+  for (size_t b = 0; b < models.size(); ++b) {
+    GlobalConfig::activate(models.at(b));
+    auto block = std::make_shared<PackedBlockType>(solver, b);
+    for (auto&& name : GlobalConfig::instance().output_files_list()) {
+      outputs.push_back(make_field_output_file<PackedBlockType>(name, tparams,
+								block, writer));
+    }
+  }
+
+  return std::make_shared<RungeKuttaBlockSolver<PackedSolverType>>
+    (tparams, method_type_str, solver, outputs);
+}
+
+/**
+   Solve the model of each job, with its own configuration and base
+   path. The configurations are read first, and models that can be
+   packed together (see pack_key) are solved in packs of up to
+   pack_size models; the others, and those of a pack that cannot be
+   created, one after another. Returns the number of jobs that failed.
+ */
+size_t solve_jobs(const std::shared_ptr<sycl::queue>& queue,
+		  const std::vector<stdfs::path>& jobs,
+		  size_t pack_size)
+{
+  size_t failed_jobs = 0;
+  std::vector<std::shared_ptr<GlobalConfig>> models(jobs.size());
+  std::map<std::string, std::vector<size_t>> packs;
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    try {
+      GlobalConfig::init(jobs.at(i), jobs.at(i).parent_path());
+      models.at(i) = GlobalConfig::current();
+      packs[pack_key()].push_back(i);
+    } catch (const std::exception& e) {
+      std::cerr << "ERROR: Job " << jobs.at(i) << " failed: "
+		<< e.what() << std::endl;
+      ++failed_jobs;
+    }
+  }
+
+  auto solve_job = [&] (size_t i)
+  {
+    try {
+      GlobalConfig::activate(models.at(i));
+      create_model_scheme(queue)->solve();
+    } catch (const std::exception& e) {
+      std::cerr << "ERROR: Job " << jobs.at(i) << " failed: "
+		<< e.what() << std::endl;
+      ++failed_jobs;
+    }
+    // Let the caches of inputs forget the model
+    models.at(i).reset();
+  };
+
+  pack_size = std::max(pack_size, size_t(1));
+  for (auto&& [key, pack] : packs) {
+    for (size_t first = 0; first < pack.size(); first += pack_size) {
+      size_t last = std::min(first + pack_size, pack.size());
+      if (key.empty() or last - first == 1) {
+	for (size_t k = first; k < last; ++k) {
+	  solve_job(pack.at(k));
+	}
+	continue;
+      }
+
+      std::vector<std::shared_ptr<GlobalConfig>> pack_models;
+      for (size_t k = first; k < last; ++k) {
+	pack_models.push_back(models.at(pack.at(k)));
+      }
+      std::shared_ptr<TemporalScheme> scheme;
+      try {
+	scheme = create_pack_scheme(queue, pack_models);
+      } catch (const std::exception& e) {
+	std::cerr << "WARNING: " << pack_models.size() << " models cannot be "
+		  << "packed together (" << e.what() << "), so they are "
+		  << "solved one at a time." << std::endl;
+      }
+      if (not scheme) {
+	for (size_t k = first; k < last; ++k) {
+	  solve_job(pack.at(k));
+	}
+	continue;
+      }
+
+      std::cout << "Solving " << pack_models.size()
+		<< " models packed together" << std::endl;
+      try {
+	scheme->solve();
+      } catch (const std::exception& e) {
+	for (size_t k = first; k < last; ++k) {
+	  std::cerr << "ERROR: Job " << jobs.at(pack.at(k)) << " failed: "
+		    << e.what() << std::endl;
+	}
+	failed_jobs += last - first;
+      }
+      for (size_t k = first; k < last; ++k) {
+	models.at(pack.at(k)).reset();
+      }
+    }
+  }
+  return failed_jobs;
+}
+
+/**
+   Solve each model in the job list (see read_job_list) of the batch
+   configuration.
+
+   Models that can be packed together are solved in packs of up to
+   "models per pack" (default 64), so that they share the start-up of
+   the process, the SYCL queue and each kernel launch (see
+   solve_jobs).
+ */
+void run_batch(const std::shared_ptr<sycl::queue>& queue)
+{
+  // The jobs replace the configuration instance, so keep what is
+  // needed of the batch configuration
+  const Config& conf = GlobalConfig::instance().batch_configuration();
+  stdfs::path list_path = conf.get<stdfs::path>("job list");
+  if (not list_path.is_absolute()) {
+    list_path = GlobalConfig::instance().simulation_base_path() / list_path;
+  }
+  size_t pack_size = conf.get<size_t>("models per pack", 64);
+
+  std::vector<stdfs::path> jobs = read_job_list(list_path);
+  std::cout << "Solving " << jobs.size() << " jobs" << std::endl;
+
+  size_t failed_jobs = solve_jobs(queue, jobs, pack_size);
+  if (failed_jobs > 0) {
+    std::cerr << "ERROR: " << failed_jobs << " of " << jobs.size()
+	      << " jobs failed." << std::endl;
+    throw std::runtime_error("Batch jobs failed.");
+  }
+}
+
+/**
+   Keep the process, its SYCL queue and its caches of rasters and time
+   series resident, and solve the jobs that arrive in the spool
+   directory of the server configuration one after another. The
+   models of a job list are packed as in a batch run (see run_batch),
+   in packs of up to "models per pack" (default 64).
+
+   A job is a job list (see read_job_list) whose name ends in ".jobs",
+   so it should be written under another name and then renamed. Once
+   solved, ".done" or ".failed" is appended to its name. A file named
+   "shutdown" in the spool directory stops the server. While idle the
+   directory is scanned every "poll interval" seconds (default 5).
+ */
+void run_server(const std::shared_ptr<sycl::queue>& queue)
+{
+  // The jobs replace the configuration instance, so keep what is
+  // needed of the server configuration
+  const Config& conf = GlobalConfig::instance().server_configuration();
+  stdfs::path spool_path = conf.get<stdfs::path>("spool directory");
+  if (not spool_path.is_absolute()) {
+    spool_path = GlobalConfig::instance().simulation_base_path() / spool_path;
+  }
+  double poll_interval = conf.get<double>("poll interval", 5.0);
+  size_t pack_size = conf.get<size_t>("models per pack", 64);
+
+  // Job lists that were solved but could not be renamed, which must
+  // not be solved again
+  std::set<stdfs::path> finished;
+
+  std::cout << "Watching spool directory " << spool_path << std::endl;
+  while (not stdfs::exists(spool_path / "shutdown")) {
+    std::vector<stdfs::path> job_lists;
+    for (auto&& entry : stdfs::directory_iterator(spool_path)) {
+      if (entry.is_regular_file() and entry.path().extension() == ".jobs" and
+	  finished.count(entry.path()) == 0) {
+	job_lists.push_back(entry.path());
+      }
+    }
+    if (job_lists.empty()) {
+      std::this_thread::sleep_for(std::chrono::duration<double>(poll_interval));
+      continue;
+    }
+
+    std::sort(job_lists.begin(), job_lists.end());
+    for (auto&& list_path : job_lists) {
+      std::cout << "Starting job list " << list_path << std::endl;
+      size_t failed_jobs = 1;
+      try {
+	failed_jobs = solve_jobs(queue, read_job_list(list_path), pack_size);
+      } catch (const std::exception& e) {
+	std::cerr << "ERROR: Job list " << list_path << " failed: "
+		  << e.what() << std::endl;
+      }
+      stdfs::path done_path = list_path;
+      done_path += (failed_jobs > 0) ? ".failed" : ".done";
+      std::error_code ec;
+      stdfs::rename(list_path, done_path, ec);
+      if (ec) {
+	std::cerr << "ERROR: Cannot rename job list " << list_path
+		  << " to " << done_path << ": " << ec.message() << std::endl;
+	finished.insert(list_path);
+      } else {
+	std::cout << "Finished job list " << done_path << std::endl;
+      }
+    }
+  }
+
+  stdfs::remove(spool_path / "shutdown");
+  std::cout << "Server shut down" << std::endl;
+}
+
 int main(int argc, char* argv[])
 {
   std::locale loc;
-  GlobalConfig::init(argc, argv);
+#ifdef MFCM_USE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  std::shared_ptr<TemporalScheme> scheme_ptr;
+  try {
+    GlobalConfig::init(argc, argv);
 
-  std::cout << "Initialised global configuration" << std::endl;
+    std::cout << "Initialised global configuration" << std::endl;
+
+    if (GlobalConfig::instance().server_configuration().count("spool directory") > 0) {
+      run_server(get_sycl_queue());
+    } else if (GlobalConfig::instance().batch_configuration().count("job list") > 0) {
+      run_batch(get_sycl_queue());
+    } else {
+      scheme_ptr = create_model_scheme(get_sycl_queue());
+      scheme_ptr->solve();
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+#ifdef MFCM_USE_MPI
+    // The other ranks would wait for this one forever
+    MPI_Abort(MPI_COMM_WORLD, 1);
+#endif
+    return 1;
+  }
 
-  auto scheme_ptr = create_scheme<SolverType>(get_sycl_queue());
-  scheme_ptr->solve();
+#ifdef MFCM_USE_MPI
+  scheme_ptr.reset();
+  MPI_Finalize();
+#endif
   
   return 0;
 }
@@ -0,0 +1,75 @@
+/***********************************************************************
+ * mfcm mpi.hpp
+ *
+ * Copyright (C) Edenvale Young Associates 2022
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef mfcm_mpi_hpp
+#define mfcm_mpi_hpp
+
+#ifdef MFCM_USE_MPI
+#include <mpi.h>
+#endif
+
+#include <type_traits>
+
+/**
+   Return the rank of this process, or zero if mfcm is built without
+   MPI.
+ */
+inline int mpi_rank(void)
+{
+#ifdef MFCM_USE_MPI
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  return rank;
+#else
+  return 0;
+#endif
+}
+
+/**
+   Return the number of processes, or one if mfcm is built without
+   MPI.
+ */
+inline int mpi_size(void)
+{
+#ifdef MFCM_USE_MPI
+  int size;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  return size;
+#else
+  return 1;
+#endif
+}
+
+#ifdef MFCM_USE_MPI
+/**
+   Return the MPI datatype of a floating point type.
+ */
+template<typename T>
+inline MPI_Datatype mpi_datatype(void)
+{
+  static_assert(std::is_same<T,float>::value or std::is_same<T,double>::value,
+		"No MPI datatype for this type.");
+  if constexpr (std::is_same<T,float>::value) {
+    return MPI_FLOAT;
+  } else {
+    return MPI_DOUBLE;
+  }
+}
+#endif
+
+#endif
@@ -17,6 +17,8 @@
  ***********************************************************************/
 
 #include "sycl.hpp"
+#include "launch.hpp"
+#include "mpi.hpp"
 #include "Config.hpp"
 
 std::shared_ptr<sycl::queue> get_sycl_queue(void)
@@ -92,6 +94,10 @@ std::shared_ptr<sycl::queue> get_sycl_queue(void)
     for (auto&& dn : device_names) {
       std::cout << "  " << dn << std::endl;
     }
+  } else if (device_str == "all" and not devices.empty()) {
+    // Every device of the platform is used by a decomposed solver
+    // (see get_sycl_queues); the first one hosts the main queue
+    device_id = 0;
   } else {
     for (size_t i = 0; i < devices.size(); ++i) {
       size_t pos = device_names.at(i).find(device_str);
@@ -122,5 +128,63 @@ std::shared_ptr<sycl::queue> get_sycl_queue(void)
     throw std::runtime_error("Device not available.");
   }    
   
+  // The blocked engine (see default_launch_configuration) suits CPU
+  // devices
+  if (default_launch_configuration().block_size > 1 and
+      not devices.at(device_id).is_cpu()) {
+    std::cout << "WARNING: The blocked engine is intended for CPU devices."
+	      << std::endl;
+  }
+  
   return std::make_shared<sycl::queue>(devices.at(device_id));
 }
+
+LaunchConfiguration default_launch_configuration(void)
+{
+  const Config& device_conf = GlobalConfig::instance().device_configuration();
+
+  LaunchConfiguration lc;
+  std::string engine_str = device_conf.get<std::string>("engine", "sycl");
+  if (engine_str == "blocked") {
+    lc.block_size = device_conf.get<size_t>("block size", 256);
+  } else if (engine_str != "sycl") {
+    std::cerr << "ERROR: Unknown engine: "
+	      << std::quoted(engine_str) << std::endl;
+    throw std::runtime_error("Unknown engine.");
+  }
+  return lc;
+}
+
+std::vector<std::shared_ptr<sycl::queue>>
+get_sycl_queues(const std::shared_ptr<sycl::queue>& queue, const size_t& n)
+{
+  const Config& device_conf = GlobalConfig::instance().device_configuration();
+
+  sycl::device device = queue->get_device();
+  std::vector<sycl::device> devices;
+  if (device_conf.get<std::string>("device", "list") == "all") {
+    devices = device.get_platform().get_devices();
+  } else if (n > 1) {
+    size_t units = device.get_info<sycl::info::device::max_compute_units>();
+    if (units >= n) {
+      try {
+	devices = device.create_sub_devices<sycl::info::partition_property::partition_equally>(units / n);
+      } catch (const sycl::exception& e) {
+	std::cout << "Device cannot be partitioned (" << e.what()
+		  << "): subdomains will share it." << std::endl;
+      }
+    }
+  }
+
+  std::vector<std::shared_ptr<sycl::queue>> queues;
+  for (size_t i = 0; i < n; ++i) {
+    if (devices.empty()) {
+      queues.push_back(i == 0 ? queue : std::make_shared<sycl::queue>(device));
+    } else {
+      // Ranks sharing a node take successive devices
+      size_t j = mpi_rank() * n + i;
+      queues.push_back(std::make_shared<sycl::queue>(devices.at(j % devices.size())));
+    }
+  }
+  return queues;
+}
@@ -28,4 +28,15 @@ namespace sycl = cl::sycl;
 
 std::shared_ptr<sycl::queue> get_sycl_queue(void);
 
+/**
+   Return n queues for the subdomains of a decomposed solver. If the
+   device configuration selects "all" devices, the queues are spread
+   over every device of the platform of queue. Otherwise the device of
+   queue is partitioned into n equal sub-devices if it supports that,
+   which lets a CPU-only machine run the subdomains on separate cores,
+   or failing that every queue shares its device.
+*/
+std::vector<std::shared_ptr<sycl::queue>>
+get_sycl_queues(const std::shared_ptr<sycl::queue>& queue, const size_t& n);
+
 #endif